@@ -0,0 +1,559 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT. It implements the batching of small RPCs.
+ *
+ * Small RPCs sent to the same endpoint within CRT_BATCH_WINDOW are packed
+ * (common header + input) on origin side and shipped in one CRT_OPC_BATCH
+ * RPC. The target unpacks them and invokes the RPC handlers individually,
+ * the replies are packed in the same order and sent back as the reply of
+ * the CRT_OPC_BATCH RPC, then every batched RPC is completed with its own
+ * reply on origin side.
+ *
+ * An RPC to an endpoint without batch in flight is sent right away, in a batch
+ * of its own. The following RPCs to that endpoint are collected while the batch
+ * is in flight, and sent on its completion, or once CRT_BATCH_WINDOW expired or
+ * the batch is full. So the batching never delays an RPC if the endpoint is idle,
+ * and it does not rely on the progress thread waking up for a new deadline.
+ *
+ * The batched RPCs are not tracked by the context themselves, the batch RPC
+ * is tracked instead and its timeout is the min timeout of the batched RPCs.
+ */
+#define D_LOGFAC	DD_FAC(rpc)
+
+#include "crt_internal.h"
+
+static void
+crt_batch_put(struct crt_batch *batch)
+{
+	if (atomic_fetch_sub(&batch->cb_ref, 1) != 1)
+		return;
+
+	D_ASSERT(batch->cb_iovs == NULL);
+	if (batch->cb_rpc != NULL)
+		RPC_DECREF(batch->cb_rpc);
+	D_FREE(batch);
+}
+
+static inline bool
+crt_batch_ep_match(crt_endpoint_t *ep1, crt_endpoint_t *ep2)
+{
+	return ep1->ep_grp == ep2->ep_grp && ep1->ep_rank == ep2->ep_rank &&
+	       ep1->ep_tag == ep2->ep_tag;
+}
+
+static bool
+crt_batch_eligible(struct crt_rpc_priv *rpc_priv)
+{
+	crt_opcode_t	opc = rpc_priv->crp_pub.cr_opc;
+
+	/* collective, one-way and CaRT internal (including SWIM) RPCs are never batched */
+	if (rpc_priv->crp_coll || rpc_priv->crp_opc_info->coi_no_reply)
+		return false;
+
+	return (opc & CRT_PROTO_BASEOPC_MASK) < CRT_OPC_FI_BASE;
+}
+
+static struct crt_batch *
+crt_batch_alloc(crt_endpoint_t *ep)
+{
+	struct crt_batch	*batch;
+
+	D_ALLOC_PTR(batch);
+	if (batch == NULL)
+		return NULL;
+
+	D_ALLOC_ARRAY(batch->cb_iovs, crt_gdata.cg_batch_max);
+	if (batch->cb_iovs == NULL) {
+		D_FREE(batch);
+		return NULL;
+	}
+
+	D_INIT_LIST_HEAD(&batch->cb_link);
+	D_INIT_LIST_HEAD(&batch->cb_tmp_link);
+	D_INIT_LIST_HEAD(&batch->cb_rpcs);
+	batch->cb_ep = *ep;
+	batch->cb_cap = crt_gdata.cg_batch_max;
+	batch->cb_deadline = d_timeus_secdiff(0) + crt_gdata.cg_batch_window;
+	/* released on batch completion */
+	atomic_init(&batch->cb_ref, 1);
+
+	return batch;
+}
+
+/* Complete all the batched RPCs with the replies in \a out, or with \a rc for failure */
+static void
+crt_batch_complete(struct crt_batch *batch, struct crt_batch_out *out, int rc)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	int			 rpc_rc;
+	int			 i;
+
+	while ((rpc_priv = d_list_pop_entry(&batch->cb_rpcs, struct crt_rpc_priv,
+					    crp_parent_link))) {
+		rpc_rc = rc;
+		if (rpc_rc == 0) {
+			D_ASSERT(rpc_priv->crp_batch_idx < out->bo_replies.ca_count);
+			rpc_rc = crt_proc_batch_decode(rpc_priv, true /* reply */,
+						       &out->bo_replies.ca_arrays[rpc_priv->crp_batch_idx]);
+			if (rpc_rc == 0)
+				rpc_priv->crp_output_got = 1;
+		}
+
+		crt_rpc_lock(rpc_priv);
+		crt_rpc_complete_and_unlock(rpc_priv, rpc_rc);
+		/* corresponding to RPC_ADDREF in crt_batch_req_add() */
+		RPC_DECREF(rpc_priv);
+	}
+
+	for (i = 0; i < batch->cb_nr; i++)
+		D_FREE(batch->cb_iovs[i].iov_buf);
+	D_FREE(batch->cb_iovs);
+
+	crt_batch_put(batch);
+}
+
+static void crt_batch_send(struct crt_batch *batch);
+
+/*
+ * Remove the batch that is done from the context, and send the batch collected
+ * to the same endpoint meanwhile.
+ */
+static void
+crt_batch_done(struct crt_context *ctx, struct crt_batch *batch)
+{
+	struct crt_batch	*next;
+	bool			 found = false;
+
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_del_init(&batch->cb_link);
+	d_list_for_each_entry(next, &ctx->cc_batch_list, cb_link) {
+		if (!next->cb_sent && crt_batch_ep_match(&next->cb_ep, &batch->cb_ep)) {
+			next->cb_sent = true;
+			found = true;
+			break;
+		}
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	if (found)
+		crt_batch_send(next);
+}
+
+static void
+crt_batch_send_cb(const struct crt_cb_info *cb_info)
+{
+	struct crt_batch	*batch = cb_info->cci_arg;
+	struct crt_batch_out	*out = NULL;
+	int			 rc = cb_info->cci_rc;
+
+	crt_batch_done(cb_info->cci_rpc->cr_ctx, batch);
+
+	if (rc == 0) {
+		out = crt_reply_get(cb_info->cci_rpc);
+		rc = out->bo_rc;
+		if (rc == 0 && out->bo_replies.ca_count != batch->cb_nr) {
+			D_ERROR("Batch of %u RPCs got %u replies.\n", batch->cb_nr,
+				(uint32_t)out->bo_replies.ca_count);
+			rc = -DER_PROTO;
+		}
+	}
+
+	if (rc == 0) {
+		/* The unpacked replies refer to the reply buffer of the batch RPC */
+		RPC_PUB_ADDREF(cb_info->cci_rpc);
+		batch->cb_rpc = container_of(cb_info->cci_rpc, struct crt_rpc_priv, crp_pub);
+	} else {
+		D_CDEBUG(crt_quiet_error(rc), DB_NET, DLOG_ERR,
+			 "Batch of %u RPCs to %u:%u failed, " DF_RC "\n", batch->cb_nr,
+			 batch->cb_ep.ep_rank, batch->cb_ep.ep_tag, DP_RC(rc));
+	}
+
+	crt_batch_complete(batch, out, rc);
+}
+
+static void
+crt_batch_send(struct crt_batch *batch)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	struct crt_batch_in	*in;
+	crt_rpc_t		*req;
+	int			 rc;
+
+	D_ASSERT(!d_list_empty(&batch->cb_rpcs));
+	rpc_priv = d_list_entry(batch->cb_rpcs.next, struct crt_rpc_priv, crp_parent_link);
+
+	D_ASSERT(batch->cb_sent);
+	rc = crt_req_create(rpc_priv->crp_pub.cr_ctx, &batch->cb_ep, CRT_OPC_BATCH, &req);
+	if (rc != 0) {
+		D_ERROR("Failed to create batch RPC: " DF_RC "\n", DP_RC(rc));
+		crt_batch_done(rpc_priv->crp_pub.cr_ctx, batch);
+		crt_batch_complete(batch, NULL, rc);
+		return;
+	}
+
+	in = crt_req_get(req);
+	in->bi_reqs.ca_count = batch->cb_nr;
+	in->bi_reqs.ca_arrays = batch->cb_iovs;
+	crt_req_set_timeout(req, batch->cb_timeout);
+
+	D_DEBUG(DB_TRACE, "Send batch of %u RPCs to %u:%u\n", batch->cb_nr,
+		batch->cb_ep.ep_rank, batch->cb_ep.ep_tag);
+
+	/* failure is reported through crt_batch_send_cb() */
+	crt_req_send(req, crt_batch_send_cb, batch);
+}
+
+/*
+ * Pack the RPC into the pending batch to its target endpoint, it is
+ * completed on the batch completion.
+ *
+ * Returns 0 if the RPC is batched, or error if it should be sent alone.
+ */
+int
+crt_batch_req_add(struct crt_rpc_priv *rpc_priv)
+{
+	struct crt_context	*ctx = rpc_priv->crp_pub.cr_ctx;
+	struct crt_batch	*batch = NULL;
+	struct crt_batch	*tmp;
+	bool			 busy = false;
+	bool			 send = false;
+	d_iov_t			 iov;
+	int			 rc;
+
+	if (!crt_batch_eligible(rpc_priv))
+		return -DER_NOTAPPLICABLE;
+
+	rc = crt_proc_batch_encode(rpc_priv, false /* reply */, &iov);
+	if (rc != 0)
+		return rc;
+
+	if (iov.iov_len > crt_gdata.cg_batch_rpc_size) {
+		D_FREE(iov.iov_buf);
+		return -DER_NOTAPPLICABLE;
+	}
+
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_for_each_entry(tmp, &ctx->cc_batch_list, cb_link) {
+		if (!crt_batch_ep_match(&tmp->cb_ep, &rpc_priv->crp_pub.cr_ep))
+			continue;
+		if (tmp->cb_sent)
+			busy = true;
+		else
+			batch = tmp;
+	}
+
+	if (batch == NULL) {
+		batch = crt_batch_alloc(&rpc_priv->crp_pub.cr_ep);
+		if (batch == NULL) {
+			D_MUTEX_UNLOCK(&ctx->cc_mutex);
+			D_FREE(iov.iov_buf);
+			return -DER_NOMEM;
+		}
+		d_list_add_tail(&batch->cb_link, &ctx->cc_batch_list);
+	}
+
+	/* released on completion, see crt_batch_complete() */
+	RPC_ADDREF(rpc_priv);
+	rpc_priv->crp_state = RPC_STATE_QUEUED;
+	rpc_priv->crp_batched = 1;
+	rpc_priv->crp_batch = batch;
+	rpc_priv->crp_batch_idx = batch->cb_nr;
+	/* released on RPC destroy, see crt_batch_req_destroy() */
+	atomic_fetch_add(&batch->cb_ref, 1);
+	d_list_add_tail(&rpc_priv->crp_parent_link, &batch->cb_rpcs);
+
+	batch->cb_iovs[batch->cb_nr++] = iov;
+	if (batch->cb_timeout == 0 || rpc_priv->crp_timeout_sec < batch->cb_timeout)
+		batch->cb_timeout = rpc_priv->crp_timeout_sec;
+
+	/*
+	 * Nothing in flight to the endpoint, do not wait for other RPCs. Otherwise the batch
+	 * is sent on completion of the one in flight, see crt_batch_done().
+	 */
+	if (!busy || batch->cb_nr == batch->cb_cap) {
+		batch->cb_sent = true;
+		send = true;
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	if (send)
+		crt_batch_send(batch);
+
+	return 0;
+}
+
+/*
+ * Send the expired batches, and return the progress timeout shortened to the
+ * time that the next pending batch expires.
+ */
+int64_t
+crt_batch_progress(struct crt_context *ctx, int64_t timeout)
+{
+	struct crt_batch	*batch;
+	d_list_t		 expired;
+	uint64_t		 now;
+	int64_t			 wait = -1;
+
+	if (!crt_batch_enabled() || d_list_empty(&ctx->cc_batch_list))
+		return timeout;
+
+	D_INIT_LIST_HEAD(&expired);
+	now = d_timeus_secdiff(0);
+
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_for_each_entry(batch, &ctx->cc_batch_list, cb_link) {
+		if (batch->cb_sent)
+			continue;
+
+		if (batch->cb_deadline <= now) {
+			batch->cb_sent = true;
+			d_list_add_tail(&batch->cb_tmp_link, &expired);
+		} else if (wait < 0 || batch->cb_deadline - now < wait) {
+			wait = batch->cb_deadline - now;
+		}
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	while ((batch = d_list_pop_entry(&expired, struct crt_batch, cb_tmp_link)))
+		crt_batch_send(batch);
+
+	if (wait >= 0 && (timeout < 0 || wait < timeout))
+		timeout = wait;
+
+	return timeout;
+}
+
+/* Send all the pending batches of the context regardless of their expiration */
+void
+crt_batch_flush(struct crt_context *ctx)
+{
+	struct crt_batch	*batch;
+	d_list_t		 pending;
+
+	if (d_list_empty(&ctx->cc_batch_list))
+		return;
+
+	D_INIT_LIST_HEAD(&pending);
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_for_each_entry(batch, &ctx->cc_batch_list, cb_link) {
+		if (!batch->cb_sent) {
+			batch->cb_sent = true;
+			d_list_add_tail(&batch->cb_tmp_link, &pending);
+		}
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	while ((batch = d_list_pop_entry(&pending, struct crt_batch, cb_tmp_link)))
+		crt_batch_send(batch);
+}
+
+/* Send the reply of the batch RPC after all the batched RPCs are replied */
+static void
+crt_batch_reply_all(struct crt_batch *batch)
+{
+	struct crt_batch_out	*out;
+	int			 rc;
+	int			 i;
+
+	out = crt_reply_get(&batch->cb_rpc->crp_pub);
+	out->bo_replies.ca_count = batch->cb_nr;
+	out->bo_replies.ca_arrays = batch->cb_iovs;
+	out->bo_rc = 0;
+
+	rc = crt_reply_send(&batch->cb_rpc->crp_pub);
+	if (rc != 0)
+		RPC_ERROR(batch->cb_rpc, "failed to reply batch of %u RPCs: " DF_RC "\n",
+			  batch->cb_nr, DP_RC(rc));
+
+	/* The replies have been packed into the reply buffer */
+	out->bo_replies.ca_count = 0;
+	out->bo_replies.ca_arrays = NULL;
+	for (i = 0; i < batch->cb_nr; i++)
+		D_FREE(batch->cb_iovs[i].iov_buf);
+	D_FREE(batch->cb_iovs);
+}
+
+static void
+crt_batch_reply_pack(struct crt_batch *batch, uint32_t idx, struct crt_rpc_priv *rpc_priv)
+{
+	int	rc;
+
+	rpc_priv->crp_batch_replied = 1;
+	/* The origin fails to unpack the empty reply if packing failed */
+	rc = crt_proc_batch_encode(rpc_priv, true /* reply */, &batch->cb_iovs[idx]);
+	if (rc != 0)
+		RPC_ERROR(rpc_priv, "failed to pack reply: " DF_RC "\n", DP_RC(rc));
+
+	if (atomic_fetch_sub(&batch->cb_pending, 1) == 1)
+		crt_batch_reply_all(batch);
+}
+
+/* Reply a batched RPC that failed before the RPC handler could be invoked */
+static void
+crt_batch_reply_error(struct crt_batch *batch, uint32_t idx, int error_code)
+{
+	struct crt_rpc_priv	rpc_tmp = {0};
+
+	rpc_tmp.crp_pub.cr_ctx = batch->cb_rpc->crp_pub.cr_ctx;
+	rpc_tmp.crp_reply_hdr.cch_rc = error_code;
+	crt_batch_reply_pack(batch, idx, &rpc_tmp);
+}
+
+int
+crt_batch_reply_send(struct crt_rpc_priv *rpc_priv)
+{
+	D_ASSERT(rpc_priv->crp_batched && rpc_priv->crp_srv);
+
+	if (rpc_priv->crp_batch_replied) {
+		RPC_ERROR(rpc_priv, "already replied.\n");
+		return -DER_ALREADY;
+	}
+
+	crt_batch_reply_pack(rpc_priv->crp_batch, rpc_priv->crp_batch_idx, rpc_priv);
+	return 0;
+}
+
+/* Unpack the batched RPC and invoke its handler, error is packed as the reply */
+static void
+crt_batch_req_dispatch(struct crt_batch *batch, uint32_t idx, d_iov_t *iov)
+{
+	struct crt_rpc_priv	*parent = batch->cb_rpc;
+	struct crt_context	*ctx = parent->crp_pub.cr_ctx;
+	struct crt_rpc_priv	*rpc_priv;
+	struct crt_common_hdr	 hdr;
+	int			 rc;
+
+	rc = crt_proc_batch_header(ctx, iov, &hdr);
+	if (rc != 0) {
+		RPC_ERROR(parent, "failed to unpack header of RPC %u: " DF_RC "\n", idx,
+			  DP_RC(rc));
+		D_GOTO(out, rc = -DER_MISC);
+	}
+
+	if (hdr.cch_flags & CRT_RPC_FLAG_COLL) {
+		RPC_ERROR(parent, "collective RPC %#x can not be batched\n", hdr.cch_opc);
+		D_GOTO(out, rc = -DER_PROTO);
+	}
+
+	rc = crt_rpc_priv_alloc(hdr.cch_opc, &rpc_priv, false /* forward */);
+	if (rc != 0)
+		D_GOTO(out, rc = (rc == -DER_NOMEM ? -DER_DOS : rc));
+
+	crt_hg_header_copy(parent, rpc_priv);
+	rpc_priv->crp_req_hdr = hdr;
+	rpc_priv->crp_flags = hdr.cch_flags;
+	rpc_priv->crp_fail_hlc = parent->crp_fail_hlc;
+	rpc_priv->crp_pub.cr_ep.ep_rank = hdr.cch_dst_rank;
+	rpc_priv->crp_pub.cr_ep.ep_tag = hdr.cch_dst_tag;
+	rpc_priv->crp_batched = 1;
+	rpc_priv->crp_batch = batch;
+	rpc_priv->crp_batch_idx = idx;
+	/* released on RPC destroy, see crt_batch_req_destroy() */
+	atomic_fetch_add(&batch->cb_ref, 1);
+
+	crt_rpc_priv_init(rpc_priv, ctx, true /* srv_flag */);
+
+	if (rpc_priv->crp_pub.cr_input_size > 0) {
+		/* The input refers to the request buffer of the batch RPC */
+		rc = crt_proc_batch_decode(rpc_priv, false /* reply */, iov);
+		if (rc != 0)
+			D_GOTO(decref, rc = -DER_MISC);
+		rpc_priv->crp_input_got = 1;
+	}
+
+	if (unlikely(rpc_priv->crp_opc_info->coi_rpc_cb == NULL)) {
+		RPC_ERROR(rpc_priv, "NULL RPC handler.\n");
+		D_GOTO(decref, rc = -DER_UNREG);
+	}
+
+	rc = crt_rpc_common_hdlr(rpc_priv);
+	if (rc != 0)
+		RPC_ERROR(rpc_priv, "failed to invoke RPC handler, rc: " DF_RC "\n", DP_RC(rc));
+
+decref:
+	if (rc != 0) {
+		rpc_priv->crp_reply_hdr.cch_rc = rc;
+		crt_batch_reply_pack(batch, idx, rpc_priv);
+		RPC_DECREF(rpc_priv);
+	}
+	return;
+out:
+	crt_batch_reply_error(batch, idx, rc);
+}
+
+void
+crt_hdlr_batch(crt_rpc_t *rpc_req)
+{
+	struct crt_rpc_priv	*rpc_priv;
+	struct crt_batch_in	*in = crt_req_get(rpc_req);
+	struct crt_batch_out	*out = crt_reply_get(rpc_req);
+	struct crt_batch	*batch;
+	uint32_t		 nr = in->bi_reqs.ca_count;
+	uint32_t		 i;
+	int			 rc;
+
+	rpc_priv = container_of(rpc_req, struct crt_rpc_priv, crp_pub);
+	if (nr == 0 || nr > CRT_BATCH_RPCS_MAX) {
+		RPC_ERROR(rpc_priv, "invalid batch size %u\n", nr);
+		D_GOTO(out, rc = -DER_PROTO);
+	}
+
+	D_ALLOC_PTR(batch);
+	if (batch == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	D_ALLOC_ARRAY(batch->cb_iovs, nr);
+	if (batch->cb_iovs == NULL) {
+		D_FREE(batch);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	/* released after all the batched RPCs are destroyed */
+	RPC_ADDREF(rpc_priv);
+	batch->cb_rpc = rpc_priv;
+	batch->cb_nr = nr;
+	batch->cb_cap = nr;
+	atomic_init(&batch->cb_pending, nr);
+	/* released below, after all the batched RPCs are dispatched */
+	atomic_init(&batch->cb_ref, 1);
+
+	for (i = 0; i < nr; i++)
+		crt_batch_req_dispatch(batch, i, &in->bi_reqs.ca_arrays[i]);
+
+	crt_batch_put(batch);
+	return;
+out:
+	out->bo_rc = rc;
+	rc = crt_reply_send(rpc_req);
+	if (rc != 0)
+		RPC_ERROR(rpc_priv, "crt_reply_send failed, rc: " DF_RC "\n", DP_RC(rc));
+}
+
+/* Called from crt_req_destroy() for the batched RPC */
+void
+crt_batch_req_destroy(struct crt_rpc_priv *rpc_priv)
+{
+	struct crt_batch	*batch = rpc_priv->crp_batch;
+
+	D_ASSERT(rpc_priv->crp_batched);
+	if (rpc_priv->crp_srv) {
+		if (!rpc_priv->crp_batch_replied) {
+			D_WARN("no reply sent for rpc_priv %p (opc: %#x).\n",
+			       rpc_priv, rpc_priv->crp_pub.cr_opc);
+			rpc_priv->crp_reply_hdr.cch_rc = -DER_NOREPLY;
+			crt_batch_reply_pack(batch, rpc_priv->crp_batch_idx, rpc_priv);
+		}
+		if (rpc_priv->crp_input_got)
+			crt_proc_batch_free(rpc_priv, false /* reply */);
+	} else if (rpc_priv->crp_output_got) {
+		crt_proc_batch_free(rpc_priv, true /* reply */);
+	}
+
+	crt_rpc_priv_fini(rpc_priv);
+	crt_rpc_priv_free(rpc_priv);
+	crt_batch_put(batch);
+}
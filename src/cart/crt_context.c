@@ -154,6 +154,8 @@ crt_context_init(crt_context_t crt_ctx)
 
 	D_INIT_LIST_HEAD(&ctx->cc_quotas.rpc_waitq);
 	D_INIT_LIST_HEAD(&ctx->cc_link);
+	D_INIT_LIST_HEAD(&ctx->cc_batch_list);
+	D_INIT_LIST_HEAD(&ctx->cc_pipe_list);
 
 	/* create timeout binheap */
 	bh_node_cnt = CRT_DEFAULT_CREDITS_PER_EP_CTX * 64;
@@ -334,6 +336,38 @@ crt_context_provider_create(crt_context_t *crt_ctx, crt_provider_t provider, boo
 				      "net/%s/swim_delay/ctx_%u", prov, ctx->cc_idx);
 		if (ret)
 			DL_WARN(rc, "Failed to create SWIM delay gauge");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_hg_pool.chp_hit_cnt, D_TM_COUNTER,
+				      "Total number of RPC handles taken from the handle pool",
+				      "hdls", "net/%s/hdl_pool/hits/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create handle pool hit counter");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_hg_pool.chp_miss_cnt, D_TM_COUNTER,
+				      "Total number of RPC handles created as the handle pool "
+				      "was empty", "hdls", "net/%s/hdl_pool/misses/ctx_%u",
+				      prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create handle pool miss counter");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_hg_pool.chp_size, D_TM_GAUGE,
+				      "Number of RPC handles in the handle pool", "hdls",
+				      "net/%s/hdl_pool/size/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create handle pool size gauge");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_in_peak_tm, D_TM_GAUGE,
+				      "Peak number of incoming RPCs holding a preposted handle",
+				      "hdls", "net/%s/hdl_pool/in_peak/ctx_%u", prov, ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create incoming RPC peak gauge");
+
+		ret = d_tm_add_metric(&ctx->cc_hg_ctx.chc_in_posted_est_tm, D_TM_GAUGE,
+				      "Estimated number of handles preposted for incoming RPCs",
+				      "hdls", "net/%s/hdl_pool/in_posted_est/ctx_%u", prov,
+				      ctx->cc_idx);
+		if (ret)
+			DL_WARN(ret, "Failed to create preposted handle estimate gauge");
 	}
 
 	if (crt_is_service() &&
@@ -725,6 +759,10 @@ crt_context_destroy(crt_context_t crt_ctx, int force)
 			D_GOTO(out, rc);
 	}
 
+	/* pending batches are sent so that they can be aborted like other RPCs */
+	crt_batch_flush(ctx);
+	crt_corpc_pipe_flush(ctx);
+
 	timeout_sec = crt_swim_rpc_timeout();
 	for (i = 0; i < CRT_SWIM_FLUSH_ATTEMPTS; i++) {
 		rc = crt_context_abort(ctx, force);
@@ -802,6 +840,8 @@ crt_context_flush(crt_context_t crt_ctx, uint64_t timeout)
 	if (timeout > 0)
 		ts_deadline = d_timeus_secdiff(timeout);
 
+	crt_batch_flush(crt_ctx);
+	crt_corpc_pipe_flush(crt_ctx);
 	do {
 		rc = crt_progress(crt_ctx, 1);
 		if (rc != DER_SUCCESS && rc != -DER_TIMEDOUT) {
@@ -1734,6 +1774,7 @@ crt_progress_cond(crt_context_t crt_ctx, int64_t timeout,
 	/** loop until callback returns non-null value */
 	while ((rc = cond_cb(arg)) == 0) {
 		crt_context_timeout_check(ctx);
+		crt_hg_pool_adapt(&ctx->cc_hg_ctx);
 		timeout = crt_exec_progress_cb(ctx, timeout);
 
 		if (timeout < 0) {
@@ -1752,6 +1793,9 @@ crt_progress_cond(crt_context_t crt_ctx, int64_t timeout,
 			else
 				hg_timeout = timeout;
 		}
+		/** wake up in time to send the pending batches and poll the corpc parents */
+		hg_timeout = crt_batch_progress(ctx, hg_timeout);
+		hg_timeout = crt_corpc_pipe_progress(ctx, hg_timeout);
 
 		rc = crt_hg_progress(&ctx->cc_hg_ctx, hg_timeout);
 		if (unlikely(rc && rc != -DER_TIMEDOUT)) {
@@ -1806,7 +1850,10 @@ crt_progress(crt_context_t crt_ctx, int64_t timeout)
 	 * progress
 	 */
 	crt_context_timeout_check(ctx);
+	crt_hg_pool_adapt(&ctx->cc_hg_ctx);
 	timeout = crt_exec_progress_cb(ctx, timeout);
+	timeout = crt_batch_progress(ctx, timeout);
+	timeout = crt_corpc_pipe_progress(ctx, timeout);
 
 	if (timeout != 0 && (rc == 0 || rc == -DER_TIMEDOUT)) {
 		/** call progress once again with the real timeout */
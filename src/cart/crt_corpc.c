@@ -10,6 +10,9 @@
 
 #include "crt_internal.h"
 
+static void
+crt_corpc_local_hdlr(struct crt_rpc_priv *rpc_priv, int rc);
+
 static inline int
 crt_corpc_info_init(struct crt_rpc_priv *rpc_priv,
 		    struct crt_grp_priv *grp_priv, bool grp_ref_taken,
@@ -78,10 +81,26 @@ out:
 	return rc;
 }
 
+static void
+crt_corpc_pipe_fini(struct crt_corpc_pipe *pipe)
+{
+	/* the pipe holds a reference of the RPC while waiting to poll */
+	D_ASSERT(d_list_empty(&pipe->cpp_link));
+	if (pipe->cpp_remote_hdl != CRT_BULK_NULL)
+		crt_bulk_free(pipe->cpp_remote_hdl);
+	if (pipe->cpp_expose_hdl != CRT_BULK_NULL)
+		crt_bulk_free(pipe->cpp_expose_hdl);
+	if (pipe->cpp_poll_hdl != CRT_BULK_NULL)
+		crt_bulk_free(pipe->cpp_poll_hdl);
+	D_FREE(pipe);
+}
+
 void
 crt_corpc_info_fini(struct crt_rpc_priv *rpc_priv)
 {
 	D_ASSERT(rpc_priv->crp_coll && rpc_priv->crp_corpc_info);
+	if (rpc_priv->crp_corpc_info->co_pipe != NULL)
+		crt_corpc_pipe_fini(rpc_priv->crp_corpc_info->co_pipe);
 	d_rank_list_free(rpc_priv->crp_corpc_info->co_filter_ranks);
 	if (rpc_priv->crp_corpc_info->co_grp_ref_taken)
 		crt_grp_priv_decref(rpc_priv->crp_corpc_info->co_grp_priv);
@@ -89,7 +108,7 @@ crt_corpc_info_fini(struct crt_rpc_priv *rpc_priv)
 }
 
 static int
-crt_corpc_initiate(struct crt_rpc_priv *rpc_priv)
+crt_corpc_initiate(struct crt_rpc_priv *rpc_priv, struct crt_corpc_pipe *pipe)
 {
 	struct crt_grp_gdata	*grp_gdata;
 	struct crt_grp_priv	*grp_priv;
@@ -144,6 +163,7 @@ crt_corpc_initiate(struct crt_rpc_priv *rpc_priv)
 			  DP_RC(rc));
 		D_GOTO(out, rc);
 	}
+	rpc_priv->crp_corpc_info->co_pipe = pipe;
 
 	rc = crt_corpc_req_hdlr(rpc_priv);
 	if (rc != 0)
@@ -194,7 +214,7 @@ crt_corpc_chained_bulk_cb(const struct crt_bulk_cb_info *cb_info)
 	}
 
 	rpc_priv->crp_pub.cr_co_bulk_hdl = local_bulk_hdl;
-	rc = crt_corpc_initiate(rpc_priv);
+	rc = crt_corpc_initiate(rpc_priv, NULL);
 	if (rc != 0) {
 		RPC_ERROR(rpc_priv, "crt_corpc_initiate failed: "DF_RC"\n",
 			  DP_RC(rc));
@@ -255,6 +275,306 @@ out:
 	return rc;
 }
 
+static void
+crt_corpc_pipe_pull(struct crt_rpc_priv *rpc_priv);
+static void
+crt_corpc_pipe_poll(struct crt_rpc_priv *rpc_priv);
+
+/* all the data pulled or failed, the local RPC handler can be invoked */
+static void
+crt_corpc_pipe_done(struct crt_rpc_priv *rpc_priv, int rc)
+{
+	struct crt_corpc_pipe	*pipe = rpc_priv->crp_corpc_info->co_pipe;
+	bool			 local_pending;
+
+	crt_bulk_free(pipe->cpp_remote_hdl);
+	pipe->cpp_remote_hdl = CRT_BULK_NULL;
+	/* let children polling the progress word know the failure */
+	if (rc != 0)
+		pipe->cpp_progress = CRT_CORPC_PIPE_ABORT;
+
+	D_SPIN_LOCK(&rpc_priv->crp_lock);
+	pipe->cpp_done = 1;
+	pipe->cpp_rc = rc;
+	local_pending = pipe->cpp_local_pending;
+	D_SPIN_UNLOCK(&rpc_priv->crp_lock);
+
+	if (local_pending)
+		crt_corpc_local_hdlr(rpc_priv, rc);
+
+	/* correspond to addref in crt_corpc_pipe_start */
+	RPC_DECREF(rpc_priv);
+}
+
+static int
+crt_corpc_pipe_data_cb(const struct crt_bulk_cb_info *cb_info)
+{
+	struct crt_rpc_priv	*rpc_priv = cb_info->bci_arg;
+	struct crt_corpc_pipe	*pipe = rpc_priv->crp_corpc_info->co_pipe;
+
+	if (cb_info->bci_rc != 0) {
+		RPC_ERROR(rpc_priv, "pipelined bulk failed: "DF_RC"\n",
+			  DP_RC(cb_info->bci_rc));
+		crt_corpc_pipe_done(rpc_priv, cb_info->bci_rc);
+		return 0;
+	}
+
+	/* publish the data to children */
+	pipe->cpp_progress += cb_info->bci_bulk_desc->bd_len;
+	crt_corpc_pipe_pull(rpc_priv);
+	return 0;
+}
+
+static int
+crt_corpc_pipe_poll_cb(const struct crt_bulk_cb_info *cb_info)
+{
+	struct crt_rpc_priv	*rpc_priv = cb_info->bci_arg;
+	struct crt_corpc_pipe	*pipe = rpc_priv->crp_corpc_info->co_pipe;
+	int			 rc = cb_info->bci_rc;
+
+	if (rc == 0 && pipe->cpp_poll == CRT_CORPC_PIPE_ABORT)
+		rc = -DER_CANCELED;
+	else if (rc == 0 && (pipe->cpp_poll > pipe->cpp_len ||
+			     pipe->cpp_poll < pipe->cpp_avail))
+		rc = -DER_PROTO;
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "polling pipelined bulk failed: "DF_RC"\n",
+			  DP_RC(rc));
+		crt_corpc_pipe_done(rpc_priv, rc);
+		return 0;
+	}
+
+	/* back off while parent has no new data */
+	if (pipe->cpp_poll == pipe->cpp_avail)
+		pipe->cpp_poll_delay = pipe->cpp_poll_delay == 0 ? CRT_CORPC_PIPE_POLL_MIN :
+				       min(pipe->cpp_poll_delay * 2, CRT_CORPC_PIPE_POLL_MAX);
+	else
+		pipe->cpp_poll_delay = 0;
+
+	pipe->cpp_avail = pipe->cpp_poll;
+	crt_corpc_pipe_pull(rpc_priv);
+	return 0;
+}
+
+/* Read the progress word of parent */
+static void
+crt_corpc_pipe_poll(struct crt_rpc_priv *rpc_priv)
+{
+	struct crt_corpc_pipe	*pipe = rpc_priv->crp_corpc_info->co_pipe;
+	struct crt_bulk_desc	 bulk_desc;
+	int			 rc;
+
+	bulk_desc.bd_rpc = &rpc_priv->crp_pub;
+	bulk_desc.bd_bulk_op = CRT_BULK_GET;
+	bulk_desc.bd_remote_hdl = pipe->cpp_remote_hdl;
+	bulk_desc.bd_remote_off = 0;
+	bulk_desc.bd_local_hdl = pipe->cpp_poll_hdl;
+	bulk_desc.bd_local_off = 0;
+	bulk_desc.bd_len = sizeof(pipe->cpp_poll);
+
+	rc = crt_bulk_transfer(&bulk_desc, crt_corpc_pipe_poll_cb, rpc_priv, NULL);
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "crt_bulk_transfer failed: "DF_RC"\n",
+			  DP_RC(rc));
+		crt_corpc_pipe_done(rpc_priv, rc);
+	}
+}
+
+/*
+ * Poll the parents that are due, and return the progress timeout shortened to
+ * the time of the next poll.
+ */
+int64_t
+crt_corpc_pipe_progress(struct crt_context *ctx, int64_t timeout)
+{
+	struct crt_corpc_pipe	*pipe;
+	struct crt_corpc_pipe	*tmp;
+	d_list_t		 expired;
+	uint64_t		 now;
+	int64_t			 wait = -1;
+
+	if (d_list_empty(&ctx->cc_pipe_list))
+		return timeout;
+
+	D_INIT_LIST_HEAD(&expired);
+	now = d_timeus_secdiff(0);
+
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_for_each_entry_safe(pipe, tmp, &ctx->cc_pipe_list, cpp_link) {
+		if (pipe->cpp_poll_ts <= now)
+			d_list_move_tail(&pipe->cpp_link, &expired);
+		else if (wait < 0 || pipe->cpp_poll_ts - now < wait)
+			wait = pipe->cpp_poll_ts - now;
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	while ((pipe = d_list_pop_entry(&expired, struct crt_corpc_pipe, cpp_link)))
+		crt_corpc_pipe_poll(pipe->cpp_rpc);
+
+	if (wait >= 0 && (timeout < 0 || wait < timeout))
+		timeout = wait;
+
+	return timeout;
+}
+
+/* Poll the parents of all the waiting pipes of the context now */
+void
+crt_corpc_pipe_flush(struct crt_context *ctx)
+{
+	struct crt_corpc_pipe	*pipe;
+	d_list_t		 pending;
+
+	D_INIT_LIST_HEAD(&pending);
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_splice_init(&ctx->cc_pipe_list, &pending);
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	while ((pipe = d_list_pop_entry(&pending, struct crt_corpc_pipe, cpp_link)))
+		crt_corpc_pipe_poll(pipe->cpp_rpc);
+}
+
+/*
+ * Pull the next chunk of data that is available on parent, or poll the
+ * progress word of parent if all the available data has been pulled. The
+ * poll is delayed by cpp_poll_delay, see crt_corpc_pipe_progress().
+ */
+static void
+crt_corpc_pipe_pull(struct crt_rpc_priv *rpc_priv)
+{
+	struct crt_corpc_pipe	*pipe = rpc_priv->crp_corpc_info->co_pipe;
+	struct crt_context	*ctx = rpc_priv->crp_pub.cr_ctx;
+	struct crt_bulk_desc	 bulk_desc;
+	int			 rc;
+
+	if (pipe->cpp_progress == pipe->cpp_len) {
+		crt_corpc_pipe_done(rpc_priv, 0);
+		return;
+	}
+
+	if (pipe->cpp_avail == pipe->cpp_progress) {
+		if (pipe->cpp_poll_delay == 0) {
+			crt_corpc_pipe_poll(rpc_priv);
+			return;
+		}
+
+		D_MUTEX_LOCK(&ctx->cc_mutex);
+		pipe->cpp_poll_ts = d_timeus_secdiff(0) + pipe->cpp_poll_delay;
+		d_list_add_tail(&pipe->cpp_link, &ctx->cc_pipe_list);
+		D_MUTEX_UNLOCK(&ctx->cc_mutex);
+		return;
+	}
+
+	bulk_desc.bd_rpc = &rpc_priv->crp_pub;
+	bulk_desc.bd_bulk_op = CRT_BULK_GET;
+	bulk_desc.bd_remote_hdl = pipe->cpp_remote_hdl;
+	bulk_desc.bd_remote_off = pipe->cpp_remote_off + pipe->cpp_progress;
+	bulk_desc.bd_local_hdl = rpc_priv->crp_pub.cr_co_bulk_hdl;
+	bulk_desc.bd_local_off = pipe->cpp_progress;
+	bulk_desc.bd_len = min(pipe->cpp_avail - pipe->cpp_progress, pipe->cpp_chunk);
+
+	rc = crt_bulk_transfer(&bulk_desc, crt_corpc_pipe_data_cb, rpc_priv, NULL);
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "crt_bulk_transfer failed: "DF_RC"\n",
+			  DP_RC(rc));
+		crt_corpc_pipe_done(rpc_priv, rc);
+	}
+}
+
+/*
+ * Pipeline the chained bulk, i.e. forward the RPC to children firstly and then
+ * pull the data from parent, the local RPC handler is invoked after all the
+ * data arrived.
+ */
+static int
+crt_corpc_pipe_start(struct crt_rpc_priv *rpc_priv, size_t bulk_len,
+		     bool parent_pipe)
+{
+	struct crt_corpc_hdr	*co_hdr = &rpc_priv->crp_coreq_hdr;
+	struct crt_corpc_pipe	*pipe;
+	crt_context_t		 crt_ctx = rpc_priv->crp_pub.cr_ctx;
+	crt_bulk_t		 local_bulk_hdl = CRT_BULK_NULL;
+	d_sg_list_t		 bulk_sgl;
+	d_iov_t			 bulk_iovs[2];
+	void			*bulk_buf;
+	int			 rc;
+
+	D_ALLOC_PTR(pipe);
+	if (pipe == NULL)
+		return -DER_NOMEM;
+
+	D_INIT_LIST_HEAD(&pipe->cpp_link);
+	pipe->cpp_rpc = rpc_priv;
+	pipe->cpp_remote_off = parent_pipe ? sizeof(pipe->cpp_progress) : 0;
+	pipe->cpp_len = bulk_len - pipe->cpp_remote_off;
+	pipe->cpp_avail = parent_pipe ? 0 : pipe->cpp_len;
+	pipe->cpp_chunk = crt_gdata.cg_corpc_pipe_chunk;
+	if (pipe->cpp_chunk == 0)
+		pipe->cpp_chunk = CRT_CORPC_PIPE_CHUNK_DEFAULT;
+
+	D_ALLOC(bulk_buf, pipe->cpp_len);
+	if (bulk_buf == NULL)
+		D_GOTO(err_pipe, rc = -DER_NOMEM);
+
+	/* the local handle of data only, for the local RPC handler */
+	d_iov_set(&bulk_iovs[0], bulk_buf, pipe->cpp_len);
+	bulk_sgl.sg_nr = 1;
+	bulk_sgl.sg_iovs = bulk_iovs;
+	rc = crt_bulk_create(crt_ctx, &bulk_sgl, CRT_BULK_RW, &local_bulk_hdl);
+	if (rc != 0)
+		D_GOTO(err_buf, rc);
+
+	d_iov_set(&bulk_iovs[0], &pipe->cpp_progress, sizeof(pipe->cpp_progress));
+	d_iov_set(&bulk_iovs[1], bulk_buf, pipe->cpp_len);
+	bulk_sgl.sg_nr = 2;
+	rc = crt_bulk_create(crt_ctx, &bulk_sgl, CRT_BULK_RO, &pipe->cpp_expose_hdl);
+	if (rc != 0)
+		D_GOTO(err_buf, rc);
+
+	d_iov_set(&bulk_iovs[0], &pipe->cpp_poll, sizeof(pipe->cpp_poll));
+	bulk_sgl.sg_nr = 1;
+	rc = crt_bulk_create(crt_ctx, &bulk_sgl, CRT_BULK_RW, &pipe->cpp_poll_hdl);
+	if (rc != 0)
+		D_GOTO(err_buf, rc);
+
+	/*
+	 * The parent handle is kept by the pipe until all the data pulled,
+	 * crt_corpc_initiate() will reuse coh_bulk_hdl as the local handle.
+	 */
+	pipe->cpp_remote_hdl = co_hdr->coh_bulk_hdl;
+	co_hdr->coh_bulk_hdl = CRT_BULK_NULL;
+
+	rpc_priv->crp_pub.cr_co_bulk_hdl = local_bulk_hdl;
+	rc = crt_corpc_initiate(rpc_priv, pipe);
+	if (rc != 0) {
+		RPC_ERROR(rpc_priv, "crt_corpc_initiate failed: "DF_RC"\n",
+			  DP_RC(rc));
+		/* otherwise the pipe is freed along with the corpc info */
+		if (rpc_priv->crp_corpc_info == NULL) {
+			co_hdr->coh_bulk_hdl = pipe->cpp_remote_hdl;
+			pipe->cpp_remote_hdl = CRT_BULK_NULL;
+			D_GOTO(err_buf, rc);
+		}
+		return rc;
+	}
+
+	D_DEBUG(DB_NET, "pipelined chained bulk of "DF_U64" bytes, parent %s.\n",
+		pipe->cpp_len, parent_pipe ? "pipelined" : "not pipelined");
+
+	/* corresponds to decref in crt_corpc_pipe_done */
+	RPC_ADDREF(rpc_priv);
+	crt_corpc_pipe_pull(rpc_priv);
+	return 0;
+
+err_buf:
+	if (local_bulk_hdl != CRT_BULK_NULL)
+		crt_bulk_free(local_bulk_hdl);
+	rpc_priv->crp_pub.cr_co_bulk_hdl = CRT_BULK_NULL;
+	D_FREE(bulk_buf);
+err_pipe:
+	crt_corpc_pipe_fini(pipe);
+	return rc;
+}
+
 /* only be called in crt_rpc_handler_common after RPC header unpacked */
 int
 crt_corpc_common_hdlr(struct crt_rpc_priv *rpc_priv)
@@ -282,6 +602,8 @@ crt_corpc_common_hdlr(struct crt_rpc_priv *rpc_priv)
 	co_hdr = &rpc_priv->crp_coreq_hdr;
 	parent_bulk_hdl = co_hdr->coh_bulk_hdl;
 	if (parent_bulk_hdl != CRT_BULK_NULL) {
+		bool parent_pipe = co_hdr->coh_flags & CRT_COH_FLAG_BULK_PIPE;
+
 		rc = crt_bulk_get_len(parent_bulk_hdl, &bulk_len);
 		if (rc != 0 || bulk_len == 0) {
 			RPC_ERROR(rpc_priv, "crt_bulk_get_len failed: "
@@ -289,6 +611,22 @@ crt_corpc_common_hdlr(struct crt_rpc_priv *rpc_priv)
 			D_GOTO(out, rc);
 		}
 
+		/*
+		 * Must follow the pipeline if parent pipelined, otherwise only
+		 * pipeline the data larger than one chunk.
+		 */
+		if (parent_pipe ||
+		    (crt_gdata.cg_corpc_pipe_chunk != 0 &&
+		     bulk_len > crt_gdata.cg_corpc_pipe_chunk)) {
+			if (parent_pipe && bulk_len <= sizeof(uint64_t)) {
+				RPC_ERROR(rpc_priv, "bad pipelined bulk len %zu.\n",
+					  bulk_len);
+				D_GOTO(out, rc = -DER_PROTO);
+			}
+			rc = crt_corpc_pipe_start(rpc_priv, bulk_len, parent_pipe);
+			D_GOTO(out, rc);
+		}
+
 		D_ALLOC(bulk_iov.iov_buf, bulk_len);
 		if (bulk_iov.iov_buf == NULL)
 			D_GOTO(out, rc = -DER_NOMEM);
@@ -326,7 +664,7 @@ crt_corpc_common_hdlr(struct crt_rpc_priv *rpc_priv)
 		D_GOTO(out, rc);
 	} else {
 		rpc_priv->crp_pub.cr_co_bulk_hdl = CRT_BULK_NULL;
-		rc = crt_corpc_initiate(rpc_priv);
+		rc = crt_corpc_initiate(rpc_priv, NULL);
 		if (rc != 0)
 			RPC_ERROR(rpc_priv, "crt_corpc_initiate failed: "
 				  DF_RC"\n", DP_RC(rc));
@@ -484,17 +822,23 @@ corpc_add_child_rpc(struct crt_rpc_priv *parent_rpc_priv,
 	/* inherit crp_coreq_hdr from parent */
 	parent_co_hdr = &parent_rpc_priv->crp_coreq_hdr;
 	child_co_hdr = &child_rpc_priv->crp_coreq_hdr;
+	co_info = parent_rpc_priv->crp_corpc_info;
 	child_co_hdr->coh_grpid = parent_co_hdr->coh_grpid;
 	/* child's coh_bulk_hdl is different with parent_co_hdr */
-	child_co_hdr->coh_bulk_hdl = parent_rpc_priv->crp_pub.cr_co_bulk_hdl;
+	if (co_info->co_pipe != NULL) {
+		child_co_hdr->coh_bulk_hdl = co_info->co_pipe->cpp_expose_hdl;
+		child_co_hdr->coh_flags = parent_co_hdr->coh_flags |
+					  CRT_COH_FLAG_BULK_PIPE;
+	} else {
+		child_co_hdr->coh_bulk_hdl = parent_rpc_priv->crp_pub.cr_co_bulk_hdl;
+		child_co_hdr->coh_flags = parent_co_hdr->coh_flags &
+					  ~CRT_COH_FLAG_BULK_PIPE;
+	}
 	child_co_hdr->coh_filter_ranks = parent_co_hdr->coh_filter_ranks;
 	child_co_hdr->coh_inline_ranks = parent_co_hdr->coh_inline_ranks;
 	child_co_hdr->coh_grp_ver = parent_co_hdr->coh_grp_ver;
 	child_co_hdr->coh_tree_topo = parent_co_hdr->coh_tree_topo;
 	child_co_hdr->coh_root = parent_co_hdr->coh_root;
-	child_co_hdr->coh_padding = parent_co_hdr->coh_padding;
-
-	co_info = parent_rpc_priv->crp_corpc_info;
 
 	RPC_ADDREF(child_rpc_priv);
 
@@ -558,6 +902,10 @@ crt_corpc_complete(struct crt_rpc_priv *rpc_priv)
 		 * on root node, don't need to free chained bulk handle as it is
 		 * created and passed in by user.
 		 */
+		if (co_info->co_pipe != NULL) {
+			crt_corpc_pipe_fini(co_info->co_pipe);
+			co_info->co_pipe = NULL;
+		}
 		rc = crt_corpc_free_chained_bulk(
 			rpc_priv->crp_coreq_hdr.coh_bulk_hdl);
 		if (rc != 0)
@@ -918,26 +1266,25 @@ forward_done:
 		D_GOTO(out, rc);
 	}
 
-	/* invoke RPC handler on local node */
-	rc = crt_rpc_common_hdlr(rpc_priv);
-	if (rc != 0) {
-		RPC_ERROR(rpc_priv, "crt_rpc_common_hdlr failed: "DF_RC"\n",
-			  DP_RC(rc));
-		crt_corpc_fail_child_rpc(rpc_priv, 1, rc);
+	/* invoke RPC handler on local node after the pipelined bulk is done */
+	rc = 0;
+	if (co_info->co_pipe != NULL) {
+		bool	local_pending = false;
 
 		D_SPIN_LOCK(&rpc_priv->crp_lock);
-		co_info->co_local_done = 1;
-		rpc_priv->crp_reply_pending = 0;
+		if (co_info->co_pipe->cpp_done == 0) {
+			co_info->co_pipe->cpp_local_pending = 1;
+			local_pending = true;
+		} else {
+			rc = co_info->co_pipe->cpp_rc;
+		}
 		D_SPIN_UNLOCK(&rpc_priv->crp_lock);
 
-		/* Handle ref count difference between call on root vs
-		 * call on intermediate nodes
-		 */
-		if (co_info->co_root != co_info->co_grp_priv->gp_self)
-			RPC_DECREF(rpc_priv);
-
-		rc = 0;
+		if (local_pending)
+			D_GOTO(out, rc = 0);
 	}
+	crt_corpc_local_hdlr(rpc_priv, rc);
+	rc = 0;
 
 out:
 	if (children_rank_list != NULL)
@@ -945,3 +1292,31 @@ out:
 
 	return rc;
 }
+
+/* invoke RPC handler on local node, or fail it with \a rc */
+static void
+crt_corpc_local_hdlr(struct crt_rpc_priv *rpc_priv, int rc)
+{
+	struct crt_corpc_info	*co_info = rpc_priv->crp_corpc_info;
+
+	if (rc == 0) {
+		rc = crt_rpc_common_hdlr(rpc_priv);
+		if (rc == 0)
+			return;
+		RPC_ERROR(rpc_priv, "crt_rpc_common_hdlr failed: "DF_RC"\n",
+			  DP_RC(rc));
+	}
+
+	crt_corpc_fail_child_rpc(rpc_priv, 1, rc);
+
+	D_SPIN_LOCK(&rpc_priv->crp_lock);
+	co_info->co_local_done = 1;
+	rpc_priv->crp_reply_pending = 0;
+	D_SPIN_UNLOCK(&rpc_priv->crp_lock);
+
+	/* Handle ref count difference between call on root vs
+	 * call on intermediate nodes
+	 */
+	if (co_info->co_root != co_info->co_grp_priv->gp_self)
+		RPC_DECREF(rpc_priv);
+}
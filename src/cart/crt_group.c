@@ -1102,6 +1102,35 @@ out:
 }
 
 
+static void
+crt_grp_domains_free(struct crt_grp_domains *gd)
+{
+	d_rank_list_free(gd->gd_ranks);
+	gd->gd_ranks = NULL;
+	D_FREE(gd->gd_domains);
+}
+
+static int
+crt_grp_domains_rank_cmp(const void *a, const void *b)
+{
+	d_rank_t	ra = *(const d_rank_t *)a;
+	d_rank_t	rb = *(const d_rank_t *)b;
+
+	return ra < rb ? -1 : (ra > rb ? 1 : 0);
+}
+
+/* index of \a rank in the sorted \a ranks, or -1 */
+static int
+crt_grp_domains_rank_idx(d_rank_list_t *ranks, d_rank_t rank)
+{
+	d_rank_t	*found;
+
+	found = bsearch(&rank, ranks->rl_ranks, ranks->rl_nr, sizeof(rank),
+			crt_grp_domains_rank_cmp);
+
+	return found == NULL ? -1 : found - ranks->rl_ranks;
+}
+
 void
 crt_grp_priv_destroy(struct crt_grp_priv *grp_priv)
 {
@@ -1129,6 +1158,9 @@ crt_grp_priv_destroy(struct crt_grp_priv *grp_priv)
 	crt_grp_lc_destroy(grp_priv);
 	d_list_del_init(&grp_priv->gp_link);
 
+	for (i = 0; i < CRT_GRP_DOMAINS_NR; i++)
+		crt_grp_domains_free(&grp_priv->gp_domains[i]);
+
 	/* remove from group list */
 	D_RWLOCK_WRLOCK(&crt_grp_list_rwlock);
 	crt_grp_del_locked(grp_priv);
@@ -2797,6 +2829,111 @@ out:
 	return rc;
 }
 
+int
+crt_group_domains_set(crt_group_t *group, d_rank_list_t *ranks, uint32_t *domains,
+		      uint32_t version)
+{
+	struct crt_grp_priv	*grp_priv;
+	struct crt_grp_domains	*gd;
+	d_rank_list_t		*sorted = NULL;
+	uint32_t		*sorted_domains = NULL;
+	int			 i;
+	int			 j;
+	int			 rc = 0;
+
+	if (ranks == NULL || (ranks->rl_nr > 0 && domains == NULL)) {
+		D_ERROR("Invalid argument, ranks %p, domains %p\n", ranks, domains);
+		return -DER_INVAL;
+	}
+
+	grp_priv = crt_grp_pub2priv(group);
+	if (grp_priv == NULL) {
+		D_ERROR("Failed to lookup group %p\n", group);
+		return -DER_INVAL;
+	}
+
+	rc = d_rank_list_dup_sort_uniq(&sorted, ranks);
+	if (rc != 0)
+		return rc;
+
+	if (sorted->rl_nr != ranks->rl_nr) {
+		D_ERROR("Duplicate ranks in the list of %u ranks\n", ranks->rl_nr);
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	if (ranks->rl_nr > 0) {
+		D_ALLOC_ARRAY(sorted_domains, ranks->rl_nr);
+		if (sorted_domains == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	for (i = 0; i < ranks->rl_nr; i++) {
+		j = crt_grp_domains_rank_idx(sorted, ranks->rl_ranks[i]);
+		D_ASSERT(j >= 0);
+		sorted_domains[j] = domains[i];
+	}
+
+	D_RWLOCK_WRLOCK(&grp_priv->gp_rwlock);
+	if (version < grp_priv->gp_membs_ver) {
+		D_ERROR("Group %s version %u is older than current %u\n",
+			grp_priv->gp_pub.cg_grpid, version, grp_priv->gp_membs_ver);
+		D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+	/* replace the domains of the same version, or else of the oldest version */
+	gd = &grp_priv->gp_domains[0];
+	for (i = 0; i < CRT_GRP_DOMAINS_NR; i++) {
+		if (grp_priv->gp_domains[i].gd_ranks == NULL ||
+		    grp_priv->gp_domains[i].gd_ver == version) {
+			gd = &grp_priv->gp_domains[i];
+			break;
+		}
+		if (grp_priv->gp_domains[i].gd_ver < gd->gd_ver)
+			gd = &grp_priv->gp_domains[i];
+	}
+	crt_grp_domains_free(gd);
+	gd->gd_ver = version;
+	gd->gd_ranks = sorted;
+	gd->gd_domains = sorted_domains;
+	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
+
+	D_DEBUG(DB_TRACE, "Group %s, %u domains set for version %u\n",
+		grp_priv->gp_pub.cg_grpid, ranks->rl_nr, version);
+	return 0;
+
+out:
+	d_rank_list_free(sorted);
+	D_FREE(sorted_domains);
+	return rc;
+}
+
+/*
+ * Get the domain of each rank of \a ranks, as set for the group version \a grp_ver.
+ * The caller holds gp_rwlock.
+ */
+void
+crt_grp_priv_get_domains(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
+			 d_rank_list_t *ranks, uint32_t *domains)
+{
+	struct crt_grp_domains	*gd = NULL;
+	int			 idx;
+	int			 i;
+
+	for (i = 0; i < CRT_GRP_DOMAINS_NR; i++) {
+		if (grp_priv->gp_domains[i].gd_ranks != NULL &&
+		    grp_priv->gp_domains[i].gd_ver == grp_ver) {
+			gd = &grp_priv->gp_domains[i];
+			break;
+		}
+	}
+
+	for (i = 0; i < ranks->rl_nr; i++) {
+		idx = gd == NULL ? -1 : crt_grp_domains_rank_idx(gd->gd_ranks, ranks->rl_ranks[i]);
+		domains[i] = idx < 0 ? CRT_NO_DOMAIN : gd->gd_domains[idx];
+	}
+}
+
 int
 crt_group_info_get(crt_group_t *group, d_iov_t *grp_info)
 {
@@ -45,6 +45,19 @@ struct crt_grp_priv_sec {
 	d_list_t		gps_link;
 };
 
+/* number of group versions the topology domains are kept for */
+#define CRT_GRP_DOMAINS_NR	2
+
+/* Topology domains of the ranks of a group for a group version */
+struct crt_grp_domains {
+	/* group version the domains are set for */
+	uint32_t	 gd_ver;
+	/* ranks in ascending order, NULL if the domains are not set */
+	d_rank_list_t	*gd_ranks;
+	/* domain of each rank in gd_ranks */
+	uint32_t	*gd_domains;
+};
+
 struct crt_grp_priv;
 
 struct crt_grp_priv {
@@ -107,6 +120,12 @@ struct crt_grp_priv {
 	/* Secondary to primary rank mapping table */
 	struct d_hash_table	 gp_s2p_table;
 
+	/*
+	 * Topology domains of the ranks for the two latest group versions they
+	 * are set for, see crt_group_domains_set().
+	 */
+	struct crt_grp_domains	 gp_domains[CRT_GRP_DOMAINS_NR];
+
 	/* set of variables only valid in primary service groups */
 	uint32_t		 gp_primary:1, /* flag of primary group */
 				 gp_view:1, /* flag to indicate it is a view */
@@ -128,6 +147,13 @@ grp_priv_get_membs(struct crt_grp_priv *priv)
 d_rank_t
 crt_grp_priv_get_primary_rank(struct crt_grp_priv *priv, d_rank_t rank);
 
+/* domain of the ranks that crt_group_domains_set() is not called for */
+#define CRT_NO_DOMAIN	((uint32_t)-1)
+
+void
+crt_grp_priv_get_domains(struct crt_grp_priv *priv, uint32_t grp_ver,
+			 d_rank_list_t *ranks, uint32_t *domains);
+
 /*
  * This call is currently called only when group is created.
  */
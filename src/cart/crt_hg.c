@@ -263,7 +263,14 @@ crt_hg_pool_init(struct crt_hg_context *hg_ctx)
 	hg_pool->chp_num = 0;
 	hg_pool->chp_max_num = 0;
 	hg_pool->chp_enabled = false;
+	hg_pool->chp_prepost_num = CRT_HG_POOL_PREPOST_NUM;
+	hg_pool->chp_hits = 0;
+	hg_pool->chp_misses = 0;
+	hg_pool->chp_adapt_ts = d_timeus_secdiff(0);
 	D_INIT_LIST_HEAD(&hg_pool->chp_list);
+	atomic_init(&hg_ctx->chc_in_num, 0);
+	hg_ctx->chc_in_peak = 0;
+	hg_ctx->chc_in_posted_est = crt_gdata.cg_post_init;
 
 	rc = crt_hg_pool_enable(hg_ctx, CRT_HG_POOL_MAX_NUM,
 				CRT_HG_POOL_PREPOST_NUM);
@@ -291,6 +298,7 @@ crt_hg_pool_get(struct crt_hg_context *hg_ctx)
 {
 	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
 	struct crt_hg_hdl	*hdl = NULL;
+	bool			 hit = false;
 
 	D_SPIN_LOCK(&hg_pool->chp_lock);
 	if (!hg_pool->chp_enabled) {
@@ -302,19 +310,26 @@ crt_hg_pool_get(struct crt_hg_context *hg_ctx)
 			       struct crt_hg_hdl,
 			       chh_link);
 	if (hdl == NULL) {
+		hg_pool->chp_misses++;
 		D_DEBUG(DB_NET,
 			"hg_pool %p is empty, cannot get.\n", hg_pool);
-		D_GOTO(unlock, hdl);
+		D_SPIN_UNLOCK(&hg_pool->chp_lock);
+		d_tm_inc_counter(hg_pool->chp_miss_cnt, 1);
+		return NULL;
 	}
 
 	D_ASSERT(hdl->chh_hdl != HG_HANDLE_NULL);
+	hg_pool->chp_hits++;
 	hg_pool->chp_num--;
 	D_ASSERT(hg_pool->chp_num >= 0);
 	D_DEBUG(DB_NET, "hg_pool %p, remove, chp_num %d.\n",
 		hg_pool, hg_pool->chp_num);
+	hit = true;
 
 unlock:
 	D_SPIN_UNLOCK(&hg_pool->chp_lock);
+	if (hit)
+		d_tm_inc_counter(hg_pool->chp_hit_cnt, 1);
 	return hdl;
 }
 
@@ -360,6 +375,139 @@ out:
 	return rc;
 }
 
+/**
+ * Adapt the size of the HG handle pool to the workload observed since the
+ * last adaptation, called periodically from the progress loop:
+ * - pool misses double the prepost number (at least by the number of misses),
+ *   and raise the pool capacity accordingly up to CRT_HG_POOL_MAX_LIMIT.
+ * - when the demand is far below the prepost number, halve it down to
+ *   CRT_HG_POOL_PREPOST_NUM and lower the capacity.
+ * Only the targets are changed here, the HG handles are created or destroyed
+ * by crt_hg_pool_refill() once the progress is idle.
+ *
+ * The incoming requests use the handles preposted by Mercury, which are sized
+ * by D_POST_INIT and grown by D_POST_INCR handles when they are exhausted, see
+ * crt_hg_class_init(). Mercury neither reports nor resizes them at runtime, so
+ * they are not adapted here. Their number is only estimated from the peak of
+ * incoming RPCs, and a larger D_POST_INIT is recommended when the peak exceeds
+ * the estimate.
+ */
+void
+crt_hg_pool_adapt(struct crt_hg_context *hg_ctx)
+{
+	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
+	uint64_t		 now;
+	uint32_t		 demand;
+	uint32_t		 posted;
+	int32_t			 max_num;
+	int32_t			 prepost;
+
+	now = d_timeus_secdiff(0);
+	if (now - hg_pool->chp_adapt_ts < CRT_HG_POOL_ADAPT_INTERVAL)
+		return;
+
+	D_SPIN_LOCK(&hg_pool->chp_lock);
+	/* recheck in case of concurrent progress on the same context */
+	if (!hg_pool->chp_enabled || now - hg_pool->chp_adapt_ts < CRT_HG_POOL_ADAPT_INTERVAL) {
+		D_SPIN_UNLOCK(&hg_pool->chp_lock);
+		return;
+	}
+
+	hg_pool->chp_adapt_ts = now;
+	demand = hg_pool->chp_hits + hg_pool->chp_misses;
+	prepost = hg_pool->chp_prepost_num;
+	max_num = hg_pool->chp_max_num;
+
+	if (hg_pool->chp_misses > 0) {
+		prepost = max(prepost * 2, prepost + (int32_t)hg_pool->chp_misses);
+		prepost = min(prepost, CRT_HG_POOL_MAX_LIMIT);
+		max_num = min(max(max_num, prepost * 2), CRT_HG_POOL_MAX_LIMIT);
+	} else if (demand < prepost / 4 && prepost > CRT_HG_POOL_PREPOST_NUM) {
+		prepost = max(prepost / 2, CRT_HG_POOL_PREPOST_NUM);
+		max_num = max(prepost * 2, CRT_HG_POOL_MAX_NUM);
+	}
+
+	if (prepost != hg_pool->chp_prepost_num)
+		D_DEBUG(DB_NET, "hg_pool %p, hits %u, misses %u, prepost %d -> %d, max %d -> %d\n",
+			hg_pool, hg_pool->chp_hits, hg_pool->chp_misses, hg_pool->chp_prepost_num,
+			prepost, hg_pool->chp_max_num, max_num);
+
+	hg_pool->chp_hits = 0;
+	hg_pool->chp_misses = 0;
+	hg_pool->chp_prepost_num = prepost;
+	hg_pool->chp_max_num = max_num;
+	D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+	posted = hg_ctx->chc_in_posted_est;
+	if (hg_ctx->chc_in_peak > posted) {
+		D_INFO("hg_ctx %p, %u incoming RPCs in flight for %u preposted handles, "
+		       "consider setting D_POST_INIT to at least %u\n", hg_ctx,
+		       hg_ctx->chc_in_peak, posted, hg_ctx->chc_in_peak);
+		while (hg_ctx->chc_in_peak > hg_ctx->chc_in_posted_est &&
+		       crt_gdata.cg_post_incr > 0)
+			hg_ctx->chc_in_posted_est += crt_gdata.cg_post_incr;
+	}
+	d_tm_set_gauge(hg_ctx->chc_in_peak_tm, hg_ctx->chc_in_peak);
+	d_tm_set_gauge(hg_ctx->chc_in_posted_est_tm, hg_ctx->chc_in_posted_est);
+	hg_ctx->chc_in_peak = atomic_load_relaxed(&hg_ctx->chc_in_num);
+}
+
+/**
+ * Create or destroy HG handles to reach the targets set by crt_hg_pool_adapt(),
+ * at most CRT_HG_POOL_REFILL_MAX of them each time. Called when HG_Progress()
+ * found nothing to do, so this is not on the path of any RPC.
+ */
+static void
+crt_hg_pool_refill(struct crt_hg_context *hg_ctx)
+{
+	struct crt_hg_pool	*hg_pool = &hg_ctx->chc_hg_pool;
+	struct crt_hg_hdl	*hdl;
+	d_list_t		 destroy_list;
+	int32_t			 max_num;
+	int32_t			 prepost;
+	int32_t			 num;
+	hg_return_t		 hg_ret;
+	int			 rc;
+
+	D_INIT_LIST_HEAD(&destroy_list);
+
+	D_SPIN_LOCK(&hg_pool->chp_lock);
+	if (!hg_pool->chp_enabled || (hg_pool->chp_num >= hg_pool->chp_prepost_num &&
+				      hg_pool->chp_num <= hg_pool->chp_max_num)) {
+		D_SPIN_UNLOCK(&hg_pool->chp_lock);
+		return;
+	}
+
+	for (num = 0; hg_pool->chp_num > hg_pool->chp_max_num && num < CRT_HG_POOL_REFILL_MAX;
+	     num++) {
+		hdl = d_list_pop_entry(&hg_pool->chp_list, struct crt_hg_hdl, chh_link);
+		D_ASSERT(hdl != NULL);
+		d_list_add(&hdl->chh_link, &destroy_list);
+		hg_pool->chp_num--;
+	}
+	num = hg_pool->chp_num;
+	prepost = hg_pool->chp_prepost_num;
+	max_num = hg_pool->chp_max_num;
+	D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+	while ((hdl = d_list_pop_entry(&destroy_list, struct crt_hg_hdl, chh_link))) {
+		hg_ret = HG_Destroy(hdl->chh_hdl);
+		if (hg_ret != HG_SUCCESS)
+			D_ERROR("HG_Destroy() failed, hg_hdl %p, hg_ret: %d.\n",
+				hdl->chh_hdl, hg_ret);
+		D_FREE(hdl);
+	}
+
+	if (num < prepost) {
+		rc = crt_hg_pool_enable(hg_ctx, max_num,
+					min(prepost, num + CRT_HG_POOL_REFILL_MAX));
+		if (rc != 0)
+			D_WARN("failed to refill hg_pool %p: " DF_RC "\n", hg_pool, DP_RC(rc));
+	}
+
+	d_tm_set_gauge(hg_pool->chp_size, hg_pool->chp_num);
+}
+
 int
 crt_hg_addr_free(struct crt_hg_context *hg_ctx, hg_addr_t addr)
 {
@@ -1035,6 +1183,16 @@ out:
 	return rc;
 }
 
+/* time on the d_gettime() clock in ns, for the server side RPC stage timings */
+static inline uint64_t
+crt_hg_time_ns(void)
+{
+	struct timespec	now;
+
+	d_gettime(&now);
+	return (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
 int
 crt_rpc_handler_common(hg_handle_t hg_hdl)
 {
@@ -1050,7 +1208,10 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 	bool			 is_coll_req = false;
 	int			 rc = 0;
 	struct crt_rpc_priv	 rpc_tmp = {0};
+	uint64_t		 recv_ts;
+	uint32_t		 in_num;
 
+	recv_ts = crt_hg_time_ns();
 	hg_info = HG_Get_info(hg_hdl);
 	if (unlikely(hg_info == NULL)) {
 		D_ERROR("HG_Get_info failed.\n");
@@ -1129,6 +1290,11 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 		  &rpc_priv->crp_pub);
 
 	crt_rpc_priv_init(rpc_priv, crt_ctx, true /* srv_flag */);
+	rpc_priv->crp_recv_ts = recv_ts;
+	/* released in crt_hg_req_destroy() */
+	in_num = atomic_fetch_add(&hg_ctx->chc_in_num, 1) + 1;
+	if (in_num > hg_ctx->chc_in_peak)
+		hg_ctx->chc_in_peak = in_num;
 
 	D_ASSERT(rpc_priv->crp_srv != 0);
 	if (rpc_pub->cr_input_size > 0) {
@@ -1149,6 +1315,7 @@ crt_rpc_handler_common(hg_handle_t hg_hdl)
 	} else {
 		crt_hg_unpack_cleanup(proc);
 	}
+	rpc_priv->crp_decode_ts = crt_hg_time_ns();
 
 	if (unlikely(opc_info->coi_rpc_cb == NULL)) {
 		D_ERROR("NULL crp_hg_hdl, opc: %#x.\n", opc);
@@ -1239,7 +1406,8 @@ out:
 void
 crt_hg_req_destroy(struct crt_rpc_priv *rpc_priv)
 {
-	hg_return_t hg_ret;
+	struct crt_context	*ctx;
+	hg_return_t		 hg_ret;
 
 	D_ASSERT(rpc_priv != NULL);
 	if (rpc_priv->crp_output_got != 0) {
@@ -1262,6 +1430,11 @@ crt_hg_req_destroy(struct crt_rpc_priv *rpc_priv)
 
 	crt_rpc_priv_fini(rpc_priv);
 
+	if (rpc_priv->crp_srv && !rpc_priv->crp_batched) {
+		ctx = rpc_priv->crp_pub.cr_ctx;
+		atomic_fetch_sub(&ctx->cc_hg_ctx.chc_in_num, 1);
+	}
+
 	if (!rpc_priv->crp_coll && rpc_priv->crp_hg_hdl != NULL &&
 		(rpc_priv->crp_input_got == 0)) {
 		if (!rpc_priv->crp_srv &&
@@ -1553,6 +1726,8 @@ crt_hg_progress(struct crt_hg_context *hg_ctx, int64_t timeout)
 		/** progress RPC execution */
 		hg_ret = HG_Progress(hg_context, hg_timeout);
 		if (hg_ret == HG_TIMEOUT) {
+			/** nothing to progress, good time to resize the handle pool */
+			crt_hg_pool_refill(hg_ctx);
 			rc = -DER_TIMEDOUT;
 		} else if (hg_ret != HG_SUCCESS) {
 			D_ERROR("HG_Progress failed, hg_ret: " DF_HG_RC "\n",
@@ -10,6 +10,7 @@
 #define __CRT_MERCURY_H__
 
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 
 #include <mercury.h>
 #include <mercury_types.h>
@@ -26,6 +27,12 @@
 #define CRT_HG_POOL_MAX_NUM	(512)
 /** number of prepost HG handles when enable pool */
 #define CRT_HG_POOL_PREPOST_NUM	(16)
+/** upper limit of the pool size when it grows with the workload */
+#define CRT_HG_POOL_MAX_LIMIT	(16384)
+/** interval (us) to adapt the pool size to the observed workload */
+#define CRT_HG_POOL_ADAPT_INTERVAL	(100000)
+/** max number of HG handles created per adaptation to refill the pool */
+#define CRT_HG_POOL_REFILL_MAX	(256)
 
 /** default values for init / incr to prepost handles */
 #define CRT_HG_POST_INIT        (512)
@@ -115,6 +122,19 @@ struct crt_hg_pool {
 	/* HG handle list */
 	d_list_t		chp_list;
 	bool			chp_enabled;
+	/* number of HG handles the pool is refilled to, adapted to the workload */
+	int32_t			chp_prepost_num;
+	/* number of gets served from/missed in the pool since last adaptation */
+	uint32_t		chp_hits;
+	uint32_t		chp_misses;
+	/* time (us) of the last adaptation */
+	uint64_t		chp_adapt_ts;
+	/* Total number of gets served from the pool, of type counter */
+	struct d_tm_node_t	*chp_hit_cnt;
+	/* Total number of gets that found the pool empty, of type counter */
+	struct d_tm_node_t	*chp_miss_cnt;
+	/* Number of HG handles in pool, of type gauge */
+	struct d_tm_node_t	*chp_size;
 };
 
 /** HG context */
@@ -127,6 +147,19 @@ struct crt_hg_context {
 	hg_context_t		*chc_bulkctx; /* bulk context */
 	struct crt_hg_pool	 chc_hg_pool; /* HG handle pool */
 	int			 chc_provider; /* provider */
+	/* number of incoming RPCs holding a preposted HG handle */
+	ATOMIC uint32_t		 chc_in_num;
+	/* peak of chc_in_num since last adaptation of the pool */
+	uint32_t		 chc_in_peak;
+	/*
+	 * estimate of the HG handles preposted by Mercury for incoming RPCs, it
+	 * is not read from Mercury but assumed to grow by D_POST_INCR handles
+	 */
+	uint32_t		 chc_in_posted_est;
+	/* Peak number of incoming RPCs, of type gauge */
+	struct d_tm_node_t	*chc_in_peak_tm;
+	/* Estimate of the preposted HG handles for incoming RPCs, of type gauge */
+	struct d_tm_node_t	*chc_in_posted_est_tm;
 };
 
 /* crt_hg.c */
@@ -146,6 +179,7 @@ int crt_hg_req_cancel(struct crt_rpc_priv *rpc_priv);
 int crt_hg_progress(struct crt_hg_context *hg_ctx, int64_t timeout);
 int crt_hg_addr_free(struct crt_hg_context *hg_ctx, hg_addr_t addr);
 int crt_hg_get_addr(hg_class_t *hg_class, char *addr_str, size_t *str_size);
+void crt_hg_pool_adapt(struct crt_hg_context *hg_ctx);
 
 int crt_rpc_handler_common(hg_handle_t hg_hdl);
 
@@ -157,6 +191,10 @@ void crt_hg_unpack_cleanup(crt_proc_t proc);
 int crt_hg_unpack_body(struct crt_rpc_priv *rpc_priv, crt_proc_t proc);
 int crt_proc_in_common(crt_proc_t proc, crt_rpc_input_t *data);
 int crt_proc_out_common(crt_proc_t proc, crt_rpc_output_t *data);
+int crt_proc_batch_encode(struct crt_rpc_priv *rpc_priv, bool reply, d_iov_t *iov);
+int crt_proc_batch_header(crt_context_t ctx, d_iov_t *iov, struct crt_common_hdr *hdr);
+int crt_proc_batch_decode(struct crt_rpc_priv *rpc_priv, bool reply, d_iov_t *iov);
+void crt_proc_batch_free(struct crt_rpc_priv *rpc_priv, bool reply);
 
 bool crt_provider_is_contig_ep(int provider);
 bool crt_provider_is_port_based(int provider);
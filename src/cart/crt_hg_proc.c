@@ -12,6 +12,9 @@
 #include "crt_internal.h"
 
 #define CRT_PROC_NULL (NULL)
+
+/* the RPC of which the input is being decoded or freed, if in place decode is allowed */
+static __thread struct crt_rpc_priv *crt_proc_inplace_rpc;
 #define CRT_PROC_TYPE_FUNC(type)                                                                   \
 	int crt_proc_##type(crt_proc_t proc, crt_proc_op_t proc_op, type *data)                    \
 	{                                                                                          \
@@ -113,6 +116,45 @@ CRT_PROC_TYPE_FUNC(int64_t)
 CRT_PROC_TYPE_FUNC(uint64_t)
 CRT_PROC_TYPE_FUNC(bool)
 
+bool
+crt_proc_inplace_decode(crt_proc_t proc, void **data, size_t data_size, size_t align)
+{
+	struct crt_rpc_priv	*rpc_priv = crt_proc_inplace_rpc;
+	crt_proc_op_t		 proc_op;
+	char			*buf;
+	int			 rc;
+
+	if (rpc_priv == NULL || data_size == 0)
+		return false;
+
+	rc = crt_proc_get_op(proc, &proc_op);
+	if (rc != 0 || !DECODING(proc_op))
+		return false;
+
+	/* current position in the request buffer */
+	buf = hg_proc_save_ptr(proc, 0);
+	if (buf == NULL || ((uintptr_t)buf & (align - 1)) != 0 ||
+	    buf < (char *)rpc_priv->crp_in_buf ||
+	    buf + data_size > (char *)rpc_priv->crp_in_buf + rpc_priv->crp_in_buf_size)
+		return false;
+
+	*data = hg_proc_save_ptr(proc, data_size);
+	return true;
+}
+
+bool
+crt_proc_inplace_data(crt_proc_t proc, const void *data)
+{
+	struct crt_rpc_priv	*rpc_priv = crt_proc_inplace_rpc;
+	uintptr_t		 buf;
+
+	if (rpc_priv == NULL || data == NULL)
+		return false;
+
+	buf = (uintptr_t)rpc_priv->crp_in_buf;
+	return (uintptr_t)data >= buf && (uintptr_t)data < buf + rpc_priv->crp_in_buf_size;
+}
+
 int
 crt_proc_crt_bulk_t(crt_proc_t proc, crt_proc_op_t proc_op,
 		    crt_bulk_t *bulk_hdl)
@@ -333,12 +375,12 @@ crt_proc_corpc_hdr(crt_proc_t proc, struct crt_corpc_hdr *hdr)
 		buf[0] = hdr->coh_grp_ver;
 		buf[1] = hdr->coh_tree_topo;
 		buf[2] = hdr->coh_root;
-		buf[3] = hdr->coh_padding;
+		buf[3] = hdr->coh_flags;
 	} else { /* DECODING(proc_op) */
 		hdr->coh_grp_ver   = buf[0];
 		hdr->coh_tree_topo = buf[1];
 		hdr->coh_root      = buf[2];
-		hdr->coh_padding   = buf[3];
+		hdr->coh_flags     = buf[3];
 	}
 
 out:
@@ -477,6 +519,8 @@ crt_hg_unpack_header(hg_handle_t handle, struct crt_rpc_priv *rpc_priv,
 		}
 	}
 
+	rpc_priv->crp_in_buf = in_buf;
+	rpc_priv->crp_in_buf_size = in_buf_size;
 	*proc = hg_proc;
 
 out:
@@ -494,6 +538,8 @@ crt_hg_header_copy(struct crt_rpc_priv *in, struct crt_rpc_priv *out)
 
 	out->crp_req_hdr = in->crp_req_hdr;
 	out->crp_reply_hdr.cch_hlc = in->crp_reply_hdr.cch_hlc;
+	out->crp_in_buf = in->crp_in_buf;
+	out->crp_in_buf_size = in->crp_in_buf_size;
 
 	if (!(out->crp_flags & CRT_RPC_FLAG_COLL))
 		return;
@@ -511,10 +557,18 @@ crt_hg_unpack_cleanup(crt_proc_t proc)
 static inline int
 crt_proc_input(struct crt_rpc_priv *rpc_priv, crt_proc_t proc)
 {
-	struct crt_req_format *crf = rpc_priv->crp_opc_info->coi_crf;
+	struct crt_req_format	*crf = rpc_priv->crp_opc_info->coi_crf;
+	int			 rc;
 
 	D_ASSERT(crf != NULL);
-	return crf->crf_proc_in(proc, rpc_priv->crp_pub.cr_input);
+	if (!rpc_priv->crp_opc_info->coi_inplace_decode || rpc_priv->crp_in_buf == NULL)
+		return crf->crf_proc_in(proc, rpc_priv->crp_pub.cr_input);
+
+	crt_proc_inplace_rpc = rpc_priv;
+	rc = crf->crf_proc_in(proc, rpc_priv->crp_pub.cr_input);
+	crt_proc_inplace_rpc = NULL;
+
+	return rc;
 }
 
 static inline int
@@ -738,6 +792,129 @@ out:
 	return crt_der_2_hgret(rc);
 }
 
+/* Initial buffer size to pack a batched RPC, proc allocates extra buffer if it overflows */
+#define CRT_BATCH_PACK_BUF_SIZE	(1024)
+
+/*
+ * Pack the request (reply == false) or the reply (reply == true) of a batched
+ * RPC together with its common header into a newly allocated buffer.
+ */
+int
+crt_proc_batch_encode(struct crt_rpc_priv *rpc_priv, bool reply, d_iov_t *iov)
+{
+	struct crt_context	*ctx = rpc_priv->crp_pub.cr_ctx;
+	char			 pack_buf[CRT_BATCH_PACK_BUF_SIZE];
+	hg_proc_t		 hg_proc = HG_PROC_NULL;
+	hg_return_t		 hg_ret;
+	void			*data;
+	size_t			 size;
+	int			 rc = 0;
+
+	hg_ret = hg_proc_create_set(ctx->cc_hg_ctx.chc_hgcla, pack_buf, sizeof(pack_buf),
+				    HG_ENCODE, HG_NOHASH, &hg_proc);
+	if (hg_ret != HG_SUCCESS) {
+		RPC_ERROR(rpc_priv, "hg_proc_create_set failed: %d\n", hg_ret);
+		D_GOTO(out, rc = crt_hgret_2_der(hg_ret));
+	}
+
+	if (reply)
+		hg_ret = crt_proc_out_common(hg_proc, &rpc_priv->crp_pub.cr_output);
+	else
+		hg_ret = crt_proc_in_common(hg_proc, &rpc_priv->crp_pub.cr_input);
+	if (hg_ret != HG_SUCCESS) {
+		RPC_ERROR(rpc_priv, "failed to pack batched RPC: %d\n", hg_ret);
+		D_GOTO(out, rc = crt_hgret_2_der(hg_ret));
+	}
+
+	/* Packed data is moved to the extra buffer if the initial buffer overflows */
+	size = hg_proc_get_size_used(hg_proc);
+	data = hg_proc_get_extra_buf(hg_proc);
+	if (data == NULL)
+		data = pack_buf;
+
+	D_ALLOC(iov->iov_buf, size);
+	if (iov->iov_buf == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+	memcpy(iov->iov_buf, data, size);
+	iov->iov_buf_len = size;
+	iov->iov_len = size;
+out:
+	if (hg_proc != HG_PROC_NULL)
+		hg_proc_free(hg_proc);
+	return rc;
+}
+
+/* Unpack only the common header of a batched request to know about the CRT opc */
+int
+crt_proc_batch_header(crt_context_t ctx, d_iov_t *iov, struct crt_common_hdr *hdr)
+{
+	crt_proc_t	proc;
+	int		rc;
+
+	rc = crt_proc_create(ctx, iov->iov_buf, iov->iov_len, CRT_PROC_DECODE, &proc);
+	if (rc != 0)
+		return rc;
+
+	rc = crt_proc_common_hdr(proc, hdr);
+	crt_proc_destroy(proc);
+
+	return rc;
+}
+
+/*
+ * Unpack the request or the reply of a batched RPC, the unpacked data
+ * possibly refers to \a iov, so it should be valid until the RPC is destroyed.
+ */
+int
+crt_proc_batch_decode(struct crt_rpc_priv *rpc_priv, bool reply, d_iov_t *iov)
+{
+	crt_proc_t	proc;
+	hg_return_t	hg_ret;
+	int		rc;
+
+	rc = crt_proc_create(rpc_priv->crp_pub.cr_ctx, iov->iov_buf, iov->iov_len,
+			     CRT_PROC_DECODE, &proc);
+	if (rc != 0)
+		return rc;
+
+	if (reply) {
+		hg_ret = crt_proc_out_common(proc, &rpc_priv->crp_pub.cr_output);
+		rc = crt_hgret_2_der(hg_ret);
+		D_GOTO(out, rc);
+	}
+
+	rc = crt_proc_common_hdr(proc, &rpc_priv->crp_req_hdr);
+	if (rc != 0 || rpc_priv->crp_pub.cr_input == NULL)
+		D_GOTO(out, rc);
+
+	rpc_priv->crp_in_buf = iov->iov_buf;
+	rpc_priv->crp_in_buf_size = iov->iov_len;
+	rc = crt_proc_input(rpc_priv, proc);
+out:
+	if (rc != 0)
+		RPC_ERROR(rpc_priv, "failed to unpack batched RPC: "DF_RC"\n", DP_RC(rc));
+	crt_proc_destroy(proc);
+	return rc;
+}
+
+/* Free the unpacked request or reply of a batched RPC */
+void
+crt_proc_batch_free(struct crt_rpc_priv *rpc_priv, bool reply)
+{
+	crt_proc_t	proc;
+	int		rc;
+
+	rc = crt_proc_create(rpc_priv->crp_pub.cr_ctx, NULL, 0, CRT_PROC_FREE, &proc);
+	if (rc != 0)
+		return;
+
+	if (reply)
+		crt_proc_out_common(proc, &rpc_priv->crp_pub.cr_output);
+	else if (rpc_priv->crp_pub.cr_input != NULL)
+		crt_proc_input(rpc_priv, proc);
+	crt_proc_destroy(proc);
+}
+
 int
 crt_proc_create(crt_context_t crt_ctx, void *buf, size_t buf_size,
 		crt_proc_op_t proc_op, crt_proc_t *proc)
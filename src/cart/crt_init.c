@@ -53,6 +53,9 @@ static const char      *crt_env_names[] = {"D_PROVIDER",
 					   "D_QUOTA_RPCS",
 					   "D_POST_INIT",
 					   "D_POST_INCR",
+					   "CRT_BATCH_RPCS",
+					   "CRT_BATCH_WINDOW",
+					   "CRT_BATCH_RPC_SIZE",
 					   "DAOS_SIGNAL_REGISTER"};
 
 static void
@@ -337,6 +340,23 @@ static int data_init(int server, crt_init_options_t *opt)
 
 	d_getenv_uint("D_QUOTA_RPCS", &crt_gdata.cg_rpc_quota);
 
+	/* RPC batching is disabled by default */
+	crt_gdata.cg_batch_max = 0;
+	crt_gdata.cg_batch_window = CRT_BATCH_WINDOW_DEFAULT;
+	crt_gdata.cg_batch_rpc_size = CRT_BATCH_RPC_SIZE_DEFAULT;
+	d_getenv_uint("CRT_BATCH_RPCS", &crt_gdata.cg_batch_max);
+	d_getenv_uint("CRT_BATCH_WINDOW", &crt_gdata.cg_batch_window);
+	d_getenv_uint("CRT_BATCH_RPC_SIZE", &crt_gdata.cg_batch_rpc_size);
+	if (crt_gdata.cg_batch_max > CRT_BATCH_RPCS_MAX)
+		crt_gdata.cg_batch_max = CRT_BATCH_RPCS_MAX;
+	if (crt_gdata.cg_batch_max > 1)
+		D_INFO("RPC batching enabled, max %u RPCs of %u bytes in %u us\n",
+		       crt_gdata.cg_batch_max, crt_gdata.cg_batch_rpc_size,
+		       crt_gdata.cg_batch_window);
+
+	crt_gdata.cg_corpc_pipe_chunk = CRT_CORPC_PIPE_CHUNK_DEFAULT;
+	d_getenv_uint("CRT_CORPC_PIPE_CHUNK", &crt_gdata.cg_corpc_pipe_chunk);
+
 	/* Must be set on the server when using UCX, will not affect OFI */
 	d_getenv_char("UCX_IB_FORK_INIT", &ucx_ib_fork_init);
 	if (ucx_ib_fork_init) {
@@ -148,6 +148,15 @@ struct crt_gdata {
 	long			 cg_num_cores;
 	/** Inflight rpc quota limit */
 	uint32_t		cg_rpc_quota;
+
+	/** Max number of small RPCs packed in one batch, 0 or 1 to disable batching */
+	uint32_t		cg_batch_max;
+	/** Max time (us) a small RPC waits for the batch to fill */
+	uint32_t		cg_batch_window;
+	/** Max packed size of a RPC to be batched */
+	uint32_t		cg_batch_rpc_size;
+	/** Chunk size of pipelined corpc chained bulk, 0 to disable pipelining */
+	uint32_t		cg_corpc_pipe_chunk;
 };
 
 extern struct crt_gdata		crt_gdata;
@@ -245,6 +254,12 @@ struct crt_context {
 
 	/** Stores quotas */
 	struct crt_quotas	cc_quotas;
+
+	/** Pending and in-flight RPC batches (struct crt_batch), protected by cc_mutex */
+	d_list_t		cc_batch_list;
+
+	/** Pipelined corpc waiting to poll parent (struct crt_corpc_pipe), protected by cc_mutex */
+	d_list_t		cc_pipe_list;
 };
 
 /* in-flight RPC req list, be tracked per endpoint for every crt_context */
@@ -295,7 +310,8 @@ struct crt_opc_info {
 				 coi_coops_init:1,
 				 coi_no_reply:1, /* flag of one-way RPC */
 				 coi_queue_front:1, /* add to front of queue */
-				 coi_reset_timer:1; /* reset timer on timeout */
+				 coi_reset_timer:1, /* reset timer on timeout */
+				 coi_inplace_decode:1; /* decode input in place */
 
 	crt_rpc_cb_t		 coi_rpc_cb;
 	struct crt_corpc_ops	*coi_co_ops;
@@ -114,6 +114,8 @@ crt_hdlr_ctl_fi_attr_set(crt_rpc_t *rpc_req)
 /* CRT internal RPC format definitions uri lookup */
 CRT_RPC_DEFINE(crt_uri_lookup, CRT_ISEQ_URI_LOOKUP, CRT_OSEQ_URI_LOOKUP)
 
+CRT_RPC_DEFINE(crt_batch, CRT_ISEQ_BATCH, CRT_OSEQ_BATCH)
+
 /* for self-test service */
 CRT_RPC_DEFINE(crt_st_send_id_reply_iov,
 	       CRT_ISEQ_ST_SEND_ID, CRT_OSEQ_ST_REPLY_IOV)
@@ -762,10 +764,32 @@ out:
 	return rc;
 }
 
+int
+crt_req_get_recv_time(crt_rpc_t *req, uint64_t *recv_ns, uint64_t *decoded_ns)
+{
+	struct crt_rpc_priv	*rpc_priv;
+
+	if (req == NULL || recv_ns == NULL || decoded_ns == NULL) {
+		D_ERROR("invalid parameter (NULL req, recv_ns or decoded_ns).\n");
+		return -DER_INVAL;
+	}
+
+	rpc_priv = container_of(req, struct crt_rpc_priv, crp_pub);
+	*recv_ns = rpc_priv->crp_recv_ts;
+	*decoded_ns = rpc_priv->crp_decode_ts;
+
+	return 0;
+}
+
 /* Called from a decref() call when the count drops to zero */
 void
 crt_req_destroy(struct crt_rpc_priv *rpc_priv)
 {
+	if (rpc_priv->crp_batched) {
+		crt_batch_req_destroy(rpc_priv);
+		return;
+	}
+
 	if (rpc_priv->crp_reply_pending == 1) {
 		D_WARN("no reply sent for rpc_priv %p (opc: %#x).\n",
 		       rpc_priv, rpc_priv->crp_pub.cr_opc);
@@ -1492,6 +1516,11 @@ crt_req_send(crt_rpc_t *req, crt_cb_t complete_cb, void *arg)
 		}
 	}
 
+	if (crt_batch_enabled() && crt_batch_req_add(rpc_priv) == 0) {
+		RPC_TRACE(DB_TRACE, rpc_priv, "batched.\n");
+		D_GOTO(out, rc = 0);
+	}
+
 	RPC_TRACE(DB_TRACE, rpc_priv, "submitted.\n");
 
 	crt_rpc_lock(rpc_priv);
@@ -1560,6 +1589,9 @@ crt_reply_send(crt_rpc_t *req)
 		cb_info.cci_arg = rpc_priv;
 
 		crt_corpc_reply_hdlr(&cb_info);
+	} else if (rpc_priv->crp_batched) {
+		RPC_TRACE(DB_ALL, rpc_priv, "batch reply_send\n");
+		rc = crt_batch_reply_send(rpc_priv);
 	} else {
 		RPC_TRACE(DB_ALL, rpc_priv, "reply_send\n");
 		rc = crt_hg_reply_send(rpc_priv);
@@ -20,6 +20,17 @@
 
 #define CRT_QUOTA_RPCS_DEFAULT 64
 
+/* RPC batching, see CRT_BATCH_RPCS/CRT_BATCH_WINDOW/CRT_BATCH_RPC_SIZE */
+#define CRT_BATCH_RPCS_MAX		(256)
+#define CRT_BATCH_WINDOW_DEFAULT	(50)	/* micro-second */
+#define CRT_BATCH_RPC_SIZE_DEFAULT	(512)
+
+/* chunk size of pipelined corpc chained bulk, see CRT_CORPC_PIPE_CHUNK */
+#define CRT_CORPC_PIPE_CHUNK_DEFAULT	(1UL << 20)
+/* min and max delay (us) to poll parent again when it has no new data */
+#define CRT_CORPC_PIPE_POLL_MIN		(8)
+#define CRT_CORPC_PIPE_POLL_MAX		(1024)
+
 /* uri lookup max retry times */
 #define CRT_URI_LOOKUP_RETRY_MAX	(8)
 
@@ -37,6 +48,12 @@ enum crt_rpc_flags_internal {
 	CRT_RPC_FLAG_PRIMARY_GRP	= (1U << 17),
 };
 
+/* corpc header flags */
+enum crt_corpc_hdr_flags {
+	/* coh_bulk_hdl is pipelined, i.e. a progress word followed by the data */
+	CRT_COH_FLAG_BULK_PIPE		= (1U << 0),
+};
+
 struct crt_corpc_hdr {
 	/* internal group ID name */
 	d_string_t		 coh_grpid;
@@ -51,7 +68,8 @@ struct crt_corpc_hdr {
 	uint32_t		 coh_tree_topo;
 	/* root rank of the tree, it is the logical rank within the group */
 	uint32_t		 coh_root;
-	uint32_t		 coh_padding;
+	/* bit flags, see enum crt_corpc_hdr_flags */
+	uint32_t		 coh_flags;
 };
 
 /* CaRT layer common header */
@@ -91,6 +109,48 @@ typedef enum {
 	RPC_STATE_FWD_UNREACH,
 } crt_rpc_state_t;
 
+/* value of the progress word when the pipelined bulk transfer failed */
+#define CRT_CORPC_PIPE_ABORT	((uint64_t)-1)
+
+/*
+ * Pipelined chained bulk of corpc. The RPC is forwarded to children before the
+ * bulk data arrives, and the children pull the data through the exposed handle
+ * (a progress word followed by the data) chunk by chunk as it arrives, so that
+ * the transfer time does not grow with the depth of the tree.
+ */
+struct crt_corpc_pipe {
+	/* bulk handle of parent, freed once all the data is pulled */
+	crt_bulk_t		 cpp_remote_hdl;
+	/* bulk handle exposed to children (progress word + data) */
+	crt_bulk_t		 cpp_expose_hdl;
+	/* bulk handle of cpp_poll */
+	crt_bulk_t		 cpp_poll_hdl;
+	/* offset of the data in parent's bulk, non-zero if parent pipelined */
+	uint64_t		 cpp_remote_off;
+	/* length of the data */
+	uint64_t		 cpp_len;
+	uint64_t		 cpp_chunk;
+	/* bytes of data pulled, published to children as the progress word */
+	uint64_t		 cpp_progress;
+	/* bytes of data known to be available on parent */
+	uint64_t		 cpp_avail;
+	/* progress word of parent polled through cpp_poll_hdl */
+	uint64_t		 cpp_poll;
+	/* link to crt_context::cc_pipe_list while waiting to poll parent */
+	d_list_t		 cpp_link;
+	/* RPC the pipe belongs to */
+	struct crt_rpc_priv	*cpp_rpc;
+	/* time (us) to poll parent again */
+	uint64_t		 cpp_poll_ts;
+	/* delay (us) to poll parent again, doubled every time it has no new data */
+	uint32_t		 cpp_poll_delay;
+	/* all the data pulled or failed */
+	uint32_t		 cpp_done:1,
+	/* local RPC handler waits for the data */
+				 cpp_local_pending:1;
+	int			 cpp_rc;
+};
+
 /* corpc info to track the tree topo and child RPCs info */
 struct crt_corpc_info {
 	struct crt_grp_priv	*co_grp_priv;
@@ -101,6 +161,8 @@ struct crt_corpc_info {
 	d_rank_t		 co_root;
 	/* the priv passed in crt_corpc_req_create */
 	void			*co_priv;
+	/* pipelined chained bulk, NULL if not pipelined */
+	struct crt_corpc_pipe	*co_pipe;
 	/* child RPCs list */
 	d_list_t		 co_child_rpcs;
 	/*
@@ -126,6 +188,37 @@ struct crt_corpc_info {
 	int			 co_rc;
 };
 
+/*
+ * Batch of small RPCs to the same endpoint, sent in one CRT_OPC_BATCH RPC.
+ * On origin side it collects the packed requests until flushed, on target
+ * side it collects the packed replies of the unpacked requests. It is freed
+ * after all the batched RPCs are destroyed.
+ */
+struct crt_batch {
+	/* link to crt_context::cc_batch_list, origin only */
+	d_list_t		 cb_link;
+	/* link to a local list of the batches to send, origin only */
+	d_list_t		 cb_tmp_link;
+	/* batched RPCs (linked by crp_parent_link), origin only */
+	d_list_t		 cb_rpcs;
+	crt_endpoint_t		 cb_ep;
+	/* the CRT_OPC_BATCH RPC */
+	struct crt_rpc_priv	*cb_rpc;
+	/* packed requests (origin) or replies (target) */
+	d_iov_t			*cb_iovs;
+	uint32_t		 cb_nr;
+	uint32_t		 cb_cap;
+	/* min timeout of the batched RPCs, origin only */
+	uint32_t		 cb_timeout;
+	/* number of replies not packed yet, target only */
+	ATOMIC uint32_t		 cb_pending;
+	ATOMIC uint32_t		 cb_ref;
+	/* time to flush the batch (us), origin only */
+	uint64_t		 cb_deadline;
+	/* the batch RPC has been sent and not completed yet, origin only */
+	bool			 cb_sent;
+};
+
 struct crt_rpc_priv {
 	crt_rpc_t		crp_pub; /* public part */
 	/* link to crt_ep_inflight::epi_req_q/::epi_req_waitq */
@@ -186,11 +279,25 @@ struct crt_rpc_priv {
 				/* RPC completed flag */
 				crp_completed:1,
 				/* RPC originated from a primary provider */
-				crp_src_is_primary:1;
+				crp_src_is_primary:1,
+				/* RPC is packed in a CRT_OPC_BATCH RPC */
+				crp_batched:1,
+				/* reply of batched RPC has been packed */
+				crp_batch_replied:1;
 
 	struct crt_opc_info	*crp_opc_info;
 	/* corpc info, only valid when (crp_coll == 1) */
 	struct crt_corpc_info	*crp_corpc_info;
+	/* batch info, only valid when (crp_batched == 1) */
+	struct crt_batch	*crp_batch;
+	/* index in the batch */
+	uint32_t		crp_batch_idx;
+	/* when the request was received and decoded (ns), server side only */
+	uint64_t		crp_recv_ts;
+	uint64_t		crp_decode_ts;
+	/* received request buffer, the input may be decoded in place in it */
+	void			*crp_in_buf;
+	size_t			crp_in_buf_size;
 	pthread_spinlock_t	crp_lock;
 	/*
 	 * Prevent data races on most crt_rpc_priv fields from crt_req_send,
@@ -242,6 +349,9 @@ crt_rpc_unlock(struct crt_rpc_priv *rpc_priv)
 	X(CRT_OPC_CTL_LS,						\
 		0, &CQF_crt_ctl_ep_ls,					\
 		crt_hdlr_ctl_ls, NULL)					\
+	X(CRT_OPC_BATCH,						\
+		0, &CQF_crt_batch,					\
+		crt_hdlr_batch, NULL)					\
 
 #define CRT_FI_RPCS_LIST						\
 	X(CRT_OPC_CTL_FI_TOGGLE,					\
@@ -386,6 +496,17 @@ CRT_GEN_STRUCT(crt_grp_cache, CRT_SEQ_GRP_CACHE)
 
 CRT_RPC_DECLARE(crt_uri_lookup, CRT_ISEQ_URI_LOOKUP, CRT_OSEQ_URI_LOOKUP)
 
+#define CRT_ISEQ_BATCH		/* input fields */		 \
+	/* packed requests, see crt_proc_batch_encode() */	 \
+	((d_iov_t)		(bi_reqs)		CRT_ARRAY)
+
+#define CRT_OSEQ_BATCH		/* output fields */		 \
+	/* packed replies in the same order of requests */	 \
+	((d_iov_t)		(bo_replies)		CRT_ARRAY) \
+	((int32_t)		(bo_rc)			CRT_VAR)
+
+CRT_RPC_DECLARE(crt_batch, CRT_ISEQ_BATCH, CRT_OSEQ_BATCH)
+
 #define CRT_ISEQ_ST_SEND_ID	/* input fields */		 \
 	((uint64_t)		(unused1)		CRT_VAR)
 
@@ -703,6 +824,22 @@ int crt_corpc_req_hdlr(struct crt_rpc_priv *rpc_priv);
 void crt_corpc_reply_hdlr(const struct crt_cb_info *cb_info);
 int crt_corpc_common_hdlr(struct crt_rpc_priv *rpc_priv);
 void crt_corpc_info_fini(struct crt_rpc_priv *rpc_priv);
+int64_t crt_corpc_pipe_progress(struct crt_context *ctx, int64_t timeout);
+void crt_corpc_pipe_flush(struct crt_context *ctx);
+
+/* crt_batch.c */
+void crt_hdlr_batch(crt_rpc_t *rpc_req);
+int crt_batch_req_add(struct crt_rpc_priv *rpc_priv);
+int crt_batch_reply_send(struct crt_rpc_priv *rpc_priv);
+void crt_batch_req_destroy(struct crt_rpc_priv *rpc_priv);
+int64_t crt_batch_progress(struct crt_context *ctx, int64_t timeout);
+void crt_batch_flush(struct crt_context *ctx);
+
+static inline bool
+crt_batch_enabled(void)
+{
+	return crt_gdata.cg_batch_max > 1;
+}
 
 /* crt_iv.c */
 void crt_hdlr_iv_fetch(crt_rpc_t *rpc_req);
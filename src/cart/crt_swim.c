@@ -13,10 +13,10 @@
 #include "crt_internal.h"
 #include "crt_internal_fns.h"
 
-#define CRT_OPC_SWIM_VERSION	2
+#define CRT_OPC_SWIM_VERSION	3
 #define CRT_SWIM_FAIL_BASE	((CRT_OPC_SWIM_BASE >> 16) | \
 				 (CRT_OPC_SWIM_VERSION << 4))
-#define CRT_SWIM_FAIL_DROP_RPC	(CRT_SWIM_FAIL_BASE | 0x1)	/* id: 65057 */
+#define CRT_SWIM_FAIL_DROP_RPC	(CRT_SWIM_FAIL_BASE | 0x1)	/* id: 65073 */
 
 /**
  * use this macro to determine if a fault should be injected at
@@ -210,6 +210,7 @@ crt_swim_membs_add(struct crt_swim_membs *csm, struct crt_swim_target *cst)
 
 	csm->csm_list[csm->csm_list_len] = cst->cst_id;
 	csm->csm_list_len++;
+	swim_member_count_set(csm->csm_ctx, csm->csm_list_len);
 
 	if (csm->csm_target == CRT_SWIM_TARGET_INVALID)
 		csm->csm_target = 0;
@@ -238,6 +239,7 @@ crt_swim_membs_del(struct crt_swim_membs *csm, d_rank_t rank)
 		memmove(&csm->csm_list[i], &csm->csm_list[i + 1],
 			sizeof(csm->csm_list[0]) * (csm->csm_list_len - (i + 1)));
 	csm->csm_list_len--;
+	swim_member_count_set(csm->csm_ctx, csm->csm_list_len);
 
 	if (csm->csm_list_len == 0) {
 		D_FREE(csm->csm_list);
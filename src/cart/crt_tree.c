@@ -81,6 +81,32 @@ out:
 	return rc;
 }
 
+/*
+ * Get the topology domain of each rank in \a grp_rank_list for CRT_TREE_DOMAIN,
+ * as set for \a grp_ver, so that all the ranks at that version build the same tree.
+ * The trees without version (e.g. IV) use the domains of the current version.
+ */
+static int
+crt_tree_get_domains(struct crt_grp_priv *grp_priv, uint32_t grp_ver, uint32_t tree_type,
+		     d_rank_list_t *grp_rank_list, uint32_t **grp_domains)
+{
+	uint32_t	*domains;
+
+	*grp_domains = NULL;
+	if (tree_type != CRT_TREE_DOMAIN)
+		return 0;
+
+	D_ALLOC_ARRAY(domains, grp_rank_list->rl_nr);
+	if (domains == NULL)
+		return -DER_NOMEM;
+
+	if (grp_ver == 0)
+		grp_ver = grp_priv->gp_membs_ver;
+	crt_grp_priv_get_domains(grp_priv, grp_ver, grp_rank_list, domains);
+
+	*grp_domains = domains;
+	return 0;
+}
 
 #define CRT_TREE_PARAMETER_CHECKING(grp_priv, tree_topo, root, self)	\
 	do {								\
@@ -114,6 +140,7 @@ crt_tree_get_nchildren(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	bool			 allocated = false;
 	uint32_t		 tree_type, tree_ratio;
 	uint32_t		 grp_size;
+	uint32_t		*grp_domains = NULL;
 	struct crt_topo_ops	*tops;
 	int			 rc = 0;
 
@@ -146,9 +173,13 @@ crt_tree_get_nchildren(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
+	rc = crt_tree_get_domains(grp_priv, grp_ver, tree_type, grp_rank_list, &grp_domains);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
 	tops = crt_tops[tree_type];
 	rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root, grp_self,
-				       nchildren);
+				       grp_domains, nchildren);
 	if (rc != 0)
 		D_ERROR("to_get_children_cnt (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -158,6 +189,7 @@ out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
+	D_FREE(grp_domains);
 	return rc;
 }
 
@@ -181,6 +213,7 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	uint32_t		 tree_type, tree_ratio;
 	uint32_t		 grp_size, nchildren;
 	uint32_t		 *tree_children;
+	uint32_t		*grp_domains = NULL;
 	struct crt_topo_ops	*tops;
 	int			 i, rc = 0;
 
@@ -225,10 +258,14 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc);
 	}
 
+	rc = crt_tree_get_domains(grp_priv, grp_ver, tree_type, grp_rank_list, &grp_domains);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
 	tops = crt_tops[tree_type];
 
 	rc = tops->to_get_children_cnt(grp_size, tree_ratio, grp_root, grp_self,
-				       &nchildren);
+				       grp_domains, &nchildren);
 	if (rc != 0) {
 		D_ERROR("to_get_children_cnt (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -249,7 +286,7 @@ crt_tree_get_children(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_NOMEM);
 	}
 	rc = tops->to_get_children(grp_size, tree_ratio, grp_root, grp_self,
-				   tree_children);
+				   grp_domains, tree_children);
 	if (rc != 0) {
 		D_ERROR("to_get_children (group %s, root %d, self %d) "
 			"failed, rc: %d.\n", grp_priv->gp_pub.cg_grpid,
@@ -270,6 +307,7 @@ out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
+	D_FREE(grp_domains);
 	return rc;
 }
 
@@ -283,6 +321,7 @@ crt_tree_get_parent(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 	bool			 allocated = false;
 	uint32_t		 tree_type, tree_ratio;
 	uint32_t		 grp_size, tree_parent;
+	uint32_t		*grp_domains = NULL;
 	struct crt_topo_ops	*tops;
 	int			 rc = 0;
 
@@ -315,9 +354,13 @@ crt_tree_get_parent(struct crt_grp_priv *grp_priv, uint32_t grp_ver,
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
+	rc = crt_tree_get_domains(grp_priv, grp_ver, tree_type, grp_rank_list, &grp_domains);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
 	tops = crt_tops[tree_type];
 	rc = tops->to_get_parent(grp_size, tree_ratio, grp_root, grp_self,
-				 &tree_parent);
+				 grp_domains, &tree_parent);
 	if (rc != 0) {
 		D_ERROR("to_get_parent (group %s, root %d, self %d) failed, "
 			"rc: %d.\n", grp_priv->gp_pub.cg_grpid, root, self, rc);
@@ -329,6 +372,7 @@ out:
 	D_RWLOCK_UNLOCK(&grp_priv->gp_rwlock);
 	if (allocated)
 		d_rank_list_free(grp_rank_list);
+	D_FREE(grp_domains);
 	return rc;
 }
 
@@ -337,4 +381,5 @@ struct crt_topo_ops *crt_tops[] = {
 	&crt_flat_ops,		/* CRT_TREE_FLAT */
 	&crt_kary_ops,		/* CRT_TREE_KARY */
 	&crt_knomial_ops,	/* CRT_TREE_KNOMIAL */
+	&crt_domain_ops,	/* CRT_TREE_DOMAIN */
 };
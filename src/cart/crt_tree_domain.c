@@ -0,0 +1,267 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT. It gives out the domain (topology aware) tree
+ * topo related function implementation.
+ *
+ * Every domain (e.g. node) has a leader, that is the root for the domain of
+ * the root, or the rank with the smallest tree rank for the other domains.
+ * The leaders form a knomial tree, and each leader has all the other ranks
+ * of its domain as children, so that every domain gets one inbound message
+ * and fans it out locally. A rank of unknown domain is a domain by itself.
+ */
+#define D_LOGFAC	DD_FAC(grp)
+
+#include "crt_internal.h"
+
+struct domain_rank {
+	uint32_t	dr_domain;
+	uint32_t	dr_tree_rank;
+};
+
+static int
+domain_rank_cmp(const void *a, const void *b)
+{
+	const struct domain_rank	*dr_a = a;
+	const struct domain_rank	*dr_b = b;
+
+	if (dr_a->dr_domain != dr_b->dr_domain)
+		return dr_a->dr_domain < dr_b->dr_domain ? -1 : 1;
+	if (dr_a->dr_tree_rank != dr_b->dr_tree_rank)
+		return dr_a->dr_tree_rank < dr_b->dr_tree_rank ? -1 : 1;
+	return 0;
+}
+
+static int
+tree_rank_cmp(const void *a, const void *b)
+{
+	uint32_t	ra = *(const uint32_t *)a;
+	uint32_t	rb = *(const uint32_t *)b;
+
+	return ra < rb ? -1 : (ra > rb ? 1 : 0);
+}
+
+static inline uint32_t
+domain_of(uint32_t grp_size, uint32_t grp_root, uint32_t *grp_domains, uint32_t tree_rank)
+{
+	if (grp_domains == NULL)
+		return CRT_NO_DOMAIN;
+
+	return grp_domains[crt_treerank_2_grprank(grp_size, grp_root, tree_rank)];
+}
+
+/* tree rank of the leader of the domain that \a tree_self belongs to */
+static uint32_t
+domain_get_leader(uint32_t grp_size, uint32_t grp_root, uint32_t *grp_domains,
+		  uint32_t tree_self)
+{
+	uint32_t	domain;
+	uint32_t	i;
+
+	domain = domain_of(grp_size, grp_root, grp_domains, tree_self);
+	if (domain == CRT_NO_DOMAIN)
+		return tree_self;
+
+	for (i = 0; i < tree_self; i++) {
+		if (domain_of(grp_size, grp_root, grp_domains, i) == domain)
+			return i;
+	}
+
+	return tree_self;
+}
+
+/*
+ * Get the tree ranks of all the domain leaders in ascending order, so the
+ * index of a leader is its tree rank in the knomial tree of the leaders.
+ */
+static int
+domain_get_leaders(uint32_t grp_size, uint32_t grp_root, uint32_t *grp_domains,
+		   uint32_t **leaders_out, uint32_t *nleaders_out)
+{
+	struct domain_rank	*drs;
+	uint32_t		*leaders;
+	uint32_t		 nleaders = 0;
+	uint32_t		 i;
+
+	D_ALLOC_ARRAY(drs, grp_size);
+	if (drs == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY(leaders, grp_size);
+	if (leaders == NULL) {
+		D_FREE(drs);
+		return -DER_NOMEM;
+	}
+
+	for (i = 0; i < grp_size; i++) {
+		drs[i].dr_domain = domain_of(grp_size, grp_root, grp_domains, i);
+		drs[i].dr_tree_rank = i;
+	}
+	qsort(drs, grp_size, sizeof(*drs), domain_rank_cmp);
+
+	for (i = 0; i < grp_size; i++) {
+		if (i == 0 || drs[i].dr_domain == CRT_NO_DOMAIN ||
+		    drs[i].dr_domain != drs[i - 1].dr_domain)
+			leaders[nleaders++] = drs[i].dr_tree_rank;
+	}
+	D_FREE(drs);
+
+	qsort(leaders, nleaders, sizeof(*leaders), tree_rank_cmp);
+	D_ASSERT(leaders[0] == 0);
+
+	*leaders_out = leaders;
+	*nleaders_out = nleaders;
+	return 0;
+}
+
+static uint32_t
+domain_leader_idx(uint32_t *leaders, uint32_t nleaders, uint32_t tree_rank)
+{
+	uint32_t	*found;
+
+	found = bsearch(&tree_rank, leaders, nleaders, sizeof(*leaders), tree_rank_cmp);
+	D_ASSERT(found != NULL);
+
+	return found - leaders;
+}
+
+/* Get the children (in group rank), or only count them if \a children is NULL */
+static int
+domain_get_children(uint32_t grp_size, uint32_t tree_ratio, uint32_t grp_root,
+		    uint32_t grp_self, uint32_t *grp_domains, uint32_t *children,
+		    uint32_t *nchildren)
+{
+	uint32_t	*leaders = NULL;
+	uint32_t	 nleaders;
+	uint32_t	 tree_self;
+	uint32_t	 domain;
+	uint32_t	 idx;
+	uint32_t	 nr = 0;
+	uint32_t	 i;
+	int		 rc;
+
+	tree_self = crt_grprank_2_teerank(grp_size, grp_root, grp_self);
+	if (domain_get_leader(grp_size, grp_root, grp_domains, tree_self) != tree_self) {
+		*nchildren = 0;
+		return 0;
+	}
+
+	rc = domain_get_leaders(grp_size, grp_root, grp_domains, &leaders, &nleaders);
+	if (rc != 0)
+		return rc;
+
+	/* leaders of the child domains */
+	idx = domain_leader_idx(leaders, nleaders, tree_self);
+	rc = crt_knomial_ops.to_get_children_cnt(nleaders, tree_ratio, 0, idx, NULL, &nr);
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	if (children != NULL && nr > 0) {
+		rc = crt_knomial_ops.to_get_children(nleaders, tree_ratio, 0, idx, NULL, children);
+		if (rc != 0)
+			D_GOTO(out, rc);
+
+		for (i = 0; i < nr; i++)
+			children[i] = crt_treerank_2_grprank(grp_size, grp_root,
+							     leaders[children[i]]);
+	}
+
+	/* other ranks of the local domain */
+	domain = grp_domains == NULL ? CRT_NO_DOMAIN : grp_domains[grp_self];
+	if (domain != CRT_NO_DOMAIN) {
+		for (i = 0; i < grp_size; i++) {
+			if (i == grp_self || grp_domains[i] != domain)
+				continue;
+			if (children != NULL)
+				children[nr] = i;
+			nr++;
+		}
+	}
+
+	*nchildren = nr;
+out:
+	D_FREE(leaders);
+	return rc;
+}
+
+int
+crt_domain_get_children_cnt(uint32_t grp_size, uint32_t tree_ratio,
+			    uint32_t grp_root, uint32_t grp_self, uint32_t *grp_domains,
+			    uint32_t *nchildren)
+{
+	D_ASSERT(grp_size > 0);
+	D_ASSERT(nchildren != NULL);
+	D_ASSERT(tree_ratio >= CRT_TREE_MIN_RATIO &&
+		 tree_ratio <= CRT_TREE_MAX_RATIO);
+
+	return domain_get_children(grp_size, tree_ratio, grp_root, grp_self,
+				   grp_domains, NULL, nchildren);
+}
+
+int
+crt_domain_get_children(uint32_t grp_size, uint32_t tree_ratio,
+			uint32_t grp_root, uint32_t grp_self, uint32_t *grp_domains,
+			uint32_t *children)
+{
+	uint32_t	nchildren;
+
+	D_ASSERT(grp_size > 0);
+	D_ASSERT(children != NULL);
+	D_ASSERT(tree_ratio >= CRT_TREE_MIN_RATIO &&
+		 tree_ratio <= CRT_TREE_MAX_RATIO);
+
+	return domain_get_children(grp_size, tree_ratio, grp_root, grp_self,
+				   grp_domains, children, &nchildren);
+}
+
+int
+crt_domain_get_parent(uint32_t grp_size, uint32_t tree_ratio,
+		      uint32_t grp_root, uint32_t grp_self, uint32_t *grp_domains,
+		      uint32_t *parent)
+{
+	uint32_t	*leaders = NULL;
+	uint32_t	 nleaders;
+	uint32_t	 tree_self;
+	uint32_t	 tree_leader;
+	uint32_t	 idx;
+	int		 rc;
+
+	D_ASSERT(grp_size > 0);
+	D_ASSERT(parent != NULL);
+	D_ASSERT(tree_ratio >= CRT_TREE_MIN_RATIO &&
+		 tree_ratio <= CRT_TREE_MAX_RATIO);
+
+	if (grp_self == grp_root)
+		return -DER_INVAL;
+
+	tree_self = crt_grprank_2_teerank(grp_size, grp_root, grp_self);
+	D_ASSERT(tree_self != 0);
+
+	/* non-leader ranks get the message from the leader of the local domain */
+	tree_leader = domain_get_leader(grp_size, grp_root, grp_domains, tree_self);
+	if (tree_leader != tree_self) {
+		*parent = crt_treerank_2_grprank(grp_size, grp_root, tree_leader);
+		return 0;
+	}
+
+	rc = domain_get_leaders(grp_size, grp_root, grp_domains, &leaders, &nleaders);
+	if (rc != 0)
+		return rc;
+
+	idx = domain_leader_idx(leaders, nleaders, tree_self);
+	rc = crt_knomial_ops.to_get_parent(nleaders, tree_ratio, 0, idx, NULL, &idx);
+	if (rc == 0)
+		*parent = crt_treerank_2_grprank(grp_size, grp_root, leaders[idx]);
+
+	D_FREE(leaders);
+	return rc;
+}
+
+struct crt_topo_ops crt_domain_ops = {
+	.to_get_children_cnt	= crt_domain_get_children_cnt,
+	.to_get_children	= crt_domain_get_children,
+	.to_get_parent		= crt_domain_get_parent
+};
@@ -34,7 +34,7 @@ kary_get_children(uint32_t *children, uint32_t self, uint32_t size,
 
 int
 crt_kary_get_children_cnt(uint32_t grp_size, uint32_t tree_ratio,
-			  uint32_t grp_root, uint32_t grp_self,
+			  uint32_t grp_root, uint32_t grp_self, uint32_t *grp_domains,
 			  uint32_t *nchildren)
 {
 	uint32_t	tree_self;
@@ -53,7 +53,8 @@ crt_kary_get_children_cnt(uint32_t grp_size, uint32_t tree_ratio,
 
 int
 crt_kary_get_children(uint32_t grp_size, uint32_t tree_ratio,
-		      uint32_t grp_root, uint32_t grp_self, uint32_t *children)
+		      uint32_t grp_root, uint32_t grp_self, uint32_t *grp_domains,
+		      uint32_t *children)
 {
 	uint32_t	nchildren;
 	uint32_t	tree_self;
@@ -78,7 +79,7 @@ crt_kary_get_children(uint32_t grp_size, uint32_t tree_ratio,
 
 int
 crt_kary_get_parent(uint32_t grp_size, uint32_t tree_ratio, uint32_t grp_root,
-		    uint32_t grp_self, uint32_t *parent)
+		    uint32_t grp_self, uint32_t *grp_domains, uint32_t *parent)
 {
 	uint32_t	tree_self, tree_parent;
 
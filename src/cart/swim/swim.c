@@ -19,6 +19,7 @@ static const char *SWIM_STATUS_STR[] = {
 static uint64_t swim_prot_period_len;
 static uint64_t swim_suspect_timeout;
 static uint64_t swim_ping_timeout;
+static bool     swim_lifeguard;
 
 static inline uint64_t
 swim_prot_period_len_default(void)
@@ -47,6 +48,15 @@ swim_ping_timeout_default(void)
 	return val;
 }
 
+static inline bool
+swim_lifeguard_default(void)
+{
+	bool val = false;
+
+	d_getenv_bool("SWIM_LIFEGUARD", &val);
+	return val;
+}
+
 void
 swim_period_set(uint64_t val)
 {
@@ -86,6 +96,110 @@ swim_ping_timeout_get(void)
 	return swim_ping_timeout;
 }
 
+void
+swim_lifeguard_set(bool val)
+{
+	D_DEBUG(DB_TRACE, "swim_lifeguard set as %d\n", val);
+	swim_lifeguard = val;
+}
+
+bool
+swim_lifeguard_get(void)
+{
+	return swim_lifeguard;
+}
+
+/* ceil(log10(N + 1)) of the members count N, at least 1 */
+static inline uint64_t
+swim_members_log10(struct swim_context *ctx)
+{
+	uint64_t	n = ctx->sc_members;
+	uint64_t	l = 1;
+
+	for (; n >= 10; n /= 10)
+		l++;
+	return l;
+}
+
+/* scale a timeout or period by the local health multiplier */
+static inline uint64_t
+swim_lhm_scale(struct swim_context *ctx, uint64_t val)
+{
+	return val * (ctx->sc_lhm + 1);
+}
+
+/* update the local health multiplier, the caller must hold the ctx lock */
+static inline void
+swim_lhm_update(struct swim_context *ctx, bool healthy)
+{
+	if (!swim_lifeguard)
+		return;
+
+	if (healthy && ctx->sc_lhm > 0)
+		ctx->sc_lhm--;
+	else if (!healthy && ctx->sc_lhm < SWIM_LHM_MAX)
+		ctx->sc_lhm++;
+}
+
+/*
+ * The suspect timeout of a member with \a nsuspecters independent suspicions.
+ * In Lifeguard mode, it decreases from the max to the min timeout in log of
+ * the count of confirmations, i.e. suspicions from members other than the
+ * first one.
+ */
+static uint64_t
+swim_suspect_deadline_len(struct swim_context *ctx, uint32_t nsuspecters)
+{
+	/* log(c + 1) / log(SWIM_SUSPECT_CONFIRMS + 1) in 1/1000 */
+	static const uint64_t	 confirm_frac[SWIM_SUSPECT_CONFIRMS + 1] = {0, 500, 792, 1000};
+	uint64_t		 min_timeout;
+	uint64_t		 max_timeout;
+	uint32_t		 confirms;
+
+	if (!swim_lifeguard)
+		return swim_suspect_timeout_get();
+
+	min_timeout = SWIM_SUSPECT_MULT * swim_members_log10(ctx) * swim_period_get();
+	max_timeout = SWIM_SUSPECT_MAX_MULT * min_timeout;
+	confirms = nsuspecters > 0 ? min(nsuspecters - 1, SWIM_SUSPECT_CONFIRMS) : 0;
+
+	return max_timeout - (max_timeout - min_timeout) * confirm_frac[confirms] / 1000;
+}
+
+/* insert the update before the ones which have been transferred more times */
+static void
+swim_updates_insert(struct swim_context *ctx, struct swim_item *item)
+{
+	struct swim_item *pos;
+
+	TAILQ_FOREACH(pos, &ctx->sc_updates, si_link) {
+		if (pos->u.si_count > item->u.si_count) {
+			TAILQ_INSERT_BEFORE(pos, item, si_link);
+			return;
+		}
+	}
+	TAILQ_INSERT_TAIL(&ctx->sc_updates, item, si_link);
+}
+
+/*
+ * The member which originated the state of \a id, i.e. the first suspecter of
+ * a suspected member, or self for the other states. The caller must hold the
+ * ctx lock.
+ */
+static swim_id_t
+swim_member_origin(struct swim_context *ctx, swim_id_t id, struct swim_member_state *state)
+{
+	struct swim_item *item;
+
+	if (state->sms_status == SWIM_MEMBER_SUSPECT) {
+		TAILQ_FOREACH(item, &ctx->sc_suspects, si_link) {
+			if (item->si_id == id)
+				return item->si_suspecters[0];
+		}
+	}
+	return ctx->sc_self;
+}
+
 static inline void
 swim_dump_updates(swim_id_t self_id, swim_id_t from_id, swim_id_t to_id,
 		  struct swim_member_update *upds, size_t nupds)
@@ -122,6 +236,7 @@ int
 swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 		     struct swim_member_update **pupds, size_t *pnupds)
 {
+	TAILQ_HEAD(, swim_item)		 sent;
 	struct swim_member_update	*upds;
 	struct swim_item		*next, *item;
 	swim_id_t			 self_id = swim_self_get(ctx);
@@ -143,6 +258,7 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 	if (upds == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
 
+	TAILQ_INIT(&sent);
 	swim_ctx_lock(ctx);
 
 	rc = ctx->sc_ops->get_member_state(ctx, id, &upds[n].smu_state);
@@ -153,6 +269,7 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 			SWIM_ERROR("get_member_state(%lu): "DF_RC"\n", id, DP_RC(rc));
 		D_GOTO(out_unlock, rc);
 	}
+	upds[n].smu_origin = swim_member_origin(ctx, id, &upds[n].smu_state);
 	upds[n++].smu_id = id;
 
 	if (id != self_id) {
@@ -163,6 +280,7 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 			SWIM_ERROR("get_member_state(%lu): "DF_RC"\n", self_id, DP_RC(rc));
 			D_GOTO(out_unlock, rc);
 		}
+		upds[n].smu_origin = swim_member_origin(ctx, self_id, &upds[n].smu_state);
 		upds[n++].smu_id = self_id;
 	}
 
@@ -175,6 +293,7 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 				SWIM_ERROR("get_member_state(%lu): "DF_RC"\n", to, DP_RC(rc));
 			D_GOTO(out_unlock, rc);
 		}
+		upds[n].smu_origin = swim_member_origin(ctx, to, &upds[n].smu_state);
 		upds[n++].smu_id = to;
 	}
 
@@ -182,8 +301,12 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 	while (item != NULL) {
 		next = TAILQ_NEXT(item, si_link);
 
-		/* delete entries that are too many */
 		if (n >= nupds) {
+			/* keep the rest for the next messages */
+			if (swim_lifeguard)
+				break;
+
+			/* delete entries that are too many */
 			TAILQ_REMOVE(&ctx->sc_updates, item, si_link);
 			D_FREE(item);
 			item = next;
@@ -208,12 +331,16 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 					   item->si_id, DP_RC(rc));
 				D_GOTO(out_unlock, rc);
 			}
+			upds[n].smu_origin = swim_member_origin(ctx, item->si_id, &upds[n].smu_state);
 			upds[n++].smu_id = item->si_id;
 		}
 
 		if (++item->u.si_count > ctx->sc_piggyback_tx_max) {
 			TAILQ_REMOVE(&ctx->sc_updates, item, si_link);
 			D_FREE(item);
+		} else if (swim_lifeguard) {
+			TAILQ_REMOVE(&ctx->sc_updates, item, si_link);
+			TAILQ_INSERT_TAIL(&sent, item, si_link);
 		}
 
 		item = next;
@@ -221,6 +348,11 @@ swim_updates_prepare(struct swim_context *ctx, swim_id_t id, swim_id_t to,
 	rc = 0;
 
 out_unlock:
+	/* the least transferred updates go first next time */
+	while ((item = TAILQ_FIRST(&sent)) != NULL) {
+		TAILQ_REMOVE(&sent, item, si_link);
+		swim_updates_insert(ctx, item);
+	}
 	swim_ctx_unlock(ctx);
 
 	if (rc) {
@@ -263,6 +395,10 @@ swim_updates_notify(struct swim_context *ctx, swim_id_t from, swim_id_t id,
 		if (item->si_id == id) {
 			item->si_from = from;
 			item->u.si_count = count;
+			if (swim_lifeguard) {
+				TAILQ_REMOVE(&ctx->sc_updates, item, si_link);
+				swim_updates_insert(ctx, item);
+			}
 			D_GOTO(update, 0);
 		}
 	}
@@ -275,7 +411,10 @@ swim_updates_notify(struct swim_context *ctx, swim_id_t from, swim_id_t id,
 		item->si_id   = id;
 		item->si_from = from;
 		item->u.si_count = count;
-		TAILQ_INSERT_HEAD(&ctx->sc_updates, item, si_link);
+		if (swim_lifeguard)
+			swim_updates_insert(ctx, item);
+		else
+			TAILQ_INSERT_HEAD(&ctx->sc_updates, item, si_link);
 	}
 update:
 	return ctx->sc_ops->set_member_state(ctx, id, id_state);
@@ -381,8 +520,52 @@ out:
 	return rc;
 }
 
+/* start (or restart) the suspicion of a member, told by \a from and originated by \a origin */
+static void
+swim_suspect_start(struct swim_context *ctx, struct swim_item *item, swim_id_t from,
+		   swim_id_t origin)
+{
+	item->si_from = from;
+	item->si_start = swim_now_ms();
+	item->si_suspecters[0] = origin;
+	item->si_nsuspecters = 1;
+	item->u.si_deadline = item->si_start + swim_suspect_deadline_len(ctx, item->si_nsuspecters);
+}
+
+/*
+ * Record an independent suspicion of an already suspected member, \a origin is
+ * the member which suspected it, not the one which relayed the suspicion.
+ */
+static void
+swim_suspect_confirm(struct swim_context *ctx, swim_id_t origin, swim_id_t id)
+{
+	struct swim_item	*item;
+	uint64_t		 deadline;
+	uint32_t		 i;
+
+	TAILQ_FOREACH(item, &ctx->sc_suspects, si_link) {
+		if (item->si_id != id)
+			continue;
+
+		if (item->si_nsuspecters > SWIM_SUSPECT_CONFIRMS)
+			return;
+		for (i = 0; i < item->si_nsuspecters; i++) {
+			if (item->si_suspecters[i] == origin)
+				return;
+		}
+		item->si_suspecters[item->si_nsuspecters++] = origin;
+
+		deadline = item->si_start + swim_suspect_deadline_len(ctx, item->si_nsuspecters);
+		if (deadline < item->u.si_deadline)
+			item->u.si_deadline = deadline;
+		SWIM_INFO("member %lu is SUSPECT by %u members\n", id, item->si_nsuspecters);
+		return;
+	}
+}
+
 static int
-swim_member_suspect(struct swim_context *ctx, swim_id_t from, swim_id_t id, uint64_t nr)
+swim_member_suspect(struct swim_context *ctx, swim_id_t from, swim_id_t origin, swim_id_t id,
+		    uint64_t nr)
 {
 	struct swim_member_state	 id_state;
 	struct swim_item		*item;
@@ -404,6 +587,13 @@ swim_member_suspect(struct swim_context *ctx, swim_id_t from, swim_id_t id, uint
 	if (nr > id_state.sms_incarnation)
 		D_GOTO(search, rc = 0);
 
+	/* an independent suspicion shortens the suspect timeout */
+	if (swim_lifeguard && id_state.sms_status == SWIM_MEMBER_SUSPECT &&
+	    id_state.sms_incarnation == nr) {
+		swim_suspect_confirm(ctx, origin, id);
+		D_GOTO(out, rc = -DER_ALREADY);
+	}
+
 	/* ignore old updates or updates for dead members */
 	if (id_state.sms_status == SWIM_MEMBER_DEAD ||
 	    id_state.sms_status == SWIM_MEMBER_SUSPECT ||
@@ -418,10 +608,8 @@ search:
 			 * if the new suspicion is of a newer incarnation,
 			 * reset the existing one
 			 */
-			if (nr > id_state.sms_incarnation) {
-				item->si_from = from;
-				item->u.si_deadline = swim_now_ms() + swim_suspect_timeout_get();
-			}
+			if (nr > id_state.sms_incarnation)
+				swim_suspect_start(ctx, item, from, origin);
 			goto update;
 		}
 	}
@@ -431,8 +619,7 @@ search:
 	if (item == NULL)
 		D_GOTO(out, rc = -DER_NOMEM);
 	item->si_id   = id;
-	item->si_from = from;
-	item->u.si_deadline = swim_now_ms() + swim_suspect_timeout_get();
+	swim_suspect_start(ctx, item, from, origin);
 	TAILQ_INSERT_TAIL(&ctx->sc_suspects, item, si_link);
 
 update:
@@ -462,6 +649,7 @@ swim_member_update_suspected(struct swim_context *ctx, uint64_t now, uint64_t ne
 	while (item != NULL) {
 		next = TAILQ_NEXT(item, si_link);
 		item->u.si_deadline += net_glitch_delay;
+		item->si_start += net_glitch_delay;
 		if (now > item->u.si_deadline) {
 			rc = ctx->sc_ops->get_member_state(ctx, item->si_id, &id_state);
 			if (rc || (id_state.sms_status != SWIM_MEMBER_SUSPECT)) {
@@ -735,6 +923,7 @@ swim_init(swim_id_t self_id, struct swim_ops *swim_ops, void *data)
 	swim_prot_period_len = swim_prot_period_len_default();
 	swim_suspect_timeout = swim_suspect_timeout_default();
 	swim_ping_timeout    = swim_ping_timeout_default();
+	swim_lifeguard       = swim_lifeguard_default();
 
 	ctx->sc_default_ping_timeout = swim_ping_timeout;
 
@@ -804,8 +993,10 @@ swim_net_glitch_update(struct swim_context *ctx, swim_id_t id, uint64_t delay)
 
 	/* update expire time of suspected members */
 	TAILQ_FOREACH(item, &ctx->sc_suspects, si_link) {
-		if (id == self_id || id == item->si_id)
+		if (id == self_id || id == item->si_id) {
 			item->u.si_deadline += delay;
+			item->si_start += delay;
+		}
 	}
 	/* update expire time of ipinged members */
 	TAILQ_FOREACH(item, &ctx->sc_ipings, si_link) {
@@ -905,7 +1096,9 @@ swim_progress(struct swim_context *ctx, int64_t timeout_us)
 		switch (ctx_state) {
 		case SCS_BEGIN:
 			if (now > ctx->sc_next_tick_time) {
-				uint64_t delay = swim_ping_delay(target_state.sms_delay);
+				uint64_t delay;
+
+				delay = swim_lhm_scale(ctx, swim_ping_delay(target_state.sms_delay));
 
 				target_id = ctx->sc_target;
 				sendto_id = ctx->sc_target;
@@ -917,7 +1110,7 @@ swim_progress(struct swim_context *ctx, int64_t timeout_us)
 					  target_state.sms_incarnation,
 					  target_state.sms_delay, delay);
 
-				ctx->sc_next_tick_time = now + swim_period_get();
+				ctx->sc_next_tick_time = now + swim_lhm_scale(ctx, swim_period_get());
 				ctx->sc_deadline = now + delay;
 				if (ctx->sc_deadline < ctx->sc_next_event)
 					ctx->sc_next_event = ctx->sc_deadline;
@@ -983,7 +1176,7 @@ swim_progress(struct swim_context *ctx, int64_t timeout_us)
 					goto done_item;
 				}
 
-				delay = swim_ping_delay(target_state.sms_delay);
+				delay = swim_lhm_scale(ctx, swim_ping_delay(target_state.sms_delay));
 
 				if (target_id != sendto_id) {
 					/* Send indirect ping request to ALIVE member only */
@@ -1028,8 +1221,11 @@ done_item:
 			if (now > ctx->sc_deadline) {
 				/* no response from indirect pings */
 				if (target_state.sms_status != SWIM_MEMBER_INACTIVE) {
+					/* failed probe, maybe we are slow ourselves */
+					swim_lhm_update(ctx, false);
 					/* suspect this member */
-					swim_member_suspect(ctx, ctx->sc_self, ctx->sc_target,
+					swim_member_suspect(ctx, ctx->sc_self, ctx->sc_self,
+							    ctx->sc_target,
 							    target_state.sms_incarnation);
 				}
 				ctx->sc_next_event = now;
@@ -1096,6 +1292,7 @@ swim_updates_parse(struct swim_context *ctx, swim_id_t from_id, swim_id_t id,
 	if ((from_id == ctx->sc_target || id == ctx->sc_target) &&
 	    (ctx_state == SCS_BEGIN || ctx_state == SCS_PINGED || ctx_state == SCS_IPINGED)) {
 		ctx_state = SCS_SELECT;
+		swim_lhm_update(ctx, true);
 		SWIM_INFO("target %lu %s okay\n", ctx->sc_target,
 			  from_id == id ? "dping" : "iping");
 	}
@@ -1148,6 +1345,8 @@ swim_updates_parse(struct swim_context *ctx, swim_id_t from_id, swim_id_t id,
 					   upds[i].smu_state.sms_incarnation,
 					   from_id);
 
+				/* refuting a suspicion on self, maybe we are slow */
+				swim_lhm_update(ctx, false);
 				ctx->sc_ops->new_incarnation(ctx, self_id, &self_state);
 				rc = swim_updates_notify(ctx, self_id, self_id, &self_state, 0);
 				if (rc) {
@@ -1160,7 +1359,9 @@ swim_updates_parse(struct swim_context *ctx, swim_id_t from_id, swim_id_t id,
 			}
 
 			if (upds[i].smu_state.sms_status == SWIM_MEMBER_SUSPECT)
-				swim_member_suspect(ctx, from_id, upd_id,
+				swim_member_suspect(ctx, from_id,
+						    upds[i].smu_origin != SWIM_ID_INVALID ?
+						    upds[i].smu_origin : from_id, upd_id,
 						    upds[i].smu_state.sms_incarnation);
 			else
 				swim_member_dead(ctx, from_id, upd_id,
@@ -1226,12 +1427,14 @@ swim_updates_short(struct swim_context *ctx, swim_id_t self_id, uint64_t self_in
 	upds[i].smu_state.sms_incarnation = self_state.sms_incarnation;
 	upds[i].smu_state.sms_status = SWIM_MEMBER_ALIVE;
 	upds[i].smu_state.sms_delay = 0;
+	upds[i].smu_origin = self_id;
 	upds[i++].smu_id = self_id;
 
 	if (id != self_id && id_upd != NULL) {
 		upds[i].smu_state.sms_incarnation = id_upd->smu_state.sms_incarnation;
 		upds[i].smu_state.sms_status = SWIM_MEMBER_ALIVE;
 		upds[i].smu_state.sms_delay = 0;
+		upds[i].smu_origin = self_id;
 		upds[i++].smu_id = id;
 	}
 
@@ -1244,6 +1447,17 @@ swim_updates_short(struct swim_context *ctx, swim_id_t self_id, uint64_t self_in
 	return 0;
 }
 
+void
+swim_member_count_set(struct swim_context *ctx, uint64_t count)
+{
+	if (ctx == NULL)
+		return;
+
+	ctx->sc_members = count;
+	if (swim_lifeguard)
+		ctx->sc_piggyback_tx_max = SWIM_PIGGYBACK_MULT * swim_members_log10(ctx);
+}
+
 void
 swim_member_del(struct swim_context *ctx, swim_id_t id)
 {
@@ -58,6 +58,19 @@ extern "C" {
 					 * updates.
 					 */
 
+/** Lifeguard (scalable mode) parameters, see SWIM_LIFEGUARD */
+#define SWIM_LHM_MAX		8	/**< max local health multiplier */
+#define SWIM_SUSPECT_MULT	4	/**< min suspect timeout in periods,
+					 * per log10 of the members count.
+					 */
+#define SWIM_SUSPECT_MAX_MULT	6	/**< max to min suspect timeout ratio */
+#define SWIM_SUSPECT_CONFIRMS	3	/**< count of independent suspicions to
+					 * reduce suspect timeout to the min.
+					 */
+#define SWIM_PIGGYBACK_MULT	4	/**< count of transfers of each update,
+					 * per log10 of the members count.
+					 */
+
 enum swim_context_state {
 	SCS_BEGIN = 0,		/**< initial state when next target was already
 				 * selected.
@@ -84,6 +97,10 @@ struct swim_item {
 		uint64_t	 si_deadline; /**< for sc_suspects/sc_ipings */
 		uint64_t	 si_count;    /**< for sc_updates */
 	} u;
+	/** for sc_suspects: start time and members which suspected it */
+	uint64_t		 si_start;
+	uint32_t		 si_nsuspecters;
+	swim_id_t		 si_suspecters[SWIM_SUSPECT_CONFIRMS + 1];
 };
 
 /** internal swim context implementation */
@@ -109,6 +126,8 @@ struct swim_context {
 	uint64_t		 sc_deadline;
 
 	uint64_t		 sc_piggyback_tx_max;
+	uint64_t		 sc_members;	/**< count of members */
+	uint32_t		 sc_lhm;	/**< local health multiplier */
 
 	unsigned int		 sc_glitch:1;
 };
@@ -209,6 +228,25 @@ void swim_ping_timeout_set(uint64_t val);
  */
 uint64_t swim_ping_timeout_get(void);
 
+/**
+ * Enable or disable the Lifeguard extensions for large systems: the ping
+ * timeouts and the protocol period are scaled by a local health multiplier
+ * to reduce false suspicions made by a member which is slow itself, the
+ * suspect timeout is scaled by log(N) and reduced by independent suspicions
+ * from other members, and the updates are piggybacked with priority to the
+ * least transferred ones.
+ *
+ * \param[in] val	true to enable
+ */
+void swim_lifeguard_set(bool val);
+
+/**
+ * Get whether the Lifeguard extensions are enabled.
+ *
+ * \return		true if enabled
+ */
+bool swim_lifeguard_get(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -128,6 +128,35 @@ daos_array_close(daos_handle_t oh, daos_event_t *ev)
 	return dc_task_schedule(task, true);
 }
 
+int
+daos_array_set_write_back(daos_handle_t oh, daos_size_t size, uint32_t max_age_ms)
+{
+	return dc_array_set_write_back(oh, size, max_age_ms);
+}
+
+int
+daos_array_set_read_ahead(daos_handle_t oh, daos_size_t size)
+{
+	return dc_array_set_read_ahead(oh, size);
+}
+
+int
+daos_array_flush(daos_handle_t oh, daos_event_t *ev)
+{
+	daos_array_flush_t	*args;
+	tse_task_t		*task;
+	int			 rc;
+
+	rc = dc_task_create(dc_array_flush, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->oh = oh;
+
+	return dc_task_schedule(task, true);
+}
+
 int
 daos_array_destroy(daos_handle_t oh, daos_handle_t th, daos_event_t *ev)
 {
@@ -82,18 +82,30 @@ daos_evx2ev(struct daos_event_private *evx)
 	return container_of(evx, struct daos_event, ev_private);
 }
 
+struct eq_progress_xs;
+
 struct daos_eq_private {
 	/* link chain in the global hash list */
 	struct d_hlink		eqx_hlink;
 	pthread_mutex_t		eqx_lock;
 	unsigned int		eqx_lock_init:1,
+				eqx_cond_init:1,
 				eqx_finalizing:1;
+	/* bumped under eqx_lock on every event completion of a serviced EQ */
+	uint32_t		eqx_comp_gen;
 
 	/* CRT context associated with this eq */
 	crt_context_t		eqx_ctx;
 
 	/* Scheduler associated with this EQ */
 	tse_sched_t		eqx_sched;
+
+	/* progress thread servicing this EQ, NULL if daos_eq_poll() progresses it */
+	struct eq_progress_xs	*eqx_xs;
+	/* link chain in the EQ list of eqx_xs */
+	d_list_t		eqx_xs_link;
+	/* waiters of a serviced EQ sleep here instead of progressing eqx_ctx */
+	pthread_cond_t		eqx_cond;
 };
 
 static inline struct daos_eq_private *
@@ -108,6 +120,73 @@ daos_eqx2eq(struct daos_eq_private *eqx)
 	return container_of(eqx, struct daos_eq, eq_private);
 }
 
+/**
+ * Start the pool of EQ progress threads if D_EQ_PROGRESS_THREADS is set. Each
+ * NUMA node gets that many threads, each pinned to the node and owning one
+ * CaRT context shared by all the EQs it services.
+ *
+ * \return		0 on success (including when the pool is disabled),
+ *			negative DER error otherwise.
+ */
+int
+daos_eq_progress_init(void);
+
+/** Stop the EQ progress threads and destroy their CaRT contexts. */
+void
+daos_eq_progress_fini(void);
+
+/**
+ * Attach a new EQ to the least loaded progress thread on the NUMA node of the
+ * calling thread, the EQ then uses the CaRT context of that thread.
+ *
+ * \param eqx [IN]	EQ being created.
+ *
+ * \return		true if the EQ is serviced by a progress thread,
+ *			false if the pool is disabled.
+ */
+bool
+daos_eq_progress_attach(struct daos_eq_private *eqx);
+
+/**
+ * Forget the progress threads of the parent in a forked child, without
+ * joining them or destroying their CaRT contexts.
+ */
+void
+daos_eq_progress_reset_after_fork(void);
+
+/**
+ * Wait until all in-flight tasks of a serviced EQ completed, then stop
+ * progressing it from the progress thread. A forced destroy waits too, the
+ * RPCs in flight on the shared CaRT context can't be aborted.
+ *
+ * \param eqx [IN]	EQ being destroyed.
+ */
+void
+daos_eq_progress_detach(struct daos_eq_private *eqx);
+
+/**
+ * Replacement of crt_progress_cond() for a serviced EQ: \a cond_cb is
+ * re-evaluated each time an event of the EQ completes, until it returns
+ * non-zero or \a timeout (in us, negative for infinite) expires.
+ *
+ * \return		0 if \a cond_cb returned a positive value,
+ *			-DER_TIMEDOUT on timeout, or the negative value
+ *			returned by \a cond_cb.
+ */
+int
+daos_eq_progress_cond(struct daos_eq_private *eqx, int64_t timeout,
+		      crt_progress_cond_cb_t cond_cb, void *arg);
+
+/** Wake up the waiters of a serviced EQ, called with eqx_lock held. */
+static inline void
+daos_eq_progress_signal(struct daos_eq_private *eqx)
+{
+	if (eqx->eqx_xs == NULL)
+		return;
+	eqx->eqx_comp_gen++;
+	pthread_cond_broadcast(&eqx->eqx_cond);
+}
+
 /**
  * Reset the private per-thread event.
  *
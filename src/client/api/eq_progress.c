@@ -0,0 +1,394 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/*
+ * This file is part of client DAOS library.
+ *
+ * client/eq_progress.c
+ *
+ * Optional pool of progress threads for event queues. By default every EQ owns
+ * a CaRT context which is only progressed by the threads polling the EQ. With
+ * D_EQ_PROGRESS_THREADS=N, N threads are started on each NUMA node, each one
+ * pinned to its node and owning a single CaRT context. EQs are spread over the
+ * threads of the NUMA node they are created on, their tasks and RPCs are then
+ * progressed by that thread, and daos_eq_poll() only waits for completions.
+ * This lets many application threads use their own lightweight EQ without a
+ * CaRT context (and endpoints) per EQ.
+ */
+#define D_LOGFAC	DD_FAC(client)
+
+#include <sched.h>
+#include <hwloc.h>
+#include "client_internal.h"
+
+/** timeout of crt_progress() in the progress threads, in us */
+#define EQ_PROGRESS_TIMEOUT	1000
+
+struct eq_progress_xs {
+	pthread_t		 ex_thread;
+	/* protect ex_eq_list and ex_eq_nr */
+	pthread_mutex_t		 ex_lock;
+	/* EQs serviced by this thread */
+	d_list_t		 ex_eq_list;
+	int			 ex_eq_nr;
+	/* referenced EQs progressed in the current round, only used by the thread */
+	struct daos_eq_private	**ex_eqs;
+	int			 ex_eqs_size;
+	/* CaRT context shared by all the EQs of this thread */
+	crt_context_t		 ex_ctx;
+	/* CPUs of the NUMA node the thread is pinned to */
+	hwloc_bitmap_t		 ex_cpuset;
+	int			 ex_numa;
+	ATOMIC bool		 ex_stop;
+	unsigned int		 ex_lock_init:1,
+				 ex_started:1;
+};
+
+static hwloc_topology_t		 eq_topo;
+static struct eq_progress_xs	*eq_xs;
+static int			 eq_xs_nr;
+
+/*
+ * Take a reference on each EQ of the thread, so that they can be progressed
+ * without holding ex_lock, which would block daos_eq_create() and
+ * daos_eq_destroy() for the whole round.
+ */
+static int
+eq_progress_collect(struct eq_progress_xs *xs)
+{
+	struct daos_eq_private	 *eqx;
+	struct daos_eq_private	**eqs;
+	int			  nr = 0;
+
+	D_MUTEX_LOCK(&xs->ex_lock);
+	if (xs->ex_eq_nr > xs->ex_eqs_size) {
+		D_REALLOC_ARRAY(eqs, xs->ex_eqs, xs->ex_eqs_size, xs->ex_eq_nr);
+		if (eqs == NULL) {
+			/* progress what fits, the others are picked up by the next round */
+			D_WARN("failed to grow the EQ array of progress thread %d\n",
+			       (int)(xs - eq_xs));
+		} else {
+			xs->ex_eqs = eqs;
+			xs->ex_eqs_size = xs->ex_eq_nr;
+		}
+	}
+
+	d_list_for_each_entry(eqx, &xs->ex_eq_list, eqx_xs_link) {
+		if (nr == xs->ex_eqs_size)
+			break;
+		daos_hhash_link_getref(&eqx->eqx_hlink);
+		xs->ex_eqs[nr++] = eqx;
+	}
+	D_MUTEX_UNLOCK(&xs->ex_lock);
+
+	return nr;
+}
+
+static void *
+eq_progress_thread(void *arg)
+{
+	struct eq_progress_xs	*xs = arg;
+	struct daos_eq_private	*eqx;
+	int			 nr;
+	int			 i;
+	int			 rc;
+
+	rc = hwloc_set_cpubind(eq_topo, xs->ex_cpuset, HWLOC_CPUBIND_THREAD);
+	if (rc != 0)
+		D_WARN("failed to bind EQ progress thread to NUMA node %d\n", xs->ex_numa);
+
+	while (!atomic_load_relaxed(&xs->ex_stop)) {
+		rc = crt_progress(xs->ex_ctx, EQ_PROGRESS_TIMEOUT);
+		if (rc != 0 && rc != -DER_TIMEDOUT)
+			D_ERROR("failed to progress EQ context: "DF_RC"\n", DP_RC(rc));
+
+		nr = eq_progress_collect(xs);
+		for (i = 0; i < nr; i++) {
+			eqx = xs->ex_eqs[i];
+			tse_sched_progress(&eqx->eqx_sched);
+
+			/* daos_eq_progress_detach() waits for the tasks of a finalizing EQ */
+			D_MUTEX_LOCK(&eqx->eqx_lock);
+			if (eqx->eqx_finalizing)
+				daos_eq_progress_signal(eqx);
+			D_MUTEX_UNLOCK(&eqx->eqx_lock);
+
+			daos_hhash_link_putref(&eqx->eqx_hlink);
+		}
+	}
+
+	return NULL;
+}
+
+int
+daos_eq_progress_init(void)
+{
+	struct eq_progress_xs	*xs;
+	hwloc_obj_t		 numa;
+	uint32_t		 per_numa = 0;
+	int			 numa_nr;
+	int			 depth;
+	int			 i;
+	int			 rc;
+
+	d_getenv_uint32_t("D_EQ_PROGRESS_THREADS", &per_numa);
+	if (per_numa == 0)
+		return 0;
+
+	rc = hwloc_topology_init(&eq_topo);
+	if (rc != 0) {
+		D_ERROR("failed to init hwloc topology\n");
+		return -DER_INVAL;
+	}
+
+	rc = hwloc_topology_load(eq_topo);
+	if (rc != 0) {
+		D_ERROR("failed to load hwloc topology\n");
+		D_GOTO(out_topo, rc = -DER_INVAL);
+	}
+
+	depth = hwloc_get_type_depth(eq_topo, HWLOC_OBJ_NUMANODE);
+	numa_nr = hwloc_get_nbobjs_by_depth(eq_topo, depth);
+	if (numa_nr <= 0)
+		numa_nr = 1;
+
+	D_ALLOC_ARRAY(eq_xs, numa_nr * per_numa);
+	if (eq_xs == NULL)
+		D_GOTO(out_topo, rc = -DER_NOMEM);
+
+	for (i = 0; i < numa_nr * per_numa; i++) {
+		xs = &eq_xs[i];
+		eq_xs_nr++;
+
+		xs->ex_numa = i / per_numa;
+		D_INIT_LIST_HEAD(&xs->ex_eq_list);
+		rc = D_MUTEX_INIT(&xs->ex_lock, NULL);
+		if (rc != 0)
+			D_GOTO(out_xs, rc);
+		xs->ex_lock_init = 1;
+
+		numa = hwloc_get_obj_by_depth(eq_topo, depth, xs->ex_numa);
+		if (numa != NULL)
+			xs->ex_cpuset = hwloc_bitmap_dup(numa->cpuset);
+		else
+			xs->ex_cpuset = hwloc_bitmap_dup(hwloc_topology_get_topology_cpuset(eq_topo));
+		if (xs->ex_cpuset == NULL)
+			D_GOTO(out_xs, rc = -DER_NOMEM);
+
+		rc = crt_context_create(&xs->ex_ctx);
+		if (rc != 0) {
+			D_ERROR("failed to create EQ progress context: "DF_RC"\n", DP_RC(rc));
+			D_GOTO(out_xs, rc);
+		}
+
+		rc = pthread_create(&xs->ex_thread, NULL, eq_progress_thread, xs);
+		if (rc != 0) {
+			D_ERROR("failed to create EQ progress thread: %d\n", rc);
+			D_GOTO(out_xs, rc = daos_errno2der(rc));
+		}
+		xs->ex_started = 1;
+	}
+
+	D_INFO("started %u EQ progress threads on each of %d NUMA nodes\n", per_numa, numa_nr);
+	return 0;
+
+out_xs:
+	daos_eq_progress_fini();
+	return rc;
+out_topo:
+	hwloc_topology_destroy(eq_topo);
+	return rc;
+}
+
+void
+daos_eq_progress_fini(void)
+{
+	struct eq_progress_xs	*xs;
+	int			 rc;
+	int			 i;
+
+	if (eq_xs == NULL)
+		return;
+
+	for (i = 0; i < eq_xs_nr; i++) {
+		xs = &eq_xs[i];
+
+		if (xs->ex_started) {
+			atomic_store_relaxed(&xs->ex_stop, true);
+			pthread_join(xs->ex_thread, NULL);
+		}
+		if (xs->ex_eq_nr > 0)
+			D_WARN("%d EQs still attached to progress thread %d\n", xs->ex_eq_nr, i);
+
+		if (xs->ex_ctx != NULL) {
+			rc = crt_context_destroy(xs->ex_ctx, 1 /* force */);
+			if (rc != 0)
+				D_ERROR("failed to destroy EQ progress context: "DF_RC"\n",
+					DP_RC(rc));
+		}
+		if (xs->ex_cpuset != NULL)
+			hwloc_bitmap_free(xs->ex_cpuset);
+		if (xs->ex_lock_init)
+			D_MUTEX_DESTROY(&xs->ex_lock);
+		D_FREE(xs->ex_eqs);
+	}
+
+	D_FREE(eq_xs);
+	eq_xs_nr = 0;
+	hwloc_topology_destroy(eq_topo);
+}
+
+void
+daos_eq_progress_reset_after_fork(void)
+{
+	int	i;
+
+	if (eq_xs == NULL)
+		return;
+
+	/*
+	 * The threads didn't survive fork(), and their locks may have been held
+	 * by them, only release the memory. The CaRT contexts go away with the
+	 * CaRT state of the parent.
+	 */
+	for (i = 0; i < eq_xs_nr; i++) {
+		if (eq_xs[i].ex_cpuset != NULL)
+			hwloc_bitmap_free(eq_xs[i].ex_cpuset);
+		D_FREE(eq_xs[i].ex_eqs);
+	}
+
+	D_FREE(eq_xs);
+	eq_xs_nr = 0;
+	hwloc_topology_destroy(eq_topo);
+}
+
+bool
+daos_eq_progress_attach(struct daos_eq_private *eqx)
+{
+	struct eq_progress_xs	*xs = NULL;
+	pthread_condattr_t	 attr;
+	int			 cpu;
+	int			 i;
+	int			 rc;
+
+	if (eq_xs == NULL)
+		return false;
+
+	/* waiters use the monotonic clock of d_gettime() for their deadline */
+	rc = pthread_condattr_init(&attr);
+	if (rc == 0) {
+		pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+		rc = pthread_cond_init(&eqx->eqx_cond, &attr);
+		pthread_condattr_destroy(&attr);
+	}
+	if (rc != 0) {
+		D_WARN("failed to init EQ condition, progress it from the poller: %d\n", rc);
+		return false;
+	}
+	eqx->eqx_cond_init = 1;
+
+	/*
+	 * Least loaded thread of the local NUMA node, or of all the nodes if the
+	 * CPU is unknown. ex_eq_nr is read unlocked, balancing is best effort.
+	 */
+	cpu = sched_getcpu();
+	for (i = 0; i < eq_xs_nr; i++) {
+		if (cpu >= 0 && !hwloc_bitmap_isset(eq_xs[i].ex_cpuset, cpu))
+			continue;
+		if (xs == NULL || eq_xs[i].ex_eq_nr < xs->ex_eq_nr)
+			xs = &eq_xs[i];
+	}
+	if (xs == NULL) {
+		xs = &eq_xs[0];
+		for (i = 1; i < eq_xs_nr; i++) {
+			if (eq_xs[i].ex_eq_nr < xs->ex_eq_nr)
+				xs = &eq_xs[i];
+		}
+	}
+
+	/* completions are drained by the progress thread, see tse_sched_set_comp_queue() */
+	tse_sched_set_comp_queue(&eqx->eqx_sched, true);
+
+	eqx->eqx_ctx = xs->ex_ctx;
+	eqx->eqx_xs  = xs;
+	D_MUTEX_LOCK(&xs->ex_lock);
+	d_list_add_tail(&eqx->eqx_xs_link, &xs->ex_eq_list);
+	xs->ex_eq_nr++;
+	D_MUTEX_UNLOCK(&xs->ex_lock);
+
+	D_DEBUG(DB_TRACE, "EQ %p serviced by progress thread %d (NUMA %d) on cpu %d\n", eqx,
+		(int)(xs - eq_xs), xs->ex_numa, cpu);
+	return true;
+}
+
+void
+daos_eq_progress_detach(struct daos_eq_private *eqx)
+{
+	struct eq_progress_xs *xs = eqx->eqx_xs;
+
+	D_ASSERT(xs != NULL);
+
+	/*
+	 * The progress thread completes the RPCs in flight, like crt_context_flush()
+	 * would, and wakes us up after each round on this finalizing EQ. This is
+	 * also needed by a forced destroy: the shared context can't be destroyed to
+	 * abort the RPCs, and their callbacks still reference the tasks of the EQ.
+	 */
+	D_MUTEX_LOCK(&eqx->eqx_lock);
+	while (!tse_sched_check_complete(&eqx->eqx_sched))
+		pthread_cond_wait(&eqx->eqx_cond, &eqx->eqx_lock);
+	D_MUTEX_UNLOCK(&eqx->eqx_lock);
+
+	D_MUTEX_LOCK(&xs->ex_lock);
+	d_list_del_init(&eqx->eqx_xs_link);
+	xs->ex_eq_nr--;
+	D_MUTEX_UNLOCK(&xs->ex_lock);
+}
+
+int
+daos_eq_progress_cond(struct daos_eq_private *eqx, int64_t timeout,
+		      crt_progress_cond_cb_t cond_cb, void *arg)
+{
+	struct timespec	deadline;
+	uint32_t	gen;
+	int		rc;
+
+	if (timeout > 0) {
+		d_gettime(&deadline);
+		d_timeinc(&deadline, timeout * NSEC_PER_USEC);
+	}
+
+	while (1) {
+		/* sample the generation first so a completion racing cond_cb() is not missed */
+		D_MUTEX_LOCK(&eqx->eqx_lock);
+		gen = eqx->eqx_comp_gen;
+		D_MUTEX_UNLOCK(&eqx->eqx_lock);
+
+		rc = cond_cb(arg);
+		if (rc != 0)
+			return rc > 0 ? 0 : rc;
+		if (timeout == 0)
+			return -DER_TIMEDOUT;
+
+		D_MUTEX_LOCK(&eqx->eqx_lock);
+		while (rc == 0 && gen == eqx->eqx_comp_gen) {
+			if (timeout < 0)
+				rc = pthread_cond_wait(&eqx->eqx_cond, &eqx->eqx_lock);
+			else
+				rc = pthread_cond_timedwait(&eqx->eqx_cond, &eqx->eqx_lock,
+							    &deadline);
+		}
+		D_MUTEX_UNLOCK(&eqx->eqx_lock);
+
+		if (rc == ETIMEDOUT) {
+			/* try callback one last time just in case */
+			rc = cond_cb(arg);
+			if (rc != 0)
+				return rc > 0 ? 0 : rc;
+			return -DER_TIMEDOUT;
+		}
+		D_ASSERTF(rc == 0, "pthread_cond_wait failed: %d\n", rc);
+	}
+}
@@ -26,6 +26,12 @@ static __thread bool		ev_thpriv_is_init;
  */
 static uint32_t ev_prog_timeout;
 
+/**
+ * Complete tasks of EQ schedulers through the lock-free completion queue,
+ * useful when many threads share one EQ (D_EQ_COMP_QUEUE).
+ */
+static bool eq_comp_queue;
+
 #define EQ_WITH_CRT
 
 #if !defined(EQ_WITH_CRT)
@@ -90,18 +96,25 @@ daos_eq_lib_init()
 		D_GOTO(crt, rc);
 	}
 
+	rc = daos_eq_progress_init();
+	if (rc != 0)
+		D_GOTO(crt, rc);
+
 	/** set up scheduler for non-eq events */
 	rc = tse_sched_init(&daos_sched_g, NULL, daos_eq_ctx);
 	if (rc != 0)
-		D_GOTO(crt, rc);
+		D_GOTO(progress, rc);
 
 	eq_ref = 1;
 
 	d_getenv_uint32_t("D_POLL_TIMEOUT", &ev_prog_timeout);
+	d_getenv_bool("D_EQ_COMP_QUEUE", &eq_comp_queue);
 
 unlock:
 	D_MUTEX_UNLOCK(&daos_eq_lock);
 	return rc;
+progress:
+	daos_eq_progress_fini();
 crt:
 	crt_finalize();
 	D_GOTO(unlock, rc);
@@ -112,6 +125,7 @@ daos_eq_lib_reset_after_fork(void)
 {
 	eq_ref            = 0;
 	ev_thpriv_is_init = false;
+	daos_eq_progress_reset_after_fork();
 	return daos_eq_lib_init();
 }
 
@@ -140,6 +154,7 @@ daos_eq_lib_fini()
 	ev_thpriv_is_init = false;
 
 	tse_sched_complete(&daos_sched_g, 0, true);
+	daos_eq_progress_fini();
 
 	rc = crt_finalize();
 	if (rc != 0) {
@@ -169,6 +184,8 @@ daos_eq_free(struct d_hlink *hlink)
 
 	if (eqx->eqx_lock_init)
 		D_MUTEX_DESTROY(&eqx->eqx_lock);
+	if (eqx->eqx_cond_init)
+		pthread_cond_destroy(&eqx->eqx_cond);
 
 	D_FREE(eq);
 }
@@ -190,6 +207,8 @@ daos_eq_alloc(void)
 	struct daos_eq_private	*eqx;
 	int			rc;
 
+	D_CASSERT(sizeof(eq->eq_private) >= sizeof(*eqx));
+
 	D_ALLOC_PTR(eq);
 	if (eq == NULL)
 		return NULL;
@@ -340,8 +359,10 @@ daos_event_complete_locked(struct daos_eq_private *eqx,
 	struct daos_eq			*eq = NULL;
 	daos_event_t			*ev = daos_evx2ev(evx);
 
-	if (eqx != NULL)
+	if (eqx != NULL) {
 		eq = daos_eqx2eq(eqx);
+		daos_eq_progress_signal(eqx);
+	}
 
 	rc = daos_event_complete_cb(evx, rc);
 	if (evx->is_errno)
@@ -526,7 +547,9 @@ ev_progress_cb(void *arg)
 	struct daos_eq_private		*eqx = epa->eqx;
 	int				rc;
 
-	tse_sched_progress(evx->evx_sched);
+	/** the progress thread of a serviced EQ runs the scheduler */
+	if (eqx == NULL || eqx->eqx_xs == NULL)
+		tse_sched_progress(evx->evx_sched);
 
 	if (daos_handle_is_inval(evx->evx_eqh))
 		D_MUTEX_LOCK(&evx->evx_lock);
@@ -605,7 +628,10 @@ daos_event_test(struct daos_event *ev, int64_t timeout, bool *flag)
 	}
 
 	/* pass the timeout to crt_progress() with a conditional callback */
-	rc = crt_progress_cond(evx->evx_ctx, timeout, ev_progress_cb, &epa);
+	if (epa.eqx != NULL && epa.eqx->eqx_xs != NULL)
+		rc = daos_eq_progress_cond(epa.eqx, timeout, ev_progress_cb, &epa);
+	else
+		rc = crt_progress_cond(evx->evx_ctx, timeout, ev_progress_cb, &epa);
 
 	/** drop ref grabbed in daos_eq_lookup() */
 	if (epa.eqx)
@@ -645,19 +671,30 @@ daos_eq_create(daos_handle_t *eqh)
 
 	eqx = daos_eq2eqx(eq);
 
-	rc = crt_context_create(&eqx->eqx_ctx);
-	if (rc) {
-		D_WARN("Failed to create CART context; using the global one, "DF_RC"\n", DP_RC(rc));
-		eqx->eqx_ctx = daos_eq_ctx;
+	rc = tse_sched_init(&eqx->eqx_sched, NULL, NULL);
+	if (rc != 0) {
+		daos_eq_free(&eqx->eqx_hlink);
+		return rc;
 	}
 
+	/** EQs serviced by a progress thread share the CART context of that thread */
+	if (!daos_eq_progress_attach(eqx)) {
+		rc = crt_context_create(&eqx->eqx_ctx);
+		if (rc) {
+			D_WARN("Failed to create CART context; using the global one, "DF_RC"\n",
+			       DP_RC(rc));
+			eqx->eqx_ctx = daos_eq_ctx;
+		}
+		if (eq_comp_queue)
+			tse_sched_set_comp_queue(&eqx->eqx_sched, true);
+	}
+	eqx->eqx_sched.ds_udata = eqx->eqx_ctx;
+
 	daos_eq_insert(eqx);
 	daos_eq_handle(eqx, eqh);
 
-	rc = tse_sched_init(&eqx->eqx_sched, NULL, eqx->eqx_ctx);
-
 	daos_eq_putref(eqx);
-	return rc;
+	return 0;
 }
 
 struct eq_progress_arg {
@@ -679,7 +716,9 @@ eq_progress_cb(void *arg)
 
 	eq = daos_eqx2eq(epa->eqx);
 
-	tse_sched_progress(&epa->eqx->eqx_sched);
+	/** the progress thread of a serviced EQ runs the scheduler */
+	if (epa->eqx->eqx_xs == NULL)
+		tse_sched_progress(&epa->eqx->eqx_sched);
 
 	D_MUTEX_LOCK(&epa->eqx->eqx_lock);
 	d_list_for_each_entry_safe(evx, tmp, &eq->eq_comp, evx_link) {
@@ -755,7 +794,10 @@ daos_eq_poll(daos_handle_t eqh, int wait_running, int64_t timeout,
 	epa.count	= 0;
 
 	/* pass the timeout to crt_progress() with a conditional callback */
-	rc = crt_progress_cond(epa.eqx->eqx_ctx, timeout, eq_progress_cb, &epa);
+	if (epa.eqx->eqx_xs != NULL)
+		rc = daos_eq_progress_cond(epa.eqx, timeout, eq_progress_cb, &epa);
+	else
+		rc = crt_progress_cond(epa.eqx->eqx_ctx, timeout, eq_progress_cb, &epa);
 
 	/* drop ref grabbed in daos_eq_lookup() */
 	daos_eq_putref(epa.eqx);
@@ -868,11 +910,15 @@ daos_eq_destroy(daos_handle_t eqh, int flags)
 
 	/* prevent other threads to launch new event */
 	eqx->eqx_finalizing = 1;
+	/* and wake up the waiters of a serviced EQ */
+	daos_eq_progress_signal(eqx);
 
 	D_MUTEX_UNLOCK(&eqx->eqx_lock);
 
 	/** Flush the tasks for this EQ */
-	if (eqx->eqx_ctx != NULL) {
+	if (eqx->eqx_xs != NULL) {
+		daos_eq_progress_detach(eqx);
+	} else if (eqx->eqx_ctx != NULL) {
 		rc = crt_context_flush(eqx->eqx_ctx, 0);
 		if (rc != 0) {
 			D_ERROR("failed to flush client context: "DF_RC"\n", DP_RC(rc));
@@ -903,8 +949,8 @@ daos_eq_destroy(daos_handle_t eqh, int flags)
 
 	tse_sched_complete(&eqx->eqx_sched, rc, true);
 
-	/** destroy the EQ cart context only if it's not the global one */
-	if (eqx->eqx_ctx != daos_eq_ctx) {
+	/** destroy the EQ cart context only if it's not the global or a shared one */
+	if (eqx->eqx_ctx != daos_eq_ctx && eqx->eqx_xs == NULL) {
 		rc = crt_context_destroy(eqx->eqx_ctx, (flags & DAOS_EQ_DESTROY_FORCE));
 		if (rc) {
 			D_ERROR("Failed to destroy CART context for EQ: " DF_RC "\n", DP_RC(rc));
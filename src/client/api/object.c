@@ -170,6 +170,30 @@ daos_obj_fetch(daos_handle_t oh, daos_handle_t th, uint64_t flags,
 	return dc_task_schedule(task, true);
 }
 
+int
+daos_obj_fetch_multi(daos_handle_t th, uint64_t flags, unsigned int nr,
+		     daos_obj_fetch_req_t *reqs, daos_event_t *ev)
+{
+	daos_obj_fetch_multi_t	*args;
+	tse_task_t		*task;
+	int			 rc;
+
+	if (nr == 0 || reqs == NULL)
+		return -DER_INVAL;
+
+	rc = dc_task_create(dc_obj_fetch_multi, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->th	= th;
+	args->flags	= flags;
+	args->nr	= nr;
+	args->reqs	= reqs;
+
+	return dc_task_schedule(task, true);
+}
+
 int
 daos_obj_update(daos_handle_t oh, daos_handle_t th, uint64_t flags,
 		daos_key_t *dkey, unsigned int nr, daos_iod_t *iods,
@@ -1272,6 +1272,14 @@ eq_ut_setup(void **state)
 	return rc;
 }
 
+/** same tests with the EQs serviced by progress threads */
+static int
+eq_ut_setup_progress(void **state)
+{
+	d_setenv("D_EQ_PROGRESS_THREADS", "1", 1);
+	return eq_ut_setup(state);
+}
+
 static int
 eq_ut_teardown(void **state)
 {
@@ -1282,6 +1290,14 @@ eq_ut_teardown(void **state)
 	return 0;
 }
 
+static int
+eq_ut_teardown_progress(void **state)
+{
+	eq_ut_teardown(state);
+	d_unsetenv("D_EQ_PROGRESS_THREADS");
+	return 0;
+}
+
 static const struct CMUnitTest eq_uts[] = {
 	{ "EQ_Test_1", eq_test_1, NULL, NULL},
 	{ "EQ_Test_2", eq_test_2, NULL, NULL},
@@ -1297,8 +1313,13 @@ static const struct CMUnitTest eq_uts[] = {
 
 int main(int argc, char **argv)
 {
+	int rc;
+
 	d_register_alt_assert(mock_assert);
 
-	return cmocka_run_group_tests_name("Event Queue unit tests", eq_uts,
-					   eq_ut_setup, eq_ut_teardown);
+	rc = cmocka_run_group_tests_name("Event Queue unit tests", eq_uts,
+					 eq_ut_setup, eq_ut_teardown);
+	rc += cmocka_run_group_tests_name("Event Queue progress thread unit tests", eq_uts,
+					  eq_ut_setup_progress, eq_ut_teardown_progress);
+	return rc;
 }
@@ -40,6 +40,41 @@ struct dc_array {
 	unsigned int		mode;
 	/** Is this a byte array (set short fetch & memset holes to 0 */
 	bool			byte_array;
+	/** protects the write-back state below */
+	pthread_mutex_t		wb_lock;
+	/** max bytes buffered by write-back, 0 if write-back is disabled */
+	daos_size_t		wb_size;
+	/** max age (usec) of buffered data, 0 for no limit */
+	uint64_t		wb_age;
+	/** time (usec) the oldest buffered extent was written */
+	uint64_t		wb_stamp;
+	/** dkey all buffered extents belong to */
+	uint64_t		wb_dkey;
+	/** buffered extents, their data is packed in wb_buf in the same order */
+	daos_recx_t		*wb_recxs;
+	unsigned int		wb_nr;
+	char			*wb_buf;
+	daos_size_t		wb_bytes;
+	/** last flush in flight, later flushes and other operations depend on it */
+	tse_task_t		*wb_flush;
+	/** error of a background flush, returned by the next operation */
+	int			wb_err;
+	/** protects the read-ahead state below */
+	pthread_mutex_t		ra_lock;
+	/** max bytes cached by read-ahead, 0 if read-ahead is disabled */
+	daos_size_t		ra_size;
+	/** cached or in-flight extents (struct array_ra_ext), their number and size */
+	d_list_t		ra_list;
+	unsigned int		ra_nr;
+	daos_size_t		ra_bytes;
+	/** index and length of the last read, and stride from the one before */
+	daos_off_t		ra_last_idx;
+	daos_size_t		ra_last_len;
+	daos_size_t		ra_stride;
+	/** number of consecutive reads at the same stride */
+	unsigned int		ra_hits;
+	/** first index found past the end of the array by a prefetch */
+	daos_off_t		ra_eof;
 };
 
 struct md_params {
@@ -69,6 +104,91 @@ struct io_params {
 	char			akey_val;
 };
 
+/** Extent prefetched by read-ahead */
+struct array_ra_ext {
+	/** link chain in dc_array::ra_list */
+	d_list_t		re_link;
+	struct dc_array		*re_array;
+	/** prefetch task, NULL once it completed */
+	tse_task_t		*re_task;
+	/** records that were actually read, valid once the prefetch completed */
+	daos_size_t		re_nr_read;
+	/** dropped from the cache while the prefetch was in flight */
+	bool			re_stale;
+	daos_array_iod_t	re_iod;
+	daos_range_t		re_rg;
+	d_sg_list_t		re_sgl;
+	d_iov_t			re_iov;
+};
+
+static void
+array_ra_ext_free(struct array_ra_ext *ext)
+{
+	D_FREE(ext->re_iov.iov_buf);
+	D_FREE(ext);
+}
+
+/* Drop an extent from the read-ahead cache. Called with ra_lock held. */
+static void
+array_ra_ext_drop(struct dc_array *array, struct array_ra_ext *ext)
+{
+	d_list_del_init(&ext->re_link);
+	array->ra_nr--;
+	array->ra_bytes -= ext->re_iov.iov_buf_len;
+	if (ext->re_task != NULL)
+		ext->re_stale = true;
+	else
+		array_ra_ext_free(ext);
+}
+
+/* Drop everything cached by read-ahead, called on any modification through the handle */
+static void
+array_ra_invalidate(struct dc_array *array)
+{
+	struct array_ra_ext	*ext;
+	struct array_ra_ext	*tmp;
+
+	if (d_list_empty(&array->ra_list))
+		return;
+
+	D_MUTEX_LOCK(&array->ra_lock);
+	d_list_for_each_entry_safe(ext, tmp, &array->ra_list, re_link)
+		array_ra_ext_drop(array, ext);
+	array->ra_hits	= 0;
+	array->ra_eof	= UINT64_MAX;
+	D_MUTEX_UNLOCK(&array->ra_lock);
+}
+
+static int
+array_ra_invalidate_cb(tse_task_t *task, void *data)
+{
+	struct dc_array *array = *((struct dc_array **)data);
+
+	array_ra_invalidate(array);
+	daos_hhash_link_putref(&array->hlink);
+	return task->dt_result;
+}
+
+/*
+ * Drop the read-ahead cache before \a task modifies the array, and again once it completes so
+ * nothing prefetched while the modification was in flight is served afterwards.
+ */
+static int
+array_ra_invalidate_task(struct dc_array *array, tse_task_t *task)
+{
+	int rc;
+
+	if (array->ra_size == 0)
+		return 0;
+
+	array_ra_invalidate(array);
+	daos_hhash_link_getref(&array->hlink);
+	rc = tse_task_register_comp_cb(task, array_ra_invalidate_cb, &array, sizeof(array));
+	if (rc)
+		daos_hhash_link_putref(&array->hlink);
+	return rc;
+}
+
 static void
 array_free(struct d_hlink *hlink)
 {
@@ -76,6 +196,13 @@ array_free(struct d_hlink *hlink)
 
 	array = container_of(hlink, struct dc_array, hlink);
 	D_ASSERT(daos_hhash_link_empty(&array->hlink));
+	D_ASSERT(array->wb_flush == NULL);
+	array_ra_invalidate(array);
+	D_ASSERT(d_list_empty(&array->ra_list));
+	D_MUTEX_DESTROY(&array->ra_lock);
+	D_MUTEX_DESTROY(&array->wb_lock);
+	D_FREE(array->wb_recxs);
+	D_FREE(array->wb_buf);
 	D_FREE(array);
 }
 
@@ -92,6 +219,18 @@ array_alloc(void)
 	if (array == NULL)
 		return NULL;
 
+	if (D_MUTEX_INIT(&array->wb_lock, NULL) != 0) {
+		D_FREE(array);
+		return NULL;
+	}
+	if (D_MUTEX_INIT(&array->ra_lock, NULL) != 0) {
+		D_MUTEX_DESTROY(&array->wb_lock);
+		D_FREE(array);
+		return NULL;
+	}
+	D_INIT_LIST_HEAD(&array->ra_list);
+	array->ra_eof = UINT64_MAX;
+
 	daos_hhash_hlink_init(&array->hlink, &array_h_ops);
 	return array;
 }
@@ -135,6 +274,311 @@ array_hdl_unlink(struct dc_array *array)
 	daos_hhash_link_delete(&array->hlink);
 }
 
+/** Max number of disjoint extents buffered by write-back before a flush */
+#define ARRAY_WB_EXTS_MAX	64
+
+struct wb_flush_params {
+	struct dc_array		*array;
+	daos_key_t		dkey;
+	uint64_t		dkey_val;
+	char			akey_val;
+	daos_iod_t		iod;
+	d_sg_list_t		sgl;
+	d_iov_t			sg_iov;
+};
+
+static int
+array_wb_flush_cb(tse_task_t *task, void *data)
+{
+	struct wb_flush_params	*fp = *((struct wb_flush_params **)data);
+	struct dc_array		*array = fp->array;
+	bool			put = false;
+	int			rc = task->dt_result;
+
+	D_MUTEX_LOCK(&array->wb_lock);
+	if (rc != 0) {
+		D_ERROR("Write-back flush of dkey "DF_U64" failed: "DF_RC"\n", fp->dkey_val,
+			DP_RC(rc));
+		if (array->wb_err == 0)
+			array->wb_err = rc;
+	}
+	if (array->wb_flush == task) {
+		array->wb_flush = NULL;
+		put = true;
+	}
+	D_MUTEX_UNLOCK(&array->wb_lock);
+
+	if (put)
+		tse_task_decref(task);
+	D_FREE(fp->iod.iod_recxs);
+	D_FREE(fp->sg_iov.iov_buf);
+	array_decref(array);
+	D_FREE(fp);
+	return rc;
+}
+
+/*
+ * Hand the buffered extents over to a new update task, ordered after the flush already in
+ * flight if any. The task is returned in \a taskp and has to be scheduled by the caller after
+ * dropping wb_lock. Called with wb_lock held.
+ */
+static int
+array_wb_flush_locked(struct dc_array *array, tse_sched_t *sched, tse_task_t **taskp)
+{
+	struct wb_flush_params	*fp;
+	daos_obj_update_t	*io_arg;
+	tse_task_t		*flush_task;
+	int			rc;
+
+	*taskp = NULL;
+	if (array->wb_nr == 0)
+		return 0;
+
+	D_ALLOC_PTR(fp);
+	if (fp == NULL)
+		return -DER_NOMEM;
+
+	rc = daos_task_create(DAOS_OPC_OBJ_UPDATE, sched, array->wb_flush ? 1 : 0,
+			      array->wb_flush ? &array->wb_flush : NULL, &flush_task);
+	if (rc != 0) {
+		D_ERROR("Failed to create write-back flush task "DF_RC"\n", DP_RC(rc));
+		D_FREE(fp);
+		return rc;
+	}
+
+	fp->array	= array;
+	fp->dkey_val	= array->wb_dkey;
+	fp->akey_val	= '0';
+	d_iov_set(&fp->dkey, &fp->dkey_val, sizeof(uint64_t));
+	d_iov_set(&fp->iod.iod_name, &fp->akey_val, 1);
+	fp->iod.iod_type	= DAOS_IOD_ARRAY;
+	fp->iod.iod_size	= array->cell_size;
+	fp->iod.iod_nr		= array->wb_nr;
+	fp->iod.iod_recxs	= array->wb_recxs;
+	d_iov_set(&fp->sg_iov, array->wb_buf, array->wb_bytes);
+	fp->sgl.sg_nr		= 1;
+	fp->sgl.sg_iovs		= &fp->sg_iov;
+
+	io_arg = daos_task_get_args(flush_task);
+	io_arg->oh	= array->daos_oh;
+	io_arg->th	= DAOS_TX_NONE;
+	io_arg->dkey	= &fp->dkey;
+	io_arg->nr	= 1;
+	io_arg->iods	= &fp->iod;
+	io_arg->sgls	= &fp->sgl;
+
+	rc = tse_task_register_comp_cb(flush_task, array_wb_flush_cb, &fp, sizeof(fp));
+	if (rc != 0) {
+		tse_task_complete(flush_task, rc);
+		D_FREE(fp);
+		return rc;
+	}
+
+	D_DEBUG(DB_IO, "Flushing %u extents, %zu bytes in dkey "DF_U64"\n", array->wb_nr,
+		array->wb_bytes, array->wb_dkey);
+
+	/** the flush task owns the buffer now, and holds a ref on the array until it's done */
+	daos_hhash_link_getref(&array->hlink);
+	tse_task_addref(flush_task);
+	if (array->wb_flush)
+		tse_task_decref(array->wb_flush);
+	array->wb_flush	= flush_task;
+	array->wb_recxs	= NULL;
+	array->wb_buf	= NULL;
+	array->wb_nr	= 0;
+	array->wb_bytes	= 0;
+
+	*taskp = flush_task;
+	return 0;
+}
+
+/*
+ * Make \a task wait for the data buffered by write-back to be persisted before it accesses the
+ * array. If there is anything to wait for, a flush is started and \a task is re-initialized to
+ * run again once it completes. Returns true if \a task has been deferred or completed here, in
+ * which case \a rcp is the value to return from the task body.
+ */
+static bool
+array_wb_sync(struct dc_array *array, tse_task_t *task, int *rcp)
+{
+	tse_task_t	*flush_task = NULL;
+	tse_task_t	*dep;
+	int		rc;
+
+	if (array->wb_size == 0)
+		return false;
+
+	D_MUTEX_LOCK(&array->wb_lock);
+
+	/** task re-run after waiting on a flush that failed */
+	if (task->dt_result != 0) {
+		rc = task->dt_result;
+		if (array->wb_err == rc)
+			array->wb_err = 0;
+		D_MUTEX_UNLOCK(&array->wb_lock);
+		goto out_complete;
+	}
+
+	rc = array_wb_flush_locked(array, tse_task2sched(task), &flush_task);
+	if (rc != 0) {
+		D_MUTEX_UNLOCK(&array->wb_lock);
+		goto out_complete;
+	}
+
+	dep = array->wb_flush;
+	if (dep == NULL) {
+		rc = array->wb_err;
+		array->wb_err = 0;
+		D_MUTEX_UNLOCK(&array->wb_lock);
+		if (rc == 0)
+			return false;
+		goto out_complete;
+	}
+
+	rc = tse_task_register_deps(task, 1, &dep);
+	D_MUTEX_UNLOCK(&array->wb_lock);
+	if (rc == 0)
+		rc = tse_task_reinit(task);
+	if (flush_task)
+		tse_task_schedule(flush_task, true);
+	if (rc != 0) {
+		D_ERROR("Failed to wait for write-back flush "DF_RC"\n", DP_RC(rc));
+		goto out_complete;
+	}
+
+	*rcp = 0;
+	return true;
+
+out_complete:
+	tse_task_complete(task, rc);
+	*rcp = rc;
+	return true;
+}
+
+/*
+ * Try to absorb a write in the write-back buffer. Only single-range writes outside of a
+ * transaction that fit in one dkey chunk and in the buffer are absorbed; the task is completed
+ * right away and true is returned. Otherwise the write goes through array_wb_sync().
+ */
+static bool
+array_wb_write(struct dc_array *array, tse_task_t *task, daos_handle_t th,
+	       daos_array_iod_t *rg_iod, d_sg_list_t *sgl, int *rcp)
+{
+	tse_task_t	*flush_tasks[2] = { NULL };
+	daos_range_t	*rg;
+	daos_recx_t	*recx;
+	daos_size_t	len;
+	daos_size_t	off;
+	uint64_t	dkey_val;
+	daos_off_t	record_i;
+	bool		flush = false;
+	char		*dst = NULL;
+	unsigned int	i;
+	int		rc = 0;
+
+	if (array->wb_size == 0 || daos_handle_is_valid(th) || rg_iod->arr_nr != 1)
+		return false;
+
+	rg = &rg_iod->arr_rgs[0];
+	len = rg->rg_len * array->cell_size;
+	/** same mapping as compute_dkey() */
+	dkey_val = rg->rg_idx / array->chunk_size + 1;
+	record_i = rg->rg_idx % array->chunk_size;
+	if (len == 0 || record_i + rg->rg_len > array->chunk_size)
+		return false;
+
+	D_MUTEX_LOCK(&array->wb_lock);
+	if (len > array->wb_size) {
+		D_MUTEX_UNLOCK(&array->wb_lock);
+		return false;
+	}
+
+	if (array->wb_err != 0) {
+		rc = array->wb_err;
+		array->wb_err = 0;
+		goto out;
+	}
+
+	if (array->wb_nr > 0 && array->wb_dkey != dkey_val)
+		flush = true;
+
+	/** overwrite of buffered data is applied in place, a partial overlap needs a flush */
+	off = 0;
+	for (i = 0; !flush && i < array->wb_nr; i++) {
+		recx = &array->wb_recxs[i];
+		if (record_i >= recx->rx_idx &&
+		    record_i + rg->rg_len <= recx->rx_idx + recx->rx_nr) {
+			dst = array->wb_buf + off + (record_i - recx->rx_idx) * array->cell_size;
+			break;
+		}
+		if (record_i < recx->rx_idx + recx->rx_nr &&
+		    recx->rx_idx < record_i + rg->rg_len)
+			flush = true;
+		off += recx->rx_nr * array->cell_size;
+	}
+
+	if (dst == NULL) {
+		if (array->wb_bytes + len > array->wb_size || array->wb_nr == ARRAY_WB_EXTS_MAX)
+			flush = true;
+
+		if (flush) {
+			rc = array_wb_flush_locked(array, tse_task2sched(task), &flush_tasks[0]);
+			if (rc != 0)
+				goto out;
+		}
+
+		if (array->wb_buf == NULL) {
+			D_ALLOC_NZ(array->wb_buf, array->wb_size);
+			D_ALLOC_ARRAY(array->wb_recxs, ARRAY_WB_EXTS_MAX);
+			if (array->wb_buf == NULL || array->wb_recxs == NULL) {
+				D_FREE(array->wb_buf);
+				D_FREE(array->wb_recxs);
+				D_GOTO(out, rc = -DER_NOMEM);
+			}
+		}
+
+		if (array->wb_nr == 0) {
+			array->wb_dkey	= dkey_val;
+			array->wb_stamp	= daos_getutime();
+		}
+
+		/** extend the last extent if this write appends to it */
+		recx = array->wb_nr > 0 ? &array->wb_recxs[array->wb_nr - 1] : NULL;
+		if (recx != NULL && recx->rx_idx + recx->rx_nr == record_i) {
+			recx->rx_nr += rg->rg_len;
+		} else {
+			recx = &array->wb_recxs[array->wb_nr++];
+			recx->rx_idx	= record_i;
+			recx->rx_nr	= rg->rg_len;
+		}
+		dst = array->wb_buf + array->wb_bytes;
+		array->wb_bytes += len;
+	}
+
+	for (i = 0; i < sgl->sg_nr; i++) {
+		memcpy(dst, sgl->sg_iovs[i].iov_buf, sgl->sg_iovs[i].iov_len);
+		dst += sgl->sg_iovs[i].iov_len;
+	}
+
+	/** flush in the background once the buffer is full or too old */
+	if (array->wb_bytes == array->wb_size || array->wb_nr == ARRAY_WB_EXTS_MAX ||
+	    (array->wb_age != 0 && daos_getutime() - array->wb_stamp >= array->wb_age)) {
+		/** the data is buffered, a failure here is retried by the next flush */
+		if (array_wb_flush_locked(array, tse_task2sched(task), &flush_tasks[1]) != 0)
+			D_ERROR("Failed to start write-back flush\n");
+	}
+
+out:
+	D_MUTEX_UNLOCK(&array->wb_lock);
+	for (i = 0; i < ARRAY_SIZE(flush_tasks); i++) {
+		if (flush_tasks[i])
+			tse_task_schedule(flush_tasks[i], true);
+	}
+	tse_task_complete(task, rc);
+	*rcp = rc;
+	return true;
+}
+
 static int
 free_md_params_cb(tse_task_t *task, void *data)
 {
@@ -839,6 +1283,25 @@ dc_array_close_direct(daos_handle_t oh)
 	if (array == NULL)
 		return -DER_NO_HDL;
 
+	array_ra_invalidate(array);
+
+	if (array->wb_size != 0) {
+		daos_array_flush_t	*flush_args;
+		tse_task_t		*flush_task;
+
+		rc = dc_task_create(dc_array_flush, NULL, NULL, &flush_task);
+		if (rc == 0) {
+			flush_args = dc_task_get_args(flush_task);
+			flush_args->oh = oh;
+			rc = dc_task_schedule(flush_task, true);
+		}
+		if (rc) {
+			D_ERROR("Failed to flush array before close: "DF_RC"\n", DP_RC(rc));
+			array_decref(array);
+			return rc;
+		}
+	}
+
 	rc = daos_obj_close(array->daos_oh, NULL);
 	if (rc) {
 		D_ERROR("daos_obj_close() failed: "DF_RC"\n", DP_RC(rc));
@@ -868,6 +1331,13 @@ dc_array_close(tse_task_t *task)
 	if (array == NULL)
 		D_GOTO(err_ptask, rc = -DER_NO_HDL);
 
+	/** buffered writes have to be persisted before the object is closed */
+	if (array_wb_sync(array, task, &rc)) {
+		array_decref(array);
+		return rc;
+	}
+	array_ra_invalidate(array);
+
 	/** Create task to close object */
 	rc = daos_task_create(DAOS_OPC_OBJ_CLOSE, tse_task2sched(task),
 			      0, NULL, &close_task);
@@ -917,6 +1387,15 @@ dc_array_destroy(tse_task_t *task)
 	if (array == NULL)
 		D_GOTO(err_ptask, rc = -DER_NO_HDL);
 
+	if (array_wb_sync(array, task, &rc)) {
+		array_decref(array);
+		return rc;
+	}
+
+	rc = array_ra_invalidate_task(array, task);
+	if (rc != 0)
+		D_GOTO(err_put1, rc);
+
 	/** Create task to punch object */
 	rc = daos_task_create(DAOS_OPC_OBJ_PUNCH, tse_task2sched(task),
 			      0, NULL, &punch_task);
@@ -985,6 +1464,69 @@ dc_array_update_chunk_size(daos_handle_t oh, daos_size_t chunk_size)
 	return 0;
 }
 
+int
+dc_array_set_write_back(daos_handle_t oh, daos_size_t size, uint32_t max_age_ms)
+{
+	struct dc_array		*array;
+	int			rc = 0;
+
+	array = array_hdl2ptr(oh);
+	if (array == NULL)
+		return -DER_NO_HDL;
+
+	D_MUTEX_LOCK(&array->wb_lock);
+	if (array->wb_nr != 0 || array->wb_flush != NULL) {
+		rc = -DER_BUSY;
+	} else {
+		/** buffered extents never span dkeys */
+		array->wb_size	= min(size, array->chunk_size * array->cell_size);
+		array->wb_age	= (uint64_t)max_age_ms * 1000;
+	}
+	D_MUTEX_UNLOCK(&array->wb_lock);
+	array_decref(array);
+
+	return rc;
+}
+
+int
+dc_array_set_read_ahead(daos_handle_t oh, daos_size_t size)
+{
+	struct dc_array		*array;
+
+	array = array_hdl2ptr(oh);
+	if (array == NULL)
+		return -DER_NO_HDL;
+
+	array_ra_invalidate(array);
+	D_MUTEX_LOCK(&array->ra_lock);
+	array->ra_size	= size;
+	array->ra_hits	= 0;
+	D_MUTEX_UNLOCK(&array->ra_lock);
+	array_decref(array);
+
+	return 0;
+}
+
+int
+dc_array_flush(tse_task_t *task)
+{
+	daos_array_flush_t	*args = daos_task_get_args(task);
+	struct dc_array		*array;
+	int			rc = 0;
+
+	array = array_hdl2ptr(args->oh);
+	if (array == NULL) {
+		rc = -DER_NO_HDL;
+		tse_task_complete(task, rc);
+		return rc;
+	}
+
+	if (!array_wb_sync(array, task, &rc))
+		tse_task_complete(task, rc);
+	array_decref(array);
+	return rc;
+}
+
 static bool
 io_extent_same(daos_array_iod_t *iod, d_sg_list_t *sgl, daos_size_t cell_size,
 	       daos_size_t *num_records)
@@ -1453,6 +1995,19 @@ dc_array_io(daos_handle_t array_oh, daos_handle_t th,
 		D_GOTO(err_task, rc);
 	}
 
+	if (op_type != DAOS_OPC_ARRAY_READ) {
+		rc = array_ra_invalidate_task(array, task);
+		if (rc)
+			D_GOTO(err_task, rc);
+	}
+
+	if ((op_type == DAOS_OPC_ARRAY_WRITE &&
+	     array_wb_write(array, task, th, rg_iod, user_sgl, &rc)) ||
+	    array_wb_sync(array, task, &rc)) {
+		array_decref(array);
+		return rc;
+	}
+
 	oh = array->daos_oh;
 
 	cur_off = 0;
@@ -1809,10 +2364,288 @@ err_task:
 	return rc;
 }
 
+/** Max number of extents cached by read-ahead per handle */
+#define ARRAY_RA_EXTS_MAX	16
+/** Number of reads at the same stride, after the first two, before prefetching starts */
+#define ARRAY_RA_HITS		2
+
+static int
+array_ra_fetch(tse_task_t *task)
+{
+	daos_array_io_t *args = daos_task_get_args(task);
+
+	return dc_array_io(args->oh, args->th, args->iod, args->sgl, DAOS_OPC_ARRAY_READ, task);
+}
+
+static int
+array_ra_fetch_cb(tse_task_t *task, void *data)
+{
+	struct array_ra_ext	*ext = *((struct array_ra_ext **)data);
+	struct dc_array		*array = ext->re_array;
+	bool			free_ext;
+	int			rc = task->dt_result;
+
+	D_MUTEX_LOCK(&array->ra_lock);
+	if (rc != 0) {
+		D_DEBUG(DB_IO, "Prefetch of "DF_U64"/%zu failed: "DF_RC"\n", ext->re_rg.rg_idx,
+			ext->re_rg.rg_len, DP_RC(rc));
+		/** failed extents are not cached, readers waiting on it read the range directly */
+		if (!ext->re_stale)
+			array_ra_ext_drop(array, ext);
+	} else {
+		ext->re_nr_read = ext->re_iod.arr_nr_read;
+		/** short read, no need to prefetch past the end of the array */
+		if (ext->re_nr_read < ext->re_rg.rg_len && !ext->re_stale)
+			array->ra_eof = min(array->ra_eof, ext->re_rg.rg_idx + ext->re_nr_read);
+	}
+	ext->re_task = NULL;
+	free_ext = ext->re_stale;
+	D_MUTEX_UNLOCK(&array->ra_lock);
+
+	tse_task_decref(task);
+	if (free_ext)
+		array_ra_ext_free(ext);
+	array_decref(array);
+	return rc;
+}
+
+/* Start prefetching \a nr records at \a idx. Called with ra_lock held. */
+static int
+array_ra_prefetch(struct dc_array *array, tse_sched_t *sched, daos_off_t idx, daos_size_t nr,
+		  d_list_t *task_list)
+{
+	struct array_ra_ext	*ext;
+	daos_array_io_t		*args;
+	tse_task_t		*ra_task;
+	void			*buf;
+	int			rc;
+
+	D_ALLOC_PTR(ext);
+	if (ext == NULL)
+		return -DER_NOMEM;
+	D_ALLOC_NZ(buf, nr * array->cell_size);
+	if (buf == NULL) {
+		D_FREE(ext);
+		return -DER_NOMEM;
+	}
+
+	ext->re_array		= array;
+	ext->re_rg.rg_idx	= idx;
+	ext->re_rg.rg_len	= nr;
+	ext->re_iod.arr_nr	= 1;
+	ext->re_iod.arr_rgs	= &ext->re_rg;
+	d_iov_set(&ext->re_iov, buf, nr * array->cell_size);
+	ext->re_sgl.sg_nr	= 1;
+	ext->re_sgl.sg_iovs	= &ext->re_iov;
+
+	rc = dc_task_create(array_ra_fetch, sched, NULL, &ra_task);
+	if (rc != 0) {
+		array_ra_ext_free(ext);
+		return rc;
+	}
+	args		= dc_task_get_args(ra_task);
+	args->oh	= array_ptr2hdl(array);
+	args->th	= DAOS_TX_NONE;
+	args->iod	= &ext->re_iod;
+	args->sgl	= &ext->re_sgl;
+
+	rc = tse_task_register_comp_cb(ra_task, array_ra_fetch_cb, &ext, sizeof(ext));
+	if (rc != 0) {
+		tse_task_complete(ra_task, rc);
+		array_ra_ext_free(ext);
+		return rc;
+	}
+
+	D_DEBUG(DB_IO, "Prefetching "DF_U64"/%zu\n", idx, nr);
+
+	/** the extent holds a ref on the task until it completes, and the task one on the array */
+	tse_task_addref(ra_task);
+	daos_hhash_link_getref(&array->hlink);
+	ext->re_task = ra_task;
+	d_list_add_tail(&ext->re_link, &array->ra_list);
+	array->ra_nr++;
+	array->ra_bytes += ext->re_iov.iov_buf_len;
+	tse_task_list_add(ra_task, task_list);
+	return 0;
+}
+
+/* Find a cached extent covering the \a nr records at \a idx. Called with ra_lock held. */
+static struct array_ra_ext *
+array_ra_lookup(struct dc_array *array, daos_off_t idx, daos_size_t nr)
+{
+	struct array_ra_ext *ext;
+
+	d_list_for_each_entry(ext, &array->ra_list, re_link) {
+		if (idx >= ext->re_rg.rg_idx &&
+		    idx + nr <= ext->re_rg.rg_idx + ext->re_rg.rg_len)
+			return ext;
+	}
+	return NULL;
+}
+
+/*
+ * Track the access pattern of the handle and, once sequential or strided reads of the same
+ * size are detected, prefetch the following extents. Called with ra_lock held.
+ */
+static void
+array_ra_detect(struct dc_array *array, tse_sched_t *sched, daos_off_t idx, daos_size_t nr,
+		d_list_t *task_list)
+{
+	struct array_ra_ext	*ext;
+	struct array_ra_ext	*tmp;
+	daos_off_t		start;
+	daos_size_t		ext_nr;
+	bool			seq;
+	int			i;
+
+	if (nr == array->ra_last_len && idx > array->ra_last_idx &&
+	    idx - array->ra_last_idx == array->ra_stride) {
+		array->ra_hits++;
+	} else {
+		/** pattern changed, nothing cached is likely to be read */
+		if (array->ra_hits > 0) {
+			d_list_for_each_entry_safe(ext, tmp, &array->ra_list, re_link)
+				array_ra_ext_drop(array, ext);
+		}
+		array->ra_hits		= 0;
+		array->ra_stride	= idx > array->ra_last_idx ? idx - array->ra_last_idx : 0;
+	}
+	array->ra_last_idx	= idx;
+	array->ra_last_len	= nr;
+
+	/** extents behind the current read are consumed */
+	d_list_for_each_entry_safe(ext, tmp, &array->ra_list, re_link) {
+		if (ext->re_rg.rg_idx + ext->re_rg.rg_len <= idx)
+			array_ra_ext_drop(array, ext);
+	}
+
+	if (array->ra_hits < ARRAY_RA_HITS || array->ra_stride < nr)
+		return;
+
+	/** sequential reads are prefetched in larger extents, strided ones one read at a time */
+	seq = array->ra_stride == nr;
+	ext_nr = nr;
+	if (seq)
+		ext_nr = max(nr, array->ra_size / array->cell_size / 4);
+
+	start = idx + array->ra_stride;
+	for (i = 0; i < ARRAY_RA_EXTS_MAX * 2 && array->ra_nr < ARRAY_RA_EXTS_MAX; i++) {
+		if (start >= array->ra_eof)
+			break;
+
+		ext = array_ra_lookup(array, start, nr);
+		if (ext != NULL) {
+			start = seq ? ext->re_rg.rg_idx + ext->re_rg.rg_len : start + array->ra_stride;
+			continue;
+		}
+
+		if (array->ra_bytes + ext_nr * array->cell_size > array->ra_size)
+			break;
+		if (array_ra_prefetch(array, sched, start, ext_nr, task_list) != 0)
+			break;
+		start += seq ? ext_nr : array->ra_stride;
+	}
+}
+
+/*
+ * Serve a read from the read-ahead cache if possible, and drive prefetching. Returns true if
+ * \a task was completed or deferred here, in which case \a rcp is the value to return from the
+ * task body.
+ */
+static bool
+array_ra_read(tse_task_t *task, daos_array_io_t *args, int *rcp)
+{
+	struct dc_array		*array;
+	struct array_ra_ext	*ext;
+	daos_range_t		*rg;
+	d_list_t		task_list;
+	tse_task_t		*dep;
+	bool			done = false;
+	char			*src;
+	unsigned int		i;
+	int			rc = 0;
+
+	if (args->iod == NULL || args->sgl == NULL || args->iod->arr_nr != 1 ||
+	    daos_handle_is_valid(args->th))
+		return false;
+
+	array = array_hdl2ptr(args->oh);
+	if (array == NULL)
+		return false;
+
+	rg = &args->iod->arr_rgs[0];
+	if (array->ra_size == 0 || !array->byte_array || rg->rg_len == 0 ||
+	    rg->rg_len * array->cell_size != daos_sgl_buf_size(args->sgl)) {
+		array_decref(array);
+		return false;
+	}
+
+	/**
+	 * Re-run after waiting on a prefetch that failed. The extent was already dropped by
+	 * array_ra_fetch_cb(), so clear the error propagated from it and issue the normal read.
+	 */
+	if (task->dt_result != 0) {
+		D_DEBUG(DB_IO, "Prefetch of "DF_U64"/%zu failed, reading it directly: "DF_RC"\n",
+			rg->rg_idx, rg->rg_len, DP_RC(task->dt_result));
+		task->dt_result = 0;
+		array_decref(array);
+		return false;
+	}
+
+	D_INIT_LIST_HEAD(&task_list);
+	D_MUTEX_LOCK(&array->ra_lock);
+	ext = array_ra_lookup(array, rg->rg_idx, rg->rg_len);
+	if (ext != NULL && ext->re_task != NULL) {
+		/** prefetch in flight, run again once it completes */
+		dep = ext->re_task;
+		rc = tse_task_register_deps(task, 1, &dep);
+		if (rc == 0)
+			rc = tse_task_reinit(task);
+		D_MUTEX_UNLOCK(&array->ra_lock);
+		if (rc != 0) {
+			D_ERROR("Failed to wait for prefetch "DF_RC"\n", DP_RC(rc));
+			done = true;
+		}
+		*rcp = rc;
+		array_decref(array);
+		if (done)
+			tse_task_complete(task, rc);
+		return true;
+	}
+
+	if (ext != NULL && rg->rg_idx + rg->rg_len <= ext->re_rg.rg_idx + ext->re_nr_read) {
+		src = (char *)ext->re_iov.iov_buf +
+		      (rg->rg_idx - ext->re_rg.rg_idx) * array->cell_size;
+		for (i = 0; i < args->sgl->sg_nr; i++) {
+			memcpy(args->sgl->sg_iovs[i].iov_buf, src, args->sgl->sg_iovs[i].iov_len);
+			src += args->sgl->sg_iovs[i].iov_len;
+		}
+		args->sgl->sg_nr_out = args->sgl->sg_nr;
+		args->iod->arr_nr_short_read	= 0;
+		args->iod->arr_nr_read		= rg->rg_len;
+		done = true;
+	}
+
+	array_ra_detect(array, tse_task2sched(task), rg->rg_idx, rg->rg_len, &task_list);
+	D_MUTEX_UNLOCK(&array->ra_lock);
+	tse_task_list_sched(&task_list, true);
+
+	array_decref(array);
+	if (done) {
+		tse_task_complete(task, rc);
+		*rcp = rc;
+	}
+	return done;
+}
+
 int
 dc_array_read(tse_task_t *task)
 {
 	daos_array_io_t *args = daos_task_get_args(task);
+	int		rc;
+
+	if (array_ra_read(task, args, &rc))
+		return rc;
 
 	return dc_array_io(args->oh, args->th, args->iod, args->sgl,
 			   DAOS_OPC_ARRAY_READ, task);
@@ -1903,6 +2736,11 @@ dc_array_get_size(tse_task_t *task)
 	if (array == NULL)
 		D_GOTO(err_task, rc = -DER_NO_HDL);
 
+	if (array_wb_sync(array, task, &rc)) {
+		array_decref(array);
+		return rc;
+	}
+
 	oh = array->daos_oh;
 
 	D_ALLOC_PTR(kqp);
@@ -1977,6 +2815,11 @@ dc_array_stat(tse_task_t *task)
 	if (array == NULL)
 		D_GOTO(err_task, rc = -DER_NO_HDL);
 
+	if (array_wb_sync(array, task, &rc)) {
+		array_decref(array);
+		return rc;
+	}
+
 	oh = array->daos_oh;
 
 	D_ALLOC_PTR(kqp);
@@ -2512,6 +3355,18 @@ dc_array_set_size(tse_task_t *task)
 	if (array == NULL)
 		D_GOTO(err_task, rc = -DER_NO_HDL);
 
+	if (array_wb_sync(array, task, &rc)) {
+		array_decref(array);
+		return rc;
+	}
+
+	rc = array_ra_invalidate_task(array, task);
+	if (rc != 0) {
+		array_decref(array);
+		tse_task_complete(task, rc);
+		return rc;
+	}
+
 	oh = array->daos_oh;
 
 	/** get key information for the last record */
@@ -144,6 +144,8 @@ struct dfs {
 	int                  mounted;
 	/** flag to indicate whether dfs is mounted with balanced mode (DTX) */
 	bool                 use_dtx;
+	/** read-ahead cache size of file array handles, 0 if disabled */
+	uint64_t             ra_size;
 	/** lock for threadsafety */
 	pthread_mutex_t      lock;
 	/** layout version of DFS container that is mounted */
@@ -149,6 +149,8 @@ lookup_rel_path_loop:
 				D_ERROR("daos_array_open() Failed (%d)\n", rc);
 				D_GOTO(err_obj, rc = daos_der2errno(rc));
 			}
+			if (dfs->ra_size)
+				daos_array_set_read_ahead(obj->oh, dfs->ra_size);
 			if (flags & O_TRUNC) {
 				rc = daos_array_set_size(obj->oh, DAOS_TX_NONE, 0, NULL);
 				if (rc) {
@@ -452,6 +454,8 @@ lookup_rel_int(dfs_t *dfs, dfs_obj_t *parent, const char *name, int flags, dfs_o
 			D_ERROR("daos_array_open_with_attr() Failed " DF_RC "\n", DP_RC(rc));
 			D_GOTO(err_obj, rc = daos_der2errno(rc));
 		}
+		if (dfs->ra_size)
+			daos_array_set_read_ahead(obj->oh, dfs->ra_size);
 		if (flags & O_TRUNC) {
 			rc = daos_array_set_size(obj->oh, DAOS_TX_NONE, 0, NULL);
 			if (rc) {
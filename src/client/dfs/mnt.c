@@ -656,6 +656,9 @@ dfs_mount(daos_handle_t poh, daos_handle_t coh, int flags, dfs_t **_dfs)
 	if ((dfs->attr.da_mode & MODE_MASK) == DFS_RELAXED)
 		d_getenv_bool("DFS_USE_DTX", &dfs->use_dtx);
 
+	/** read-ahead on files is opt-in */
+	d_getenv_uint64_t("DFS_READ_AHEAD_SIZE", &dfs->ra_size);
+
 	/** Check if super object has the root entry */
 	strcpy(dfs->root.name, "/");
 	rc = open_dir(dfs, NULL, amode, flags, &root_dir, 1, &dfs->root);
@@ -995,6 +998,7 @@ dfs_global2local(daos_handle_t poh, daos_handle_t coh, int flags, d_iov_t glob,
 	dfs->poh                    = poh;
 	dfs->coh                    = coh;
 	dfs->use_dtx                = dfs_params->use_dtx;
+	d_getenv_uint64_t("DFS_READ_AHEAD_SIZE", &dfs->ra_size);
 	dfs->layout_v               = dfs_params->layout_v;
 	dfs->amode                  = (flags == 0) ? dfs_params->amode : (flags & O_ACCMODE);
 	dfs->uid                    = dfs_params->uid;
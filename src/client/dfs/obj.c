@@ -241,6 +241,8 @@ open_file(dfs_t *dfs, dfs_obj_t *parent, int flags, daos_oclass_id_t cid, daos_s
 		D_ERROR("daos_array_open_with_attr() failed, " DF_RC "\n", DP_RC(rc));
 		return daos_der2errno(rc);
 	}
+	if (dfs->ra_size)
+		daos_array_set_read_ahead(file->oh, dfs->ra_size);
 
 	if (flags & O_TRUNC) {
 		rc = daos_array_set_size(file->oh, DAOS_TX_NONE, 0, NULL);
@@ -155,6 +155,23 @@ ih_addref(struct d_hash_table *htable, d_list_t *rlink)
 	atomic_fetch_add_relaxed(&ie->ie_ref, 1);
 }
 
+/* Take a reference for the lockless lookup, unless the inode is already being released */
+static bool
+ih_tryaddref(struct d_hash_table *htable, d_list_t *rlink)
+{
+	struct dfuse_inode_entry *ie;
+	uint32_t                  oldref;
+
+	ie     = container_of(rlink, struct dfuse_inode_entry, ie_htl);
+	oldref = atomic_load_relaxed(&ie->ie_ref);
+	do {
+		if (oldref == 0)
+			return false;
+	} while (!atomic_compare_exchange(&ie->ie_ref, oldref, oldref + 1));
+
+	return true;
+}
+
 static bool
 ih_decref(struct d_hash_table *htable, d_list_t *rlink)
 {
@@ -176,12 +193,13 @@ ih_free(struct d_hash_table *htable, d_list_t *rlink)
 }
 
 static d_hash_table_ops_t ie_hops = {
-    .hop_key_cmp    = ih_key_cmp,
-    .hop_key_hash   = ih_key_hash,
-    .hop_rec_hash   = ih_rec_hash,
-    .hop_rec_addref = ih_addref,
-    .hop_rec_decref = ih_decref,
-    .hop_rec_free   = ih_free,
+    .hop_key_cmp       = ih_key_cmp,
+    .hop_key_hash      = ih_key_hash,
+    .hop_rec_hash      = ih_rec_hash,
+    .hop_rec_addref    = ih_addref,
+    .hop_rec_decref    = ih_decref,
+    .hop_rec_free      = ih_free,
+    .hop_rec_tryaddref = ih_tryaddref,
 };
 
 static uint32_t
@@ -1155,7 +1173,8 @@ dfuse_fs_init(struct dfuse_info *dfuse_info)
 	if (rc != 0)
 		D_GOTO(err, rc);
 
-	rc = d_hash_table_create_inplace(D_HASH_FT_LRU | D_HASH_FT_EPHEMERAL, 16, dfuse_info,
+	/* Inode lookups are far more frequent than inserts so do them without locking */
+	rc = d_hash_table_create_inplace(D_HASH_FT_RCU | D_HASH_FT_EPHEMERAL, 16, dfuse_info,
 					 &ie_hops, &dfuse_info->dpi_iet);
 	if (rc != 0)
 		D_GOTO(err_pt, rc);
@@ -1507,37 +1526,59 @@ err:
 	return rc;
 }
 
+struct ino_flush_args {
+	struct dfuse_inode_entry **ies;
+	uint32_t                   nr;
+	uint32_t                   size;
+	bool                       roots;
+};
+
 static int
-ino_dfs_flush(d_list_t *rlink, void *arg)
+ino_dfs_collect(d_list_t *rlink, void *arg)
 {
-	struct dfuse_info        *dfuse_info = arg;
-	struct dfuse_inode_entry *ie = container_of(rlink, struct dfuse_inode_entry, ie_htl);
-
-	d_list_del(&ie->ie_htl);
+	struct ino_flush_args     *args = arg;
+	struct dfuse_inode_entry  *ie   = container_of(rlink, struct dfuse_inode_entry, ie_htl);
+	struct dfuse_inode_entry **ies;
+	uint32_t                   size;
 
-	atomic_store_relaxed(&ie->ie_ref, 0);
+	if (ie->ie_root && !args->roots)
+		return 0;
 
-	dfuse_ie_close(dfuse_info, ie);
+	if (args->nr == args->size) {
+		size = max(args->size * 2, 1024U);
+		D_REALLOC_ARRAY(ies, args->ies, args->size, size);
+		if (ies == NULL)
+			return -DER_NOMEM;
+		args->ies  = ies;
+		args->size = size;
+	}
+	args->ies[args->nr++] = ie;
 
 	return -DER_SUCCESS;
 }
 
+/* Release the inodes, the container roots only if @roots is set.  The records cannot be removed
+ * while traversing the table, so collect them first then drop them through the hash table so it
+ * keeps track of its size, and wait for the frees it defers.
+ */
 static int
-ino_dfs_flush_nr(d_list_t *rlink, void *arg)
+ino_dfs_flush(struct dfuse_info *dfuse_info, bool roots)
 {
-	struct dfuse_info        *dfuse_info = arg;
-	struct dfuse_inode_entry *ie = container_of(rlink, struct dfuse_inode_entry, ie_htl);
-
-	if (ie->ie_root)
-		return 0;
+	struct ino_flush_args args = {.roots = roots};
+	uint32_t              i;
+	int                   rc;
 
-	d_list_del(&ie->ie_htl);
+	rc = d_hash_table_traverse(&dfuse_info->dpi_iet, ino_dfs_collect, &args);
 
-	atomic_store_relaxed(&ie->ie_ref, 0);
+	for (i = 0; i < args.nr; i++) {
+		atomic_store_relaxed(&args.ies[i]->ie_ref, 1);
+		d_hash_rec_decref(&dfuse_info->dpi_iet, &args.ies[i]->ie_htl);
+	}
+	D_FREE(args.ies);
 
-	dfuse_ie_close(dfuse_info, ie);
+	d_hash_table_synchronize(&dfuse_info->dpi_iet);
 
-	return -DER_SUCCESS;
+	return rc;
 }
 
 static int
@@ -1667,7 +1708,7 @@ dfuse_fs_stop(struct dfuse_info *dfuse_info)
 	/* At this point there's a number of inodes which are in memory, traverse these and free
 	 * them, along with any resources.
 	 * The reference count on inodes match kernel references but the fuse module is disconnected
-	 * at this point so simply set this to 0.
+	 * at this point so simply drop it to 0.
 	 * Inodes do not hold a reference on their parent so removing a single entry should not
 	 * affect other entries in the list, however pools and containers are more tricy, first
 	 * iterate over the list and release inodes which are not the root of a container, then
@@ -1676,14 +1717,14 @@ dfuse_fs_stop(struct dfuse_info *dfuse_info)
 	 */
 	DFUSE_TRA_INFO(dfuse_info, "Draining inode table");
 
-	rc = d_hash_table_traverse(&dfuse_info->dpi_iet, ino_dfs_flush_nr, dfuse_info);
+	rc = ino_dfs_flush(dfuse_info, false);
 
 	DHL_INFO(dfuse_info, rc, "First flush complete");
 
 	/* Second pass, this should close all inodes which are the root of containers and therefore
 	 * close all containers and pools.
 	 */
-	rc = d_hash_table_traverse(&dfuse_info->dpi_iet, ino_dfs_flush, dfuse_info);
+	rc = ino_dfs_flush(dfuse_info, true);
 
 	DHL_INFO(dfuse_info, rc, "Second flush complete");
 
@@ -91,6 +91,7 @@ struct dfuse_time_entry {
 struct dfuse_ival {
 	d_list_t             time_entry_list;
 	struct fuse_session *session;
+	struct d_hash_table *inode_table;
 	bool                 session_dead;
 };
 
@@ -228,6 +229,10 @@ ival_thread_fn(void *arg)
 
 		while (ival_loop(&sleep_time))
 			;
+
+		/* Close the forgotten inodes whose free is still deferred by an idle inode table */
+		d_hash_table_synchronize(ival_data.inode_table);
+
 		if (sleep_time < 2)
 			sleep_time = 2;
 		DFUSE_TRA_DEBUG(&ival_data, "Sleeping %d", sleep_time);
@@ -289,7 +294,8 @@ ival_thread_start(struct dfuse_info *dfuse_info)
 {
 	int rc;
 
-	ival_data.session = dfuse_info->di_session;
+	ival_data.session     = dfuse_info->di_session;
+	ival_data.inode_table = &dfuse_info->dpi_iet;
 
 	rc = pthread_create(&ival_thread, NULL, ival_thread_fn, NULL);
 	if (rc != 0)
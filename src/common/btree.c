@@ -157,6 +157,8 @@ struct btr_context {
 	int				 tc_class;
 	/** cached feature bits, avoid loading from slow memory */
 	uint64_t			 tc_feats;
+	/** cached hashed key size, avoid calling into the tree class */
+	uint32_t			 tc_hkey_size;
 	/** trace for the tree root */
 	struct btr_trace_info            tc_trace;
 	/** trace buffer */
@@ -180,6 +182,7 @@ static int btr_node_insert_rec(struct btr_context *tcx,
 static int btr_node_destroy(struct btr_context *tcx, umem_off_t nd_off,
 			    void *args, bool *empty_rc);
 static int btr_root_tx_add(struct btr_context *tcx);
+static inline uint32_t btr_hkey_size_const(btr_ops_t *ops, uint64_t feats);
 static bool btr_probe_prev(struct btr_context *tcx);
 static bool btr_probe_next(struct btr_context *tcx);
 
@@ -370,6 +373,7 @@ btr_context_create(umem_off_t root_off, struct btr_root *root,
 		D_DEBUG(DB_TRACE, "Load tree context from "DF_X64"\n",
 			root_off);
 	}
+	tcx->tc_hkey_size = btr_hkey_size_const(btr_ops(tcx), tcx->tc_feats);
 
 	btr_context_set_depth(tcx, depth);
 	*tcxp = tcx;
@@ -535,10 +539,10 @@ btr_hkey_size_const(btr_ops_t *ops, uint64_t feats)
 /**
  * Wrapper for customized tree functions
  */
-static uint32_t
+static inline uint32_t
 btr_hkey_size(struct btr_context *tcx)
 {
-	return btr_hkey_size_const(btr_ops(tcx), tcx->tc_feats);
+	return tcx->tc_hkey_size;
 }
 
 static inline int
@@ -573,23 +577,33 @@ btr_hkey_copy(struct btr_context *tcx, char *dst_key, char *src_key)
 	memcpy(dst_key, src_key, btr_hkey_size(tcx));
 }
 
+static inline int
+btr_uint_cmp(struct btr_context *tcx, struct btr_record *rec, char *hkey)
+{
+	uint64_t a = rec->rec_ukey[0];
+	uint64_t b = *(uint64_t *)hkey;
+
+	return (a < b) ? BTR_CMP_LT : ((a > b) ? BTR_CMP_GT : BTR_CMP_EQ);
+}
+
+static inline int
+btr_memcmp_cmp(struct btr_context *tcx, struct btr_record *rec, char *hkey)
+{
+	return dbtree_key_cmp_rc(memcmp(&rec->rec_hkey[0], hkey,
+					btr_hkey_size(tcx)));
+}
+
 static int
 btr_hkey_cmp(struct btr_context *tcx, struct btr_record *rec, void *hkey)
 {
 	D_ASSERT(!btr_is_direct_key(tcx));
 
-	if (btr_is_int_key(tcx)) {
-		uint64_t a = rec->rec_ukey[0];
-		uint64_t b = *(uint64_t *)hkey;
-
-		return (a < b) ? BTR_CMP_LT :
-				 ((a > b) ? BTR_CMP_GT : BTR_CMP_EQ);
-	}
+	if (btr_is_int_key(tcx))
+		return btr_uint_cmp(tcx, rec, hkey);
 	if (btr_ops(tcx)->to_hkey_cmp)
 		return btr_ops(tcx)->to_hkey_cmp(&tcx->tc_tins, rec, hkey);
 	else
-		return dbtree_key_cmp_rc(
-			memcmp(&rec->rec_hkey[0], hkey, btr_hkey_size(tcx)));
+		return btr_memcmp_cmp(tcx, rec, hkey);
 }
 
 static void
@@ -1573,6 +1587,66 @@ btr_cmp(struct btr_context *tcx, umem_off_t nd_off,
 	return cmp;
 }
 
+/**
+ * Generate a binary search of \a hkey within the records of a node, for tree
+ * classes whose hashed keys can be compared without calling into the class.
+ * \a cmp3 compares the hashed key of a record with \a hkey and returns
+ * BTR_CMP_LT, BTR_CMP_GT or BTR_CMP_EQ like btr_hkey_cmp().
+ *
+ * It visits the same records as the generic search of btr_probe(), and
+ * returns the position and comparison result that search ends up with.
+ */
+#define BTR_NODE_SEARCH_DEFINE(name, cmp3)				\
+static int								\
+name(struct btr_context *tcx, umem_off_t nd_off, char *hkey, int *cmpp)	\
+{									\
+	struct btr_node	*nd = btr_off2ptr(tcx, nd_off);			\
+	char		*recs = (char *)&nd[1];				\
+	uint32_t	 rec_size = btr_rec_size(tcx);			\
+	int		 start = 0;					\
+	int		 end = nd->tn_keyn - 1;				\
+	int		 at;						\
+	int		 cmp;						\
+									\
+	for (;;) {							\
+		at = (start + end) / 2;					\
+		cmp = cmp3(tcx, (struct btr_record *)&recs[at * rec_size],\
+			   hkey);					\
+		if (cmp == BTR_CMP_EQ || start >= end)			\
+			break;						\
+		if (cmp & BTR_CMP_LT)					\
+			start = at + 1;					\
+		else							\
+			end = at - 1;					\
+	}								\
+	*cmpp = cmp;							\
+	return at;							\
+}
+
+/** integer keys, BTR_FEAT_UINT_KEY */
+BTR_NODE_SEARCH_DEFINE(btr_node_search_uint, btr_uint_cmp)
+/** hashed keys of tree classes without btr_ops_t::to_hkey_cmp */
+BTR_NODE_SEARCH_DEFINE(btr_node_search_memcmp, btr_memcmp_cmp)
+
+typedef int (*btr_node_search_t)(struct btr_context *tcx, umem_off_t nd_off,
+				 char *hkey, int *cmp);
+
+/** Return the inline node search for probing \a hkey, NULL if there is none */
+static btr_node_search_t
+btr_node_search(struct btr_context *tcx, char *hkey)
+{
+	if (hkey == NULL || btr_is_direct_key(tcx))
+		return NULL;
+
+	if (btr_is_int_key(tcx))
+		return btr_node_search_uint;
+
+	if (btr_ops(tcx)->to_hkey_cmp == NULL)
+		return btr_node_search_memcmp;
+
+	return NULL;
+}
+
 bool
 btr_probe_valid(dbtree_probe_opc_t opc)
 {
@@ -1683,6 +1757,7 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 	struct btr_node		*nd;
 	struct btr_check_alb	 alb;
 	umem_off_t		 nd_off;
+	btr_node_search_t	 search = NULL;
 
 	if (!btr_probe_valid(probe_opc)) {
 		rc = PROBE_RC_ERR;
@@ -1710,6 +1785,8 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 	}
 
 	nd_off = tcx->tc_tins.ti_root->tr_node;
+	if (probe_opc & BTR_PROBE_SPEC)
+		search = btr_node_search(tcx, hkey);
 
 	for (start = end = 0, level = 0, next_level = true ;;) {
 		if (next_level) { /* search a new level of the tree */
@@ -1730,6 +1807,9 @@ btr_probe(struct btr_context *tcx, dbtree_probe_opc_t probe_opc,
 		} else if (probe_opc == BTR_PROBE_LAST) {
 			at = start = end;
 			cmp = BTR_CMP_LT;
+		} else if (search != NULL) {
+			/* the same binary search without going through btr_cmp() */
+			at = start = end = search(tcx, nd_off, hkey, &cmp);
 		} else {
 			D_ASSERT(probe_opc & BTR_PROBE_SPEC);
 			/* binary search */
@@ -2539,6 +2619,387 @@ dbtree_upsert(daos_handle_t toh, dbtree_probe_opc_t opc, uint32_t intent,
 	return btr_tx_end(tcx, rc);
 }
 
+/**
+ * Number of records loaded, or subtrees deleted, by dbtree_bulk_load and
+ * dbtree_delete_range in one transaction. It bounds the undo log of a single
+ * transaction when the tree is on persistent memory.
+ */
+#define BTR_BULK_BATCH		1024
+
+/**
+ * State of bulk loading. The tree is built bottom-up from the sorted input,
+ * only the rightmost node of each level can take more records or children.
+ */
+struct btr_bulk_load {
+	/** depth of the tree being built */
+	int			bl_depth;
+	/** records loaded in the current transaction */
+	int			bl_batched;
+	/** the rightmost node of each level, [0] is the leaf level */
+	umem_off_t		bl_nodes[BTR_TRACE_MAX];
+};
+
+/** Start the tree being built with an empty leaf */
+static int
+btr_bulk_start(struct btr_context *tcx, struct btr_bulk_load *bl)
+{
+	struct btr_root	*root = tcx->tc_tins.ti_root;
+	umem_off_t	 nd_off;
+	int		 rc;
+
+	/* A loaded tree is fully packed, so all nodes including the root
+	 * have the size of the tree order.
+	 */
+	if (root->tr_node_size != tcx->tc_order) {
+		if (btr_has_tx(tcx)) {
+			rc = btr_root_tx_add(tcx);
+			if (rc != 0)
+				return rc;
+		}
+		root->tr_node_size = tcx->tc_order;
+	}
+
+	rc = btr_node_alloc(tcx, &nd_off);
+	if (rc != 0)
+		return rc;
+
+	btr_node_set(tcx, nd_off, BTR_NODE_LEAF);
+	bl->bl_nodes[0] = nd_off;
+	bl->bl_depth	= 1;
+	return 0;
+}
+
+/**
+ * The rightmost leaf is full, start a new leaf for \a rec and add it to the
+ * parent level. Full nodes on the way up are closed as well, and a new root is
+ * added if all levels are full. All the new nodes are allocated before any of
+ * them is linked, so a failure leaves the tree being built unchanged.
+ */
+static int
+btr_bulk_grow(struct btr_context *tcx, struct btr_bulk_load *bl,
+	      struct btr_record *rec)
+{
+	union btr_rec_buf	 sep_buf = {0};
+	struct btr_record	*sep = &sep_buf.rb_rec;
+	struct btr_node		*nd;
+	umem_off_t		 nodes[BTR_TRACE_MAX];
+	int			 full;
+	int			 nr;
+	int			 i;
+	int			 rc;
+
+	for (full = 1; full < bl->bl_depth; full++) {
+		if (!btr_node_is_full(tcx, bl->bl_nodes[full]))
+			break;
+	}
+	nr = full + (full == bl->bl_depth);
+	D_ASSERT(nr < BTR_TRACE_MAX);
+
+	for (i = 0; i < nr; i++) {
+		rc = btr_node_alloc(tcx, &nodes[i]);
+		if (rc != 0) {
+			while (--i >= 0)
+				btr_node_free(tcx, nodes[i]);
+			return rc;
+		}
+	}
+	btr_node_set(tcx, nodes[0], BTR_NODE_LEAF);
+
+	/* the first key of the new leaf separates it from its left sibling */
+	if (btr_is_direct_key(tcx))
+		sep->rec_node[0] = nodes[0];
+	else
+		btr_rec_copy_hkey(tcx, sep, rec);
+	sep->rec_off = nodes[0];
+
+	/* new node of a full level only has the leftmost child, the separator
+	 * goes further up.
+	 */
+	for (i = 1; i < full; i++) {
+		nd = btr_off2ptr(tcx, nodes[i]);
+		nd->tn_child = nodes[i - 1];
+		sep->rec_off = nodes[i];
+	}
+
+	if (full == bl->bl_depth) {
+		D_DEBUG(DB_TRACE, "Grow the loaded tree depth to %d\n", full + 1);
+		nd = btr_off2ptr(tcx, nodes[full]);
+		nd->tn_child = bl->bl_nodes[full - 1];
+		bl->bl_nodes[full] = nodes[full];
+		bl->bl_depth++;
+	}
+
+	nd = btr_off2ptr(tcx, bl->bl_nodes[full]);
+	btr_rec_copy(tcx, btr_node_rec_at(tcx, bl->bl_nodes[full], nd->tn_keyn),
+		     sep, 1);
+	nd->tn_keyn++;
+
+	for (i = 0; i < full; i++)
+		bl->bl_nodes[i] = nodes[i];
+	return 0;
+}
+
+/** Append a record to the rightmost leaf of the tree being built */
+static int
+btr_bulk_append(struct btr_context *tcx, struct btr_bulk_load *bl,
+		d_iov_t *key, d_iov_t *val)
+{
+	union btr_rec_buf	 rec_buf = {0};
+	struct btr_record	*rec = &rec_buf.rb_rec;
+	struct btr_node		*nd;
+	int			 cmp;
+	int			 rc = 0;
+
+	btr_hkey_gen(tcx, key, &rec->rec_hkey[0]);
+	if (bl->bl_depth > 0) {
+		/* input must be in ascending order of the tree */
+		nd = btr_off2ptr(tcx, bl->bl_nodes[0]);
+		cmp = btr_cmp(tcx, bl->bl_nodes[0], nd->tn_keyn - 1,
+			      &rec->rec_hkey[0], key);
+		if ((cmp & BTR_CMP_ERR) || !(cmp & BTR_CMP_LT)) {
+			D_ERROR("Input of bulk load is not sorted\n");
+			return -DER_INVAL;
+		}
+	}
+
+	rc = btr_rec_alloc(tcx, key, val, rec, NULL);
+	if (rc != 0) {
+		D_DEBUG(DB_TRACE, "Failed to create new record: "DF_RC"\n",
+			DP_RC(rc));
+		return rc;
+	}
+
+	if (bl->bl_depth == 0)
+		rc = btr_bulk_start(tcx, bl);
+	else if (btr_node_is_full(tcx, bl->bl_nodes[0]))
+		rc = btr_bulk_grow(tcx, bl, rec);
+
+	if (rc != 0) {
+		btr_rec_free(tcx, rec, NULL);
+		return rc;
+	}
+
+	nd = btr_off2ptr(tcx, bl->bl_nodes[0]);
+	btr_rec_copy(tcx, btr_node_rec_at(tcx, bl->bl_nodes[0], nd->tn_keyn),
+		     rec, 1);
+	nd->tn_keyn++;
+	return 0;
+}
+
+/**
+ * The rightmost non-leaf node of a level is left with only one child if the
+ * level was split by the last record. The deletion code requires at least two
+ * children for each non-leaf node, so borrow the last child of the left
+ * sibling, which is always full. Levels are fixed from top to bottom because
+ * the parent must have a key to find the left sibling.
+ */
+static int
+btr_bulk_fixup(struct btr_context *tcx, struct btr_bulk_load *bl)
+{
+	struct btr_record	*par_rec;
+	struct btr_record	*src_rec;
+	struct btr_record	*dst_rec;
+	struct btr_node		*par_nd;
+	struct btr_node		*cur_nd;
+	struct btr_node		*sib_nd;
+	umem_off_t		 par_off;
+	umem_off_t		 cur_off;
+	umem_off_t		 sib_off;
+	int			 level;
+	int			 rc;
+
+	for (level = bl->bl_depth - 2; level > 0; level--) {
+		cur_off = bl->bl_nodes[level];
+		cur_nd	= btr_off2ptr(tcx, cur_off);
+		if (cur_nd->tn_keyn > 0)
+			continue;
+
+		par_off = bl->bl_nodes[level + 1];
+		par_nd	= btr_off2ptr(tcx, par_off);
+		D_ASSERT(par_nd->tn_keyn > 0);
+
+		sib_off = btr_node_child_at(tcx, par_off, par_nd->tn_keyn - 1);
+		sib_nd	= btr_off2ptr(tcx, sib_off);
+		D_ASSERT(sib_nd->tn_keyn > 1);
+
+		if (btr_has_tx(tcx)) {
+			rc = btr_node_tx_add(tcx, sib_off);
+			if (rc != 0)
+				return rc;
+		}
+
+		par_rec = btr_node_rec_at(tcx, par_off, par_nd->tn_keyn - 1);
+		src_rec = btr_node_rec_at(tcx, sib_off, sib_nd->tn_keyn - 1);
+		dst_rec = btr_node_rec_at(tcx, cur_off, 0);
+
+		/* the parent key moves down, the last key of the sibling
+		 * moves up to the parent.
+		 */
+		btr_rec_copy_hkey(tcx, dst_rec, par_rec);
+		dst_rec->rec_off = cur_nd->tn_child;
+		btr_rec_copy_hkey(tcx, par_rec, src_rec);
+
+		cur_nd->tn_child = src_rec->rec_off;
+		cur_nd->tn_keyn	 = 1;
+		sib_nd->tn_keyn--;
+	}
+	return 0;
+}
+
+/** Make the tree being built a valid tree and publish it in the root */
+static int
+btr_bulk_publish(struct btr_context *tcx, struct btr_bulk_load *bl)
+{
+	struct btr_root	*root = tcx->tc_tins.ti_root;
+	umem_off_t	 top;
+	int		 rc;
+
+	if (bl->bl_depth == 0)
+		return 0;
+
+	rc = btr_bulk_fixup(tcx, bl);
+	if (rc != 0)
+		return rc;
+
+	top = bl->bl_nodes[bl->bl_depth - 1];
+	if (root->tr_node == top)
+		return 0;
+
+	if (btr_has_tx(tcx)) {
+		rc = btr_root_tx_add(tcx);
+		if (rc != 0)
+			return rc;
+	}
+
+	if (!UMOFF_IS_NULL(root->tr_node))
+		btr_node_unset(tcx, root->tr_node, BTR_NODE_ROOT);
+	btr_node_set(tcx, top, BTR_NODE_ROOT);
+
+	root->tr_node  = top;
+	root->tr_depth = bl->bl_depth;
+	btr_context_set_depth(tcx, root->tr_depth);
+	return 0;
+}
+
+static int
+btr_bulk_tx_begin(struct btr_context *tcx, struct btr_bulk_load *bl)
+{
+	int	i;
+	int	rc;
+
+	bl->bl_batched = 0;
+	rc = btr_tx_begin(tcx);
+	if (rc != 0 || !btr_has_tx(tcx))
+		return rc;
+
+	/* the rightmost nodes are changed by the following records */
+	for (i = 0; i < bl->bl_depth; i++) {
+		rc = btr_node_tx_add(tcx, bl->bl_nodes[i]);
+		if (rc != 0)
+			return btr_tx_end(tcx, rc);
+	}
+	return 0;
+}
+
+/**
+ * Load records returned by \a load_cb into the tree.
+ *
+ * If the tree is empty, records must be returned in ascending order of the
+ * tree, which is the key order for trees with BTR_FEAT_DIRECT_KEY or
+ * BTR_FEAT_UINT_KEY, or the hashed key order otherwise. The tree is then built
+ * bottom-up with fully packed nodes, without probing or splitting for each
+ * record. Records are inserted one by one in any order if the tree is not
+ * empty or has BTR_FEAT_EMBED_FIRST.
+ *
+ * Records are loaded in a sequence of transactions, a valid tree with all
+ * records of the committed transactions is published at the end of each of
+ * them.
+ *
+ * \param[in] toh	Tree open handle.
+ * \param[in] load_cb	Callback to return the next record, see
+ *			dbtree_load_cb_t.
+ * \param[in] arg	Argument of \a load_cb.
+ *
+ * \return		0	success
+ *			-DER_INVAL input is not sorted
+ *			-ve	error code
+ */
+int
+dbtree_bulk_load(daos_handle_t toh, dbtree_load_cb_t load_cb, void *arg)
+{
+	struct btr_context	*tcx;
+	struct btr_bulk_load	 bl = {0};
+	d_iov_t			 key;
+	d_iov_t			 val;
+	bool			 bulk;
+	int			 rc;
+
+	tcx = btr_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	bulk = btr_root_empty(tcx) && !btr_supports_embedded_value(tcx);
+	D_DEBUG(DB_TRACE, "Load records into %s tree\n", bulk ? "empty" : "non-empty");
+
+	rc = btr_bulk_tx_begin(tcx, &bl);
+	if (rc != 0)
+		return rc;
+
+	while (1) {
+		d_iov_set(&key, NULL, 0);
+		d_iov_set(&val, NULL, 0);
+		rc = load_cb(&key, &val, arg);
+		if (rc != 0) {
+			if (rc == 1) { /* end of input */
+				rc = 0;
+			} else if (rc > 0) {
+				D_ERROR("Invalid return value of load_cb: %d\n", rc);
+				rc = -DER_INVAL;
+			}
+			break;
+		}
+
+		rc = btr_verify_key(tcx, &key);
+		if (rc != 0)
+			break;
+
+		if (bulk)
+			rc = btr_bulk_append(tcx, &bl, &key, &val);
+		else
+			rc = btr_upsert(tcx, BTR_PROBE_EQ, DAOS_INTENT_UPDATE,
+					&key, &val, NULL);
+		if (rc != 0)
+			break;
+
+		if (++bl.bl_batched < BTR_BULK_BATCH)
+			continue;
+
+		rc = btr_bulk_publish(tcx, &bl);
+		rc = btr_tx_end(tcx, rc);
+		if (rc != 0)
+			goto out;
+
+		rc = btr_bulk_tx_begin(tcx, &bl);
+		if (rc != 0)
+			goto out;
+	}
+
+	/* Without transaction, records loaded before the failure are kept
+	 * in the tree instead of being leaked.
+	 */
+	if (rc == 0 || !btr_has_tx(tcx)) {
+		int	rc2;
+
+		rc2 = btr_bulk_publish(tcx, &bl);
+		if (rc == 0)
+			rc = rc2;
+	}
+	rc = btr_tx_end(tcx, rc);
+out:
+	tcx->tc_probe_rc = PROBE_RC_UNKNOWN;
+	return rc;
+}
+
 /** When pairing down from 2 entries in the root to 2 we can remove
  * the node and restore the embedded entry.  This function will modify
  * the root and set flags accordingly.
@@ -3320,14 +3781,18 @@ btr_root_del_rec(struct btr_context *tcx, struct btr_trace *trace, void *args)
 	return rc;
 }
 
+/**
+ * Delete the record or child pointed by the trace of \a level, then rebalance
+ * the tree from this level up to the root.
+ */
 static int
-btr_delete(struct btr_context *tcx, void *args)
+btr_delete_at(struct btr_context *tcx, int level, void *args)
 {
 	struct btr_trace	*par_tr;
 	struct btr_trace	*cur_tr;
 	int			 rc = 0;
 
-	for (cur_tr = &tcx->tc_trace.ti_trace[tcx->tc_depth - 1];; cur_tr = par_tr) {
+	for (cur_tr = &tcx->tc_trace.ti_trace[level];; cur_tr = par_tr) {
 		if (cur_tr == tcx->tc_trace.ti_trace) { /* root */
 			rc = btr_root_del_rec(tcx, cur_tr, args);
 			break;
@@ -3346,6 +3811,12 @@ btr_delete(struct btr_context *tcx, void *args)
 	return rc;
 }
 
+static int
+btr_delete(struct btr_context *tcx, void *args)
+{
+	return btr_delete_at(tcx, tcx->tc_depth - 1, args);
+}
+
 static int
 btr_tx_delete(struct btr_context *tcx, void *args)
 {
@@ -3407,6 +3878,288 @@ delete:
 	return rc;
 }
 
+/**
+ * Move the trace to the first record that is not less than \a key, or to the
+ * first record of the tree if \a key is NULL. Unlike btr_probe, availability
+ * of the record is not checked.
+ */
+static enum btr_probe_rc
+btr_range_probe(struct btr_context *tcx, d_iov_t *key, char *hkey)
+{
+	struct btr_node	*nd;
+	umem_off_t	 nd_off;
+	bool		 leaf;
+	int		 level;
+	int		 start;
+	int		 end;
+	int		 at;
+	int		 cmp;
+
+	btr_context_set_depth(tcx, tcx->tc_tins.ti_root->tr_depth);
+	if (btr_root_empty(tcx))
+		return PROBE_RC_NONE;
+
+	if (btr_has_embedded_value(tcx))
+		return btr_probe(tcx, key == NULL ? BTR_PROBE_FIRST : BTR_PROBE_GE,
+				 DAOS_INTENT_PURGE, key, hkey);
+
+	nd_off = tcx->tc_tins.ti_root->tr_node;
+	for (level = 0;; level++) {
+		nd   = btr_off2ptr(tcx, nd_off);
+		leaf = btr_node_is_leaf(tcx, nd_off);
+
+		for (start = 0, end = nd->tn_keyn; key != NULL && start < end;) {
+			at  = (start + end) / 2;
+			cmp = btr_cmp(tcx, nd_off, at, hkey, key);
+			if (cmp & BTR_CMP_ERR)
+				return PROBE_RC_ERR;
+
+			/* leaf: the first record not less than the key.
+			 * non-leaf: the child on the right side of the last
+			 * key not greater than the key.
+			 */
+			if ((cmp & BTR_CMP_LT) || (!leaf && !(cmp & BTR_CMP_GT)))
+				start = at + 1;
+			else
+				end = at;
+		}
+		if (leaf)
+			break;
+
+		btr_trace_set(tcx, level, nd_off, start, BTR_EMBEDDED_NONE);
+		nd_off = btr_node_child_at(tcx, nd_off, start);
+	}
+
+	if (start < nd->tn_keyn) {
+		btr_trace_set(tcx, level, nd_off, start, BTR_EMBEDDED_NONE);
+		return PROBE_RC_OK;
+	}
+
+	/* all records of this leaf are less than the key */
+	btr_trace_set(tcx, level, nd_off, nd->tn_keyn - 1, BTR_EMBEDDED_NONE);
+	return btr_probe_next(tcx) ? PROBE_RC_OK : PROBE_RC_NONE;
+}
+
+/** Compare the record pointed by the trace with \a key */
+static int
+btr_range_cmp(struct btr_context *tcx, d_iov_t *key, char *hkey)
+{
+	struct btr_record *rec = &tcx->tc_record;
+
+	if (!btr_has_embedded_value(tcx))
+		return btr_cmp(tcx, BTR_NODE_NULL, -1, hkey, key);
+
+	if (btr_is_direct_key(tcx))
+		return btr_key_cmp(tcx, rec, key);
+
+	if (btr_embedded_create_hash(tcx, true) != 0)
+		return BTR_CMP_ERR;
+
+	return btr_hkey_cmp(tcx, rec, hkey);
+}
+
+/** Whether the last record of subtree \a nd_off is not greater than \a key */
+static bool
+btr_range_covers(struct btr_context *tcx, umem_off_t nd_off, d_iov_t *key,
+		 char *hkey)
+{
+	struct btr_node	*nd;
+	int		 cmp;
+
+	if (key == NULL)
+		return true;
+
+	while (!btr_node_is_leaf(tcx, nd_off)) {
+		nd = btr_off2ptr(tcx, nd_off);
+		nd_off = btr_node_child_at(tcx, nd_off, nd->tn_keyn);
+	}
+
+	nd  = btr_off2ptr(tcx, nd_off);
+	cmp = btr_cmp(tcx, nd_off, nd->tn_keyn - 1, hkey, key);
+	return !(cmp & (BTR_CMP_GT | BTR_CMP_ERR));
+}
+
+/**
+ * Delete the largest subtree which starts from the record pointed by the
+ * trace, and has no record greater than \a key. All nodes and records of the
+ * subtree are freed at once, and the tree is rebalanced only for the removal
+ * of the subtree root. It only deletes the record pointed by the trace if no
+ * such subtree.
+ */
+static int
+btr_range_delete(struct btr_context *tcx, d_iov_t *key, char *hkey, void *args)
+{
+	struct btr_trace	*trace = tcx->tc_trace.ti_trace;
+	struct btr_root		*root  = tcx->tc_tins.ti_root;
+	struct btr_node		*nd;
+	umem_off_t		 sub_off;
+	int			 level;
+	int			 i;
+	int			 rc;
+
+	if (btr_has_embedded_value(tcx))
+		return btr_delete(tcx, args);
+
+	/* the subtree is the child pointed by the trace of this level */
+	for (level = tcx->tc_depth - 1; level >= 0; level--) {
+		if (trace[level].tr_at != 0 ||
+		    !btr_range_covers(tcx, trace[level].tr_node, key, hkey))
+			break;
+	}
+
+	if (level == tcx->tc_depth - 1)
+		return btr_delete(tcx, args);
+
+	if (level < 0) {
+		D_DEBUG(DB_TRACE, "Delete all records of the tree\n");
+		rc = btr_node_destroy(tcx, root->tr_node, args, NULL);
+		if (rc != 0)
+			return rc;
+
+		if (btr_has_tx(tcx)) {
+			rc = btr_root_tx_add(tcx);
+			if (rc != 0)
+				return rc;
+		}
+
+		root->tr_depth = 0;
+		root->tr_node  = BTR_NODE_NULL;
+		btr_context_set_depth(tcx, 0);
+		return 0;
+	}
+
+	/* For direct key, the parent key of a subtree points to the leftmost
+	 * leaf of the subtree. If the deleted subtree is the leftmost child,
+	 * the ancestor key pointing to its leftmost leaf should point to the
+	 * leftmost leaf of the next child, which is the first key of the node.
+	 */
+	if (btr_is_direct_key(tcx) && trace[level].tr_at == 0) {
+		for (i = level - 1; i >= 0 && trace[i].tr_at == 0; i--)
+			;
+		if (i >= 0) {
+			if (btr_has_tx(tcx)) {
+				rc = btr_node_tx_add(tcx, trace[i].tr_node);
+				if (rc != 0)
+					return rc;
+			}
+			btr_rec_copy_hkey(tcx,
+					  btr_node_rec_at(tcx, trace[i].tr_node,
+							  trace[i].tr_at - 1),
+					  btr_node_rec_at(tcx, trace[level].tr_node, 0));
+		}
+	}
+
+	/* NB: the subtree root is freed by deleting it from the parent */
+	sub_off = trace[level + 1].tr_node;
+	nd	= btr_off2ptr(tcx, sub_off);
+	D_DEBUG(DB_TRACE, "Delete subtree "DF_X64" at level %d, keyn %d\n",
+		sub_off, level + 1, nd->tn_keyn);
+
+	if (btr_node_is_leaf(tcx, sub_off)) {
+		for (i = 0; i < nd->tn_keyn; i++) {
+			rc = btr_rec_free(tcx, btr_node_rec_at(tcx, sub_off, i),
+					  args);
+			if (rc != 0)
+				return rc;
+		}
+	} else {
+		for (i = 0; i <= nd->tn_keyn; i++) {
+			rc = btr_node_destroy(tcx, btr_node_child_at(tcx, sub_off, i),
+					      args, NULL);
+			if (rc != 0)
+				return rc;
+		}
+	}
+
+	return btr_delete_at(tcx, level, args);
+}
+
+/**
+ * Delete all records between \a key_lo and \a key_hi (both inclusive) in
+ * the tree order. Subtrees within the range are freed as a whole instead of
+ * deleting and rebalancing for each record. Same as dbtree_drain, records
+ * are deleted without checking their availability.
+ *
+ * \param[in] toh	Tree open handle.
+ * \param[in] key_lo	The first key of the range, NULL for the first
+ *			record of the tree.
+ * \param[in] key_hi	The last key of the range, NULL for the last record
+ *			of the tree.
+ * \param[in] args	user parameter for btr_ops_t::to_rec_free
+ */
+int
+dbtree_delete_range(daos_handle_t toh, d_iov_t *key_lo, d_iov_t *key_hi,
+		    void *args)
+{
+	struct btr_context *tcx;
+	char		    hkey_lo[DAOS_HKEY_MAX] = {0};
+	char		    hkey_hi[DAOS_HKEY_MAX] = {0};
+	int		    cmp;
+	int		    rc;
+	int		    i;
+
+	tcx = btr_hdl2tcx(toh);
+	if (tcx == NULL)
+		return -DER_NO_HDL;
+
+	if (key_lo != NULL) {
+		rc = btr_verify_key(tcx, key_lo);
+		if (rc)
+			return rc;
+		btr_hkey_gen(tcx, key_lo, hkey_lo);
+	}
+
+	if (key_hi != NULL) {
+		rc = btr_verify_key(tcx, key_hi);
+		if (rc)
+			return rc;
+		btr_hkey_gen(tcx, key_hi, hkey_hi);
+	}
+
+	rc = btr_tx_begin(tcx);
+	if (rc != 0)
+		return rc;
+
+	for (i = 1;; i++) {
+		rc = btr_range_probe(tcx, key_lo, hkey_lo);
+		if (rc != PROBE_RC_OK) {
+			rc = (rc == PROBE_RC_NONE) ? 0 : -DER_INVAL;
+			break;
+		}
+
+		if (key_hi != NULL) {
+			cmp = btr_range_cmp(tcx, key_hi, hkey_hi);
+			if (cmp & BTR_CMP_ERR) {
+				rc = -DER_INVAL;
+				break;
+			}
+			if (cmp & BTR_CMP_GT) {
+				rc = 0;
+				break;
+			}
+		}
+
+		rc = btr_range_delete(tcx, key_hi, hkey_hi, args);
+		if (rc != 0)
+			break;
+
+		if (i % BTR_BULK_BATCH != 0)
+			continue;
+
+		rc = btr_tx_end(tcx, 0);
+		if (rc != 0)
+			goto out;
+
+		rc = btr_tx_begin(tcx);
+		if (rc != 0)
+			goto out;
+	}
+	rc = btr_tx_end(tcx, rc);
+out:
+	tcx->tc_probe_rc = PROBE_RC_UNKNOWN;
+	return rc;
+}
+
 /** gather statistics from a tree node and all its children recursively. */
 static void
 btr_node_stat(struct btr_context *tcx, umem_off_t nd_off,
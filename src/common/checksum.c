@@ -121,6 +121,11 @@ daos_csummer_copy(const struct daos_csummer *obj)
 
 	daos_csummer_init(&result, obj->dcs_algo,
 			  obj->dcs_chunk_size, obj->dcs_srv_verify);
+	if (result != NULL) {
+		result->dcs_skip_key_calc = obj->dcs_skip_key_calc;
+		result->dcs_skip_key_verify = obj->dcs_skip_key_verify;
+		result->dcs_skip_data_verify = obj->dcs_skip_data_verify;
+	}
 
 	return result;
 }
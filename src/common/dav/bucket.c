@@ -13,6 +13,8 @@
  * creation.
  */
 
+#include <sched.h>
+
 #include "alloc_class.h"
 #include "bucket.h"
 #include "heap.h"
@@ -34,11 +36,43 @@ struct bucket {
 	int is_active;
 };
 
+/*
+ * A memory block handed back to an exclusive bucket by a thread other than
+ * its owner. The entry holds a reservation of the run it belongs to.
+ */
+struct bucket_deferred {
+	struct bucket_deferred *next;
+	struct memory_block m;
+	struct memory_block_reserved *mresv;
+};
+
 struct bucket_locked {
 	struct bucket bucket;
 	os_mutex_t lock;
+
+	/*
+	 * Token of the thread the bucket is exclusive to, NULL if the bucket
+	 * is shared. The owner uses the bucket without taking the lock.
+	 */
+	const void *owner;
+
+	/*
+	 * The owner sets active while it uses the bucket without the lock,
+	 * another thread sets borrowed under the lock to use the bucket in
+	 * its place, see bucket_borrow.
+	 */
+	int active;
+	int borrowed;
+	/* the owner waited for a borrower and holds the lock */
+	int owner_locked;
+
+	/* lock-free stack of blocks returned by other threads */
+	struct bucket_deferred *deferred;
 };
 
+/* the address of this variable identifies the bucket owner */
+static __thread char bucket_thread_token;
+
 /*
  * bucket_init -- initializes the bucket's runtime state
  */
@@ -92,6 +126,11 @@ bucket_locked_new(struct block_container *c, struct alloc_class *aclass)
 
 	util_mutex_init(&b->lock);
 	b->bucket.locked = b;
+	b->owner = NULL;
+	b->active = 0;
+	b->borrowed = 0;
+	b->owner_locked = 0;
+	b->deferred = NULL;
 
 	return b;
 
@@ -106,18 +145,78 @@ err_bucket_init:
 void
 bucket_locked_delete(struct bucket_locked *b)
 {
+	struct bucket_deferred *d;
+	struct bucket_deferred *next;
+
+	for (d = b->deferred; d != NULL; d = next) {
+		next = d->next;
+		if (util_fetch_and_sub64(&d->mresv->nresv, 1) == 1)
+			D_FREE(d->mresv);
+		D_FREE(d);
+	}
+
 	bucket_fini(&b->bucket);
 	util_mutex_destroy(&b->lock);
 	D_FREE(b);
 }
 
+/*
+ * bucket_thread_owner -- returns the owner token of the calling thread
+ */
+const void *
+bucket_thread_owner(void)
+{
+	return &bucket_thread_token;
+}
+
+/*
+ * bucket_set_owner -- makes the bucket exclusive to the thread identified by
+ *	the owner token, or shared again if the token is NULL
+ */
+void
+bucket_set_owner(struct bucket_locked *b, const void *owner)
+{
+	/* wait for any thread that acquired the bucket while it was shared */
+	util_mutex_lock(&b->lock);
+	util_atomic_store_explicit64(&b->owner, owner, memory_order_release);
+	util_mutex_unlock(&b->lock);
+}
+
 /*
  * bucket_acquire -- acquires a usable bucket struct
+ *
+ * Returns NULL if the bucket is exclusive to another thread.
  */
 struct bucket *
 bucket_acquire(struct bucket_locked *b)
 {
+	const void *owner;
+	int borrowed;
+
+	util_atomic_load_explicit64(&b->owner, &owner, memory_order_acquire);
+	if (owner == &bucket_thread_token) {
+		/* pairs with the store of borrowed in bucket_borrow */
+		util_atomic_store_explicit32(&b->active, 1,
+			memory_order_seq_cst);
+		util_atomic_load_explicit32(&b->borrowed, &borrowed,
+			memory_order_seq_cst);
+		if (!borrowed)
+			return &b->bucket;
+
+		/* used by another thread, wait for it to return the bucket */
+		util_atomic_store_explicit32(&b->active, 0,
+			memory_order_release);
+		util_mutex_lock(&b->lock);
+		b->owner_locked = 1;
+		return &b->bucket;
+	}
+
 	util_mutex_lock(&b->lock);
+	if (b->owner != NULL) {
+		util_mutex_unlock(&b->lock);
+		return NULL;
+	}
+
 	return &b->bucket;
 }
 
@@ -127,9 +226,120 @@ bucket_acquire(struct bucket_locked *b)
 void
 bucket_release(struct bucket *b)
 {
+	struct bucket_locked *l = b->locked;
+
+	if (l->owner != &bucket_thread_token) {
+		util_mutex_unlock(&l->lock);
+	} else if (l->owner_locked) {
+		l->owner_locked = 0;
+		util_mutex_unlock(&l->lock);
+	} else {
+		util_atomic_store_explicit32(&l->active, 0,
+			memory_order_release);
+	}
+}
+
+/*
+ * bucket_borrow -- acquires a bucket whether or not it is exclusive to
+ *	another thread
+ *
+ * The owner of an exclusive bucket is waited for if it is using the bucket,
+ * and waits in turn on the bucket lock until bucket_return is called. The
+ * caller must not hold any bucket the owner might wait for.
+ */
+struct bucket *
+bucket_borrow(struct bucket_locked *b)
+{
+	int active;
+
+	util_mutex_lock(&b->lock);
+	util_atomic_store_explicit32(&b->borrowed, 1, memory_order_seq_cst);
+	for (;;) {
+		util_atomic_load_explicit32(&b->active, &active,
+			memory_order_seq_cst);
+		if (!active)
+			break;
+		sched_yield();
+	}
+
+	return &b->bucket;
+}
+
+/*
+ * bucket_return -- releases a bucket acquired by bucket_borrow
+ */
+void
+bucket_return(struct bucket *b)
+{
+	util_atomic_store_explicit32(&b->locked->borrowed, 0,
+		memory_order_release);
 	util_mutex_unlock(&b->locked->lock);
 }
 
+/*
+ * bucket_defer_attached_block -- hands a reserved memory block back to a
+ *	bucket exclusive to another thread
+ *
+ * The reservation of the run is taken over by the bucket and dropped once
+ * the owner drains the deferred blocks.
+ */
+int
+bucket_defer_attached_block(struct bucket_locked *b,
+	const struct memory_block *m, struct memory_block_reserved *mresv)
+{
+	struct bucket_deferred *d;
+
+	D_ALLOC_PTR_NZ(d);
+	if (d == NULL)
+		return -1;
+
+	d->m = *m;
+	d->mresv = mresv;
+	do {
+		util_atomic_load_explicit64(&b->deferred, &d->next,
+			memory_order_relaxed);
+	} while (!util_bool_compare_and_swap64(&b->deferred, d->next, d));
+
+	return 0;
+}
+
+/*
+ * bucket_drain_deferred -- returns the blocks deferred by other threads to
+ *	the bucket and drops the run reservations they held
+ */
+void
+bucket_drain_deferred(struct palloc_heap *heap, struct bucket *b)
+{
+	struct bucket_deferred *d;
+	struct bucket_deferred *next;
+
+	util_atomic_load_explicit64(&b->locked->deferred, &d,
+		memory_order_relaxed);
+	if (d == NULL)
+		return;
+
+	while (!util_bool_compare_and_swap64(&b->locked->deferred, d, NULL))
+		util_atomic_load_explicit64(&b->locked->deferred, &d,
+			memory_order_relaxed);
+
+	for (; d != NULL; d = next) {
+		next = d->next;
+
+		/* the run might have been detached in the meantime */
+		if (b->is_active && b->active_memory_block == d->mresv)
+			bucket_insert_block(b, &d->m);
+
+		if (util_fetch_and_sub64(&d->mresv->nresv, 1) == 1) {
+			VALGRIND_ANNOTATE_HAPPENS_AFTER(&d->mresv->nresv);
+			heap_discard_run(heap, &d->mresv->m);
+			D_FREE(d->mresv);
+		} else {
+			VALGRIND_ANNOTATE_HAPPENS_BEFORE(&d->mresv->nresv);
+		}
+		D_FREE(d);
+	}
+}
+
 /*
  * bucket_try_insert_attached_block -- tries to return a previously allocated
  *	memory block back to the original bucket
@@ -26,6 +26,14 @@ struct bucket_locked *bucket_locked_new(struct block_container *c,
 
 struct bucket *bucket_acquire(struct bucket_locked *b);
 void bucket_release(struct bucket *b);
+struct bucket *bucket_borrow(struct bucket_locked *b);
+void bucket_return(struct bucket *b);
+
+const void *bucket_thread_owner(void);
+void bucket_set_owner(struct bucket_locked *b, const void *owner);
+int bucket_defer_attached_block(struct bucket_locked *b,
+	const struct memory_block *m, struct memory_block_reserved *mresv);
+void bucket_drain_deferred(struct palloc_heap *heap, struct bucket *b);
 
 struct alloc_class *bucket_alloc_class(struct bucket *b);
 int bucket_insert_block(struct bucket *b, const struct memory_block *m);
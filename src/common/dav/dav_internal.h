@@ -31,6 +31,7 @@ enum dav_stats_enabled {
 enum dav_arenas_assignment_type {
 	DAV_ARENAS_ASSIGNMENT_THREAD_KEY,
 	DAV_ARENAS_ASSIGNMENT_GLOBAL,
+	DAV_ARENAS_ASSIGNMENT_THREAD_EXCLUSIVE,
 };
 
 #define	DAV_PHDR_SIZE	4096
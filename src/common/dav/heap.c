@@ -64,6 +64,11 @@ struct arenas {
  * Arenas store the collection of buckets for allocation classes.
  * Each thread is assigned an arena on its first allocator operation
  * if arena is set to auto.
+ *
+ * With the thread exclusive assignment every thread claims an arena of its
+ * own instead, whose buckets it accesses without locking. Other threads
+ * hand blocks back through the deferred list of the bucket, and only
+ * heap_force_recycle borrows such buckets from their owner.
  */
 struct arena {
 	/* one bucket per allocation class */
@@ -76,6 +81,11 @@ struct arena {
 	int automatic;
 	size_t nthreads;
 	struct arenas *arenas;
+
+	/* the arena is claimed by a single thread at a time */
+	int exclusive;
+	/* bucket owner token of the claiming thread, NULL if unclaimed */
+	const void *owner;
 };
 
 struct heap_rt {
@@ -189,6 +199,8 @@ heap_arena_new(struct palloc_heap *heap, int automatic)
 	arena->nthreads = 0;
 	arena->automatic = automatic;
 	arena->arenas = &heap->rt->arenas;
+	arena->exclusive = 0;
+	arena->owner = NULL;
 
 	COMPILE_ERROR_ON(MAX_ALLOCATION_CLASSES > UINT8_MAX);
 	for (uint8_t i = 0; i < MAX_ALLOCATION_CLASSES; ++i) {
@@ -271,8 +283,26 @@ heap_arena_thread_attach(struct palloc_heap *heap, struct arena *a)
 	os_tls_set(assignment->thread, a);
 }
 
+/*
+ * heap_arena_set_owner -- (internal) makes the arena buckets exclusive to the
+ *	thread identified by the owner token, or shared if the token is NULL
+ *
+ * Must be called with arenas lock taken.
+ */
+static void
+heap_arena_set_owner(struct arena *a, const void *owner)
+{
+	for (int i = 0; i < MAX_ALLOCATION_CLASSES; ++i)
+		if (a->buckets[i] != NULL)
+			bucket_set_owner(a->buckets[i], owner);
+	a->owner = owner;
+}
+
 /*
  * heap_thread_arena_destructor -- (internal) removes arena thread assignment
+ *
+ * An exclusive arena keeps its active runs and is left for the next thread
+ * that claims one.
  */
 static void
 heap_thread_arena_destructor(void *arg)
@@ -280,6 +310,8 @@ heap_thread_arena_destructor(void *arg)
 	struct arena *a = arg;
 
 	os_mutex_lock(&a->arenas->lock);
+	if (a->exclusive)
+		heap_arena_set_owner(a, NULL);
 	heap_arena_thread_detach(a);
 	os_mutex_unlock(&a->arenas->lock);
 }
@@ -298,6 +330,7 @@ arena_thread_assignment_init(struct arenas_thread_assignment *assignment,
 
 	switch (type) {
 	case DAV_ARENAS_ASSIGNMENT_THREAD_KEY:
+	case DAV_ARENAS_ASSIGNMENT_THREAD_EXCLUSIVE:
 		ret = os_tls_key_create(&assignment->thread,
 			heap_thread_arena_destructor);
 		break;
@@ -320,6 +353,7 @@ arena_thread_assignment_fini(struct arenas_thread_assignment *assignment)
 {
 	switch (assignment->type) {
 	case DAV_ARENAS_ASSIGNMENT_THREAD_KEY:
+	case DAV_ARENAS_ASSIGNMENT_THREAD_EXCLUSIVE:
 		os_tls_key_delete(assignment->thread);
 		break;
 	case DAV_ARENAS_ASSIGNMENT_GLOBAL:
@@ -408,6 +442,59 @@ heap_thread_arena_assign(struct palloc_heap *heap)
 	return least_used;
 }
 
+/*
+ * heap_thread_arena_claim -- (internal) claims an exclusive arena for the
+ *	current thread
+ *
+ * Arenas left behind by exited threads are reused before new ones are
+ * created. If no arena can be created, the thread falls back to the first
+ * automatic arena without remembering it, and retries on the next call.
+ */
+static struct arena *
+heap_thread_arena_claim(struct palloc_heap *heap)
+{
+	struct arenas *arenas = &heap->rt->arenas;
+	struct arena *claimed = NULL;
+	struct arena *a;
+
+	util_mutex_lock(&arenas->lock);
+
+	VEC_FOREACH(a, &arenas->vec) {
+		if (a->exclusive && a->owner == NULL) {
+			claimed = a;
+			break;
+		}
+	}
+
+	if (claimed == NULL) {
+		claimed = heap_arena_new(heap, 0);
+		if (claimed != NULL && VEC_PUSH_BACK(&arenas->vec, claimed)) {
+			heap_arena_delete(claimed);
+			claimed = NULL;
+		}
+		if (claimed == NULL) {
+			VEC_FOREACH(a, &arenas->vec) {
+				if (a->automatic)
+					break;
+			}
+			util_mutex_unlock(&arenas->lock);
+			return a;
+		}
+		claimed->exclusive = 1;
+	}
+
+	DAV_DBG("claiming %p arena for current thread", claimed);
+
+	heap_arena_set_owner(claimed, bucket_thread_owner());
+	if ((claimed->nthreads++) == 0)
+		util_fetch_and_add64(&arenas->nactive, 1);
+	os_tls_set(arenas->assignment.thread, claimed);
+
+	util_mutex_unlock(&arenas->lock);
+
+	return claimed;
+}
+
 /*
  * heap_thread_arena -- (internal) returns the arena assigned to the current
  *	thread
@@ -430,6 +517,11 @@ heap_thread_arena(struct palloc_heap *heap)
 		if (arena == NULL)
 			arena = heap_global_arena_assign(heap);
 		break;
+	case DAV_ARENAS_ASSIGNMENT_THREAD_EXCLUSIVE:
+		arena = os_tls_get(assignment->thread);
+		if (arena == NULL)
+			arena = heap_thread_arena_claim(heap);
+		break;
 	default:
 		ASSERT(0); /* unreachable */
 	}
@@ -468,6 +560,8 @@ heap_get_thread_arena_id(struct palloc_heap *heap)
 /*
  * heap_bucket_acquire -- fetches by arena or by id a bucket exclusive
  * for the thread until heap_bucket_release is called
+ *
+ * Returns NULL if the bucket belongs to an arena exclusive to another thread.
  */
 struct bucket *
 heap_bucket_acquire(struct palloc_heap *heap, uint8_t class_id,
@@ -475,11 +569,10 @@ heap_bucket_acquire(struct palloc_heap *heap, uint8_t class_id,
 {
 	struct heap_rt *rt = heap->rt;
 	struct bucket_locked *b;
+	struct bucket *bucket;
 
-	if (class_id == DEFAULT_ALLOC_CLASS_ID) {
-		b = rt->default_bucket;
-		goto out;
-	}
+	if (class_id == DEFAULT_ALLOC_CLASS_ID)
+		return bucket_acquire(rt->default_bucket);
 
 	if (arena_id == HEAP_ARENA_PER_THREAD) {
 		struct arena *arena = heap_thread_arena(heap);
@@ -491,8 +584,12 @@ heap_bucket_acquire(struct palloc_heap *heap, uint8_t class_id,
 			[arena_id - 1])->buckets[class_id];
 	}
 
-out:
-	return bucket_acquire(b);
+	bucket = bucket_acquire(b);
+	if (bucket == NULL)
+		return NULL;
+	bucket_drain_deferred(heap, bucket);
+
+	return bucket;
 }
 
 /*
@@ -1000,11 +1097,13 @@ heap_force_recycle(struct palloc_heap *heap)
 			if (locked == NULL)
 				continue;
 
-			struct bucket *b = bucket_acquire(locked);
+			/* the owner of an exclusive arena might be idle */
+			struct bucket *b = bucket_borrow(locked);
 
+			bucket_drain_deferred(heap, b);
 			heap_detach_and_try_discard_run(heap, b);
 
-			bucket_release(b);
+			bucket_return(b);
 		}
 	}
 	util_mutex_unlock(&heap->rt->arenas.lock);
@@ -1457,11 +1556,15 @@ heap_create_alloc_class_buckets(struct palloc_heap *heap, struct alloc_class *c)
 
 	VEC_FOREACH_BY_POS(i, &h->arenas.vec) {
 		arena = VEC_ARR(&h->arenas.vec)[i];
-		if (arena->buckets[c->id] == NULL)
+		if (arena->buckets[c->id] == NULL) {
 			arena->buckets[c->id] = bucket_locked_new(
 				container_new_seglists(heap), c);
-		if (arena->buckets[c->id] == NULL)
-			goto error_cache_bucket_new;
+			if (arena->buckets[c->id] == NULL)
+				goto error_cache_bucket_new;
+			if (arena->owner != NULL)
+				bucket_set_owner(arena->buckets[c->id],
+					arena->owner);
+		}
 	}
 
 	return 0;
@@ -1543,6 +1646,8 @@ heap_boot(struct palloc_heap *heap, void *heap_start, uint64_t heap_size,
 	  struct stats *stats, struct pool_set *set)
 {
 	struct heap_rt *h;
+	enum dav_arenas_assignment_type assignment_type;
+	bool thread_arenas = false;
 	int err;
 
 	/*
@@ -1566,8 +1671,13 @@ heap_boot(struct palloc_heap *heap, void *heap_start, uint64_t heap_size,
 		goto error_heap_malloc;
 	}
 
+	assignment_type = Default_arenas_assignment_type;
+	d_getenv_bool("DAOS_DAV_THREAD_ARENAS", &thread_arenas);
+	if (thread_arenas)
+		assignment_type = DAV_ARENAS_ASSIGNMENT_THREAD_EXCLUSIVE;
+
 	err = arena_thread_assignment_init(&h->arenas.assignment,
-		Default_arenas_assignment_type);
+		assignment_type);
 	if (err != 0)
 		goto error_assignment_init;
 
@@ -1580,6 +1690,10 @@ heap_boot(struct palloc_heap *heap, void *heap_start, uint64_t heap_size,
 	unsigned narenas_default = Default_arenas_max == 0 ?
 		heap_get_procs() : (unsigned)Default_arenas_max;
 
+	/* threads claim their own arenas, keep a single shared fallback */
+	if (assignment_type == DAV_ARENAS_ASSIGNMENT_THREAD_EXCLUSIVE)
+		narenas_default = 1;
+
 	if (heap_arenas_init(&h->arenas) != 0) {
 		err = ENOMEM;
 		goto error_arenas_malloc;
@@ -224,6 +224,12 @@ palloc_reservation_create(struct palloc_heap *heap, size_t size,
 
 	struct bucket *b = heap_bucket_acquire(heap, c->id, arena_id);
 
+	if (b == NULL) {
+		ERR("arena %u is exclusive to another thread", arena_id);
+		errno = EINVAL;
+		return -1;
+	}
+
 	err = heap_get_bestfit_block(heap, b, new_block);
 	if (err != 0)
 		goto out;
@@ -344,8 +350,17 @@ palloc_reservation_clear(struct palloc_heap *heap,
 		 */
 		struct bucket *b = bucket_acquire(locked);
 
-		bucket_try_insert_attached_block(b, &act->m);
-		bucket_release(b);
+		if (b != NULL) {
+			bucket_try_insert_attached_block(b, &act->m);
+			bucket_release(b);
+		} else if (bucket_defer_attached_block(locked, &act->m,
+			mresv) == 0) {
+			/*
+			 * The bucket is exclusive to another thread, which
+			 * will reinsert the block and drop the reservation.
+			 */
+			return;
+		}
 	}
 
 	if (util_fetch_and_sub64(&mresv->nresv, 1) == 1) {
@@ -415,6 +415,13 @@ daos_prop_valid(daos_prop_t *prop, bool pool, bool input)
 				return false;
 			}
 			break;
+		case DAOS_PROP_PO_SCHED_POLICY:
+			val = prop->dpp_entries[i].dpe_val;
+			if (val >= DAOS_SCHED_POLICY_MAX) {
+				D_ERROR("invalid sched policy " DF_U64 ".\n", val);
+				return false;
+			}
+			break;
 		/* container-only properties */
 		case DAOS_PROP_CO_LAYOUT_TYPE:
 			val = prop->dpp_entries[i].dpe_val;
@@ -67,6 +67,8 @@ static int	test_group_start;
 static int	test_group_stop;
 
 #define IK_TREE_CLASS	100
+/* same records as IK_TREE_CLASS, compared through btr_ops_t::to_hkey_cmp */
+#define IK_CMP_TREE_CLASS	101
 #define POOL_NAME "/mnt/daos/btree-test"
 #define POOL_SIZE ((1024 * 1024 * 1024ULL))
 
@@ -264,6 +266,36 @@ static btr_ops_t ik_ops = {
     .to_rec_stat   = ik_rec_stat,
 };
 
+/* order of the hashed keys of IK_CMP_TREE_CLASS, numeric or memcmp */
+static bool ik_cmp_uint;
+
+static int
+ik_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
+{
+	uint64_t	ka;
+	uint64_t	kb;
+
+	if (!ik_cmp_uint)
+		return dbtree_key_cmp_rc(memcmp(&rec->rec_hkey[0], hkey, sizeof(ka)));
+
+	memcpy(&ka, &rec->rec_hkey[0], sizeof(ka));
+	memcpy(&kb, hkey, sizeof(kb));
+	return ka < kb ? BTR_CMP_LT : (ka > kb ? BTR_CMP_GT : BTR_CMP_EQ);
+}
+
+static btr_ops_t ik_cmp_ops = {
+    .to_hkey_size  = ik_hkey_size,
+    .to_hkey_gen   = ik_hkey_gen,
+    .to_hkey_cmp   = ik_hkey_cmp,
+    .to_key_cmp    = ik_key_cmp,
+    .to_rec_alloc  = ik_rec_alloc,
+    .to_rec_free   = ik_rec_free,
+    .to_rec_fetch  = ik_rec_fetch,
+    .to_rec_update = ik_rec_update,
+    .to_rec_string = ik_rec_string,
+    .to_rec_stat   = ik_rec_stat,
+};
+
 #define IK_SEP		','
 #define IK_SEP_VAL	':'
 
@@ -835,6 +867,319 @@ ik_btr_perf(void **state)
 }
 
 
+struct ik_bulk_arg {
+	uint64_t	*ba_keys;
+	unsigned int	 ba_nr;
+	unsigned int	 ba_at;
+	/* returned at the end of the input */
+	int		 ba_end;
+	uint64_t	 ba_key;
+	char		 ba_buf[32];
+};
+
+/* keys are sorted in the order of the tree: numeric for BTR_FEAT_UINT_KEY,
+ * otherwise memcmp order of the hashed key (copy of the key).
+ */
+static bool ik_bulk_uint;
+
+static int
+ik_bulk_key_cmp(const void *a, const void *b)
+{
+	uint64_t	ka = *(const uint64_t *)a;
+	uint64_t	kb = *(const uint64_t *)b;
+
+	if (ik_bulk_uint)
+		return ka < kb ? -1 : (ka > kb ? 1 : 0);
+
+	return memcmp(a, b, sizeof(uint64_t));
+}
+
+static int
+ik_bulk_load_cb(d_iov_t *key, d_iov_t *val, void *arg)
+{
+	struct ik_bulk_arg	*ba = arg;
+
+	if (ba->ba_at == ba->ba_nr)
+		return ba->ba_end;
+
+	ba->ba_key = ba->ba_keys[ba->ba_at++];
+	sprintf(ba->ba_buf, DF_U64, ba->ba_key);
+	d_iov_set(key, &ba->ba_key, sizeof(ba->ba_key));
+	d_iov_set(val, ba->ba_buf, strlen(ba->ba_buf) + 1);
+	return 0;
+}
+
+/**
+ * bulk load and range delete:
+ * 1) bulk load @key_nr integer keys sorted in the order of the tree
+ * 2) lookup all keys
+ * 3) range delete the middle third of keys, then verify all keys
+ * 4) range delete all keys, the tree should be empty
+ * 5) a load callback returning a positive value other than 1 fails the load
+ */
+static void
+ik_btr_bulk(void **state)
+{
+	struct ik_bulk_arg	 ba = { 0 };
+	struct btr_attr		 attr;
+	d_iov_t			 key_iov;
+	d_iov_t			 hi_iov;
+	d_iov_t			 val_iov;
+	unsigned int		 key_nr;
+	unsigned int		 lo;
+	unsigned int		 hi;
+	double			 then;
+	double			 now;
+	int			 i;
+	int			 rc;
+
+	key_nr = atoi(tst_fn_val.optval);
+	if (key_nr == 0 || key_nr > (1U << 28)) {
+		D_PRINT("Invalid key number: %d\n", key_nr);
+		fail();
+	}
+
+	rc = dbtree_query(ik_toh, &attr, NULL);
+	if (rc != 0)
+		fail_msg("Failed to query btree: %d\n", rc);
+	ik_bulk_uint = (attr.ba_feats & BTR_FEAT_UINT_KEY) != 0;
+
+	D_ALLOC_ARRAY(ba.ba_keys, key_nr);
+	if (ba.ba_keys == NULL)
+		fail_msg("Array allocation failed\n");
+
+	for (i = 0; i < key_nr; i++)
+		ba.ba_keys[i] = i + 1;
+	qsort(ba.ba_keys, key_nr, sizeof(*ba.ba_keys), ik_bulk_key_cmp);
+	ba.ba_nr  = key_nr;
+	ba.ba_end = 1;
+
+	D_PRINT("Bulk load %d records.\n", key_nr);
+	then = dts_time_now();
+	rc = dbtree_bulk_load(ik_toh, ik_bulk_load_cb, &ba);
+	if (rc != 0)
+		fail_msg("Failed to bulk load btree: %d\n", rc);
+	now = dts_time_now();
+	D_PRINT("bulk load = %10.2f/sec\n", key_nr / (now - then));
+
+	ik_btr_query(NULL);
+	for (i = 0; i < key_nr; i++) {
+		d_iov_set(&key_iov, &ba.ba_keys[i], sizeof(ba.ba_keys[i]));
+		d_iov_set(&val_iov, NULL, 0);
+		rc = dbtree_lookup(ik_toh, &key_iov, &val_iov);
+		if (rc != 0)
+			fail_msg("Failed to lookup "DF_U64"\n", ba.ba_keys[i]);
+		if (strtoull(val_iov.iov_buf, NULL, 0) != ba.ba_keys[i])
+			fail_msg("Wrong value of "DF_U64"\n", ba.ba_keys[i]);
+	}
+
+	lo = key_nr / 3;
+	hi = key_nr - key_nr / 3 - 1;
+	if (lo <= hi) {
+		D_PRINT("Range delete %d records.\n", hi - lo + 1);
+		d_iov_set(&key_iov, &ba.ba_keys[lo], sizeof(ba.ba_keys[lo]));
+		d_iov_set(&hi_iov, &ba.ba_keys[hi], sizeof(ba.ba_keys[hi]));
+		rc = dbtree_delete_range(ik_toh, &key_iov, &hi_iov, NULL);
+		if (rc != 0)
+			fail_msg("Failed to range delete btree: %d\n", rc);
+	}
+
+	for (i = 0; i < key_nr; i++) {
+		d_iov_set(&key_iov, &ba.ba_keys[i], sizeof(ba.ba_keys[i]));
+		d_iov_set(&val_iov, NULL, 0);
+		rc = dbtree_lookup(ik_toh, &key_iov, &val_iov);
+		if (i >= lo && i <= hi) {
+			if (rc != -DER_NONEXIST)
+				fail_msg("Deleted key "DF_U64" is found: %d\n",
+					 ba.ba_keys[i], rc);
+		} else if (rc != 0) {
+			fail_msg("Failed to lookup "DF_U64"\n", ba.ba_keys[i]);
+		}
+	}
+	ik_btr_query(NULL);
+
+	D_PRINT("Range delete all records.\n");
+	rc = dbtree_delete_range(ik_toh, NULL, NULL, NULL);
+	if (rc != 0)
+		fail_msg("Failed to range delete btree: %d\n", rc);
+	if (!dbtree_is_empty(ik_toh))
+		fail_msg("Tree is not empty after deleting all records\n");
+
+	D_PRINT("Bulk load with invalid end of input.\n");
+	ba.ba_at  = 0;
+	ba.ba_end = 2;
+	rc = dbtree_bulk_load(ik_toh, ik_bulk_load_cb, &ba);
+	if (rc != -DER_INVAL)
+		fail_msg("Bulk load with invalid end of input returned %d\n", rc);
+	rc = dbtree_delete_range(ik_toh, NULL, NULL, NULL);
+	if (rc != 0)
+		fail_msg("Failed to range delete btree: %d\n", rc);
+
+	D_FREE(ba.ba_keys);
+}
+
+/* result of a probe in the sorted @keys, -1 if no key matches */
+static int
+ik_probe_expect(uint64_t *keys, unsigned int key_nr, dbtree_probe_opc_t opc,
+		uint64_t key)
+{
+	int	i;
+	int	cmp;
+
+	for (i = 0; i < key_nr; i++) {
+		cmp = ik_bulk_key_cmp(&keys[i], &key);
+		if ((opc == BTR_PROBE_EQ && cmp == 0) ||
+		    (opc == BTR_PROBE_GE && cmp >= 0) ||
+		    (opc == BTR_PROBE_GT && cmp > 0))
+			return i;
+	}
+
+	for (i = key_nr - 1; i >= 0; i--) {
+		cmp = ik_bulk_key_cmp(&keys[i], &key);
+		if ((opc == BTR_PROBE_LE && cmp <= 0) ||
+		    (opc == BTR_PROBE_LT && cmp < 0))
+			return i;
+	}
+	return -1;
+}
+
+/* fetch the key at the trace of @toh, its next one, and compare with @cmp_toh */
+static void
+ik_probe_trace_cmp(daos_handle_t toh, daos_handle_t cmp_toh, uint64_t key,
+		   dbtree_probe_opc_t opc)
+{
+	d_iov_t		 key_iov;
+	d_iov_t		 cmp_iov;
+	uint64_t	 rec_key;
+	uint64_t	 cmp_key;
+	int		 rc;
+	int		 cmp_rc;
+	int		 i;
+
+	for (i = 0; i < 2; i++) {
+		/* integer keys need a buffer of the key size */
+		d_iov_set(&key_iov, &rec_key, sizeof(rec_key));
+		d_iov_set(&cmp_iov, &cmp_key, sizeof(cmp_key));
+		if (i == 0) {
+			rc = dbtree_fetch_cur(toh, &key_iov, NULL);
+			cmp_rc = dbtree_fetch_cur(cmp_toh, &cmp_iov, NULL);
+		} else {
+			rc = dbtree_fetch_next(toh, &key_iov, NULL, false);
+			cmp_rc = dbtree_fetch_next(cmp_toh, &cmp_iov, NULL, false);
+		}
+		if (rc != cmp_rc || (rc == 0 && rec_key != cmp_key))
+			fail_msg("Probe %#x of "DF_U64" left a different %s record: %d/%d\n",
+				 opc, key, i == 0 ? "current" : "next", rc, cmp_rc);
+	}
+}
+
+/**
+ * probe opcodes:
+ * 1) insert @key_nr even keys in random order, both in the tree and in a tree
+ *    of IK_CMP_TREE_CLASS, which is searched through btr_ops_t::to_hkey_cmp
+ *    instead of the inline node search
+ * 2) fetch all the keys and the odd keys around them with every probe opcode,
+ *    check the results against the sorted keys, and check that both trees are
+ *    left with the same trace
+ */
+static void
+ik_btr_probe(void **state)
+{
+	static const dbtree_probe_opc_t opcs[] = {
+		BTR_PROBE_EQ, BTR_PROBE_GE, BTR_PROBE_GT, BTR_PROBE_LE, BTR_PROBE_LT,
+	};
+	struct btr_attr		 attr;
+	daos_handle_t		 cmp_toh;
+	umem_off_t		 cmp_root_off = UMOFF_NULL;
+	d_iov_t			 key_iov;
+	d_iov_t			 out_iov;
+	d_iov_t			 val_iov;
+	unsigned int		*arr;
+	uint64_t		*keys;
+	uint64_t		 key;
+	unsigned int		 key_nr;
+	char			 buf[32];
+	int			 expect;
+	int			 i;
+	int			 j;
+	int			 k;
+	int			 rc;
+
+	key_nr = atoi(tst_fn_val.optval);
+	if (key_nr == 0 || key_nr > (1U << 28)) {
+		D_PRINT("Invalid key number: %d\n", key_nr);
+		fail();
+	}
+
+	rc = dbtree_query(ik_toh, &attr, NULL);
+	if (rc != 0)
+		fail_msg("Failed to query btree: %d\n", rc);
+	ik_bulk_uint = (attr.ba_feats & BTR_FEAT_UINT_KEY) != 0;
+	ik_cmp_uint  = ik_bulk_uint;
+
+	/* same features and order, so that both trees have the same shape */
+	rc = dbtree_create(IK_CMP_TREE_CLASS, attr.ba_feats & ~BTR_FEAT_UINT_KEY,
+			   attr.ba_order, ik_uma, &cmp_root_off, &cmp_toh);
+	if (rc != 0)
+		fail_msg("Failed to create btree: %d\n", rc);
+
+	D_ALLOC_ARRAY(arr, key_nr);
+	D_ALLOC_ARRAY(keys, key_nr);
+	if (arr == NULL || keys == NULL)
+		fail_msg("Array allocation failed\n");
+
+	D_PRINT("Insert %d records.\n", key_nr);
+	ik_btr_gen_keys(arr, key_nr);
+	for (i = 0; i < key_nr; i++) {
+		keys[i] = 2 * (uint64_t)arr[i];
+		sprintf(buf, DF_U64, keys[i]);
+		d_iov_set(&key_iov, &keys[i], sizeof(keys[i]));
+		d_iov_set(&val_iov, buf, strlen(buf) + 1);
+		rc = dbtree_update(ik_toh, &key_iov, &val_iov);
+		if (rc == 0)
+			rc = dbtree_update(cmp_toh, &key_iov, &val_iov);
+		if (rc != 0)
+			fail_msg("Failed to insert "DF_U64": %d\n", keys[i], rc);
+	}
+	qsort(keys, key_nr, sizeof(*keys), ik_bulk_key_cmp);
+
+	D_PRINT("Probe %d keys.\n", 2 * key_nr + 1);
+	for (i = 0; i <= 2 * key_nr; i++) {
+		key = i + 1;
+		d_iov_set(&key_iov, &key, sizeof(key));
+		for (j = 0; j < ARRAY_SIZE(opcs); j++) {
+			expect = ik_probe_expect(keys, key_nr, opcs[j], key);
+			for (k = 0; k < 2; k++) {
+				d_iov_set(&out_iov, NULL, 0);
+				rc = dbtree_fetch(k == 0 ? ik_toh : cmp_toh, opcs[j],
+						  DAOS_INTENT_DEFAULT, &key_iov, &out_iov, NULL);
+				if (expect < 0 && rc == -DER_NONEXIST)
+					continue;
+				if (expect < 0 || rc != 0)
+					fail_msg("Probe %#x of "DF_U64" in %s tree: %d\n",
+						 opcs[j], key, k == 0 ? "tested" : "reference", rc);
+				if (*(uint64_t *)out_iov.iov_buf != keys[expect])
+					fail_msg("Probe %#x of "DF_U64" in %s tree got "DF_U64
+						 ", expected "DF_U64"\n", opcs[j], key,
+						 k == 0 ? "tested" : "reference",
+						 *(uint64_t *)out_iov.iov_buf, keys[expect]);
+			}
+			ik_probe_trace_cmp(ik_toh, cmp_toh, key, opcs[j]);
+		}
+	}
+
+	rc = dbtree_destroy(cmp_toh, NULL);
+	if (rc != 0)
+		fail_msg("Failed to destroy btree: %d\n", rc);
+	rc = dbtree_delete_range(ik_toh, NULL, NULL, NULL);
+	if (rc != 0)
+		fail_msg("Failed to range delete btree: %d\n", rc);
+
+	D_FREE(keys);
+	D_FREE(arr);
+	print_message("Test Passed\n");
+}
+
 static void
 ik_btr_drain(void **state)
 {
@@ -899,6 +1244,8 @@ static struct option btr_ops[] = {
 	{ "iterate",	required_argument,	NULL,	'i'	},
 	{ "batch",	required_argument,	NULL,	'b'	},
 	{ "perf",	required_argument,	NULL,	'p'	},
+	{ "bulk",	required_argument,	NULL,	'l'	},
+	{ "probe",	required_argument,	NULL,	'P'	},
 	{ NULL,		0,			NULL,	0	},
 };
 
@@ -923,7 +1270,7 @@ ts_group(void **state) {
 
 	while ((opt = getopt_long(test_group_stop-test_group_start+1,
 				  test_group_args+test_group_start,
-				  "tmC:Deocqu:d:r:f:i:b:p:",
+				  "tmC:Deocqu:d:r:f:i:b:p:l:P:",
 				  btr_ops,
 				  NULL)) != -1) {
 		tst_fn_val.optval = optarg;
@@ -977,6 +1324,12 @@ ts_group(void **state) {
 		case 'p':
 			ik_btr_perf(st);
 			break;
+		case 'l':
+			ik_btr_bulk(st);
+			break;
+		case 'P':
+			ik_btr_probe(st);
+			break;
 		default:
 			D_PRINT("Unsupported command %c\n", opt);
 		case 'm':
@@ -1054,7 +1407,7 @@ main(int argc, char **argv)
 		test_name = "Btree testing tool";
 		optind = 0;
 		/* Check for -m option first */
-		while ((opt = getopt_long(argc, argv, "tmC:Deocqu:d:r:f:i:b:p:",
+		while ((opt = getopt_long(argc, argv, "tmC:Deocqu:d:r:f:i:b:p:l:P:",
 					  btr_ops, NULL)) != -1) {
 			if (opt == 'm') {
 				rc = use_pmem();
@@ -1070,6 +1423,9 @@ main(int argc, char **argv)
 	rc = dbtree_class_register(
 	    IK_TREE_CLASS, dynamic_flag | BTR_FEAT_EMBED_FIRST | BTR_FEAT_UINT_KEY, &ik_ops);
 	D_ASSERT(rc == 0);
+	rc = dbtree_class_register(IK_CMP_TREE_CLASS, dynamic_flag | BTR_FEAT_EMBED_FIRST,
+				   &ik_cmp_ops);
+	D_ASSERT(rc == 0);
 
 	if (ik_utx == NULL) {
 		D_PRINT("Using vmem\n");
@@ -38,6 +38,7 @@ EOF
 }
 
 PERF=""
+DIRECT=""
 UINT=""
 test_conf_pre=""
 while [ $# -gt 0 ]; do
@@ -75,6 +76,7 @@ while [ $# -gt 0 ]; do
         ;;
     direct)
         BTR=${SL_BUILD_DIR}/src/common/tests/btree_direct
+        DIRECT="on"
         KEYS=${KEYS:-"delta,lambda,kappa,omega,beta,alpha,epsilon"}
         RECORDS=${RECORDS:-"omega:loaded,delta:that,kappa:dice,beta:knows,epsilon:the,lambda:are,alpha:Everybody"}
         shift
@@ -141,6 +143,22 @@ run_test()
         "${DYN}" "${PMEM}" -C "${UINT}${IPL}o:$ORDER" \
         -e -D
 
+        if [ -z "${DIRECT}" ]; then
+            echo "B+tree bulk load test..."
+            eval "${VCMD}" "$BTR" \
+            --start-test "btree bulk load ${test_conf_pre} ${test_conf}" \
+            "${DYN}" "${PMEM}" -C "${UINT}${IPL}o:$ORDER" \
+            -l "$BAT_NUM"                               \
+            -D
+
+            echo "B+tree probe test..."
+            eval "${VCMD}" "$BTR" \
+            --start-test "btree probe ${test_conf_pre} ${test_conf}" \
+            "${DYN}" "${PMEM}" -C "${UINT}${IPL}o:$ORDER" \
+            -P "$BAT_NUM"                               \
+            -D
+        fi
+
     else
         echo "B+tree performance test..."
         eval "${VCMD}" "$BTR" \
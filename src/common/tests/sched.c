@@ -1339,6 +1339,196 @@ out:
 }
 
 
+#define NR_COMP_THREADS	4
+
+struct comp_queue_arg {
+	ATOMIC int	 cqa_comp_cnt;
+	int		 cqa_result;
+	tse_task_t	**cqa_tasks;
+};
+
+struct comp_queue_thread_arg {
+	struct comp_queue_arg	*cta_arg;
+	int			 cta_th_id;
+};
+
+static int
+comp_queue_child_body(tse_task_t *task)
+{
+	/** completed by the completer threads */
+	return 0;
+}
+
+static int
+comp_queue_child_cb(tse_task_t *task, void *data)
+{
+	struct comp_queue_arg *arg = *(struct comp_queue_arg **)data;
+
+	atomic_fetch_add(&arg->cqa_comp_cnt, 1);
+	return 0;
+}
+
+static int
+comp_queue_parent_body(tse_task_t *task)
+{
+	struct comp_queue_arg *arg = tse_task_get_priv(task);
+
+	if (atomic_load(&arg->cqa_comp_cnt) != TASK_COUNT) {
+		print_error("parent ran after %d of %d deps\n",
+			    atomic_load(&arg->cqa_comp_cnt), TASK_COUNT);
+		arg->cqa_result = -DER_INVAL;
+	} else {
+		arg->cqa_result = 0;
+	}
+	tse_task_complete(task, arg->cqa_result);
+	return 0;
+}
+
+static void *
+th_comp_queue_complete(void *data)
+{
+	struct comp_queue_thread_arg	*targ = data;
+	int				 i;
+
+	for (i = targ->cta_th_id; i < TASK_COUNT; i += NR_COMP_THREADS)
+		tse_task_complete(targ->cta_arg->cqa_tasks[i], 0);
+	pthread_exit(NULL);
+}
+
+static void
+sched_test_11(void **state)
+{
+	pthread_t			th;
+	pthread_t			c_th[NR_COMP_THREADS];
+	struct comp_queue_thread_arg	targs[NR_COMP_THREADS];
+	struct comp_queue_arg		arg = { 0 };
+	tse_task_t			**tasks = NULL;
+	tse_task_t			*parent;
+	tse_sched_t			sched;
+	bool				flag;
+	int				i, rc;
+
+	TSE_TEST_ENTRY("11", "Multi threaded completion queue test");
+
+	D_ALLOC_ARRAY(tasks, TASK_COUNT);
+	if (tasks == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+	arg.cqa_tasks = tasks;
+	arg.cqa_result = -DER_NONEXIST;
+
+	print_message("Init Scheduler with completion queue\n");
+	rc = tse_sched_init(&sched, NULL, 0);
+	if (rc != 0) {
+		print_error("Failed to init scheduler: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+	tse_sched_set_comp_queue(&sched, true);
+
+	rc = tse_task_create(comp_queue_parent_body, &sched, &arg, &parent);
+	if (rc != 0) {
+		print_error("Failed to init task: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	for (i = 0; i < TASK_COUNT; i++) {
+		struct comp_queue_arg *argp = &arg;
+
+		rc = tse_task_create(comp_queue_child_body, &sched, NULL, &tasks[i]);
+		if (rc != 0) {
+			print_error("Failed to init task: %d\n", rc);
+			D_GOTO(out, rc);
+		}
+
+		rc = tse_task_register_comp_cb(tasks[i], comp_queue_child_cb, &argp,
+					       sizeof(argp));
+		if (rc != 0) {
+			print_error("Failed to register comp cb: %d\n", rc);
+			D_GOTO(out, rc);
+		}
+
+		rc = tse_task_schedule(tasks[i], false);
+		if (rc != 0) {
+			print_error("Failed to schedule task: %d\n", rc);
+			D_GOTO(out, rc);
+		}
+	}
+
+	rc = tse_task_register_deps(parent, TASK_COUNT, tasks);
+	if (rc != 0) {
+		print_error("Failed to register task Deps: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	rc = tse_task_schedule(parent, false);
+	if (rc != 0) {
+		print_error("Failed to schedule task: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	/** start all the child tasks, they stay running until completed */
+	tse_sched_progress(&sched);
+
+	stop_progress = false;
+	rc = pthread_create(&th, NULL, th_sched_progress, &sched);
+	if (rc != 0) {
+		print_error("Failed to create pthread: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	print_message("Complete tasks from %d threads\n", NR_COMP_THREADS);
+	for (i = 0; i < NR_COMP_THREADS; i++) {
+		targs[i].cta_arg = &arg;
+		targs[i].cta_th_id = i;
+		rc = pthread_create(&c_th[i], NULL, th_comp_queue_complete, &targs[i]);
+		if (rc != 0) {
+			print_error("Failed to create pthread: %d\n", rc);
+			D_GOTO(out, rc);
+		}
+	}
+
+	for (i = 0; i < NR_COMP_THREADS; i++) {
+		rc = pthread_join(c_th[i], NULL);
+		if (rc != 0) {
+			print_error("Failed pthread_join: %d\n", rc);
+			D_GOTO(out, rc);
+		}
+	}
+
+	do {
+		flag = tse_sched_check_complete(&sched);
+		if (!flag)
+			sleep(1);
+	} while (!flag);
+
+	stop_progress = true;
+	rc = pthread_join(th, NULL);
+	if (rc != 0) {
+		print_error("Failed pthread_join: %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	print_message("Verify dependent task result\n");
+	rc = arg.cqa_result;
+	if (rc != 0)
+		D_GOTO(out, rc);
+
+	print_message("COMPLETE Scheduler\n");
+	tse_sched_addref(&sched);
+	tse_sched_complete(&sched, 0, false);
+
+	print_message("Check scheduler is empty\n");
+	flag = tse_sched_check_complete(&sched);
+	tse_sched_decref(&sched);
+	if (!flag) {
+		print_error("Scheduler should not have in-flight tasks\n");
+		D_GOTO(out, rc = -DER_INVAL);
+	}
+
+out:
+	D_FREE(tasks);
+	TSE_TEST_EXIT(rc);
+}
+
 static int
 sched_ut_setup(void **state)
 {
@@ -1362,7 +1552,8 @@ static const struct CMUnitTest sched_uts[] = {
 	{ "SCHED_Test_7", sched_test_7, NULL, NULL},
 	{ "SCHED_Test_8", sched_test_8, NULL, NULL},
 	{ "SCHED_Test_9", sched_test_9, NULL, NULL},
-	{ "SCHED_Test_10", sched_test_10, NULL, NULL}
+	{ "SCHED_Test_10", sched_test_10, NULL, NULL},
+	{ "SCHED_Test_11", sched_test_11, NULL, NULL}
 };
 
 int main(int argc, char **argv)
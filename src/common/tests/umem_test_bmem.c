@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <pthread.h>
 
 #include <daos/mem.h>
 #include <daos/tests_lib.h>
@@ -123,6 +124,23 @@ failed:
 	return rc;
 }
 
+static int
+teardown_pmem_thread_arenas(void **state)
+{
+	unsetenv("DAOS_DAV_THREAD_ARENAS");
+
+	return teardown_pmem(state);
+}
+
+static int
+setup_pmem_thread_arenas(void **state)
+{
+	/* read by the allocator when the heap is booted */
+	setenv("DAOS_DAV_THREAD_ARENAS", "1", 1);
+
+	return setup_pmem(state);
+}
+
 static int
 global_setup(void **state)
 {
@@ -1295,6 +1313,115 @@ test_tx_dfree_publish_cancel(void **state)
 	umem_rsrvd_act_free(&rsrvd_act);
 }
 
+struct cancel_arg {
+	struct umem_instance	*ca_umm;
+	struct umem_rsrvd_act	*ca_act;
+};
+
+static void *
+cancel_thread(void *data)
+{
+	struct cancel_arg *ca = data;
+
+	umem_cancel(ca->ca_umm, ca->ca_act);
+	return NULL;
+}
+
+static void
+test_tx_reserve_cancel_thread(void **state)
+{
+	struct test_arg		*arg = *state;
+	struct umem_instance	*umm = utest_utx2umm(arg->ta_utx);
+	struct umem_rsrvd_act	*rsrvd_act;
+	struct cancel_arg	 ca;
+	pthread_t		 thread;
+	umem_off_t		 umoff1, umoff2;
+	char			*rsrv_ptr1, *rsrv_ptr2;
+	int			 rc;
+
+	rc = umem_rsrvd_act_alloc(umm, &rsrvd_act, 2);
+	assert_int_equal(rc, 0);
+	umoff1 = umem_reserve(umm, rsrvd_act, 980);
+	assert_false(UMOFF_IS_NULL(umoff1));
+	rsrv_ptr1 = umem_off2ptr(umm, umoff1);
+	umoff2 = umem_reserve(umm, rsrvd_act, 128);
+	assert_false(UMOFF_IS_NULL(umoff2));
+	rsrv_ptr2 = umem_off2ptr(umm, umoff2);
+
+	/* Cancel from a thread that does not own the arena of the reservations */
+	ca.ca_umm = umm;
+	ca.ca_act = rsrvd_act;
+	rc = pthread_create(&thread, NULL, cancel_thread, &ca);
+	assert_int_equal(rc, 0);
+	rc = pthread_join(thread, NULL);
+	assert_int_equal(rc, 0);
+	umem_rsrvd_act_free(&rsrvd_act);
+
+	/* The cancelled blocks are handed back to the arena of this thread */
+	umoff1 = umem_atomic_alloc(umm, 980, UMEM_TYPE_ANY);
+	assert_false(UMOFF_IS_NULL(umoff1));
+	assert_ptr_equal(rsrv_ptr1, umem_off2ptr(umm, umoff1));
+	umoff2 = umem_atomic_alloc(umm, 128, UMEM_TYPE_ANY);
+	assert_false(UMOFF_IS_NULL(umoff2));
+	assert_ptr_equal(rsrv_ptr2, umem_off2ptr(umm, umoff2));
+
+	rc = umem_atomic_free(umm, umoff1);
+	assert_int_equal(rc, 0);
+	rc = umem_atomic_free(umm, umoff2);
+	assert_int_equal(rc, 0);
+}
+
+#define LAT_ALLOC_NR	(16 * 1024)
+#define LAT_TX_BATCH	32
+
+static void
+test_alloc_latency(void **state)
+{
+	struct test_arg		*arg = *state;
+	struct umem_instance	*umm = utest_utx2umm(arg->ta_utx);
+	umem_off_t		*offs;
+	uint64_t		 start;
+	uint64_t		 alloc_ns = 0;
+	uint64_t		 free_ns = 0;
+	int			 i, j, rc;
+
+	D_ALLOC_ARRAY(offs, LAT_ALLOC_NR);
+	assert_non_null(offs);
+
+	for (i = 0; i < LAT_ALLOC_NR; i += LAT_TX_BATCH) {
+		start = daos_get_ntime();
+		rc = umem_tx_begin(umm, NULL);
+		assert_int_equal(rc, 0);
+		/* metadata sized objects, 32 to 512 bytes */
+		for (j = i; j < i + LAT_TX_BATCH; j++) {
+			offs[j] = umem_alloc(umm, 32 << (j % 5));
+			assert_false(UMOFF_IS_NULL(offs[j]));
+		}
+		rc = umem_tx_commit(umm);
+		assert_int_equal(rc, 0);
+		alloc_ns += daos_get_ntime() - start;
+	}
+
+	for (i = 0; i < LAT_ALLOC_NR; i += LAT_TX_BATCH) {
+		start = daos_get_ntime();
+		rc = umem_tx_begin(umm, NULL);
+		assert_int_equal(rc, 0);
+		for (j = i; j < i + LAT_TX_BATCH; j++) {
+			rc = umem_free(umm, offs[j]);
+			assert_int_equal(rc, 0);
+		}
+		rc = umem_tx_commit(umm);
+		assert_int_equal(rc, 0);
+		free_ns += daos_get_ntime() - start;
+	}
+
+	print_message("%s arenas: %d objects, alloc %lu ns/op, free %lu ns/op\n",
+		      getenv("DAOS_DAV_THREAD_ARENAS") != NULL ? "thread" : "shared",
+		      LAT_ALLOC_NR, alloc_ns / LAT_ALLOC_NR, free_ns / LAT_ALLOC_NR);
+
+	D_FREE(offs);
+}
+
 #if 0
 /** This test is removed because the umempobj_set_slab_desc APIs are removed.  Testing the
  *  underlying dav or pmem APIs should probably be handled elsewhere.
@@ -1401,6 +1528,15 @@ main(int argc, char **argv)
 			setup_pmem, teardown_pmem},
 		{ "BMEM015: Test tx defer free publish/cancel", test_tx_dfree_publish_cancel,
 			setup_pmem, teardown_pmem},
+		{ "BMEM016: Test tx reserve/cancel from another thread",
+			test_tx_reserve_cancel_thread, setup_pmem, teardown_pmem},
+		{ "BMEM017: Test tx reserve/cancel from another thread, thread arenas",
+			test_tx_reserve_cancel_thread, setup_pmem_thread_arenas,
+			teardown_pmem_thread_arenas},
+		{ "BMEM018: Test alloc latency", test_alloc_latency,
+			setup_pmem, teardown_pmem},
+		{ "BMEM019: Test alloc latency, thread arenas", test_alloc_latency,
+			setup_pmem_thread_arenas, teardown_pmem_thread_arenas},
 		{ NULL, NULL, NULL, NULL }
 	};
 
@@ -696,6 +696,71 @@ tse_task_post_process(tse_task_t *task)
 	return rc;
 }
 
+/*
+ * Push a running task completed by tse_task_complete() to the completion
+ * queue of the scheduler. The task keeps its in-flight accounting and stays
+ * in the running list until the progressing thread drains the queue.
+ */
+static void
+tse_task_comp_enqueue(struct tse_task_private *dtp,
+		      struct tse_sched_private *dsp)
+{
+	struct tse_task_private *head;
+
+	atomic_store(&dtp->dtp_running, 0);
+	atomic_store(&dtp->dtp_completed, TSE_TASK_COMP_QUEUED);
+
+	head = atomic_load_relaxed(&dsp->dsp_comp_queue);
+	do {
+		dtp->dtp_comp_next = head;
+	} while (!atomic_compare_exchange_weak_explicit(&dsp->dsp_comp_queue, &head, dtp,
+							memory_order_release,
+							memory_order_relaxed));
+}
+
+/*
+ * Move all the tasks of the completion queue to the complete list in the
+ * order they completed, so their dependents are woken up in one batch.
+ */
+static void
+tse_sched_drain_comp_queue_locked(struct tse_sched_private *dsp)
+{
+	struct tse_task_private *dtp;
+	struct tse_task_private *next;
+	struct tse_task_private *fifo = NULL;
+
+	if (atomic_load_relaxed(&dsp->dsp_comp_queue) == NULL)
+		return;
+
+	dtp = atomic_exchange_explicit(&dsp->dsp_comp_queue, NULL, memory_order_acquire);
+	while (dtp != NULL) {
+		next = dtp->dtp_comp_next;
+		dtp->dtp_comp_next = fifo;
+		fifo = dtp;
+		dtp = next;
+	}
+
+	for (dtp = fifo; dtp != NULL; dtp = next) {
+		next = dtp->dtp_comp_next;
+		dtp->dtp_comp_next = NULL;
+		D_ASSERT(atomic_load(&dtp->dtp_completed) == TSE_TASK_COMP_QUEUED);
+		dtp->dtp_completed = 1;
+		d_list_move_tail(&dtp->dtp_list, &dsp->dsp_complete_list);
+	}
+}
+
+void
+tse_sched_set_comp_queue(tse_sched_t *sched, bool enable)
+{
+	struct tse_sched_private *dsp = tse_sched2priv(sched);
+
+	D_MUTEX_LOCK(&dsp->dsp_lock);
+	dsp->dsp_comp_queue_on = enable ? 1 : 0;
+	/* flush completions queued before the mode is turned off */
+	tse_sched_drain_comp_queue_locked(dsp);
+	D_MUTEX_UNLOCK(&dsp->dsp_lock);
+}
+
 int
 tse_sched_process_complete(struct tse_sched_private *dsp)
 {
@@ -707,6 +772,7 @@ tse_sched_process_complete(struct tse_sched_private *dsp)
 	/* pick tasks from complete_list */
 	D_INIT_LIST_HEAD(&comp_list);
 	D_MUTEX_LOCK(&dsp->dsp_lock);
+	tse_sched_drain_comp_queue_locked(dsp);
 	d_list_splice_init(&dsp->dsp_complete_list, &comp_list);
 	D_MUTEX_UNLOCK(&dsp->dsp_lock);
 
@@ -794,7 +860,8 @@ tse_sched_complete_inflight(struct tse_sched_private *dsp)
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	d_list_for_each_entry_safe(dtp, tmp, &dsp->dsp_running_list,
 				      dtp_list)
-		if (dtp->dtp_dep_cnt == 0) {
+		/* queued completions are picked up by the next tse_sched_run() */
+		if (dtp->dtp_dep_cnt == 0 && !atomic_load(&dtp->dtp_completed)) {
 			d_list_del(&dtp->dtp_list);
 			tse_task_complete_locked(dtp, dsp);
 			processed++;
@@ -859,6 +926,17 @@ tse_task_complete(tse_task_t *task, int ret)
 	/** Execute task completion callbacks first. */
 	done = tse_task_complete_callback(task);
 
+	/**
+	 * Leave a running task to the progressing thread instead of taking the
+	 * scheduler lock, tasks that never ran still need the locked path to
+	 * fix up the in-flight accounting.
+	 */
+	if (done && dsp->dsp_comp_queue_on && !dsp->dsp_cancelling &&
+	    atomic_load(&dtp->dtp_running)) {
+		tse_task_comp_enqueue(dtp, dsp);
+		return;
+	}
+
 	D_MUTEX_LOCK(&dsp->dsp_lock);
 	if (!dsp->dsp_cancelling) {
 		/** if task reinserted itself in scheduler, don't complete */
@@ -1078,6 +1156,11 @@ tse_task_reinit_with_delay(tse_task_t *task, uint64_t delay)
 		D_GOTO(err_unlock, rc = -DER_INVAL);
 	}
 
+	if (dtp->dtp_completed == TSE_TASK_COMP_QUEUED) {
+		D_ERROR("Can't re-init a task waiting in the completion queue.\n");
+		D_GOTO(err_unlock, rc = -DER_BUSY);
+	}
+
 	if (dtp->dtp_completed) {
 		D_ASSERT(d_list_empty(&dtp->dtp_list));
 		/* +1 ref for valid until complete */
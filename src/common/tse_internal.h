@@ -31,8 +31,14 @@ struct tse_task_private {
 	/* links to scheduler */
 	d_list_t			 dtp_list;
 
-	/* time to start running this task */
-	uint64_t			 dtp_wakeup_time;
+	union {
+		/* time to start running this task */
+		uint64_t			 dtp_wakeup_time;
+		/* next task in the scheduler completion queue, only set once
+		 * the task stopped running so it never overlaps the wakeup time
+		 */
+		struct tse_task_private		*dtp_comp_next;
+	};
 
 	/* list of tasks that depend on this task */
 	d_list_t			 dtp_dep_list;
@@ -43,7 +49,9 @@ struct tse_task_private {
 	/* daos complete task callback list */
 	d_list_t			 dtp_comp_cb_list;
 
-	/* task has been completed */
+	/* task has been completed, or TSE_TASK_COMP_QUEUED if it waits in
+	 * the completion queue of the scheduler
+	 */
 	ATOMIC uint8_t			dtp_completed;
 	/* task is in running state */
 	ATOMIC uint8_t			dtp_running;
@@ -81,6 +89,9 @@ struct tse_task_private {
 	char				 dtp_buf[TSE_TASK_ARG_LEN];
 };
 
+/* dtp_completed value of a task pushed to the scheduler completion queue */
+#define TSE_TASK_COMP_QUEUED	2
+
 struct tse_task_cb {
 	d_list_t		dtc_list;
 	tse_task_cb_t		dtc_cb;
@@ -119,8 +130,16 @@ struct tse_sched_private {
 	/* number of tasks being executed */
 	int		dsp_inflight;
 
+	/* Lock-free LIFO of running tasks completed by tse_task_complete(),
+	 * linked through dtp_comp_next. The progressing thread drains it
+	 * into dsp_complete_list, see tse_sched_process_complete().
+	 */
+	struct tse_task_private * ATOMIC dsp_comp_queue;
+
 	uint32_t	dsp_cancelling:1,
-			dsp_completing:1;
+			dsp_completing:1,
+			/* completions go through dsp_comp_queue */
+			dsp_comp_queue_on:1;
 };
 
 struct tse_sched_comp {
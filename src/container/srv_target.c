@@ -517,6 +517,7 @@ cont_agg_ult(void *arg)
 
 	D_DEBUG(DB_EPC, "start VOS aggregation "DF_UUID"\n",
 		DP_UUID(cont->sc_uuid));
+	sched_ult_cls_set(ABT_THREAD_NULL, DSS_ULT_CLS_AGG);
 	param.ap_cont = cont;
 	param.ap_vos_agg = true;
 
@@ -530,6 +531,7 @@ cont_ec_agg_ult(void *arg)
 
 	D_DEBUG(DB_EPC, "start EC aggregation "DF_UUID"\n",
 		DP_UUID(cont->sc_uuid));
+	sched_ult_cls_set(ABT_THREAD_NULL, DSS_ULT_CLS_AGG);
 
 	ds_obj_ec_aggregate(arg);
 }
@@ -128,6 +128,8 @@ const (
 	PoolPropertyReintMode      = C.DAOS_PROP_PO_REINT_MODE
 	PoolPropertySvcOpsEnabled  = C.DAOS_PROP_PO_SVC_OPS_ENABLED
 	PoolPropertySvcOpsEntryAge = C.DAOS_PROP_PO_SVC_OPS_ENTRY_AGE
+	// PoolPropertySchedPolicy is the IO scheduling policy on engine targets
+	PoolPropertySchedPolicy = C.DAOS_PROP_PO_SCHED_POLICY
 )
 
 const (
@@ -267,3 +269,9 @@ const (
 	PoolReintModeDataSync   = C.DAOS_REINT_MODE_DATA_SYNC
 	PoolReintModeNoDataSync = C.DAOS_REINT_MODE_NO_DATA_SYNC
 )
+
+const (
+	PoolSchedPolicyFifo    = C.DAOS_SCHED_POLICY_FIFO
+	PoolSchedPolicyJobRR   = C.DAOS_SCHED_POLICY_JOB_RR
+	PoolSchedPolicyJobPrio = C.DAOS_SCHED_POLICY_JOB_PRIO
+)
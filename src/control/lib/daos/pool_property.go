@@ -485,6 +485,17 @@ func PoolProperties() PoolPropertyMap {
 				"no_data_sync": PoolReintModeNoDataSync,
 			},
 		},
+		"sched_policy": {
+			Property: PoolProperty{
+				Number:      PoolPropertySchedPolicy,
+				Description: "IO scheduling policy",
+			},
+			values: map[string]uint64{
+				"fifo":     PoolSchedPolicyFifo,
+				"job_rr":   PoolSchedPolicyJobRR,
+				"job_prio": PoolSchedPolicyJobPrio,
+			},
+		},
 	}
 }
 
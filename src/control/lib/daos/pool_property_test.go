@@ -252,6 +252,17 @@ func TestControl_PoolProperties(t *testing.T) {
 			value:  "bad mode",
 			expErr: errors.New(`invalid value "bad mode" for reintegration (valid: data_sync,no_data_sync)`),
 		},
+		"sched_policy-valid": {
+			name:    "sched_policy",
+			value:   "job_rr",
+			expStr:  "sched_policy:job_rr",
+			expJson: []byte(`{"name":"sched_policy","description":"IO scheduling policy","value":"job_rr"}`),
+		},
+		"sched_policy-invalid": {
+			name:   "sched_policy",
+			value:  "bad policy",
+			expErr: errors.New(`invalid value "bad policy" for sched_policy (valid: fifo,job_prio,job_rr)`),
+		},
 		"svc_ops_enabled-zero-is-valid": {
 			name:    "svc_ops_enabled",
 			value:   "0",
@@ -572,6 +572,7 @@ dtx_aggregation_main(void *arg)
 
 	uuid_clear(anonym_uuid);
 	sched_req_attr_init(&attr, SCHED_REQ_ANONYM, &anonym_uuid);
+	sched_ult_cls_set(ABT_THREAD_NULL, DSS_ULT_CLS_DTX);
 
 	D_ASSERT(dmi->dmi_dtx_agg_req == NULL);
 	dmi->dmi_dtx_agg_req = sched_req_get(&attr, ABT_THREAD_NULL);
@@ -683,6 +684,7 @@ dtx_batched_commit(void *arg)
 
 	uuid_clear(anonym_uuid);
 	sched_req_attr_init(&attr, SCHED_REQ_ANONYM, &anonym_uuid);
+	sched_ult_cls_set(ABT_THREAD_NULL, DSS_ULT_CLS_DTX);
 
 	D_ASSERT(dmi->dmi_dtx_cmt_req == NULL);
 	dmi->dmi_dtx_cmt_req = sched_req_get(&attr, ABT_THREAD_NULL);
@@ -84,18 +84,6 @@ dtx_cos_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
 	memcpy(hkey, key_iov->iov_buf, key_iov->iov_len);
 }
 
-static int
-dtx_cos_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
-{
-	struct dtx_cos_key *hkey1 = (struct dtx_cos_key *)&rec->rec_hkey[0];
-	struct dtx_cos_key *hkey2 = (struct dtx_cos_key *)hkey;
-	int		    rc;
-
-	rc = memcmp(hkey1, hkey2, sizeof(struct dtx_cos_key));
-
-	return dbtree_key_cmp_rc(rc);
-}
-
 static int
 dtx_cos_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov,
 		  d_iov_t *val_iov, struct btr_record *rec, d_iov_t *val_out)
@@ -288,7 +276,6 @@ dtx_cos_rec_update(struct btr_instance *tins, struct btr_record *rec,
 btr_ops_t dtx_btr_cos_ops = {
 	.to_hkey_size	= dtx_cos_hkey_size,
 	.to_hkey_gen	= dtx_cos_hkey_gen,
-	.to_hkey_cmp	= dtx_cos_hkey_cmp,
 	.to_rec_alloc	= dtx_cos_rec_alloc,
 	.to_rec_free	= dtx_cos_rec_free,
 	.to_rec_fetch	= dtx_cos_rec_fetch,
@@ -639,8 +639,11 @@ metrics_region_size(int num_tgts)
 {
 	const uint64_t	est_std_metrics = 1024; /* high estimate to allow for pool links */
 	const uint64_t	est_tgt_metrics = 128; /* high estimate */
+	const uint64_t	est_quantile_metrics = 64; /* per-opcode latency quantiles */
+	const uint64_t	est_ring_metrics = 64; /* per-opcode sampled stage timings */
 
-	return (est_std_metrics + est_tgt_metrics * num_tgts) * D_TM_METRIC_SIZE;
+	return (est_std_metrics + est_tgt_metrics * num_tgts) * D_TM_METRIC_SIZE +
+	       est_quantile_metrics * D_TM_QUANTILE_SIZE + est_ring_metrics * D_TM_RING_SIZE;
 }
 
 static int
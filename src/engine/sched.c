@@ -6,6 +6,7 @@
 
 #define D_LOGFAC       DD_FAC(server)
 
+#include <ctype.h>
 #include <execinfo.h>
 #include <abt.h>
 #include <daos/common.h>
@@ -146,22 +147,85 @@ struct sched_pool_info {
 	int			spi_gc_sleeping;
 	int			spi_ref;
 	uint32_t		spi_req_cnt;
+	/* IO scheduling policy of the pool, SCHED_POLICY_* */
+	uint32_t		spi_policy;
 	struct stats_window	spi_stats_window;
 };
 
+/* Quantum of the deficit round-robin for ID based policies, in request weights */
+#define SCHED_JOB_QUANTUM	8
+/* Max weight of a job for SCHED_POLICY_ID_PRIO */
+#define SCHED_JOB_WEIGHT_MAX	64
+/* Max number of job priorities configured by DAOS_SCHED_JOB_PRIO */
+#define SCHED_JOB_PRIO_MAX	32
+/* Idle job is freed after having no queued request for that long, in msecs */
+#define SCHED_JOB_IDLE_MAX	60000
+/* Max length of the job name used in telemetry path */
+#define SCHED_JOB_NAME_MAX	64
+#define SCHED_JOB_HASH_SEED	5731
+
+struct sched_job_info {
+	/* Link to 'sched_info->si_job_hash' */
+	d_list_t		 sji_hash_link;
+	/* Link to 'sched_info->si_job_list' or 'sched_info->si_job_idle_list' */
+	d_list_t		 sji_link;
+	/* Queued IO requests of the job, sorted by enqueue ID */
+	d_list_t		 sji_req_list;
+	uint64_t		 sji_job_id;
+	/* When the job became idle, in msecs */
+	uint64_t		 sji_idle_ts;
+	uint32_t		 sji_req_cnt;
+	/* Weight for SCHED_POLICY_ID_PRIO */
+	uint32_t		 sji_weight;
+	/* Deficit counter of the round-robin, in request weights */
+	int64_t			 sji_deficit;
+	/* Telemetry directory of the job, NULL if it failed to be created */
+	struct sched_job_tm	*sji_tm;
+	struct d_tm_node_t	*sji_queue_depth;
+	struct d_tm_node_t	*sji_queue_lat;
+	struct d_tm_node_t	*sji_total_req;
+};
+
+/*
+ * Telemetry directory of a job, it's shared by all the xstreams scheduling the requests of
+ * the job, and removed once the job is freed on every xstream.
+ */
+struct sched_job_tm {
+	/* Link to 'sched_job_tm_list' */
+	d_list_t		 sjt_link;
+	/* Number of xstreams having the job */
+	int			 sjt_ref;
+	char			 sjt_name[SCHED_JOB_NAME_MAX + 1];
+};
+
+static D_LIST_HEAD(sched_job_tm_list);
+static pthread_mutex_t sched_job_tm_lock = PTHREAD_MUTEX_INITIALIZER;
+
+struct sched_job_prio {
+	uint64_t	sjp_job_id;
+	uint32_t	sjp_weight;
+};
+
+static struct sched_job_prio	sched_job_prios[SCHED_JOB_PRIO_MAX];
+static unsigned int		sched_job_prio_nr;
+
 struct sched_request {
 	/*
-	 * IO request links to 'sched_info->si_fifo_list', other types of
+	 * IO request links to 'sched_info->si_fifo_list' or to the per-job
+	 * 'sched_job_info->sji_req_list' for ID based policies, other types of
 	 * request link to each 'sched_req_info->sri_req_list' respectively.
-	 * When request is not used, it's in 'sched_info->si_idle_list'.
+	 * When request is not used, it's in 'sched_info->si_idle_list', and
+	 * while its service time is sampled, in 'sched_info->si_svc_list'.
 	 */
 	d_list_t		 sr_link;
 	struct d_binheap_node	 sr_node;
 	struct sched_req_attr	 sr_attr;
-	void			*sr_func;
+	void			(*sr_func)(void *);
 	void			*sr_arg;
 	ABT_thread		 sr_ult;
 	struct sched_pool_info	*sr_pool_info;
+	/* Job of the IO request queued by ID based policies */
+	struct sched_job_info	*sr_job;
 	/* Wakeup time for the sleeping request, in milli seconds */
 	uint64_t		 sr_wakeup_time;
 	/* When the request is enqueued, in msecs */
@@ -178,25 +242,25 @@ unsigned int	sched_relax_intvl = SCHED_RELAX_INTVL_DEFAULT;
 unsigned int	sched_relax_mode;
 unsigned int	sched_unit_runtime_max = 32; /* ms */
 bool		sched_watchdog_all;
+unsigned int	sched_slo_p99; /* ms, 0: latency SLO admission control disabled */
+bool		sched_ult_acct;
 
 enum {
 	/* All requests for various pools are processed in FIFO */
 	SCHED_POLICY_FIFO	= 0,
 	/*
-	 * All requests are processed in RR based on certain ID (Client ID,
-	 * Pool ID, Container ID, JobID, UID, etc.)
+	 * IO requests are queued per client JobID, and processed in deficit
+	 * round-robin among the jobs.
 	 */
 	SCHED_POLICY_ID_RR,
 	/*
-	 * Request priority is based on certain ID (Client ID, Pool ID,
-	 * Container ID, JobID, UID, etc.)
+	 * Same as SCHED_POLICY_ID_RR, the quantum of each job is weighted by
+	 * the job priority configured by DAOS_SCHED_JOB_PRIO.
 	 */
 	SCHED_POLICY_ID_PRIO,
 	SCHED_POLICY_MAX
 };
 
-static int	sched_policy;
-
 /*
  * Time threshold for giving IO up throttling. If space pressure stays in the
  * highest level for enough long time, we assume that no more space can be
@@ -351,6 +415,302 @@ static d_hash_table_ops_t sched_pool_hash_ops = {
 	.hop_rec_free	= spi_rec_free,
 };
 
+static inline struct sched_job_info *
+sched_rlink2sji(d_list_t *rlink)
+{
+	return container_of(rlink, struct sched_job_info, sji_hash_link);
+}
+
+static bool
+sji_key_cmp(struct d_hash_table *htable, d_list_t *rlink,
+	    const void *key, unsigned int len)
+{
+	struct sched_job_info	*sji = sched_rlink2sji(rlink);
+
+	D_ASSERT(len == sizeof(uint64_t));
+	return sji->sji_job_id == *(const uint64_t *)key;
+}
+
+static uint32_t
+sji_key_hash(struct d_hash_table *htable, const void *key, unsigned int len)
+{
+	D_ASSERT(len == sizeof(uint64_t));
+	return (uint32_t)*(const uint64_t *)key;
+}
+
+/* Lifetime of sched_job_info is managed by the scheduler, no refcount needed */
+static d_hash_table_ops_t sched_job_hash_ops = {
+	.hop_key_cmp	= sji_key_cmp,
+	.hop_key_hash	= sji_key_hash,
+};
+
+static inline uint64_t
+job_name2id(const char *jobid)
+{
+	/* Requests from old clients don't carry JobID, they share the same queue. */
+	if (jobid == NULL || jobid[0] == '\0')
+		return 0;
+
+	return d_hash_murmur64((const unsigned char *)jobid, strlen(jobid),
+			       SCHED_JOB_HASH_SEED);
+}
+
+static uint32_t
+job_prio_weight(uint64_t job_id)
+{
+	int	i;
+
+	for (i = 0; i < sched_job_prio_nr; i++) {
+		if (sched_job_prios[i].sjp_job_id == job_id)
+			return sched_job_prios[i].sjp_weight;
+	}
+
+	return 1;
+}
+
+/*
+ * Parse the job priorities in format of "<JobID>:<weight>[,<JobID>:<weight>]", the
+ * weight is in range of [1, SCHED_JOB_WEIGHT_MAX], default weight is 1.
+ */
+void
+sched_job_prio_init(const char *str)
+{
+	char		*buf, *tok, *sep, *end;
+	char		*saveptr = NULL;
+	unsigned long	 weight;
+
+	D_STRNDUP(buf, str, strlen(str));
+	if (buf == NULL) {
+		D_WARN("Failed to parse job priorities [%s]\n", str);
+		return;
+	}
+
+	for (tok = strtok_r(buf, ",", &saveptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &saveptr)) {
+		/* JobID could contain ':' */
+		sep = strrchr(tok, ':');
+		if (sep == NULL || sep == tok) {
+			D_WARN("Invalid job priority [%s]\n", tok);
+			continue;
+		}
+
+		*sep = '\0';
+		weight = strtoul(sep + 1, &end, 10);
+		if (*end != '\0' || weight == 0 || weight > SCHED_JOB_WEIGHT_MAX) {
+			D_WARN("Invalid weight [%s] for job %s\n", sep + 1, tok);
+			continue;
+		}
+
+		if (sched_job_prio_nr == SCHED_JOB_PRIO_MAX) {
+			D_WARN("Too many job priorities, ignore job %s\n", tok);
+			break;
+		}
+
+		sched_job_prios[sched_job_prio_nr].sjp_job_id = job_name2id(tok);
+		sched_job_prios[sched_job_prio_nr].sjp_weight = weight;
+		sched_job_prio_nr++;
+		D_INFO("Job %s IO scheduling weight is set to %lu\n", tok, weight);
+	}
+
+	D_FREE(buf);
+}
+
+/* Size of the telemetry directory of a job, each xstream adds three metrics into it */
+static inline size_t
+job_tm_dir_size(void)
+{
+	return (DSS_XS_NR_TOTAL * 3 + 4) * D_TM_METRIC_SIZE;
+}
+
+/* Get the telemetry directory of the job, create it if this is the first xstream having it */
+static struct sched_job_tm *
+job_tm_get(const char *name)
+{
+	struct sched_job_tm	*sjt;
+	int			 rc;
+
+	D_MUTEX_LOCK(&sched_job_tm_lock);
+	d_list_for_each_entry(sjt, &sched_job_tm_list, sjt_link) {
+		if (strcmp(sjt->sjt_name, name) == 0) {
+			sjt->sjt_ref++;
+			goto out;
+		}
+	}
+
+	D_ALLOC_PTR(sjt);
+	if (sjt == NULL)
+		goto out;
+
+	rc = d_tm_add_ephemeral_dir(NULL, job_tm_dir_size(), "sched/job/%s", name);
+	if (rc) {
+		D_WARN("Failed to create job %s telemetry dir: "DF_RC"\n", name, DP_RC(rc));
+		D_FREE(sjt);
+		goto out;
+	}
+	strncpy(sjt->sjt_name, name, SCHED_JOB_NAME_MAX);
+	sjt->sjt_ref = 1;
+	d_list_add_tail(&sjt->sjt_link, &sched_job_tm_list);
+out:
+	D_MUTEX_UNLOCK(&sched_job_tm_lock);
+	return sjt;
+}
+
+/* Drop the xstream reference on the job telemetry directory, remove it on the last one */
+static void
+job_tm_put(struct sched_job_tm *sjt)
+{
+	int	rc;
+
+	D_MUTEX_LOCK(&sched_job_tm_lock);
+	D_ASSERT(sjt->sjt_ref > 0);
+	if (--sjt->sjt_ref > 0) {
+		D_MUTEX_UNLOCK(&sched_job_tm_lock);
+		return;
+	}
+
+	rc = d_tm_del_ephemeral_dir("sched/job/%s", sjt->sjt_name);
+	if (rc)
+		D_WARN("Failed to remove job %s telemetry dir: "DF_RC"\n", sjt->sjt_name,
+		       DP_RC(rc));
+	d_list_del(&sjt->sjt_link);
+	D_MUTEX_UNLOCK(&sched_job_tm_lock);
+	D_FREE(sjt);
+}
+
+static void
+job_metrics_init(struct dss_xstream *dx, struct sched_job_info *sji, const char *jobid)
+{
+	char	name[SCHED_JOB_NAME_MAX + 1];
+	int	i, rc;
+
+	if (jobid == NULL || jobid[0] == '\0')
+		jobid = "unknown";
+
+	/* JobID is from client, sanitize it for the telemetry path */
+	for (i = 0; i < SCHED_JOB_NAME_MAX && jobid[i] != '\0'; i++)
+		name[i] = (jobid[i] == '/' || !isgraph(jobid[i])) ? '_' : jobid[i];
+	name[i] = '\0';
+
+	/* The metrics live in the job directory, they are removed with the idle job. */
+	sji->sji_tm = job_tm_get(name);
+	if (sji->sji_tm == NULL)
+		return;
+
+	rc = d_tm_add_metric(&sji->sji_queue_depth, D_TM_GAUGE, "Queued IO requests of the job",
+			     "req", "sched/job/%s/queue_depth/xs_%u", name, dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create job queue_depth telemetry: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&sji->sji_queue_lat, D_TM_STATS_GAUGE,
+			     "Queuing latency of the job IO requests", "ms",
+			     "sched/job/%s/queue_latency/xs_%u", name, dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create job queue_latency telemetry: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&sji->sji_total_req, D_TM_COUNTER,
+			     "Total scheduled IO requests of the job", "req",
+			     "sched/job/%s/total_req/xs_%u", name, dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create job total_req telemetry: "DF_RC"\n", DP_RC(rc));
+}
+
+static void
+job_metrics_fini(struct sched_job_info *sji)
+{
+	if (sji->sji_tm == NULL)
+		return;
+
+	sji->sji_queue_depth = NULL;
+	sji->sji_queue_lat = NULL;
+	sji->sji_total_req = NULL;
+	job_tm_put(sji->sji_tm);
+	sji->sji_tm = NULL;
+}
+
+static struct sched_job_info *
+job_get(struct dss_xstream *dx, const char *jobid)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_job_info	*sji;
+	d_list_t		*rlink;
+	uint64_t		 job_id = job_name2id(jobid);
+	int			 rc;
+
+	D_ASSERT(info->si_job_hash != NULL);
+	rlink = d_hash_rec_find(info->si_job_hash, &job_id, sizeof(job_id));
+	if (rlink != NULL)
+		return sched_rlink2sji(rlink);
+
+	D_ALLOC_PTR(sji);
+	if (sji == NULL)
+		return NULL;
+
+	D_INIT_LIST_HEAD(&sji->sji_hash_link);
+	D_INIT_LIST_HEAD(&sji->sji_req_list);
+	sji->sji_job_id = job_id;
+	sji->sji_weight = job_prio_weight(job_id);
+	sji->sji_idle_ts = info->si_cur_ts;
+
+	rc = d_hash_rec_insert(info->si_job_hash, &job_id, sizeof(job_id),
+			       &sji->sji_hash_link, false);
+	if (rc) {
+		D_ERROR("Failed to insert job hash. "DF_RC"\n", DP_RC(rc));
+		D_FREE(sji);
+		return NULL;
+	}
+	d_list_add_tail(&sji->sji_link, &info->si_job_idle_list);
+	job_metrics_init(dx, sji, jobid);
+
+	return sji;
+}
+
+static void
+job_free(struct sched_info *info, struct sched_job_info *sji)
+{
+	D_ASSERT(sji->sji_req_cnt == 0);
+	D_ASSERT(d_list_empty(&sji->sji_req_list));
+
+	job_metrics_fini(sji);
+	d_hash_rec_delete_at(info->si_job_hash, &sji->sji_hash_link);
+	d_list_del(&sji->sji_link);
+	D_FREE(sji);
+}
+
+static void
+prune_idle_jobs(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_job_info	*sji, *tmp;
+
+	/* Idle list is sorted in idle time ascending order */
+	d_list_for_each_entry_safe(sji, tmp, &info->si_job_idle_list, sji_link) {
+		if ((sji->sji_idle_ts + SCHED_JOB_IDLE_MAX) > info->si_cur_ts)
+			break;
+		job_free(info, sji);
+	}
+}
+
+static void
+job_req_del(struct dss_xstream *dx, struct sched_request *req)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_job_info	*sji = req->sr_job;
+
+	D_ASSERT(sji->sji_req_cnt > 0);
+	sji->sji_req_cnt--;
+	req->sr_job = NULL;
+
+	d_tm_set_gauge(sji->sji_queue_depth, sji->sji_req_cnt);
+	d_tm_set_gauge(sji->sji_queue_lat, info->si_cur_ts - req->sr_enqueue_ts);
+	d_tm_inc_counter(sji->sji_total_req, 1);
+
+	if (sji->sji_req_cnt == 0) {
+		sji->sji_deficit = 0;
+		sji->sji_idle_ts = info->si_cur_ts;
+		d_list_move_tail(&sji->sji_link, &info->si_job_idle_list);
+	}
+}
+
 /*
  * d_hash_table_traverse() does not support item deletion in traverse
  * callback, so the stale 'spi' (pool was destroyed) will be added into
@@ -448,6 +808,7 @@ sched_info_fini(struct dss_xstream *dx)
 	D_ASSERT(info->si_total_req_cnt == 0);
 	D_ASSERT(d_list_empty(&info->si_sleep_list));
 	D_ASSERT(d_list_empty(&info->si_fifo_list));
+	D_ASSERT(d_list_empty(&info->si_job_list));
 
 	prune_purge_list(dx);
 
@@ -455,14 +816,35 @@ sched_info_fini(struct dss_xstream *dx)
 		d_hash_table_destroy(info->si_pool_hash, true);
 		info->si_pool_hash = NULL;
 	}
+
+	if (info->si_job_hash) {
+		struct sched_job_info	*sji, *sji_tmp;
+
+		d_list_for_each_entry_safe(sji, sji_tmp, &info->si_job_idle_list, sji_link)
+			job_free(info, sji);
+
+		d_hash_table_destroy(info->si_job_hash, true);
+		info->si_job_hash = NULL;
+	}
 	d_binheap_destroy_inplace(&info->si_heap);
 
+	for (i = 0; i < DAOS_MAX_MODULE; i++)
+		D_FREE(info->si_ult_rpc_stats[i]);
+
 	d_list_for_each_entry_safe(req, tmp, &info->si_idle_list,
 				   sr_link) {
 		D_ASSERT(req->sr_in_heap == 0);
 		d_list_del_init(&req->sr_link);
 		D_FREE(req);
 	}
+
+	/* The ULTs of these requests never finished, they won't run anymore */
+	d_list_for_each_entry_safe(req, tmp, &info->si_svc_list, sr_link) {
+		D_WARN("XS(%d) request type %u still in service\n", dx->dx_xs_id,
+		       req->sr_attr.sra_type);
+		d_list_del_init(&req->sr_link);
+		D_FREE(req);
+	}
 }
 
 static int
@@ -532,6 +914,32 @@ sched_metrics_init(struct dss_xstream *dx)
 			     "req", "sched/total_reject/xs_%u", dx->dx_xs_id);
 	if (rc)
 		D_WARN("Failed to create total_reject telemetry: "DF_RC"\n", DP_RC(rc));
+
+	if (dx->dx_steal_pool != ABT_POOL_NULL) {
+		rc = d_tm_add_metric(&stats->ss_steal_ults, D_TM_COUNTER,
+				     "ULTs picked from shared helper pool", "ULT",
+				     "sched/steal_ults/xs_%u", dx->dx_xs_id);
+		if (rc)
+			D_WARN("Failed to create steal_ults telemetry: "DF_RC"\n", DP_RC(rc));
+	}
+
+	rc = d_tm_add_metric(&stats->ss_slo_reject, D_TM_COUNTER,
+			     "Requests rejected by latency SLO", "req",
+			     "sched/slo_reject/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create slo_reject telemetry: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->ss_lat_est[SCHED_REQ_UPDATE], D_TM_GAUGE,
+			     "Estimated p99 latency of update requests", "us",
+			     "sched/latency_est/update/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create update latency_est telemetry: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->ss_lat_est[SCHED_REQ_FETCH], D_TM_GAUGE,
+			     "Estimated p99 latency of fetch requests", "us",
+			     "sched/latency_est/fetch/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create fetch latency_est telemetry: "DF_RC"\n", DP_RC(rc));
 }
 
 static int
@@ -591,9 +999,12 @@ sched_info_init(struct dss_xstream *dx)
 	info->si_cur_seq = 0;
 	info->si_cur_id = 0;
 	D_INIT_LIST_HEAD(&info->si_idle_list);
+	D_INIT_LIST_HEAD(&info->si_svc_list);
 	D_INIT_LIST_HEAD(&info->si_sleep_list);
 	D_INIT_LIST_HEAD(&info->si_fifo_list);
 	D_INIT_LIST_HEAD(&info->si_purge_list);
+	D_INIT_LIST_HEAD(&info->si_job_list);
+	D_INIT_LIST_HEAD(&info->si_job_idle_list);
 	info->si_total_req_cnt = 0;
 	info->si_sleep_cnt = 0;
 	info->si_wait_cnt = 0;
@@ -608,6 +1019,13 @@ sched_info_init(struct dss_xstream *dx)
 		return rc;
 	}
 
+	rc = d_hash_table_create(D_HASH_FT_NOLOCK, 6, NULL, &sched_job_hash_ops,
+				 &info->si_job_hash);
+	if (rc) {
+		D_ERROR("Create sched job hash failed. " DF_RC "\n", DP_RC(rc));
+		goto out;
+	}
+
 	if (D_ON_VALGRIND)
 		count = 16;
 
@@ -722,6 +1140,236 @@ req_put(struct dss_xstream *dx, struct sched_request *req)
 		d_list_add_tail(&req->sr_link, &info->si_idle_list);
 }
 
+static inline bool
+is_io_req(unsigned int req_type)
+{
+	return req_type == SCHED_REQ_UPDATE || req_type == SCHED_REQ_FETCH;
+}
+
+static inline void
+lat_est_update(struct sched_lat_est *est, uint64_t sample)
+{
+	int64_t	err;
+
+	if (est->le_avg == 0) {
+		est->le_avg = sample << 3;
+		est->le_dev = sample << 1;
+		return;
+	}
+
+	err = (int64_t)sample - (int64_t)(est->le_avg >> 3);
+	est->le_avg = (int64_t)est->le_avg + err;
+	if (err < 0)
+		err = -err;
+	est->le_dev = est->le_dev + err - (est->le_dev >> 2);
+}
+
+/* Mean plus four mean deviations, used as the p99 estimation */
+static inline uint64_t
+lat_est_p99(struct sched_lat_est *est)
+{
+	return (est->le_avg >> 3) + est->le_dev;
+}
+
+static inline uint64_t
+req_lat_est(struct sched_info *info, unsigned int req_type)
+{
+	return lat_est_p99(&info->si_qdelay_est[req_type]) +
+	       lat_est_p99(&info->si_svc_est[req_type]);
+}
+
+/* Run the IO request handler and sample its service time for the admission control */
+static void
+req_svc_ult(void *arg)
+{
+	struct sched_request	*req = arg;
+	struct dss_xstream	*dx = dss_current_xstream();
+	uint64_t		 start = daos_getutime();
+
+	req->sr_func(req->sr_arg);
+
+	lat_est_update(&dx->dx_sched_info.si_svc_est[req->sr_attr.sra_type],
+		       daos_getutime() - start);
+	d_list_del_init(&req->sr_link);
+	req_put(dx, req);
+}
+
+/* Max tracked opcodes of a module, opcodes beyond this are accounted as 'other' */
+#define SCHED_ULT_OPC_MAX	64
+
+/* Accounting record of a ULT, attached to the ULT by 'sched_ult_key' */
+struct sched_ult_rec {
+	/* Time when the ULT yielded last time (us), 0 if never run */
+	uint64_t	ur_stop_ts;
+	uint16_t	ur_cls;
+	/* Module ID and opcode of RPC handler */
+	uint8_t		ur_mod;
+	uint8_t		ur_opc;
+	/* ULT classified by function */
+	uint32_t	ur_classified:1,
+	/* ULT terminated, to be freed by sched_ult_acct_post() */
+			ur_done:1;
+};
+
+static ABT_key	sched_ult_key = ABT_KEY_NULL;
+
+static const char *sched_ult_cls_names[DSS_ULT_CLS_MAX] = {
+	"other",	/* DSS_ULT_CLS_OTHER */
+	"rpc",		/* DSS_ULT_CLS_RPC */
+	"gc",		/* DSS_ULT_CLS_GC */
+	"aggregation",	/* DSS_ULT_CLS_AGG */
+	"dtx",		/* DSS_ULT_CLS_DTX */
+	"scrub",	/* DSS_ULT_CLS_SCRUB */
+	"rebuild",	/* DSS_ULT_CLS_REBUILD */
+};
+
+/* Called on ULT free, which is in sched_run() context for unnamed ULTs */
+static void
+ult_rec_free_cb(void *arg)
+{
+	struct sched_ult_rec	*rec = arg;
+	struct dss_xstream	*dx = dss_tls_get() != NULL ? dss_current_xstream() : NULL;
+
+	if (dx != NULL && dx->dx_sched_info.si_ult_rec == rec) {
+		rec->ur_done = 1;
+		return;
+	}
+	D_FREE(rec);
+}
+
+int
+sched_ult_acct_init(void)
+{
+	int	rc;
+
+	if (!sched_ult_acct)
+		return 0;
+
+	rc = ABT_key_create(ult_rec_free_cb, &sched_ult_key);
+	if (rc != ABT_SUCCESS) {
+		D_ERROR("Failed to create ULT accounting key: %d\n", rc);
+		sched_ult_acct = false;
+		return dss_abterr2der(rc);
+	}
+	D_INFO("Per-ULT CPU accounting is enabled\n");
+
+	return 0;
+}
+
+void
+sched_ult_acct_fini(void)
+{
+	if (sched_ult_key != ABT_KEY_NULL)
+		ABT_key_free(&sched_ult_key);
+	sched_ult_acct = false;
+}
+
+static struct sched_ult_rec *
+ult_rec_get(ABT_thread thread)
+{
+	struct sched_ult_rec	*rec = NULL;
+	int			 rc;
+
+	rc = ABT_thread_get_specific(thread, sched_ult_key, (void **)&rec);
+	if (rc != ABT_SUCCESS || rec != NULL)
+		return rec;
+
+	D_ALLOC_PTR(rec);
+	if (rec == NULL)
+		return NULL;
+
+	rc = ABT_thread_set_specific(thread, sched_ult_key, rec);
+	if (rc != ABT_SUCCESS) {
+		D_FREE(rec);
+		return NULL;
+	}
+
+	return rec;
+}
+
+void
+sched_ult_cls_set(ABT_thread ult, unsigned int cls)
+{
+	struct sched_ult_rec	*rec;
+	int			 rc;
+
+	if (!sched_ult_acct)
+		return;
+
+	D_ASSERT(cls < DSS_ULT_CLS_MAX);
+	if (ult == ABT_THREAD_NULL) {
+		rc = ABT_thread_self(&ult);
+		if (rc != ABT_SUCCESS)
+			return;
+	}
+
+	rec = ult_rec_get(ult);
+	if (rec != NULL) {
+		rec->ur_cls = cls;
+		rec->ur_classified = 1;
+	}
+}
+
+static inline unsigned int
+req_type2cls(unsigned int req_type)
+{
+	switch (req_type) {
+	case SCHED_REQ_GC:
+		return DSS_ULT_CLS_GC;
+	case SCHED_REQ_SCRUB:
+		return DSS_ULT_CLS_SCRUB;
+	case SCHED_REQ_MIGRATE:
+		return DSS_ULT_CLS_REBUILD;
+	default:
+		return DSS_ULT_CLS_OTHER;
+	}
+}
+
+/* RPC handler function, all RPC handler ULTs are created by sched_req_enqueue() */
+static void (*sched_rpc_func)(void *);
+
+static void
+ult_rec_classify(struct sched_ult_rec *rec, ABT_thread thread)
+{
+	void		 (*thread_func)(void *);
+	void		*arg;
+	crt_rpc_t	*rpc;
+	int		 rc;
+#ifdef ULT_MMAP_STACK
+	mmap_stack_desc_t	*desc;
+#endif
+
+	rec->ur_classified = 1;
+	rec->ur_cls = DSS_ULT_CLS_OTHER;
+
+	rc = ABT_thread_get_thread_func(thread, &thread_func);
+	D_ASSERT(rc == ABT_SUCCESS);
+	rc = ABT_thread_get_arg(thread, &arg);
+	D_ASSERT(rc == ABT_SUCCESS);
+#ifdef ULT_MMAP_STACK
+	/* See sched_watchdog_prep() */
+	if (likely(thread_func == mmap_stack_wrapper)) {
+		desc = arg;
+		thread_func = desc->thread_func;
+		arg = desc->thread_arg;
+	}
+#endif
+	if (thread_func == req_svc_ult) {
+		struct sched_request	*req = arg;
+
+		thread_func = req->sr_func;
+		arg = req->sr_arg;
+	}
+
+	if (thread_func == NULL || thread_func != sched_rpc_func || arg == NULL)
+		return;
+
+	rpc = arg;
+	rec->ur_cls = DSS_ULT_CLS_RPC;
+	rec->ur_mod = opc_get_mod_id(rpc->cr_opc);
+	rec->ur_opc = min(opc_get(rpc->cr_opc), SCHED_ULT_OPC_MAX - 1);
+}
+
 static inline int
 req_kickoff_internal(struct dss_xstream *dx, struct sched_req_attr *attr,
 		     void (*func)(void *), void *arg)
@@ -740,11 +1388,22 @@ req_kickoff(struct dss_xstream *dx, struct sched_request *req)
 	struct sched_info	*info = &dx->dx_sched_info;
 	struct sched_pool_info	*spi = req->sr_pool_info;
 	struct sched_req_info	*sri;
+	unsigned int		 req_type = req->sr_attr.sra_type;
+	bool			 svc_sampled = false;
 	int			 rc;
 
+	if (sched_slo_p99 != 0 && is_io_req(req_type)) {
+		lat_est_update(&info->si_qdelay_est[req_type],
+			       (info->si_cur_ts - req->sr_enqueue_ts) * 1000);
+		d_tm_set_gauge(info->si_stats.ss_lat_est[req_type], req_lat_est(info, req_type));
+		svc_sampled = (req->sr_ult == ABT_THREAD_NULL);
+	}
+
 	if (req->sr_ult != ABT_THREAD_NULL) {
 		rc = ABT_thread_resume(req->sr_ult);
 		rc = dss_abterr2der(rc);
+	} else if (svc_sampled) {
+		rc = req_kickoff_internal(dx, &req->sr_attr, req_svc_ult, req);
 	} else {
 		rc = req_kickoff_internal(dx, &req->sr_attr, req->sr_func,
 					  req->sr_arg);
@@ -769,7 +1428,14 @@ req_kickoff(struct dss_xstream *dx, struct sched_request *req)
 	else
 		d_list_del_init(&req->sr_link);
 
-	req_put(dx, req);
+	if (req->sr_job != NULL)
+		job_req_del(dx, req);
+
+	/* The request will be released by req_svc_ult() when the handler is done */
+	if (svc_sampled && rc == 0)
+		d_list_add_tail(&req->sr_link, &info->si_svc_list);
+	else
+		req_put(dx, req);
 
 	return rc;
 }
@@ -1251,6 +1917,115 @@ policy_fifo_process(struct dss_xstream *dx)
 	}
 }
 
+static int
+policy_job_enqueue(struct dss_xstream *dx, struct sched_request *req,
+		   void *prio_data)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_req_attr	*attr = &req->sr_attr;
+	struct sched_job_info	*sji;
+	struct sched_request	*tmp;
+
+	sji = job_get(dx, attr->sra_jobid);
+	/* JobID string is owned by the RPC, don't reference it after enqueue */
+	attr->sra_jobid = NULL;
+	if (sji == NULL)
+		return policy_fifo_enqueue(dx, req, prio_data);
+
+	/*
+	 * Requests of the job are sorted by enqueue ID, retried RPCs carry the ID
+	 * assigned on their first arrival, so they won't starve forever. New RPCs
+	 * always have the largest ID and are appended directly.
+	 */
+	tmp = d_list_entry(sji->sji_req_list.prev, struct sched_request, sr_link);
+	if (d_list_empty(&sji->sji_req_list) ||
+	    tmp->sr_attr.sra_enqueue_id <= attr->sra_enqueue_id) {
+		d_list_add_tail(&req->sr_link, &sji->sji_req_list);
+	} else {
+		d_list_for_each_entry(tmp, &sji->sji_req_list, sr_link) {
+			if (tmp->sr_attr.sra_enqueue_id > attr->sra_enqueue_id)
+				break;
+		}
+		d_list_add_tail(&req->sr_link, &tmp->sr_link);
+	}
+
+	req->sr_job = sji;
+	if (sji->sji_req_cnt == 0)
+		d_list_move_tail(&sji->sji_link, &info->si_job_list);
+	sji->sji_req_cnt++;
+	d_tm_set_gauge(sji->sji_queue_depth, sji->sji_req_cnt);
+
+	return 0;
+}
+
+static inline uint32_t
+job_quantum(struct sched_job_info *sji)
+{
+	struct sched_request	*req;
+
+	D_ASSERT(!d_list_empty(&sji->sji_req_list));
+	req = d_list_entry(sji->sji_req_list.next, struct sched_request, sr_link);
+
+	if (req->sr_pool_info->spi_policy == SCHED_POLICY_ID_PRIO)
+		return SCHED_JOB_QUANTUM * sji->sji_weight;
+
+	return SCHED_JOB_QUANTUM;
+}
+
+/*
+ * Deficit round-robin among the jobs having queued IO requests. In each round, every
+ * job earns a quantum of request weights and kicks its requests until the deficit is
+ * used up, so the requests from a job with few requests won't be kicked (and executed)
+ * after all the requests from a job with a deep queue.
+ */
+static void
+policy_job_process(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_job_info	*sji;
+	struct sched_request	*req;
+	d_list_t		 round;
+	d_list_t		 throttled;
+	unsigned int		 cost;
+	int			 rc;
+
+	D_INIT_LIST_HEAD(&round);
+	D_INIT_LIST_HEAD(&throttled);
+
+	while (!d_list_empty(&info->si_job_list)) {
+		d_list_splice_init(&info->si_job_list, &round);
+
+		while ((sji = d_list_pop_entry(&round, struct sched_job_info,
+					       sji_link)) != NULL) {
+			sji->sji_deficit += job_quantum(sji);
+			rc = 0;
+
+			while (sji->sji_req_cnt != 0) {
+				req = d_list_entry(sji->sji_req_list.next, struct sched_request,
+						   sr_link);
+				cost = req_weights[req->sr_attr.sra_type];
+				if (cost > sji->sji_deficit)
+					break;
+
+				sji->sji_deficit -= cost;
+				/* The job will be moved to idle list once the last request kicked */
+				rc = process_req(dx, req);
+				if (rc) {
+					/* Throttled by the pool, try it again in next cycle */
+					sji->sji_deficit = 0;
+					break;
+				}
+			}
+
+			if (sji->sji_req_cnt != 0)
+				d_list_add_tail(&sji->sji_link,
+						rc ? &throttled : &info->si_job_list);
+		}
+	}
+
+	d_list_splice_init(&throttled, &info->si_job_list);
+}
+
 struct sched_policy_ops {
 	int (*enqueue_io)(struct dss_xstream *dx, struct sched_request *req,
 			   void *prio_data);
@@ -1263,12 +2038,12 @@ static struct sched_policy_ops	policy_ops[SCHED_POLICY_MAX] = {
 		.process_io = policy_fifo_process,
 	},
 	{	/* SCHED_POLICY_ID_RR */
-		.enqueue_io = NULL,
-		.process_io = NULL,
+		.enqueue_io = policy_job_enqueue,
+		.process_io = policy_job_process,
 	},
 	{	/* SCHED_POLICY_ID_PRIO */
-		.enqueue_io = NULL,
-		.process_io = NULL,
+		.enqueue_io = policy_job_enqueue,
+		.process_io = policy_job_process,
 	}
 };
 
@@ -1279,12 +2054,18 @@ process_all(struct dss_xstream *dx)
 	int			 rc;
 
 	prune_purge_list(dx);
+	prune_idle_jobs(dx);
 	rc = d_hash_table_traverse(info->si_pool_hash, process_pool_cb, dx);
 	if (rc)
 		D_ERROR("Traverse pool hash error. "DF_RC"\n", DP_RC(rc));
 
-	D_ASSERT(policy_ops[sched_policy].process_io != NULL);
-	policy_ops[sched_policy].process_io(dx);
+	/*
+	 * Policy is per pool and could be changed on the fly, the queued requests are
+	 * processed by the policy they were enqueued with. SCHED_POLICY_ID_RR and
+	 * SCHED_POLICY_ID_PRIO share the per-job queues.
+	 */
+	policy_ops[SCHED_POLICY_FIFO].process_io(dx);
+	policy_ops[SCHED_POLICY_ID_RR].process_io(dx);
 }
 
 static inline bool
@@ -1320,8 +2101,8 @@ req_enqueue(struct dss_xstream *dx, struct sched_request *req)
 	D_ASSERT(d_list_empty(&req->sr_link));
 	if (attr->sra_type == SCHED_REQ_UPDATE ||
 	    attr->sra_type == SCHED_REQ_FETCH) {
-		D_ASSERT(policy_ops[sched_policy].enqueue_io != NULL);
-		rc = policy_ops[sched_policy].enqueue_io(dx, req, NULL);
+		D_ASSERT(spi->spi_policy < SCHED_POLICY_MAX);
+		rc = policy_ops[spi->spi_policy].enqueue_io(dx, req, NULL);
 	} else {
 		d_list_add_tail(&req->sr_link, &sri->sri_req_list);
 	}
@@ -1377,17 +2158,43 @@ req_need_reject(struct sched_req_attr *attr, struct sched_info *info)
 	return false;
 }
 
+/*
+ * Latency SLO admission control: estimate the p99 latency of the incoming IO request
+ * by the smoothed queue delay and service time of the recent requests of the same type,
+ * check it against the p99 target configured by DAOS_SCHED_SLO_P99.
+ */
+static bool
+req_slo_violated(struct sched_req_attr *attr, struct sched_info *info)
+{
+	if (sched_slo_p99 == 0 || !is_io_req(attr->sra_type))
+		return false;
+
+	if (attr->sra_flags & SCHED_REQ_FL_NO_REJECT)
+		return false;
+
+	/* Nothing queued ahead, the queue delay estimation is stale */
+	if (info->si_req_cnt[attr->sra_type] == 0)
+		return false;
+
+	return req_lat_est(info, attr->sra_type) > (uint64_t)sched_slo_p99 * 1000;
+}
+
 int
 sched_req_enqueue(struct dss_xstream *dx, struct sched_req_attr *attr,
 		  void (*func)(void *), void *arg)
 {
 	struct sched_request	*req;
 	struct sched_info	*info = &dx->dx_sched_info;
+	bool			 resent = (attr->sra_enqueue_id != 0);
+
+	/* Only called by dss_rpc_hdlr(), the function is same for all RPCs */
+	if (unlikely(sched_ult_acct && sched_rpc_func == NULL))
+		sched_rpc_func = func;
 
 	if (!should_enqueue_req(dx, attr))
 		return req_kickoff_internal(dx, attr, func, arg);
 
-	if (attr->sra_enqueue_id == 0)
+	if (!resent)
 		attr->sra_enqueue_id = ++info->si_cur_id;
 
 	/*
@@ -1406,6 +2213,17 @@ sched_req_enqueue(struct dss_xstream *dx, struct sched_req_attr *attr,
 		return -DER_OVERLOAD_RETRY;
 	}
 
+	/*
+	 * Reject the new request early when the latency target would be violated, so
+	 * the client backs off before timing out. The resent request is admitted, it's
+	 * sorted by its original enqueue ID and won't starve.
+	 */
+	if (!resent && req_slo_violated(attr, info)) {
+		d_tm_inc_counter(info->si_stats.ss_total_reject, 1);
+		d_tm_inc_counter(info->si_stats.ss_slo_reject, 1);
+		return -DER_OVERLOAD_RETRY;
+	}
+
 	D_ASSERT(attr->sra_type < SCHED_REQ_MAX);
 	req = req_get(dx, attr, func, arg, ABT_THREAD_NULL, false);
 	if (req == NULL) {
@@ -1551,6 +2369,33 @@ sched_req_space_check(struct sched_request *req)
 	return check_space_pressure(dx, req->sr_pool_info);
 }
 
+int
+sched_pool_policy_set(uuid_t pool_id, unsigned int policy)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+	struct sched_pool_info	*spi;
+
+	D_CASSERT((int)SCHED_POLICY_FIFO == (int)DAOS_SCHED_POLICY_FIFO);
+	D_CASSERT((int)SCHED_POLICY_ID_RR == (int)DAOS_SCHED_POLICY_JOB_RR);
+	D_CASSERT((int)SCHED_POLICY_ID_PRIO == (int)DAOS_SCHED_POLICY_JOB_PRIO);
+
+	if (policy >= SCHED_POLICY_MAX) {
+		D_ERROR("Invalid sched policy %u for pool "DF_UUID"\n", policy, DP_UUID(pool_id));
+		return -DER_INVAL;
+	}
+
+	spi = cur_pool_info(&dx->dx_sched_info, pool_id);
+	if (spi == NULL)
+		return -DER_NOMEM;
+
+	if (spi->spi_policy != policy)
+		D_DEBUG(DB_MGMT, "Pool "DF_UUID" sched policy changed from %u to %u on xs %d\n",
+			DP_UUID(pool_id), spi->spi_policy, policy, dx->dx_xs_id);
+	spi->spi_policy = policy;
+
+	return 0;
+}
+
 static void
 wakeup_all(struct dss_xstream *dx)
 {
@@ -1618,6 +2463,8 @@ sched_req_get(struct sched_req_attr *attr, ABT_thread ult)
 	req = req_get(dx, attr, NULL, NULL, ult, owned);
 	if (req != NULL && attr->sra_type == SCHED_REQ_GC)
 		req->sr_pool_info->spi_gc_ults++;
+	if (req != NULL && req_type2cls(attr->sra_type) != DSS_ULT_CLS_OTHER)
+		sched_ult_cls_set(ult, req_type2cls(attr->sra_type));
 
 	return req;
 }
@@ -1710,6 +2557,8 @@ sched_create_ult(struct sched_req_attr *attr, void (*func)(void *), void *arg, s
 	req->sr_ult = ult;
 	if (attr->sra_type == SCHED_REQ_GC)
 		req->sr_pool_info->spi_gc_ults++;
+	if (req_type2cls(attr->sra_type) != DSS_ULT_CLS_OTHER)
+		sched_ult_cls_set(ult, req_type2cls(attr->sra_type));
 
 	return req;
 }
@@ -1724,8 +2573,13 @@ sched_create_ult(struct sched_req_attr *attr, void (*func)(void *), void *arg, s
  * Extra network & NVMe poll ULTs could be scheduled in executing stage
  * according to network/NVMe poll age;
  */
+/* Max ULTs picked from the shared work-stealing pool in a schedule cycle */
+#define SCHED_STEAL_BATCH	16
+
 struct sched_cycle {
 	uint32_t	sc_ults_cnt[DSS_POOL_CNT];
+	/* ULTs to be picked from the shared work-stealing pool */
+	uint32_t	sc_ults_steal;
 	uint32_t	sc_ults_tot;
 	uint32_t	sc_age_net;
 	uint32_t	sc_age_nvme;
@@ -1933,6 +2787,35 @@ sched_pop_one(struct sched_data *data, ABT_pool pool, int pool_idx)
 	return unit;
 }
 
+static ABT_unit
+sched_pop_steal(struct sched_data *data, ABT_pool pool)
+{
+	struct sched_cycle	*cycle = &data->sd_cycle;
+	ABT_unit		 unit;
+	int			 ret;
+
+	D_ASSERT(cycle->sc_ults_tot >= cycle->sc_ults_steal);
+	if (cycle->sc_ults_steal == 0)
+		return ABT_UNIT_NULL;
+
+	ret = ABT_pool_pop(pool, &unit);
+	if (ret != ABT_SUCCESS) {
+		D_ERROR("Failed to pop ULT from shared pool: %d\n", ret);
+		return ABT_UNIT_NULL;
+	}
+
+	/* Could have been picked by other helper XS */
+	if (unit != ABT_UNIT_NULL)
+		d_tm_inc_counter(data->sd_dx->dx_sched_info.si_stats.ss_steal_ults, 1);
+
+	cycle->sc_age_net++;
+	cycle->sc_age_nvme++;
+	cycle->sc_ults_steal -= 1;
+	cycle->sc_ults_tot -= 1;
+
+	return unit;
+}
+
 #define SCHED_IDLE_THRESH	8000UL	/* msecs */
 
 /*
@@ -2077,6 +2960,18 @@ sched_start_cycle(struct sched_data *data, ABT_pool *pools)
 	cycle->sc_ults_cnt[DSS_POOL_GENERIC] = cnt;
 	cycle->sc_ults_tot += cycle->sc_ults_cnt[DSS_POOL_GENERIC];
 
+	if (dx->dx_steal_pool != ABT_POOL_NULL) {
+		D_ASSERT(cycle->sc_ults_steal == 0);
+		ret = ABT_pool_get_size(dx->dx_steal_pool, &cnt);
+		if (ret != ABT_SUCCESS) {
+			D_ERROR("Get shared pool size error: %d\n", ret);
+			cnt = 0;
+		}
+		/* Leave the rest to other helper XS */
+		cycle->sc_ults_steal = min(cnt, (size_t)SCHED_STEAL_BATCH);
+		cycle->sc_ults_tot += cycle->sc_ults_steal;
+	}
+
 	if (sched_relax_mode != SCHED_RELAX_MODE_DISABLED)
 		sched_try_relax(dx, pools, cycle->sc_ults_tot);
 
@@ -2201,6 +3096,140 @@ sched_watchdog_post(struct dss_xstream *dx)
 	free(strings);
 }
 
+static void
+ult_stats_init(struct sched_ult_stats *stats, int xs_id, const char *fmt, ...)
+{
+	char	path[D_TM_MAX_NAME_LEN];
+	va_list	args;
+	int	rc;
+
+	va_start(args, fmt);
+	vsnprintf(path, sizeof(path), fmt, args);
+	va_end(args);
+
+	stats->us_inited = true;
+	rc = d_tm_add_metric(&stats->us_run_time, D_TM_COUNTER, "ULT run time", "us",
+			     "%s/run_time/xs_%u", path, xs_id);
+	if (rc)
+		D_WARN("Failed to create %s run_time telemetry: "DF_RC"\n", path, DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->us_wait_time, D_TM_COUNTER,
+			     "ULT wait time between runs", "us", "%s/wait_time/xs_%u", path, xs_id);
+	if (rc)
+		D_WARN("Failed to create %s wait_time telemetry: "DF_RC"\n", path, DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->us_yields, D_TM_COUNTER, "ULT yields", "yield",
+			     "%s/yields/xs_%u", path, xs_id);
+	if (rc)
+		D_WARN("Failed to create %s yields telemetry: "DF_RC"\n", path, DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->us_ults, D_TM_COUNTER, "Number of ULTs", "ULT",
+			     "%s/ults/xs_%u", path, xs_id);
+	if (rc)
+		D_WARN("Failed to create %s ults telemetry: "DF_RC"\n", path, DP_RC(rc));
+}
+
+static struct sched_ult_stats *
+ult_stats_get(struct dss_xstream *dx, struct sched_ult_rec *rec)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_ult_stats	*stats;
+	struct dss_module	*module;
+
+	if (rec->ur_cls != DSS_ULT_CLS_RPC || rec->ur_mod >= DAOS_MAX_MODULE) {
+		stats = &info->si_ult_stats[rec->ur_cls == DSS_ULT_CLS_RPC ?
+					    DSS_ULT_CLS_OTHER : rec->ur_cls];
+		if (!stats->us_inited)
+			ult_stats_init(stats, dx->dx_xs_id, "sched/ult/%s",
+				       sched_ult_cls_names[stats - info->si_ult_stats]);
+		return stats;
+	}
+
+	if (info->si_ult_rpc_stats[rec->ur_mod] == NULL) {
+		D_ALLOC_ARRAY(info->si_ult_rpc_stats[rec->ur_mod], SCHED_ULT_OPC_MAX);
+		if (info->si_ult_rpc_stats[rec->ur_mod] == NULL)
+			return NULL;
+	}
+
+	stats = &info->si_ult_rpc_stats[rec->ur_mod][rec->ur_opc];
+	if (!stats->us_inited) {
+		module = dss_module_get(rec->ur_mod);
+		if (module != NULL)
+			ult_stats_init(stats, dx->dx_xs_id, "sched/ult/rpc/%s/opc_%u",
+				       module->sm_name, rec->ur_opc);
+		else
+			ult_stats_init(stats, dx->dx_xs_id, "sched/ult/rpc/mod_%u/opc_%u",
+				       rec->ur_mod, rec->ur_opc);
+	}
+
+	return stats;
+}
+
+static void
+sched_ult_acct_prep(struct dss_xstream *dx, ABT_unit unit)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_ult_rec	*rec;
+	struct sched_ult_stats	*stats;
+	ABT_thread		 thread;
+	int			 rc;
+
+	info->si_ult_rec = NULL;
+	if (!sched_ult_acct)
+		return;
+
+	rc = ABT_unit_get_thread(unit, &thread);
+	D_ASSERT(rc == ABT_SUCCESS);
+	rec = ult_rec_get(thread);
+	if (rec == NULL)
+		return;
+
+	if (!rec->ur_classified)
+		ult_rec_classify(rec, thread);
+
+	info->si_ult_rec = rec;
+	info->si_ult_acct_start = daos_getutime();
+
+	/* Resumed after yield */
+	if (rec->ur_stop_ts != 0) {
+		stats = ult_stats_get(dx, rec);
+		if (stats == NULL)
+			return;
+		d_tm_inc_counter(stats->us_yields, 1);
+		if (info->si_ult_acct_start > rec->ur_stop_ts)
+			d_tm_inc_counter(stats->us_wait_time,
+					 info->si_ult_acct_start - rec->ur_stop_ts);
+	}
+}
+
+static void
+sched_ult_acct_post(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_ult_rec	*rec = info->si_ult_rec;
+	struct sched_ult_stats	*stats;
+	uint64_t		 cur;
+
+	if (rec == NULL)
+		return;
+	info->si_ult_rec = NULL;
+
+	cur = daos_getutime();
+	/* The ULT could have tagged itself in its first run, account it on the first yield */
+	stats = ult_stats_get(dx, rec);
+	if (stats != NULL) {
+		if (rec->ur_stop_ts == 0)
+			d_tm_inc_counter(stats->us_ults, 1);
+		if (cur > info->si_ult_acct_start)
+			d_tm_inc_counter(stats->us_run_time, cur - info->si_ult_acct_start);
+	}
+
+	if (rec->ur_done)
+		D_FREE(rec);
+	else
+		rec->ur_stop_ts = cur;
+}
+
 static void
 sched_run(ABT_sched sched)
 {
@@ -2245,6 +3274,12 @@ sched_run(ABT_sched sched)
 		if (unit != ABT_UNIT_NULL)
 			goto execute;
 
+		/* Try to pick a ULT from the pool shared by helper XS */
+		pool = dx->dx_steal_pool;
+		unit = sched_pop_steal(data, pool);
+		if (unit != ABT_UNIT_NULL)
+			goto execute;
+
 		/*
 		 * Nothing to be executed? Could be idle helper XS or poll ULT
 		 * hasn't started yet.
@@ -2253,9 +3288,11 @@ sched_run(ABT_sched sched)
 execute:
 		D_ASSERT(pool != ABT_POOL_NULL);
 		sched_watchdog_prep(dx, unit);
+		sched_ult_acct_prep(dx, unit);
 
 		ABT_xstream_run_unit(unit, pool);
 
+		sched_ult_acct_post(dx);
 		sched_watchdog_post(dx);
 start_cycle:
 		if (cycle->sc_new_cycle) {
@@ -903,7 +903,7 @@ ds_iv_init()
 {
 	D_INIT_LIST_HEAD(&ds_iv_ns_list);
 	D_INIT_LIST_HEAD(&ds_iv_class_list);
-	ds_iv_ns_tree_topo = crt_tree_topo(CRT_TREE_KNOMIAL, 4);
+	ds_iv_ns_tree_topo = crt_tree_topo(CRT_TREE_DOMAIN, 4);
 }
 
 void
@@ -92,6 +92,18 @@ unsigned int	dss_sys_xs_nr = DAOS_TGT0_OFFSET + DRPC_XS_NR;
  */
 bool		dss_helper_pool;
 
+/**
+ * Flag of work stealing among helper XS, set by DAOS_HELPER_STEAL.
+ * When it's enabled, the target independent offload ULTs (EC/checksum
+ * computing, see DSS_XS_OFFLOAD) are created in a shared pool for each
+ * NUMA node, any helper XS on the same NUMA node could pick them up, so
+ * that a hot target won't saturate its own helper XS while other helper
+ * XS idle.
+ */
+static bool	dss_helper_steal;
+static ABT_pool	*dss_steal_pools;
+static int	 dss_steal_pool_nr;
+
 /** Bypass for the nvme health check */
 bool		dss_nvme_bypass_health_check;
 
@@ -349,6 +361,14 @@ wait_all_exited(struct dss_xstream *dx, struct dss_module_info *dmi)
 			D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
 			total_size += pool_size;
 		}
+		/* Help to drain the shared pool, its creator could be waiting on it */
+		if (dx->dx_steal_pool != ABT_POOL_NULL) {
+			size_t	pool_size;
+
+			rc = ABT_pool_get_total_size(dx->dx_steal_pool, &pool_size);
+			D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
+			total_size += pool_size;
+		}
 		/*
 		 * Current running srv handler ULT is popped, so it's not
 		 * counted in pool size by argobots.
@@ -637,6 +657,7 @@ dss_xstream_alloc(hwloc_cpuset_t cpus)
 
 	for (i = 0; i < DSS_POOL_CNT; i++)
 		dx->dx_pools[i] = ABT_POOL_NULL;
+	dx->dx_steal_pool = ABT_POOL_NULL;
 
 	dx->dx_xstream	= ABT_XSTREAM_NULL;
 	dx->dx_sched	= ABT_SCHED_NULL;
@@ -669,6 +690,76 @@ dss_xstream_free(struct dss_xstream *dx)
 	D_FREE(dx);
 }
 
+static void
+dss_steal_pools_fini(void)
+{
+	int	i;
+
+	if (dss_steal_pools == NULL)
+		return;
+
+	for (i = 0; i < dss_steal_pool_nr; i++) {
+		if (dss_steal_pools[i] != ABT_POOL_NULL)
+			ABT_pool_free(&dss_steal_pools[i]);
+	}
+	D_FREE(dss_steal_pools);
+	dss_steal_pool_nr = 0;
+}
+
+static int
+dss_steal_pools_init(void)
+{
+	int	i, rc;
+
+	if (!dss_helper_steal)
+		return 0;
+
+	if (dss_tgt_offload_xs_nr == 0) {
+		D_WARN("No helper XS, ignore DAOS_HELPER_STEAL\n");
+		return 0;
+	}
+
+	/* Engine bound to a NUMA node has only one shared pool */
+	dss_steal_pool_nr = hwloc_get_nbobjs_by_type(dss_topo, HWLOC_OBJ_NUMANODE);
+	if (numa_obj != NULL || dss_steal_pool_nr <= 0)
+		dss_steal_pool_nr = 1;
+
+	D_ALLOC_ARRAY(dss_steal_pools, dss_steal_pool_nr);
+	if (dss_steal_pools == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < dss_steal_pool_nr; i++) {
+		/* Not automatic, it's shared by helper XS and freed on xstreams fini */
+		rc = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPMC, ABT_FALSE,
+					   &dss_steal_pools[i]);
+		if (rc != ABT_SUCCESS) {
+			dss_steal_pools[i] = ABT_POOL_NULL;
+			dss_steal_pools_fini();
+			return dss_abterr2der(rc);
+		}
+	}
+	D_INFO("Work stealing among helper XS is enabled, %d shared pools\n",
+	       dss_steal_pool_nr);
+
+	return 0;
+}
+
+static ABT_pool
+dss_steal_pool_get(hwloc_cpuset_t cpus)
+{
+	hwloc_obj_t	obj;
+
+	if (dss_steal_pool_nr == 1)
+		return dss_steal_pools[0];
+
+	obj = hwloc_get_next_obj_covering_cpuset_by_type(dss_topo, cpus, HWLOC_OBJ_NUMANODE,
+							 NULL);
+	if (obj == NULL)
+		return dss_steal_pools[0];
+
+	return dss_steal_pools[obj->logical_index % dss_steal_pool_nr];
+}
+
 static void
 dss_mem_stats_init(struct mem_stats *stats, int xs_id)
 {
@@ -686,6 +777,30 @@ dss_mem_stats_init(struct mem_stats *stats, int xs_id)
 	stats->ms_current = 0;
 }
 
+static void
+dss_acc_stats_init(struct acc_stats *stats, int xs_id)
+{
+	int rc;
+
+	rc = d_tm_add_metric(&stats->as_inflight, D_TM_GAUGE,
+			     "Tasks waiting on helper xstreams", "task", "offload/inflight/xs_%u",
+			     xs_id);
+	if (rc)
+		D_WARN("Failed to create offload telemetry: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->as_offloaded, D_TM_COUNTER,
+			     "Tasks offloaded to helper xstreams", "task", "offload/offloaded/xs_%u",
+			     xs_id);
+	if (rc)
+		D_WARN("Failed to create offload telemetry: "DF_RC"\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->as_inline, D_TM_COUNTER,
+			     "Offload tasks executed in place", "task", "offload/inline/xs_%u",
+			     xs_id);
+	if (rc)
+		D_WARN("Failed to create offload telemetry: "DF_RC"\n", DP_RC(rc));
+}
+
 void
 dss_mem_total_alloc_track(void *arg, daos_size_t bytes)
 {
@@ -775,6 +890,9 @@ dss_start_one_xstream(hwloc_cpuset_t cpus, int tag, int xs_id)
 	}
 	dx->dx_dsc_started = false;
 
+	if (dss_steal_pools != NULL && xs_id >= dss_sys_xs_nr && !dx->dx_main_xs)
+		dx->dx_steal_pool = dss_steal_pool_get(cpus);
+
 	/**
 	 * Generate name for each xstreams so that they can be easily identified
 	 * and monitored independently (e.g. via ps(1))
@@ -802,6 +920,8 @@ dss_start_one_xstream(hwloc_cpuset_t cpus, int tag, int xs_id)
 	}
 
 	dss_mem_stats_init(&dx->dx_mem_stats, xs_id);
+	if (dx->dx_main_xs)
+		dss_acc_stats_init(&dx->dx_acc_stats, xs_id);
 
 	/** start XS, ABT rank 0 is reserved for the primary xstream */
 	rc = ABT_xstream_create_with_rank(dx->dx_sched, xs_id + 1,
@@ -924,6 +1044,8 @@ dss_xstreams_fini(bool force)
 	/* All other xstreams have terminated. */
 	xstream_data.xd_xs_nr = 0;
 	dss_tgt_nr = 0;
+	dss_steal_pools_fini();
+	sched_ult_acct_fini();
 
 	D_DEBUG(DB_TRACE, "Execution streams stopped\n");
 }
@@ -1063,6 +1185,26 @@ dss_xstreams_init(void)
 	d_getenv_uint("DAOS_SCHED_UNIT_RUNTIME_MAX", &sched_unit_runtime_max);
 	d_getenv_bool("DAOS_SCHED_WATCHDOG_ALL", &sched_watchdog_all);
 
+	d_getenv_uint("DAOS_SCHED_SLO_P99", &sched_slo_p99);
+	if (sched_slo_p99 != 0)
+		D_INFO("IO latency SLO p99 target is set to %u msecs\n", sched_slo_p99);
+
+	d_agetenv_str(&env, "DAOS_SCHED_JOB_PRIO");
+	if (env) {
+		sched_job_prio_init(env);
+		d_freeenv_str(&env);
+	}
+
+	d_getenv_bool("DAOS_HELPER_STEAL", &dss_helper_steal);
+	rc = dss_steal_pools_init();
+	if (rc)
+		D_GOTO(out, rc);
+
+	d_getenv_bool("DAOS_SCHED_ULT_ACCT", &sched_ult_acct);
+	rc = sched_ult_acct_init();
+	if (rc)
+		D_GOTO(out, rc);
+
 	/* start the execution streams */
 	D_DEBUG(DB_TRACE,
 		"%d cores total detected starting %d main xstreams\n",
@@ -1123,6 +1265,11 @@ dss_xstreams_init(void)
 	D_DEBUG(DB_TRACE, "%d execution streams successfully started "
 		"(first core %d)\n", dss_tgt_nr, dss_core_offset);
 out:
+	/* Otherwise, shared pools will be freed by dss_xstreams_fini() */
+	if (rc != 0 && dss_xstreams_empty()) {
+		dss_steal_pools_fini();
+		sched_ult_acct_fini();
+	}
 	return rc;
 }
 
@@ -1155,13 +1302,6 @@ struct dss_module_key daos_srv_modkey = {
 	.dmk_fini = dss_srv_tls_fini,
 };
 
-/** TODO: use daos checksum library to offload checksum calculation */
-static int
-compute_checksum_ult(void *args)
-{
-	return 0;
-}
-
 /** TODO: use OFI calls to calculate checksum on FPGA */
 static int
 compute_checksum_acc(void *args)
@@ -1177,15 +1317,11 @@ compute_checksum_acc(void *args)
 int
 dss_acc_offload(struct dss_acc_task *at_args)
 {
+	struct dss_xstream	*dx;
+	struct acc_stats	*stats = NULL;
+	int			 rc = 0;
+	int			 tid;
 
-	int		rc = 0;
-	int		tid;
-
-	/**
-	 * Currently just launching it in this stream,
-	 * ideally will move to a separate exclusive xstream
-	 */
-	tid = dss_get_module_info()->dmi_tgt_id;
 	if (at_args == NULL) {
 		D_ERROR("missing arguments for acc_offload\n");
 		return -DER_INVAL;
@@ -1197,14 +1333,37 @@ dss_acc_offload(struct dss_acc_task *at_args)
 		return -DER_INVAL;
 	}
 
+	dx = dss_current_xstream();
+	if (dx->dx_main_xs)
+		stats = &dx->dx_acc_stats;
+	tid = dss_get_module_info()->dmi_tgt_id;
+
 	switch (at_args->at_offload_type) {
 	case DSS_OFFLOAD_ULT:
-		rc = dss_ult_execute(compute_checksum_ult,
-				at_args->at_params,
-				NULL /* user-cb */,
-				NULL /* user-cb args */,
-				DSS_XS_OFFLOAD, tid,
-				0);
+		if (at_args->at_cb == NULL) {
+			D_ERROR("missing callback for ULT offload\n");
+			return -DER_INVAL;
+		}
+
+		/**
+		 * Without helper xstream, the offload ULT would land on a
+		 * neighbor target xstream, just run it in place.
+		 */
+		if (stats == NULL || dss_tgt_offload_xs_nr == 0) {
+			if (stats != NULL)
+				d_tm_inc_counter(stats->as_inline, 1);
+			rc = at_args->at_cb(at_args->at_params);
+			break;
+		}
+
+		d_tm_inc_counter(stats->as_offloaded, 1);
+		d_tm_inc_gauge(stats->as_inflight, 1);
+		rc = dss_ult_execute(at_args->at_cb, at_args->at_params,
+				     NULL /* user-cb */,
+				     NULL /* user-cb args */,
+				     DSS_XS_OFFLOAD, tid,
+				     0);
+		d_tm_dec_gauge(stats->as_inflight, 1);
 		break;
 	case DSS_OFFLOAD_ACC:
 		/** calls to offload to FPGA*/
@@ -34,11 +34,34 @@ struct sched_stats {
 	struct d_tm_node_t	*ss_cycle_duration;	/* Cycle duration (ms) */
 	struct d_tm_node_t	*ss_cycle_size;		/* Total ULTs in a cycle */
 	struct d_tm_node_t	*ss_total_reject;	/* Total Rejected requests */
+	struct d_tm_node_t	*ss_steal_ults;		/* ULTs run from shared pool */
+	struct d_tm_node_t	*ss_slo_reject;		/* Requests rejected by SLO */
+	struct d_tm_node_t	*ss_lat_est[SCHED_REQ_MAX]; /* Estimated IO p99 (us) */
 	uint64_t		 ss_busy_ts;		/* Last busy timestamp (ms) */
 	uint64_t		 ss_watchdog_ts;	/* Last watchdog print ts (ms) */
 	void			*ss_last_unit;		/* Last executed unit */
 };
 
+/*
+ * Smoothed latency estimator, same as the TCP RTT estimator (RFC 6298), the mean and
+ * the mean deviation are kept in fixed-point, scaled by 8 and 4 respectively.
+ */
+struct sched_lat_est {
+	uint64_t	le_avg;		/* Smoothed latency (us) << 3 */
+	uint64_t	le_dev;		/* Smoothed mean deviation (us) << 2 */
+};
+
+/* Per-xstream CPU accounting of a class of ULTs */
+struct sched_ult_stats {
+	struct d_tm_node_t	*us_run_time;	/* Total run time (us) */
+	struct d_tm_node_t	*us_wait_time;	/* Total time between runs (us) */
+	struct d_tm_node_t	*us_yields;	/* Times rescheduled after yield */
+	struct d_tm_node_t	*us_ults;	/* Number of ULTs */
+	bool			 us_inited;
+};
+
+struct sched_ult_rec;
+
 struct sched_info {
 	uint64_t		 si_cur_ts;	/* Current timestamp (ms) */
 	uint64_t		 si_cur_seq;	/* Current schedule sequence */
@@ -47,10 +70,14 @@ struct sched_info {
 	void			*si_ult_func;	/* Function addr of last executed unit */
 	struct sched_stats	 si_stats;	/* Sched stats */
 	d_list_t		 si_idle_list;	/* All unused requests */
+	d_list_t		 si_svc_list;	/* Requests being sampled by req_svc_ult() */
 	d_list_t		 si_sleep_list;	/* All sleeping requests */
 	d_list_t		 si_fifo_list;	/* All IO requests in FIFO */
 	d_list_t		 si_purge_list;	/* Stale sched_pool_info */
 	struct d_hash_table	*si_pool_hash;	/* All sched_pool_info */
+	d_list_t		 si_job_list;	/* Jobs with queued IO requests */
+	d_list_t		 si_job_idle_list; /* Jobs without queued IO requests */
+	struct d_hash_table	*si_job_hash;	/* All sched_job_info */
 	struct d_binheap	 si_heap;	/* All retried RPC */
 	/* Total inuse request count */
 	uint32_t		 si_total_req_cnt;
@@ -60,6 +87,14 @@ struct sched_info {
 	int			 si_wait_cnt;	/* Long wait request count */
 	/* Number of kicked requests for each type in current cycle */
 	uint32_t		 si_kicked_req_cnt[SCHED_REQ_MAX];
+	/* Per-ULT CPU accounting */
+	struct sched_ult_rec	*si_ult_rec;	/* Record of the running ULT */
+	uint64_t		 si_ult_acct_start; /* Start time of the running ULT (us) */
+	struct sched_ult_stats	 si_ult_stats[DSS_ULT_CLS_MAX];
+	struct sched_ult_stats	*si_ult_rpc_stats[DAOS_MAX_MODULE]; /* Per opcode */
+	/* Queue delay and service time estimators for each type of request */
+	struct sched_lat_est	 si_qdelay_est[SCHED_REQ_MAX];
+	struct sched_lat_est	 si_svc_est[SCHED_REQ_MAX];
 	unsigned int		 si_stop:1;
 };
 
@@ -69,6 +104,12 @@ struct mem_stats {
 	uint64_t		ms_current;
 };
 
+struct acc_stats {
+	struct d_tm_node_t	*as_inflight;		/* Tasks queued on helper XS */
+	struct d_tm_node_t	*as_offloaded;		/* Tasks offloaded to helper XS */
+	struct d_tm_node_t	*as_inline;		/* Tasks executed in place */
+};
+
 /** Per-xstream configuration data */
 struct dss_xstream {
 	char			dx_name[DSS_XS_NAME_LEN];
@@ -77,6 +118,8 @@ struct dss_xstream {
 	hwloc_cpuset_t		dx_cpuset;
 	ABT_xstream		dx_xstream;
 	ABT_pool		dx_pools[DSS_POOL_CNT];
+	/* Work-stealing pool shared by helper XS on same NUMA node, helper XS only */
+	ABT_pool		dx_steal_pool;
 	ABT_sched		dx_sched;
 	ABT_thread		dx_progress;
 	struct sched_info	dx_sched_info;
@@ -96,6 +139,7 @@ struct dss_xstream {
 	bool			dx_comm;	/* true with cart context */
 	bool			dx_dsc_started;	/* DSC progress ULT started */
 	struct mem_stats	dx_mem_stats;	/* memory usages stats on this xstream */
+	struct acc_stats	dx_acc_stats;	/* offload stats of this main xstream */
 #ifdef ULT_MMAP_STACK
 	/* per-xstream pool/list of free stacks */
 	struct stack_pool	*dx_sp;
@@ -219,7 +263,12 @@ extern unsigned int sched_relax_intvl;
 extern unsigned int sched_relax_mode;
 extern unsigned int sched_unit_runtime_max;
 extern bool sched_watchdog_all;
+extern unsigned int sched_slo_p99;
+extern bool sched_ult_acct;
 
+void sched_job_prio_init(const char *str);
+int sched_ult_acct_init(void);
+void sched_ult_acct_fini(void);
 void dss_sched_fini(struct dss_xstream *dx);
 int dss_sched_init(struct dss_xstream *dx);
 int sched_req_enqueue(struct dss_xstream *dx, struct sched_req_attr *attr,
@@ -310,6 +359,10 @@ sched_create_thread(struct dss_xstream *dx, void (*func)(void *), void *arg,
 		/* Atomic integer assignment from different xstream */
 		info->si_stats.ss_busy_ts = info->si_cur_ts;
 
+	/* Any helper XS on the same NUMA node could pick it up from the shared pool */
+	if ((flags & DSS_ULT_FL_STEAL) && dx->dx_steal_pool != ABT_POOL_NULL)
+		abt_pool = dx->dx_steal_pool;
+
 	rc = daos_abt_thread_create(cur_dx->dx_sp, dss_free_stack_cb, abt_pool, func, arg, t_attr, thread);
 	return dss_abterr2der(rc);
 }
@@ -471,6 +471,10 @@ ult_create_internal(void (*func)(void *), void *arg, int xs_type, int tgt_idx,
 	if (dx == NULL)
 		return -DER_NONEXIST;
 
+	/* Offload ULTs are target independent, they can be run by any helper XS */
+	if (xs_type == DSS_XS_OFFLOAD)
+		flags |= DSS_ULT_FL_STEAL;
+
 	if (stack_size > 0) {
 		rc = ABT_thread_attr_create(&attr);
 		if (rc != ABT_SUCCESS)
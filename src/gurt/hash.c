@@ -9,6 +9,7 @@
 #define D_LOGFAC	DD_FAC(mem)
 
 #include <pthread.h>
+#include <sched.h>
 #include <gurt/common.h>
 #include <gurt/list.h>
 #include <gurt/hash.h>
@@ -218,6 +219,311 @@ d_hash_jump(uint64_t key, uint32_t num_buckets)
  * Generic Hash Table functions / data structures
  ******************************************************************************/
 
+/** maximum bits of the buckets of D_HASH_FT_RCU hash table */
+#define CH_RCU_MAX_BITS		24
+/** the buckets are doubled once there are more records on average */
+#define CH_RCU_LOAD_FACTOR	2
+/** number of buckets migrated by each insert while growing */
+#define CH_RCU_MIGRATE_NR	16
+/** number of reader counters, spread to avoid cacheline bouncing */
+#define CH_RCU_STRIPES		16
+
+enum ch_rcu_state {
+	/** records are in this bucket */
+	CH_RCU_STABLE	= 0,
+	/** records are being moved to the next buckets */
+	CH_RCU_MOVING,
+	/** records are in the next buckets */
+	CH_RCU_MOVED,
+};
+
+struct ch_rcu_buckets {
+	/** bits to generate number of buckets */
+	uint32_t		 rb_bits;
+	/** array of buckets */
+	struct d_hash_bucket	*rb_buckets;
+	/** migration state of each bucket, see ch_rcu_state */
+	ATOMIC uint32_t		*rb_states;
+	/** the doubled buckets while growing */
+	struct ch_rcu_buckets	*ATOMIC rb_next;
+};
+
+struct ch_rcu_readers {
+	/** number of lookups in progress for each epoch parity */
+	ATOMIC uint64_t		rr_nr[2];
+	uint64_t		rr_padding[6];
+};
+
+/** records deleted from a D_HASH_FT_RCU hash table, waiting to be freed */
+struct ch_rcu_defer {
+	d_list_t		**rd_recs;
+	uint32_t		  rd_nr;
+	uint32_t		  rd_size;
+};
+
+struct d_hash_rcu {
+	/** current buckets */
+	struct ch_rcu_buckets	*ATOMIC hr_buckets;
+	/** total number of records */
+	ATOMIC uint32_t		 hr_nr;
+	/** grace period counter, the lookups register on its parity */
+	ATOMIC uint32_t		 hr_epoch;
+	/** number of buckets already migrated to rb_next */
+	uint32_t		 hr_migrated;
+	/** serialize growing */
+	pthread_mutex_t		 hr_grow_lock;
+	/** serialize grace periods */
+	pthread_mutex_t		 hr_sync_lock;
+	/** protect hr_wait and hr_next */
+	pthread_mutex_t		 hr_defer_lock;
+	/** records deleted before the running grace period, freed at its end */
+	struct ch_rcu_defer	 hr_wait;
+	/** records deleted since the running grace period started */
+	struct ch_rcu_defer	 hr_next;
+	/** number of records in hr_wait and hr_next */
+	ATOMIC uint32_t		 hr_deferred;
+	/** no lookup is left on the older epoch parity, under hr_sync_lock */
+	bool			 hr_drained;
+	struct ch_rcu_readers	 hr_readers[CH_RCU_STRIPES];
+};
+
+static ATOMIC uint32_t ch_rcu_stripe_next;
+static __thread int    ch_rcu_stripe = -1;
+
+static inline struct ch_rcu_readers *
+ch_rcu_readers(struct d_hash_rcu *rcu)
+{
+	if (unlikely(ch_rcu_stripe < 0))
+		ch_rcu_stripe = atomic_fetch_add_relaxed(&ch_rcu_stripe_next, 1) %
+				CH_RCU_STRIPES;
+
+	return &rcu->hr_readers[ch_rcu_stripe];
+}
+
+/**
+ * Enter a lookup, the records and buckets it can see are not freed until
+ * ch_rcu_read_unlock() is called. Returns the epoch parity to unlock.
+ */
+static inline int
+ch_rcu_read_lock(struct d_hash_rcu *rcu)
+{
+	struct ch_rcu_readers	*readers = ch_rcu_readers(rcu);
+	int			 epoch;
+
+	for (;;) {
+		epoch = atomic_load(&rcu->hr_epoch) & 1;
+		atomic_fetch_add(&readers->rr_nr[epoch], 1);
+		/* otherwise a grace period started, it may not wait for us */
+		if ((atomic_load(&rcu->hr_epoch) & 1) == epoch)
+			return epoch;
+		atomic_fetch_sub(&readers->rr_nr[epoch], 1);
+	}
+}
+
+static inline void
+ch_rcu_read_unlock(struct d_hash_rcu *rcu, int epoch)
+{
+	atomic_fetch_sub(&ch_rcu_readers(rcu)->rr_nr[epoch], 1);
+}
+
+/** number of lookups registered on the epoch parity \a epoch */
+static inline uint64_t
+ch_rcu_readers_nr(struct d_hash_rcu *rcu, int epoch)
+{
+	uint64_t	nr;
+	int		i;
+
+	for (i = 0, nr = 0; i < CH_RCU_STRIPES; i++)
+		nr += atomic_load(&rcu->hr_readers[i].rr_nr[epoch]);
+	return nr;
+}
+
+static inline int
+ch_rcu_older(struct d_hash_rcu *rcu)
+{
+	return (atomic_load(&rcu->hr_epoch) - 1) & 1;
+}
+
+/** wait for all the lookups started before the call */
+static void
+ch_rcu_synchronize(struct d_hash_rcu *rcu)
+{
+	int	epoch;
+
+	D_MUTEX_LOCK(&rcu->hr_sync_lock);
+	/* the older parity can only be reused once the last grace period ended */
+	if (!rcu->hr_drained) {
+		while (ch_rcu_readers_nr(rcu, ch_rcu_older(rcu)) != 0)
+			sched_yield();
+	}
+	/* new lookups register on the other parity */
+	epoch = atomic_fetch_add(&rcu->hr_epoch, 1) & 1;
+	while (ch_rcu_readers_nr(rcu, epoch) != 0)
+		sched_yield();
+	rcu->hr_drained = true;
+	D_MUTEX_UNLOCK(&rcu->hr_sync_lock);
+}
+
+/** queue a deleted record to be freed after a grace period */
+static bool
+ch_rcu_defer(struct d_hash_rcu *rcu, d_list_t *link)
+{
+	struct ch_rcu_defer	*defer = &rcu->hr_next;
+	d_list_t		**recs;
+	uint32_t		  size;
+
+	D_MUTEX_LOCK(&rcu->hr_defer_lock);
+	if (defer->rd_nr == defer->rd_size) {
+		size = max(defer->rd_size * 2, 64U);
+		D_REALLOC_ARRAY(recs, defer->rd_recs, defer->rd_size, size);
+		if (recs == NULL) {
+			D_MUTEX_UNLOCK(&rcu->hr_defer_lock);
+			return false;
+		}
+		defer->rd_recs = recs;
+		defer->rd_size = size;
+	}
+	defer->rd_recs[defer->rd_nr++] = link;
+	D_MUTEX_UNLOCK(&rcu->hr_defer_lock);
+
+	atomic_fetch_add_relaxed(&rcu->hr_deferred, 1);
+	return true;
+}
+
+static void
+ch_rcu_defer_free(struct d_hash_table *htable, struct ch_rcu_defer *defer)
+{
+	uint32_t	i;
+
+	if (defer->rd_nr != 0)
+		atomic_fetch_sub_relaxed(&htable->ht_rcu->hr_deferred, defer->rd_nr);
+	for (i = 0; i < defer->rd_nr; i++)
+		htable->ht_ops->hop_rec_free(htable, defer->rd_recs[i]);
+	D_FREE(defer->rd_recs);
+}
+
+/**
+ * Free the deferred records whose grace period ended, and start a grace
+ * period for the ones deleted since. It never waits for the lookups, so
+ * that the records are freed in batches instead of paying for a grace
+ * period on each delete. If no lookup is in progress, the new grace period
+ * ends at once and its records are freed right away, so they don't stay
+ * around until the next insert or delete of an idle table.
+ */
+static void
+ch_rcu_reclaim(struct d_hash_table *htable)
+{
+	struct d_hash_rcu	*rcu = htable->ht_rcu;
+	struct ch_rcu_defer	 done[2] = {0};
+	uint32_t		 nr;
+	int			 i;
+
+	/* somebody else is at it */
+	if (D_MUTEX_TRYLOCK(&rcu->hr_sync_lock) != 0)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(done); i++) {
+		if (!rcu->hr_drained)
+			rcu->hr_drained = ch_rcu_readers_nr(rcu, ch_rcu_older(rcu)) == 0;
+		if (!rcu->hr_drained)
+			break;
+
+		D_MUTEX_LOCK(&rcu->hr_defer_lock);
+		done[i]      = rcu->hr_wait;
+		rcu->hr_wait = rcu->hr_next;
+		memset(&rcu->hr_next, 0, sizeof(rcu->hr_next));
+		nr = rcu->hr_wait.rd_nr;
+		D_MUTEX_UNLOCK(&rcu->hr_defer_lock);
+
+		if (nr == 0)
+			break;
+		/* lookups which may still see hr_wait are left on the older parity */
+		atomic_fetch_add(&rcu->hr_epoch, 1);
+		rcu->hr_drained = false;
+	}
+	D_MUTEX_UNLOCK(&rcu->hr_sync_lock);
+
+	ch_rcu_defer_free(htable, &done[0]);
+	ch_rcu_defer_free(htable, &done[1]);
+}
+
+/** wait for a grace period and free all the records deleted before the call */
+static void
+ch_rcu_reclaim_all(struct d_hash_table *htable)
+{
+	struct d_hash_rcu	*rcu = htable->ht_rcu;
+	struct ch_rcu_defer	 done[2];
+
+	D_MUTEX_LOCK(&rcu->hr_defer_lock);
+	done[0] = rcu->hr_wait;
+	done[1] = rcu->hr_next;
+	memset(&rcu->hr_wait, 0, sizeof(rcu->hr_wait));
+	memset(&rcu->hr_next, 0, sizeof(rcu->hr_next));
+	D_MUTEX_UNLOCK(&rcu->hr_defer_lock);
+
+	ch_rcu_synchronize(rcu);
+	ch_rcu_defer_free(htable, &done[0]);
+	ch_rcu_defer_free(htable, &done[1]);
+}
+
+/**
+ * List operations safe against lockless readers: a reader following the
+ * next pointers always ends at the head of the bucket, or at a deleted
+ * record pointing to itself so that the reader can restart.
+ */
+static inline void
+ch_list_add_rcu(d_list_t *link, d_list_t *head)
+{
+	d_list_t *next = head->next;
+
+	/* a lookup may still be on the record if it is being migrated */
+	__atomic_store_n(&link->next, next, __ATOMIC_RELAXED);
+	link->prev = head;
+	next->prev = link;
+	__atomic_store_n(&head->next, link, __ATOMIC_RELEASE);
+}
+
+static inline void
+ch_list_del_rcu(d_list_t *link)
+{
+	link->next->prev = link->prev;
+	__atomic_store_n(&link->prev->next, link->next, __ATOMIC_RELEASE);
+	__atomic_store_n(&link->next, link, __ATOMIC_RELEASE);
+	link->prev = link;
+}
+
+static void
+ch_rcu_buckets_free(struct ch_rcu_buckets *rb)
+{
+	D_FREE(rb->rb_states);
+	D_FREE(rb->rb_buckets);
+	D_FREE(rb);
+}
+
+static struct ch_rcu_buckets *
+ch_rcu_buckets_alloc(uint32_t bits)
+{
+	struct ch_rcu_buckets	*rb;
+	uint32_t		 nr = 1U << bits;
+	uint32_t		 i;
+
+	D_ALLOC_PTR(rb);
+	if (rb == NULL)
+		return NULL;
+
+	D_ALLOC_ARRAY(rb->rb_buckets, nr);
+	D_ALLOC_ARRAY(rb->rb_states, nr);
+	if (rb->rb_buckets == NULL || rb->rb_states == NULL) {
+		ch_rcu_buckets_free(rb);
+		return NULL;
+	}
+
+	rb->rb_bits = bits;
+	for (i = 0; i < nr; i++)
+		D_INIT_LIST_HEAD(&rb->rb_buckets[i].hb_head);
+	return rb;
+}
+
 /**
  * Lock the hash table
  *
@@ -266,6 +572,37 @@ ch_bucket_unlock(struct d_hash_table *htable, uint32_t idx, bool read_only)
 		D_SPIN_UNLOCK(&lock->spin);
 }
 
+/** index of the lock protecting the records of \a hash */
+static inline uint32_t
+ch_lock_idx(struct d_hash_table *htable, uint32_t hash)
+{
+	return hash & ((1U << htable->ht_bits) - 1);
+}
+
+/**
+ * Get the bucket of \a hash, the caller should hold the lock of it.
+ *
+ * The buckets of D_HASH_FT_RCU hash table are only doubled, so the lock of
+ * a bucket also protects the two buckets it is split into.
+ */
+static inline struct d_hash_bucket *
+ch_bucket(struct d_hash_table *htable, uint32_t hash)
+{
+	struct ch_rcu_buckets	*rb;
+	uint32_t		 idx;
+
+	if (!(htable->ht_feats & D_HASH_FT_RCU))
+		return &htable->ht_buckets[ch_lock_idx(htable, hash)];
+
+	rb = atomic_load_relaxed(&htable->ht_rcu->hr_buckets);
+	for (;;) {
+		idx = hash & ((1U << rb->rb_bits) - 1);
+		if (atomic_load_relaxed(&rb->rb_states[idx]) != CH_RCU_MOVED)
+			return &rb->rb_buckets[idx];
+		rb = atomic_load_relaxed(&rb->rb_next);
+	}
+}
+
 /**
  * wrappers for member functions.
  */
@@ -284,35 +621,28 @@ ch_key_init(struct d_hash_table *htable, d_list_t *link, void *arg)
 }
 
 /**
- * Convert key to hash bucket id.
+ * Hash the key, see ch_lock_idx() and ch_bucket() to convert it to the
+ * lock and the bucket.
  *
  * It calls DJB2 hash if no customized hash function is provided.
  */
 static inline uint32_t
 ch_key_hash(struct d_hash_table *htable, const void *key, unsigned int ksize)
 {
-	uint32_t idx;
-
 	if (htable->ht_ops->hop_key_hash)
-		idx = htable->ht_ops->hop_key_hash(htable, key, ksize);
-	else
-		idx = d_hash_string_u32((const char *)key, ksize);
+		return htable->ht_ops->hop_key_hash(htable, key, ksize);
 
-	return idx & ((1U << htable->ht_bits) - 1);
+	return d_hash_string_u32((const char *)key, ksize);
 }
 
 static inline uint32_t
 ch_rec_hash(struct d_hash_table *htable, d_list_t *link)
 {
-	uint32_t idx = 0;
-
 	if (htable->ht_ops->hop_rec_hash)
-		idx = htable->ht_ops->hop_rec_hash(htable, link);
-	else
-		D_ASSERT(htable->ht_feats &
-			 (D_HASH_FT_NOLOCK | D_HASH_FT_GLOCK));
+		return htable->ht_ops->hop_rec_hash(htable, link);
 
-	return idx & ((1U << htable->ht_bits) - 1);
+	D_ASSERT(htable->ht_feats & (D_HASH_FT_NOLOCK | D_HASH_FT_GLOCK));
+	return 0;
 }
 
 static inline void
@@ -322,6 +652,13 @@ ch_rec_addref(struct d_hash_table *htable, d_list_t *link)
 		htable->ht_ops->hop_rec_addref(htable, link);
 }
 
+static inline bool
+ch_rec_tryaddref(struct d_hash_table *htable, d_list_t *link)
+{
+	return htable->ht_ops->hop_rec_tryaddref ?
+	       htable->ht_ops->hop_rec_tryaddref(htable, link) : true;
+}
+
 static inline bool
 ch_rec_decref(struct d_hash_table *htable, d_list_t *link)
 {
@@ -332,15 +669,31 @@ ch_rec_decref(struct d_hash_table *htable, d_list_t *link)
 static inline void
 ch_rec_free(struct d_hash_table *htable, d_list_t *link)
 {
-	if (htable->ht_ops->hop_rec_free)
-		htable->ht_ops->hop_rec_free(htable, link);
+	if (htable->ht_ops->hop_rec_free == NULL)
+		return;
+
+	/* a lookup may still be looking at the record */
+	if (htable->ht_feats & D_HASH_FT_RCU) {
+		if (ch_rcu_defer(htable->ht_rcu, link)) {
+			ch_rcu_reclaim(htable);
+			return;
+		}
+		/* out of memory, wait for the grace period right here */
+		ch_rcu_synchronize(htable->ht_rcu);
+	}
+	htable->ht_ops->hop_rec_free(htable, link);
 }
 
 static inline void
 ch_rec_insert(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 	      d_list_t *link)
 {
-	d_list_add(link, &bucket->hb_head);
+	if (htable->ht_feats & D_HASH_FT_RCU) {
+		ch_list_add_rcu(link, &bucket->hb_head);
+		atomic_fetch_add_relaxed(&htable->ht_rcu->hr_nr, 1);
+	} else {
+		d_list_add(link, &bucket->hb_head);
+	}
 #if D_HASH_DEBUG
 	htable->ht_nr++;
 	if (htable->ht_nr > htable->ht_nr_max)
@@ -375,16 +728,21 @@ ch_rec_insert_addref(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 static inline void
 ch_rec_delete(struct d_hash_table *htable, d_list_t *link)
 {
-	d_list_del_init(link);
 #if D_HASH_DEBUG
 	htable->ht_nr--;
 	if (htable->ht_ops->hop_rec_hash) {
 		struct d_hash_bucket *bucket;
 
-		bucket = &htable->ht_buckets[ch_rec_hash(htable, link)];
+		bucket = ch_bucket(htable, ch_rec_hash(htable, link));
 		bucket->hb_dep--;
 	}
 #endif
+	if (htable->ht_feats & D_HASH_FT_RCU) {
+		ch_list_del_rcu(link);
+		atomic_fetch_sub_relaxed(&htable->ht_rcu->hr_nr, 1);
+	} else {
+		d_list_del_init(link);
+	}
 }
 
 /**
@@ -429,6 +787,166 @@ ch_rec_find(struct d_hash_table *htable, struct d_hash_bucket *bucket,
 	return NULL;
 }
 
+/**
+ * Migrate the records of bucket \a idx of \a rb to the next buckets, the
+ * lookups of this bucket spin until it is done.
+ */
+static void
+ch_rcu_migrate(struct d_hash_table *htable, struct ch_rcu_buckets *rb,
+	       uint32_t idx)
+{
+	struct ch_rcu_buckets	*next = atomic_load(&rb->rb_next);
+	struct d_hash_bucket	*bucket = &rb->rb_buckets[idx];
+	d_list_t		*link;
+	uint32_t		 lock_idx = ch_lock_idx(htable, idx);
+	uint32_t		 hash;
+
+	ch_bucket_lock(htable, lock_idx, false);
+	atomic_store(&rb->rb_states[idx], CH_RCU_MOVING);
+	while (!d_list_empty(&bucket->hb_head)) {
+		link = bucket->hb_head.next;
+		hash = ch_rec_hash(htable, link);
+		ch_list_del_rcu(link);
+		ch_list_add_rcu(link, &next->rb_buckets[hash & ((1U << next->rb_bits) - 1)].hb_head);
+	}
+	atomic_store(&rb->rb_states[idx], CH_RCU_MOVED);
+	ch_bucket_unlock(htable, lock_idx, false);
+}
+
+/**
+ * Double the buckets of a D_HASH_FT_RCU hash table. The migration is spread
+ * over the inserts, each of them moves CH_RCU_MIGRATE_NR buckets, unless
+ * \a finish is set. The caller should hold hr_grow_lock.
+ */
+static void
+ch_rcu_grow_locked(struct d_hash_table *htable, bool finish)
+{
+	struct d_hash_rcu	*rcu = htable->ht_rcu;
+	struct ch_rcu_buckets	*rb;
+	struct ch_rcu_buckets	*next;
+	uint32_t		 nr;
+	uint32_t		 end;
+	uint32_t		 i;
+
+	rb   = atomic_load(&rcu->hr_buckets);
+	nr   = 1U << rb->rb_bits;
+	next = atomic_load(&rb->rb_next);
+	if (next == NULL) {
+		if (finish || rb->rb_bits >= CH_RCU_MAX_BITS ||
+		    atomic_load_relaxed(&rcu->hr_nr) <= nr * CH_RCU_LOAD_FACTOR)
+			return;
+
+		/* not fatal, keep going with longer chains */
+		next = ch_rcu_buckets_alloc(rb->rb_bits + 1);
+		if (next == NULL)
+			return;
+
+		rcu->hr_migrated = 0;
+		atomic_store(&rb->rb_next, next);
+		D_DEBUG(DB_TRACE, "Growing hash table %p to %u buckets\n",
+			htable, 2 * nr);
+	}
+
+	end = finish ? nr : min(nr, rcu->hr_migrated + CH_RCU_MIGRATE_NR);
+	for (i = rcu->hr_migrated; i < end; i++)
+		ch_rcu_migrate(htable, rb, i);
+	rcu->hr_migrated = end;
+	if (end < nr)
+		return;
+
+	atomic_store(&rcu->hr_buckets, next);
+	/* wait for the updates which may still walk the old buckets */
+	for (i = 0; i < (1U << htable->ht_bits); i++) {
+		ch_bucket_lock(htable, i, false);
+		ch_bucket_unlock(htable, i, false);
+		if (htable->ht_feats & D_HASH_FT_GLOCK)
+			break;
+	}
+	/* and for the lookups */
+	ch_rcu_synchronize(rcu);
+	ch_rcu_buckets_free(rb);
+}
+
+/** grow the hash table after an insert if it is overloaded */
+static inline void
+ch_rcu_inserted(struct d_hash_table *htable)
+{
+	struct d_hash_rcu	*rcu = htable->ht_rcu;
+	struct ch_rcu_buckets	*rb;
+	bool			 grow;
+	int			 epoch;
+
+	if (!(htable->ht_feats & D_HASH_FT_RCU))
+		return;
+
+	if (atomic_load_relaxed(&rcu->hr_deferred) != 0)
+		ch_rcu_reclaim(htable);
+
+	epoch = ch_rcu_read_lock(rcu);
+	rb    = atomic_load(&rcu->hr_buckets);
+	grow  = atomic_load_relaxed(&rb->rb_next) != NULL ||
+		(rb->rb_bits < CH_RCU_MAX_BITS &&
+		 atomic_load_relaxed(&rcu->hr_nr) > (CH_RCU_LOAD_FACTOR << rb->rb_bits));
+	ch_rcu_read_unlock(rcu, epoch);
+
+	/* somebody else is already migrating */
+	if (!grow || D_MUTEX_TRYLOCK(&rcu->hr_grow_lock) != 0)
+		return;
+
+	ch_rcu_grow_locked(htable, false);
+	D_MUTEX_UNLOCK(&rcu->hr_grow_lock);
+}
+
+/** lockless lookup of D_HASH_FT_RCU hash table */
+static d_list_t *
+ch_rcu_rec_find(struct d_hash_table *htable, const void *key,
+		unsigned int ksize)
+{
+	struct d_hash_rcu	*rcu = htable->ht_rcu;
+	struct ch_rcu_buckets	*rb;
+	d_list_t		*head;
+	d_list_t		*link;
+	d_list_t		*next;
+	uint32_t		 hash;
+	uint32_t		 idx;
+	int			 epoch;
+
+	hash  = ch_key_hash(htable, key, ksize);
+	epoch = ch_rcu_read_lock(rcu);
+	rb    = atomic_load(&rcu->hr_buckets);
+retry:
+	idx = hash & ((1U << rb->rb_bits) - 1);
+	switch (atomic_load(&rb->rb_states[idx])) {
+	case CH_RCU_MOVED:
+		rb = atomic_load(&rb->rb_next);
+		goto retry;
+	case CH_RCU_MOVING:
+		goto retry;
+	default:
+		break;
+	}
+
+	head = &rb->rb_buckets[idx].hb_head;
+	for (link = head;; link = next) {
+		next = __atomic_load_n(&link->next, __ATOMIC_ACQUIRE);
+		/* the records may have been moved to another bucket */
+		if (atomic_load(&rb->rb_states[idx]) != CH_RCU_STABLE)
+			goto retry;
+		if (next == head) {
+			next = NULL;
+			break;
+		}
+		/* deleted under us */
+		if (next == link)
+			goto retry;
+		if (ch_key_cmp(htable, next, key, ksize) &&
+		    ch_rec_tryaddref(htable, next))
+			break;
+	}
+	ch_rcu_read_unlock(rcu, epoch);
+	return next;
+}
+
 bool
 d_hash_rec_unlinked(d_list_t *link)
 {
@@ -441,14 +959,19 @@ d_hash_rec_find(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
+	uint32_t		 hash;
 	uint32_t		 idx;
 	bool			 is_lru = (htable->ht_feats & D_HASH_FT_LRU);
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
+	if (htable->ht_feats & D_HASH_FT_RCU)
+		return ch_rcu_rec_find(htable, key, ksize);
+
+	hash = ch_key_hash(htable, key, ksize);
+	idx  = ch_lock_idx(htable, hash);
 
 	ch_bucket_lock(htable, idx, !is_lru);
+	bucket = ch_bucket(htable, hash);
 
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_HEAD);
 	if (link != NULL)
@@ -464,14 +987,16 @@ d_hash_rec_insert(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*tmp;
+	uint32_t		 hash;
 	uint32_t		 idx;
 	int			 rc = 0;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_key_hash(htable, key, ksize);
+	idx  = ch_lock_idx(htable, hash);
 
 	ch_bucket_lock(htable, idx, false);
+	bucket = ch_bucket(htable, hash);
 
 	if (exclusive) {
 		tmp = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_NONE);
@@ -484,6 +1009,8 @@ d_hash_rec_insert(struct d_hash_table *htable, const void *key,
 
 out_unlock:
 	ch_bucket_unlock(htable, idx, false);
+	if (rc == 0)
+		ch_rcu_inserted(htable);
 	return rc;
 }
 
@@ -493,24 +1020,26 @@ d_hash_rec_find_insert(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*tmp;
+	uint32_t		 hash;
 	uint32_t		 idx;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_key_hash(htable, key, ksize);
+	idx  = ch_lock_idx(htable, hash);
 
 	ch_bucket_lock(htable, idx, false);
+	bucket = ch_bucket(htable, hash);
 
 	tmp = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_HEAD);
 	if (tmp) {
 		ch_rec_addref(htable, tmp);
-		link = tmp;
-		D_GOTO(out_unlock, 0);
+		ch_bucket_unlock(htable, idx, false);
+		return tmp;
 	}
 	ch_rec_insert_addref(htable, bucket, link);
 
-out_unlock:
 	ch_bucket_unlock(htable, idx, false);
+	ch_rcu_inserted(htable);
 	return link;
 }
 
@@ -519,6 +1048,7 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 			 void *arg)
 {
 	struct d_hash_bucket	*bucket;
+	uint32_t		 hash;
 	uint32_t		 idx;
 	uint32_t		 nr = 1U << htable->ht_bits;
 	bool			 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
@@ -539,12 +1069,13 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 
 	/* has no key, hash table should have provided key generator */
 	ch_key_init(htable, link, arg);
-	idx = ch_rec_hash(htable, link);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_rec_hash(htable, link);
+	idx  = ch_lock_idx(htable, hash);
 
 	if (need_lock && !need_keyinit_lock)
 		ch_bucket_lock(htable, idx, false);
 
+	bucket = ch_bucket(htable, hash);
 	ch_rec_insert_addref(htable, bucket, link);
 
 	if (need_lock) {
@@ -558,6 +1089,7 @@ d_hash_rec_insert_anonym(struct d_hash_table *htable, d_list_t *link,
 			}
 		}
 	}
+	ch_rcu_inserted(htable);
 	return 0;
 }
 
@@ -567,15 +1099,17 @@ d_hash_rec_delete(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
+	uint32_t		 hash;
 	uint32_t		 idx;
 	bool			 deleted = false;
 	bool			 zombie  = false;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_key_hash(htable, key, ksize);
+	idx  = ch_lock_idx(htable, hash);
 
 	ch_bucket_lock(htable, idx, false);
+	bucket = ch_bucket(htable, hash);
 
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_NONE);
 	if (link != NULL) {
@@ -599,7 +1133,7 @@ d_hash_rec_delete_at(struct d_hash_table *htable, d_list_t *link)
 	bool	 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
+		idx = ch_lock_idx(htable, ch_rec_hash(htable, link));
 		ch_bucket_lock(htable, idx, false);
 	}
 
@@ -622,16 +1156,18 @@ d_hash_rec_evict(struct d_hash_table *htable, const void *key,
 {
 	struct d_hash_bucket	*bucket;
 	d_list_t		*link;
+	uint32_t		 hash;
 	uint32_t		 idx;
 
 	if (!(htable->ht_feats & D_HASH_FT_LRU))
 		return false;
 
 	D_ASSERT(key != NULL && ksize != 0);
-	idx = ch_key_hash(htable, key, ksize);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_key_hash(htable, key, ksize);
+	idx  = ch_lock_idx(htable, hash);
 
 	ch_bucket_lock(htable, idx, false);
+	bucket = ch_bucket(htable, hash);
 
 	link = ch_rec_find(htable, bucket, key, ksize, D_HASH_LRU_TAIL);
 
@@ -643,16 +1179,18 @@ bool
 d_hash_rec_evict_at(struct d_hash_table *htable, d_list_t *link)
 {
 	struct d_hash_bucket	*bucket;
+	uint32_t		 hash;
 	uint32_t		 idx;
 	bool			 evicted = false;
 
 	if (!(htable->ht_feats & D_HASH_FT_LRU))
 		return false;
 
-	idx = ch_rec_hash(htable, link);
-	bucket = &htable->ht_buckets[idx];
+	hash = ch_rec_hash(htable, link);
+	idx  = ch_lock_idx(htable, hash);
 
 	ch_bucket_lock(htable, idx, false);
+	bucket = ch_bucket(htable, hash);
 
 	if (link != bucket->hb_head.prev) {
 		d_list_move_tail(link, &bucket->hb_head);
@@ -670,7 +1208,7 @@ d_hash_rec_addref(struct d_hash_table *htable, d_list_t *link)
 	bool	 need_lock = !(htable->ht_feats & D_HASH_FT_NOLOCK);
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
+		idx = ch_lock_idx(htable, ch_rec_hash(htable, link));
 		ch_bucket_lock(htable, idx, true);
 	}
 
@@ -689,7 +1227,7 @@ d_hash_rec_decref(struct d_hash_table *htable, d_list_t *link)
 	bool	 zombie;
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
+		idx = ch_lock_idx(htable, ch_rec_hash(htable, link));
 		ch_bucket_lock(htable, idx, !ephemeral);
 	}
 
@@ -716,7 +1254,7 @@ d_hash_rec_ndecref(struct d_hash_table *htable, int count, d_list_t *link)
 	int	 rc = 0;
 
 	if (need_lock) {
-		idx = ch_rec_hash(htable, link);
+		idx = ch_lock_idx(htable, ch_rec_hash(htable, link));
 		ch_bucket_lock(htable, idx, !ephemeral);
 	}
 
@@ -779,6 +1317,107 @@ d_hash_rec_first(struct d_hash_table *htable)
 	return link;
 }
 
+static void
+ch_rcu_fini(struct d_hash_table *htable)
+{
+	struct d_hash_rcu	*rcu = htable->ht_rcu;
+	struct ch_rcu_buckets	*rb;
+
+	if (rcu == NULL)
+		return;
+
+	rb = atomic_load(&rcu->hr_buckets);
+	if (rb != NULL) {
+		D_ASSERT(atomic_load(&rb->rb_next) == NULL);
+		ch_rcu_buckets_free(rb);
+	}
+	D_ASSERT(rcu->hr_wait.rd_nr == 0 && rcu->hr_next.rd_nr == 0);
+	D_FREE(rcu->hr_wait.rd_recs);
+	D_FREE(rcu->hr_next.rd_recs);
+	D_MUTEX_DESTROY(&rcu->hr_defer_lock);
+	D_MUTEX_DESTROY(&rcu->hr_sync_lock);
+	D_MUTEX_DESTROY(&rcu->hr_grow_lock);
+	D_FREE(htable->ht_rcu);
+}
+
+static int
+ch_rcu_init(struct d_hash_table *htable, uint32_t bits)
+{
+	struct d_hash_rcu	*rcu;
+	struct ch_rcu_buckets	*rb;
+	int			 rc;
+
+	D_ALLOC_PTR(rcu);
+	if (rcu == NULL)
+		return -DER_NOMEM;
+
+	rc = D_MUTEX_INIT(&rcu->hr_grow_lock, NULL);
+	if (rc)
+		goto free_rcu;
+
+	rc = D_MUTEX_INIT(&rcu->hr_sync_lock, NULL);
+	if (rc)
+		goto free_grow_lock;
+
+	rc = D_MUTEX_INIT(&rcu->hr_defer_lock, NULL);
+	if (rc)
+		goto free_sync_lock;
+
+	rb = ch_rcu_buckets_alloc(bits);
+	if (rb == NULL)
+		D_GOTO(free_defer_lock, rc = -DER_NOMEM);
+
+	atomic_store(&rcu->hr_buckets, rb);
+	rcu->hr_drained = true;
+	htable->ht_rcu = rcu;
+	return 0;
+
+free_defer_lock:
+	D_MUTEX_DESTROY(&rcu->hr_defer_lock);
+free_sync_lock:
+	D_MUTEX_DESTROY(&rcu->hr_sync_lock);
+free_grow_lock:
+	D_MUTEX_DESTROY(&rcu->hr_grow_lock);
+free_rcu:
+	D_FREE(rcu);
+	return rc;
+}
+
+/**
+ * Get the buckets to go through. For D_HASH_FT_RCU hash table, it finishes
+ * the migration and holds off growing until ch_buckets_put().
+ */
+static struct d_hash_bucket *
+ch_buckets_get(struct d_hash_table *htable, uint32_t *nr)
+{
+	struct ch_rcu_buckets *rb;
+
+	if (!(htable->ht_feats & D_HASH_FT_RCU)) {
+		*nr = 1U << htable->ht_bits;
+		return htable->ht_buckets;
+	}
+
+	D_MUTEX_LOCK(&htable->ht_rcu->hr_grow_lock);
+	ch_rcu_grow_locked(htable, true);
+	rb  = atomic_load(&htable->ht_rcu->hr_buckets);
+	*nr = 1U << rb->rb_bits;
+	return rb->rb_buckets;
+}
+
+static void
+ch_buckets_put(struct d_hash_table *htable)
+{
+	if (htable->ht_feats & D_HASH_FT_RCU)
+		D_MUTEX_UNLOCK(&htable->ht_rcu->hr_grow_lock);
+}
+
+void
+d_hash_table_synchronize(struct d_hash_table *htable)
+{
+	if (htable->ht_feats & D_HASH_FT_RCU)
+		ch_rcu_reclaim_all(htable);
+}
+
 int
 d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 			    d_hash_table_ops_t *hops,
@@ -791,10 +1430,18 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 	D_ASSERT(hops != NULL);
 	D_ASSERT(hops->hop_key_cmp != NULL);
 
+	if ((feats & D_HASH_FT_RCU) &&
+	    ((feats & (D_HASH_FT_NOLOCK | D_HASH_FT_LRU)) || hops->hop_rec_hash == NULL ||
+	     (hops->hop_rec_addref != NULL && hops->hop_rec_tryaddref == NULL))) {
+		D_ERROR("Invalid feats %#x or missing member functions for RCU\n", feats);
+		return -DER_INVAL;
+	}
+
 	htable->ht_feats = feats;
 	htable->ht_bits	 = bits;
 	htable->ht_ops	 = hops;
 	htable->ht_priv	 = priv;
+	htable->ht_rcu	 = NULL;
 
 	if (hops->hop_rec_hash == NULL && !(feats & D_HASH_FT_NOLOCK)) {
 		htable->ht_feats |= D_HASH_FT_GLOCK;
@@ -803,12 +1450,18 @@ d_hash_table_create_inplace(uint32_t feats, uint32_t bits, void *priv,
 			"will be used for backward compatibility.\n");
 	}
 
-	D_ALLOC_ARRAY(htable->ht_buckets, nr);
-	if (htable->ht_buckets == NULL)
-		D_GOTO(out, rc = -DER_NOMEM);
+	if (htable->ht_feats & D_HASH_FT_RCU) {
+		rc = ch_rcu_init(htable, bits);
+		if (rc)
+			D_GOTO(out, rc);
+	} else {
+		D_ALLOC_ARRAY(htable->ht_buckets, nr);
+		if (htable->ht_buckets == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
 
-	for (i = 0; i < nr; i++)
-		D_INIT_LIST_HEAD(&htable->ht_buckets[i].hb_head);
+		for (i = 0; i < nr; i++)
+			D_INIT_LIST_HEAD(&htable->ht_buckets[i].hb_head);
+	}
 
 	if (htable->ht_feats & D_HASH_FT_NOLOCK)
 		D_GOTO(out, rc = 0);
@@ -857,6 +1510,7 @@ free_locks:
 	}
 	D_FREE(htable->ht_locks);
 free_buckets:
+	ch_rcu_fini(htable);
 	D_FREE(htable->ht_buckets);
 out:
 	return rc;
@@ -886,85 +1540,96 @@ int
 d_hash_table_traverse(struct d_hash_table *htable, d_hash_traverse_cb_t cb,
 		      void *arg)
 {
-	struct d_hash_bucket	*bucket;
+	struct d_hash_bucket	*buckets;
 	d_list_t		*link;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	uint32_t		 nr;
 	uint32_t		 idx;
 	int			 rc = 0;
 
-	if (htable->ht_buckets == NULL) {
+	if (cb == NULL) {
+		D_ERROR("invalid parameter, NULL cb.\n");
+		return -DER_INVAL;
+	}
+
+	buckets = ch_buckets_get(htable, &nr);
+	if (buckets == NULL) {
 		D_ERROR("d_hash_table %p not initialized (NULL buckets).\n",
 			htable);
 		D_GOTO(out, rc = -DER_UNINIT);
 	}
-	if (cb == NULL) {
-		D_ERROR("invalid parameter, NULL cb.\n");
-		D_GOTO(out, rc = -DER_INVAL);
-	}
 
 	for (idx = 0; idx < nr && !rc; idx++) {
 		d_list_t *linkn;
 
-		bucket = &htable->ht_buckets[idx];
-		ch_bucket_lock(htable, idx, true);
-		d_list_for_each_safe(link, linkn, &bucket->hb_head) {
+		ch_bucket_lock(htable, ch_lock_idx(htable, idx), true);
+		d_list_for_each_safe(link, linkn, &buckets[idx].hb_head) {
 			rc = cb(link, arg);
 			if (rc)
 				break;
 		}
-		ch_bucket_unlock(htable, idx, true);
+		ch_bucket_unlock(htable, ch_lock_idx(htable, idx), true);
 	}
 out:
+	ch_buckets_put(htable);
 	return rc;
 }
 
 static bool
 d_hash_table_is_empty(struct d_hash_table *htable)
 {
-	uint32_t	 nr = 1U << htable->ht_bits;
-	uint32_t	 idx;
-	bool		 is_empty = true;
+	struct d_hash_bucket	*buckets;
+	uint32_t		 nr;
+	uint32_t		 idx;
+	bool			 is_empty = true;
 
-	if (htable->ht_buckets == NULL) {
+	buckets = ch_buckets_get(htable, &nr);
+	if (buckets == NULL) {
 		D_ERROR("d_hash_table %p not initialized (NULL buckets).\n",
 			htable);
 		D_GOTO(out, 0);
 	}
 
 	for (idx = 0; idx < nr && is_empty; idx++) {
-		ch_bucket_lock(htable, idx, true);
-		is_empty = d_list_empty(&htable->ht_buckets[idx].hb_head);
-		ch_bucket_unlock(htable, idx, true);
+		ch_bucket_lock(htable, ch_lock_idx(htable, idx), true);
+		is_empty = d_list_empty(&buckets[idx].hb_head);
+		ch_bucket_unlock(htable, ch_lock_idx(htable, idx), true);
 	}
 
 out:
+	ch_buckets_put(htable);
 	return is_empty;
 }
 
 int
 d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 {
-	struct d_hash_bucket	*bucket;
-	uint32_t		 nr = 1U << htable->ht_bits;
+	struct d_hash_bucket	*buckets;
+	uint32_t		 nr;
 	uint32_t		 i;
 	int			 rc = 0;
 
-	if (htable->ht_buckets == NULL) {
+	buckets = ch_buckets_get(htable, &nr);
+	if (buckets == NULL) {
+		ch_buckets_put(htable);
 		rc = -DER_UNINIT;
 		DHL_ERROR(htable, rc, "d_hash_table not initialized (NULL buckets)");
 		D_GOTO(out, 0);
 	}
 
 	for (i = 0; i < nr; i++) {
-		bucket = &htable->ht_buckets[i];
-		while (!d_list_empty(&bucket->hb_head)) {
+		while (!d_list_empty(&buckets[i].hb_head)) {
 			if (!force) {
+				ch_buckets_put(htable);
 				D_DEBUG(DB_TRACE, "Warning, non-empty hash\n");
 				D_GOTO(out, rc = -DER_BUSY);
 			}
-			d_hash_rec_delete_at(htable, bucket->hb_head.next);
+			d_hash_rec_delete_at(htable, buckets[i].hb_head.next);
 		}
 	}
+	ch_buckets_put(htable);
+	/* free the records still waiting for a grace period */
+	d_hash_table_synchronize(htable);
+	nr = 1U << htable->ht_bits;
 
 	if (htable->ht_feats & D_HASH_FT_NOLOCK)
 		D_GOTO(free_buckets, rc = 0);
@@ -989,6 +1654,7 @@ d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force)
 	}
 
 free_buckets:
+	ch_rcu_fini(htable);
 	D_FREE(htable->ht_buckets);
 	memset(htable, 0, sizeof(*htable));
 out:
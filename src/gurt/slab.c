@@ -8,9 +8,108 @@
 
 #include <gurt/debug.h>
 #include <gurt/common.h>
+#include <gurt/atomic.h>
+#include <gurt/telemetry_common.h>
+#include <gurt/telemetry_producer.h>
 
 #include <gurt/slab.h>
 
+static int
+mag_init(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	int rc;
+
+	rc = D_MUTEX_INIT(&mag->sm_lock, NULL);
+	if (rc != -DER_SUCCESS)
+		return rc;
+
+	D_INIT_LIST_HEAD(&mag->sm_link);
+	D_INIT_LIST_HEAD(&mag->sm_free_list);
+	D_INIT_LIST_HEAD(&mag->sm_pending_list);
+	mag->sm_type = type;
+	return -DER_SUCCESS;
+}
+
+/* Hand all the objects cached by a magazine back to the type.
+ *
+ * Returns the number of objects returned.
+ * This function should be called without the type lock held.
+ */
+static int
+mag_empty(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	int count;
+
+	D_MUTEX_LOCK(&mag->sm_lock);
+	count = mag->sm_free_count + mag->sm_pending_count;
+
+	D_MUTEX_LOCK(&type->st_lock);
+	d_list_splice_init(&mag->sm_free_list, &type->st_free_list);
+	d_list_splice_init(&mag->sm_pending_list, type->st_pending_list.prev);
+	type->st_free_count += mag->sm_free_count;
+	type->st_pending_count += mag->sm_pending_count;
+	type->st_mag_hits += mag->sm_hits;
+	d_tm_inc_counter(type->st_tm_hits, mag->sm_hits);
+	D_MUTEX_UNLOCK(&type->st_lock);
+
+	mag->sm_free_count    = 0;
+	mag->sm_pending_count = 0;
+	mag->sm_hits          = 0;
+	D_MUTEX_UNLOCK(&mag->sm_lock);
+
+	return count;
+}
+
+/* Called on exit of a thread which used the type */
+static void
+mag_exit(void *arg)
+{
+	struct d_slab_mag  *mag  = arg;
+	struct d_slab_type *type = mag->sm_type;
+
+	D_MUTEX_LOCK(&type->st_mag_lock);
+	d_list_del(&mag->sm_link);
+	D_MUTEX_UNLOCK(&type->st_mag_lock);
+
+	mag_empty(type, mag);
+	D_MUTEX_DESTROY(&mag->sm_lock);
+	D_FREE(mag);
+}
+
+/* Magazine of the calling thread, created on first use of the type */
+static inline struct d_slab_mag *
+slab_mag(struct d_slab_type *type)
+{
+	struct d_slab_mag *mag = pthread_getspecific(type->st_mag_key);
+
+	if (likely(mag != NULL))
+		return mag;
+
+	D_ALIGNED_ALLOC(mag, __alignof__(*mag), sizeof(*mag));
+	if (mag == NULL)
+		goto shared;
+
+	if (mag_init(type, mag) != -DER_SUCCESS) {
+		D_FREE(mag);
+		goto shared;
+	}
+
+	if (pthread_setspecific(type->st_mag_key, mag) != 0) {
+		D_MUTEX_DESTROY(&mag->sm_lock);
+		D_FREE(mag);
+		goto shared;
+	}
+
+	D_MUTEX_LOCK(&type->st_mag_lock);
+	d_list_add_tail(&mag->sm_link, &type->st_mag_list);
+	D_MUTEX_UNLOCK(&type->st_mag_lock);
+	return mag;
+
+shared:
+	D_TRACE_INFO(type, "Using the shared magazine\n");
+	return &type->st_mag_shared;
+}
+
 static void
 debug_dump(struct d_slab_type *type)
 {
@@ -24,6 +123,8 @@ debug_dump(struct d_slab_type *type)
 	D_TRACE_DEBUG(DB_ANY, type, "OP: init %d reset %d", type->st_op_init, type->st_op_reset);
 	D_TRACE_DEBUG(DB_ANY, type, "No restock: current %d hwm %d", type->st_no_restock,
 		      type->st_no_restock_hwm);
+	D_TRACE_DEBUG(DB_ANY, type, "Magazine: hits " DF_U64 " misses " DF_U64, type->st_mag_hits,
+		      type->st_mag_misses);
 }
 
 /* Create a data slab manager */
@@ -50,6 +151,7 @@ void
 d_slab_destroy(struct d_slab *slab)
 {
 	struct d_slab_type *type;
+	struct d_slab_mag  *mag;
 	int                 rc;
 	bool                in_use;
 
@@ -67,6 +169,14 @@ d_slab_destroy(struct d_slab *slab)
 	while ((type = d_list_pop_entry(&slab->slab_list, struct d_slab_type, st_type_list))) {
 		if (type->st_count != 0)
 			D_TRACE_WARN(type, "Freeing type with active objects\n");
+		/* No exit handler after this, the magazines are empty since the reclaim */
+		pthread_key_delete(type->st_mag_key);
+		while ((mag = d_list_pop_entry(&type->st_mag_list, struct d_slab_mag, sm_link))) {
+			D_MUTEX_DESTROY(&mag->sm_lock);
+			D_FREE(mag);
+		}
+		D_MUTEX_DESTROY(&type->st_mag_shared.sm_lock);
+		D_MUTEX_DESTROY(&type->st_mag_lock);
 		rc = pthread_mutex_destroy(&type->st_lock);
 		if (rc != 0)
 			D_TRACE_ERROR(type, "Failed to destroy lock %d %s\n", rc, strerror(rc));
@@ -134,6 +244,44 @@ restock(struct d_slab_type *type, int count)
 	return reset_calls;
 }
 
+/* Return the objects cached by all the magazines to the type.
+ *
+ * Returns the number of objects returned.
+ * This function should be called without the type lock held.
+ */
+static int
+drain(struct d_slab_type *type)
+{
+	struct d_slab_mag *mag;
+	int                count;
+
+	D_MUTEX_LOCK(&type->st_mag_lock);
+	count = mag_empty(type, &type->st_mag_shared);
+	d_list_for_each_entry(mag, &type->st_mag_list, sm_link)
+		count += mag_empty(type, mag);
+	D_MUTEX_UNLOCK(&type->st_mag_lock);
+
+	return count;
+}
+
+/* Hand the objects released to a magazine over to the type in one batch.
+ *
+ * This function should be called with the magazine lock held.
+ */
+static void
+mag_flush(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	if (mag->sm_pending_count == 0)
+		return;
+
+	D_MUTEX_LOCK(&type->st_lock);
+	d_list_splice_init(&mag->sm_pending_list, type->st_pending_list.prev);
+	type->st_pending_count += mag->sm_pending_count;
+	D_MUTEX_UNLOCK(&type->st_lock);
+
+	mag->sm_pending_count = 0;
+}
+
 /* Reclaim any memory possible across all types
  *
  * Returns true of there are any descriptors in use.
@@ -151,6 +299,8 @@ d_slab_reclaim(struct d_slab *slab)
 
 		D_TRACE_DEBUG(DB_ANY, type, "Resetting type");
 
+		drain(type);
+
 		D_MUTEX_LOCK(&type->st_lock);
 
 		/* Reclaim any pending objects.  Count here just needs to be
@@ -247,19 +397,34 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d
 {
 	struct d_slab_type *type;
 	int                 rc;
+	int                 i;
 
 	if (!reg->sr_name)
 		return -DER_INVAL;
 
-	D_ALLOC_PTR(type);
+	/* Keep the magazines on their own cache lines */
+	D_ALIGNED_ALLOC(type, __alignof__(*type), sizeof(*type));
 	if (!type)
 		return -DER_NOMEM;
 
 	rc = D_MUTEX_INIT(&type->st_lock, NULL);
-	if (rc != -DER_SUCCESS) {
-		D_FREE(type);
-		return rc;
+	if (rc != -DER_SUCCESS)
+		goto free_type;
+
+	rc = D_MUTEX_INIT(&type->st_mag_lock, NULL);
+	if (rc != -DER_SUCCESS)
+		goto destroy_lock;
+
+	rc = mag_init(type, &type->st_mag_shared);
+	if (rc != -DER_SUCCESS)
+		goto destroy_mag_lock;
+
+	rc = pthread_key_create(&type->st_mag_key, mag_exit);
+	if (rc != 0) {
+		rc = d_errno2der(rc);
+		goto destroy_shared;
 	}
+	D_INIT_LIST_HEAD(&type->st_mag_list);
 
 	D_TRACE_UP(DB_ANY, type, slab, reg->sr_name);
 
@@ -285,58 +450,204 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d
 		 * injected fault would be ignored - failing the specific
 		 * test.
 		 */
-		D_MUTEX_DESTROY(&type->st_lock);
-		D_FREE(type);
-		return -DER_INVAL;
+		D_GOTO(delete_key, rc = -DER_INVAL);
 	}
 
 	D_MUTEX_LOCK(&slab->slab_lock);
 	d_list_add_tail(&type->st_type_list, &slab->slab_list);
+	i = slab->slab_type_count++;
 	D_MUTEX_UNLOCK(&slab->slab_lock);
 
+	/* Telemetry is optional, the counters are no-ops if it is not initialized */
+	rc = d_tm_add_metric(&type->st_tm_hits, D_TM_COUNTER,
+			     "Number of objects acquired from the per-thread magazines", "ops",
+			     "slab/%s/%d/mag_hits", reg->sr_name, i);
+	if (rc == 0)
+		rc = d_tm_add_metric(&type->st_tm_misses, D_TM_COUNTER,
+				     "Number of magazine refills from the shared free list", "ops",
+				     "slab/%s/%d/mag_misses", reg->sr_name, i);
+	if (rc != 0)
+		D_TRACE_DEBUG(DB_ANY, type, "No telemetry for type: " DF_RC, DP_RC(rc));
+
 	*_type = type;
 	return -DER_SUCCESS;
+
+delete_key:
+	pthread_key_delete(type->st_mag_key);
+destroy_shared:
+	D_MUTEX_DESTROY(&type->st_mag_shared.sm_lock);
+destroy_mag_lock:
+	D_MUTEX_DESTROY(&type->st_mag_lock);
+destroy_lock:
+	D_MUTEX_DESTROY(&type->st_lock);
+free_type:
+	D_FREE(type);
+	return rc;
 }
 
-/* Acquire a new object.
+/* Move a batch of free objects from the type to a magazine.
  *
- * This is to be considered on the critical path so should be as lightweight
- * as posslble.
+ * This function should be called with both the magazine and type locks held.
  */
-void *
-d_slab_acquire(struct d_slab_type *type)
+static void
+mag_fill(struct d_slab_type *type, struct d_slab_mag *mag)
 {
-	void     *ptr = NULL;
 	d_list_t *entry;
-	bool      at_limit = false;
+
+	while (mag->sm_free_count < D_SLAB_MAG_SIZE / 2 && !d_list_empty(&type->st_free_list)) {
+		entry = type->st_free_list.next;
+		d_list_move_tail(entry, &mag->sm_free_list);
+		type->st_free_count--;
+		type->st_no_restock++;
+		mag->sm_free_count++;
+	}
+}
+
+/* Refill an empty magazine from the type on the critical path.
+ *
+ * Resets pending objects if needed, or creates one object if there is none
+ * to reuse.
+ * This function should be called with the magazine lock held.
+ *
+ * Returns true if no object was available because of the descriptor limit.
+ */
+static bool
+mag_refill(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	void *ptr;
+	bool  at_limit = false;
 
 	D_MUTEX_LOCK(&type->st_lock);
 
-	type->st_no_restock++;
+	type->st_mag_hits += mag->sm_hits;
+	type->st_mag_misses++;
+	d_tm_inc_counter(type->st_tm_hits, mag->sm_hits);
+	d_tm_inc_counter(type->st_tm_misses, 1);
+	mag->sm_hits = 0;
 
-	if (type->st_free_count == 0) {
-		int count = restock(type, 1);
+	if (type->st_free_count < D_SLAB_MAG_SIZE / 2) {
+		int count = restock(type, D_SLAB_MAG_SIZE / 2);
 
 		type->st_op_reset += count;
 	}
 
-	if (!d_list_empty(&type->st_free_list)) {
-		entry = type->st_free_list.next;
-		d_list_del(entry);
-		entry->next = NULL;
-		entry->prev = NULL;
-		type->st_free_count--;
-		ptr = (void *)entry - type->st_reg.sr_offset;
-	} else {
+	mag_fill(type, mag);
+
+	if (mag->sm_free_count == 0) {
 		if (!type->st_reg.sr_max_desc || type->st_count < type->st_reg.sr_max_desc) {
 			type->st_op_init++;
+			type->st_no_restock++;
 			ptr = create(type);
+			if (ptr) {
+				d_list_add(ptr + type->st_reg.sr_offset, &mag->sm_free_list);
+				mag->sm_free_count++;
+			}
 		} else {
 			at_limit = true;
 		}
 	}
 
 	D_MUTEX_UNLOCK(&type->st_lock);
+	return at_limit;
+}
+
+/* Reset the objects released to a magazine so they are reused from it,
+ * without going through the type.  Objects failing reset are freed.
+ *
+ * This function should be called with the magazine lock held.
+ */
+static void
+mag_restock(struct d_slab_type *type, struct d_slab_mag *mag)
+{
+	d_list_t *entry, *enext;
+	d_list_t  failed;
+	int       reset_calls = 0;
+	int       failed_count = 0;
+
+	if (!type->st_reg.sr_reset) {
+		d_list_splice_init(&mag->sm_pending_list, mag->sm_free_list.prev);
+		mag->sm_free_count += mag->sm_pending_count;
+		mag->sm_pending_count = 0;
+		return;
+	}
+
+	D_INIT_LIST_HEAD(&failed);
+	d_list_for_each_safe(entry, enext, &mag->sm_pending_list) {
+		void *ptr = (void *)entry - type->st_reg.sr_offset;
+
+		if (mag->sm_free_count >= D_SLAB_MAG_SIZE)
+			break;
+
+		d_list_del(entry);
+		mag->sm_pending_count--;
+		reset_calls++;
+		if (type->st_reg.sr_reset(ptr)) {
+			d_list_add(entry, &mag->sm_free_list);
+			mag->sm_free_count++;
+		} else {
+			D_TRACE_INFO(ptr, "entry %p failed reset\n", ptr);
+			d_list_add(entry, &failed);
+			failed_count++;
+		}
+	}
+
+	if (reset_calls == 0)
+		return;
+
+	D_MUTEX_LOCK(&type->st_lock);
+	type->st_reset_count += reset_calls;
+	type->st_count -= failed_count;
+	D_MUTEX_UNLOCK(&type->st_lock);
+
+	d_list_for_each_safe(entry, enext, &failed) {
+		void *ptr = (void *)entry - type->st_reg.sr_offset;
+
+		d_list_del(entry);
+		D_FREE(ptr);
+	}
+}
+
+/* Acquire a new object.
+ *
+ * This is to be considered on the critical path so should be as lightweight
+ * as posslble.  Most calls are served by the magazine of the thread without
+ * taking the type lock.
+ */
+void *
+d_slab_acquire(struct d_slab_type *type)
+{
+	struct d_slab_mag *mag = slab_mag(type);
+	void              *ptr = NULL;
+	d_list_t          *entry;
+	bool               at_limit;
+	bool               drained = false;
+
+retry:
+	at_limit = false;
+	D_MUTEX_LOCK(&mag->sm_lock);
+
+	if (mag->sm_free_count == 0)
+		at_limit = mag_refill(type, mag);
+	else
+		mag->sm_hits++;
+
+	if (!d_list_empty(&mag->sm_free_list)) {
+		entry = mag->sm_free_list.next;
+		d_list_del(entry);
+		entry->next = NULL;
+		entry->prev = NULL;
+		mag->sm_free_count--;
+		ptr = (void *)entry - type->st_reg.sr_offset;
+	}
+
+	D_MUTEX_UNLOCK(&mag->sm_lock);
+
+	/* Objects at the limit may be cached by the magazines of other threads */
+	if (at_limit && !drained) {
+		drained = true;
+		if (drain(type) > 0)
+			goto retry;
+	}
 
 	if (ptr)
 		D_TRACE_DEBUG(DB_ANY, type, "Using %p", ptr);
@@ -350,18 +661,21 @@ d_slab_acquire(struct d_slab_type *type)
 /* Release an object ready for reuse
  *
  * This is sometimes on the critical path, sometimes not so assume that
- * for all cases it is.
+ * for all cases it is.  Objects are handed over to the type in batches.
  *
  */
 void
 d_slab_release(struct d_slab_type *type, void *ptr)
 {
-	d_list_t *entry = ptr + type->st_reg.sr_offset;
-
-	D_MUTEX_LOCK(&type->st_lock);
-	type->st_pending_count++;
-	d_list_add_tail(entry, &type->st_pending_list);
-	D_MUTEX_UNLOCK(&type->st_lock);
+	struct d_slab_mag *mag   = slab_mag(type);
+	d_list_t          *entry = ptr + type->st_reg.sr_offset;
+
+	D_MUTEX_LOCK(&mag->sm_lock);
+	mag->sm_pending_count++;
+	d_list_add_tail(entry, &mag->sm_pending_list);
+	if (mag->sm_pending_count >= D_SLAB_MAG_SIZE)
+		mag_flush(type, mag);
+	D_MUTEX_UNLOCK(&mag->sm_lock);
 }
 
 /* Re-stock an object type.
@@ -373,14 +687,28 @@ d_slab_release(struct d_slab_type *type, void *ptr)
  * Ideally this function should be called once for every acquire(), after the
  * object has been used however correctness is maintained even if that is not
  * the case.
+ *
+ * Objects released by the calling thread are recycled into its magazine, the
+ * type lock is only taken once the magazine runs low.
  */
 
 void
 d_slab_restock(struct d_slab_type *type)
 {
+	struct d_slab_mag *mag = slab_mag(type);
+
 	D_TRACE_DEBUG(DB_ANY, type, "Count (%d/%d/%d)", type->st_pending_count, type->st_free_count,
 		      type->st_count);
 
+	D_MUTEX_LOCK(&mag->sm_lock);
+
+	mag_restock(type, mag);
+	if (mag->sm_free_count >= D_SLAB_MAG_SIZE / 2 && mag->sm_pending_count == 0)
+		goto out;
+
+	/* Objects which did not fit in the magazine */
+	mag_flush(type, mag);
+
 	D_MUTEX_LOCK(&type->st_lock);
 
 	/* Update restock hwm metrics */
@@ -394,5 +722,9 @@ d_slab_restock(struct d_slab_type *type)
 	if (!type->st_reg.sr_max_desc)
 		create_many(type);
 
+	mag_fill(type, mag);
+
 	D_MUTEX_UNLOCK(&type->st_lock);
+out:
+	D_MUTEX_UNLOCK(&mag->sm_lock);
 }
@@ -15,6 +15,7 @@
 #include <malloc.h>
 #include <gurt/common.h>
 #include <gurt/list.h>
+#include <gurt/atomic.h>
 #include <sys/shm.h>
 #include <gurt/telemetry_common.h>
 #include <gurt/telemetry_producer.h>
@@ -62,6 +63,46 @@ struct d_tm_context {
 	d_list_t		 open_shmem;
 };
 
+/**
+ * Shard of a quantile sketch.  The shards live in shared memory right after
+ * each other and are updated lock-free, the number of samples is the sum of
+ * the buckets, so that a reader always gets a consistent count.
+ */
+struct d_tm_sketch_shard {
+	ATOMIC uint64_t		dss_sum;
+	ATOMIC uint64_t		dss_min;
+	ATOMIC uint64_t		dss_max;
+	ATOMIC uint64_t		dss_reserved;	/** same size as d_tm_sketch_t */
+	ATOMIC uint64_t		dss_buckets[D_TM_SKETCH_BUCKETS];
+};
+
+D_CASSERT(sizeof(struct d_tm_sketch_shard) == sizeof(struct d_tm_sketch_t));
+
+/** shard of the quantile sketches updated by this thread */
+static __thread int		sketch_shard_id = -1;
+static ATOMIC unsigned int	sketch_shard_next;
+
+/**
+ * Slot of a ring metric.  The sequence number of the slot is odd while the
+ * slot is written, and twice the record number once written, so that readers
+ * can detect a record overwritten while it was copied, like a seqlock.
+ */
+struct d_tm_ring_slot {
+	ATOMIC uint64_t		drs_seq;
+	ATOMIC uint64_t		drs_fields[D_TM_RING_FIELDS];
+};
+
+D_CASSERT(sizeof(struct d_tm_ring_slot) == sizeof(struct d_tm_ring_rec_t));
+
+/**
+ * Ring of records, the number of records ever appended is the head, and the
+ * record N is stored in the slot N % D_TM_RING_RECORDS.
+ */
+struct d_tm_ring {
+	ATOMIC uint64_t		dtr_head;
+	struct d_tm_ring_slot	dtr_slots[D_TM_RING_RECORDS];
+};
+
 /**
  * Internal tracking data for shared memory for this process.
  */
@@ -1138,6 +1179,122 @@ d_tm_print_gauge(uint64_t val, struct d_tm_stats_t *stats, char *name,
 		d_tm_print_stats(stream, stats, format);
 }
 
+/**
+ * Prints the p50, p90, p99 and p999 quantiles of a quantile sketch, and the
+ * statistics of its samples.  In CSV format the quantiles are stored in the
+ * value field, separated by semicolons.
+ *
+ * \param[in]	sketch		Pointer to the merged sketch
+ * \param[in]	name		Pointer to the name of the metric
+ * \param[in]	format		Output format.
+ *				Choose D_TM_STANDARD for standard output.
+ *				Choose D_TM_CSV for comma separated values.
+ * \param[in]	units		The units expressed as a string
+ * \param[in]	opt_fields	A bitmask.  Set to D_TM_INCLUDE_TYPE to display
+ *				metric type.
+ * \param[in]	stream		Output stream (stdout, stderr)
+ */
+void
+d_tm_print_quantile(struct d_tm_sketch_t *sketch, char *name, int format,
+		    char *units, int opt_fields, FILE *stream)
+{
+	static const struct {
+		const char	*name;
+		double		 quantile;
+	} quantiles[] = {
+		{ "p50", 0.5 }, { "p90", 0.9 }, { "p99", 0.99 }, { "p999", 0.999 },
+	};
+	double	mean = 0;
+	int	i;
+
+	if ((sketch == NULL) || (name == NULL) || (stream == NULL))
+		return;
+
+	if (sketch->dts_count > 0)
+		mean = (double)sketch->dts_sum / sketch->dts_count;
+
+	if (format == D_TM_CSV) {
+		fprintf(stream, "%s", name);
+		if (opt_fields & D_TM_INCLUDE_TYPE)
+			fprintf(stream, ",quantile");
+		for (i = 0; i < ARRAY_SIZE(quantiles); i++)
+			fprintf(stream, "%s%s:%lu", i == 0 ? "," : ";",
+				quantiles[i].name,
+				d_tm_sketch_quantile(sketch, quantiles[i].quantile));
+		if (sketch->dts_count > 0)
+			fprintf(stream, ",%lu,%lu,%lf,%lu,", sketch->dts_min,
+				sketch->dts_max, mean, sketch->dts_count);
+		return;
+	}
+
+	if (opt_fields & D_TM_INCLUDE_TYPE)
+		fprintf(stream, "type: quantile, ");
+	fprintf(stream, "%s:", name);
+	for (i = 0; i < ARRAY_SIZE(quantiles); i++) {
+		fprintf(stream, "%s %s: %lu", i == 0 ? "" : ",", quantiles[i].name,
+			d_tm_sketch_quantile(sketch, quantiles[i].quantile));
+		if (units != NULL)
+			fprintf(stream, " %s", units);
+	}
+
+	if (sketch->dts_count > 0)
+		fprintf(stream, " [min: %lu, max: %lu, avg: %.0lf, samples: %lu]",
+			sketch->dts_min, sketch->dts_max, mean, sketch->dts_count);
+}
+
+/**
+ * Prints the records of a ring metric, oldest first, with the values of each
+ * record.  In CSV format the records are stored in the value field, separated
+ * by semicolons, the values of a record being separated by spaces.
+ *
+ * \param[in]	recs		Pointer to the records read by d_tm_get_ring()
+ * \param[in]	nr		Number of records
+ * \param[in]	name		Pointer to the name of the metric
+ * \param[in]	format		Output format.
+ *				Choose D_TM_STANDARD for standard output.
+ *				Choose D_TM_CSV for comma separated values.
+ * \param[in]	units		The units expressed as a string
+ * \param[in]	opt_fields	A bitmask.  Set to D_TM_INCLUDE_TYPE to display
+ *				metric type.
+ * \param[in]	stream		Output stream (stdout, stderr)
+ */
+void
+d_tm_print_ring(struct d_tm_ring_rec_t *recs, int nr, char *name, int format,
+		char *units, int opt_fields, FILE *stream)
+{
+	int	i;
+	int	j;
+
+	if ((recs == NULL && nr > 0) || (name == NULL) || (stream == NULL))
+		return;
+
+	if (format == D_TM_CSV) {
+		fprintf(stream, "%s", name);
+		if (opt_fields & D_TM_INCLUDE_TYPE)
+			fprintf(stream, ",ring");
+		fprintf(stream, ",");
+		for (i = 0; i < nr; i++) {
+			fprintf(stream, "%s%lu:", i == 0 ? "" : ";", recs[i].dtr_seq);
+			for (j = 0; j < D_TM_RING_FIELDS; j++)
+				fprintf(stream, "%s%lu", j == 0 ? "" : " ",
+					recs[i].dtr_fields[j]);
+		}
+		return;
+	}
+
+	if (opt_fields & D_TM_INCLUDE_TYPE)
+		fprintf(stream, "type: ring, ");
+	fprintf(stream, "%s: records: %d", name, nr);
+	if (units != NULL && nr > 0)
+		fprintf(stream, " (%s)", units);
+	for (i = 0; i < nr; i++) {
+		fprintf(stream, ", [%lu:", recs[i].dtr_seq);
+		for (j = 0; j < D_TM_RING_FIELDS; j++)
+			fprintf(stream, " %lu", recs[i].dtr_fields[j]);
+		fprintf(stream, "]");
+	}
+}
+
 /**
  * Client function to print the metadata strings \a desc and \a units
  * to the \a stream provided
@@ -1205,6 +1362,9 @@ d_tm_print_node(struct d_tm_context *ctx, struct d_tm_node_t *node, int level,
 	char               *desc           = NULL;
 	char               *units          = NULL;
 	struct d_tm_meminfo_t	meminfo;
+	struct d_tm_sketch_t	*sketch;
+	struct d_tm_ring_rec_t	*recs;
+	int			 nr;
 	bool                stats_printed  = false;
 	bool                show_timestamp = false;
 	bool                show_meta      = false;
@@ -1320,6 +1480,41 @@ d_tm_print_node(struct d_tm_context *ctx, struct d_tm_node_t *node, int level,
 		if (stats.sample_size > 0)
 			stats_printed = true;
 		break;
+	case D_TM_QUANTILE:
+		D_ALLOC_PTR(sketch);
+		if (sketch == NULL) {
+			fprintf(stream, "Error on quantile read: %d\n",
+				-DER_NOMEM);
+			break;
+		}
+		rc = d_tm_get_quantile(ctx, sketch, node);
+		if (rc != DER_SUCCESS) {
+			fprintf(stream, "Error on quantile read: %d\n", rc);
+			D_FREE(sketch);
+			break;
+		}
+		d_tm_print_quantile(sketch, name, format, units, opt_fields,
+				    stream);
+		if (sketch->dts_count > 0)
+			stats_printed = true;
+		D_FREE(sketch);
+		break;
+	case D_TM_RING:
+		D_ALLOC_ARRAY(recs, D_TM_RING_RECORDS);
+		if (recs == NULL) {
+			fprintf(stream, "Error on ring read: %d\n", -DER_NOMEM);
+			break;
+		}
+		rc = d_tm_get_ring(ctx, recs, &nr, node);
+		if (rc != DER_SUCCESS) {
+			fprintf(stream, "Error on ring read: %d\n", rc);
+			D_FREE(recs);
+			break;
+		}
+		d_tm_print_ring(recs, nr, name, format, units, opt_fields,
+				stream);
+		D_FREE(recs);
+		break;
 	default:
 		fprintf(stream, "Item: %s has unknown type: 0x%x\n", name,
 			node->dtn_type);
@@ -1410,12 +1605,30 @@ d_tm_print_stats(FILE *stream, struct d_tm_stats_t *stats, int format)
 	fprintf(stream, ", samples: %lu]", stats->sample_size);
 }
 
+static void
+sketch_reset(struct d_tm_sketch_shard *shards)
+{
+	int	i;
+
+	memset(shards, 0, D_TM_SKETCH_SHARDS * sizeof(*shards));
+	for (i = 0; i < D_TM_SKETCH_SHARDS; i++)
+		atomic_store_relaxed(&shards[i].dss_min, UINT64_MAX);
+}
+
+static void
+ring_reset(struct d_tm_ring *ring)
+{
+	memset(ring, 0, sizeof(*ring));
+}
+
 static int
 _reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node)
 {
 	struct d_tm_metric_t	*metric_data = NULL;
 	struct d_tm_stats_t	*dtm_stats = NULL;
 	struct d_tm_histogram_t *dtm_histogram = NULL;
+	struct d_tm_sketch_shard *dtm_sketch = NULL;
+	struct d_tm_ring	*dtm_ring = NULL;
 	struct d_tm_shmem_hdr	*shmem = NULL;
 	int			 rc;
 
@@ -1432,10 +1645,16 @@ _reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node)
 
 	dtm_stats = conv_ptr(shmem, metric_data->dtm_stats);
 	dtm_histogram = conv_ptr(shmem, metric_data->dtm_histogram);
+	dtm_sketch = conv_ptr(shmem, metric_data->dtm_sketch);
+	dtm_ring = conv_ptr(shmem, metric_data->dtm_ring);
 	d_tm_node_lock(node);
 	memset(&metric_data->dtm_data, 0, sizeof(metric_data->dtm_data));
 	if (dtm_stats != NULL)
 		memset(dtm_stats, 0, sizeof(*dtm_stats));
+	if (dtm_sketch != NULL)
+		sketch_reset(dtm_sketch);
+	if (dtm_ring != NULL)
+		ring_reset(dtm_ring);
 
 	if (dtm_histogram != NULL) {
 		int i;
@@ -1483,6 +1702,8 @@ reset_node(struct d_tm_context *ctx, struct d_tm_node_t *node, int level,
 	case (D_TM_DURATION | D_TM_CLOCK_THREAD_CPUTIME):
 	case D_TM_GAUGE:
 	case D_TM_STATS_GAUGE:
+	case D_TM_QUANTILE:
+	case D_TM_RING:
 		_reset_node(ctx, node);
 		break;
 	default:
@@ -1682,6 +1903,114 @@ d_tm_compute_stats(struct d_tm_node_t *node, uint64_t value)
 		dtm_stats->dtm_min = value;
 }
 
+/**
+ * Find the quantile sketch bucket of \a value, see D_TM_SKETCH_SUB_BITS.
+ */
+static inline int
+sketch_bucket(uint64_t value)
+{
+	int	msb;
+
+	if (value < (1UL << D_TM_SKETCH_SUB_BITS))
+		return value;
+
+	msb = 63 - __builtin_clzl(value);
+	if (msb >= D_TM_SKETCH_MAX_BITS)
+		return D_TM_SKETCH_BUCKETS - 1;
+
+	return ((msb - D_TM_SKETCH_SUB_BITS + 1) << D_TM_SKETCH_SUB_BITS) +
+	       (value >> (msb - D_TM_SKETCH_SUB_BITS)) - (1UL << D_TM_SKETCH_SUB_BITS);
+}
+
+/**
+ * The value standing for the samples of the quantile sketch bucket \a idx,
+ * that is the middle of the range of the bucket.
+ */
+static uint64_t
+sketch_bucket_value(int idx)
+{
+	uint64_t	low;
+	int		shift;
+
+	if (idx < (1 << D_TM_SKETCH_SUB_BITS))
+		return idx;
+
+	shift = (idx >> D_TM_SKETCH_SUB_BITS) - 1;
+	low = ((uint64_t)(idx & ((1 << D_TM_SKETCH_SUB_BITS) - 1)) +
+	       (1UL << D_TM_SKETCH_SUB_BITS)) << shift;
+
+	return low + ((1UL << shift) >> 1);
+}
+
+/**
+ * Merge the quantile sketch \a src into \a dst.  Both sketches must have been
+ * initialized, either by d_tm_get_quantile() or to all zeros.
+ *
+ * \param[in,out]	dst	The sketch to merge into
+ * \param[in]		src	The sketch to merge
+ */
+void
+d_tm_merge_sketch(struct d_tm_sketch_t *dst, struct d_tm_sketch_t *src)
+{
+	int	i;
+
+	if (dst == NULL || src == NULL || src->dts_count == 0)
+		return;
+
+	if (dst->dts_count == 0 || src->dts_min < dst->dts_min)
+		dst->dts_min = src->dts_min;
+	if (src->dts_max > dst->dts_max)
+		dst->dts_max = src->dts_max;
+	dst->dts_count += src->dts_count;
+	dst->dts_sum += src->dts_sum;
+	for (i = 0; i < D_TM_SKETCH_BUCKETS; i++)
+		dst->dts_buckets[i] += src->dts_buckets[i];
+}
+
+/**
+ * Estimate the \a quantile of the samples of a quantile sketch.
+ *
+ * \param[in]	sketch		Pointer to the sketch
+ * \param[in]	quantile	The quantile in [0, 1], e.g. 0.99 for p99
+ *
+ * \return			The estimated value, 0 if the sketch is empty
+ */
+uint64_t
+d_tm_sketch_quantile(struct d_tm_sketch_t *sketch, double quantile)
+{
+	uint64_t	rank;
+	uint64_t	seen = 0;
+	uint64_t	value;
+	int		i;
+
+	if (sketch == NULL || sketch->dts_count == 0)
+		return 0;
+
+	if (quantile <= 0)
+		return sketch->dts_min;
+	if (quantile >= 1)
+		return sketch->dts_max;
+
+	rank = (uint64_t)ceil(quantile * sketch->dts_count);
+	if (rank == 0)
+		rank = 1;
+
+	for (i = 0; i < D_TM_SKETCH_BUCKETS; i++) {
+		seen += sketch->dts_buckets[i];
+		if (seen < rank)
+			continue;
+
+		value = sketch_bucket_value(i);
+		if (value < sketch->dts_min)
+			return sketch->dts_min;
+		if (value > sketch->dts_max)
+			return sketch->dts_max;
+		return value;
+	}
+
+	return sketch->dts_max;
+}
+
 /**
  * Computes the histogram for this metric by finding the bucket that corresponds
  * to the \a value given, and increments the counter for that bucket.
@@ -2006,6 +2335,90 @@ d_tm_dec_gauge(struct d_tm_node_t *metric, uint64_t value)
 	d_tm_node_unlock(metric);
 }
 
+/**
+ * Add the sample \a value to the quantile sketch.  This is lock-free, each
+ * thread updates one of the shards of the sketch with relaxed atomics, and the
+ * shards are merged when the metric is read.
+ *
+ * \param[in,out]	metric	Pointer to the metric
+ * \param[in]		value	The new sample value
+ */
+void
+d_tm_record_quantile(struct d_tm_node_t *metric, uint64_t value)
+{
+	struct d_tm_sketch_shard	*shard;
+	uint64_t			 old;
+
+	if (metric == NULL)
+		return;
+
+	if (metric->dtn_type != D_TM_QUANTILE) {
+		D_ERROR("Failed to record quantile sample [%s] on item "
+			"not a quantile.  Operation mismatch: " DF_RC "\n",
+			metric->dtn_name, DP_RC(-DER_OP_NOT_PERMITTED));
+		return;
+	}
+
+	if (unlikely(sketch_shard_id < 0))
+		sketch_shard_id = atomic_fetch_add_relaxed(&sketch_shard_next, 1) %
+				  D_TM_SKETCH_SHARDS;
+	shard = &metric->dtn_metric->dtm_sketch[sketch_shard_id];
+
+	old = atomic_load_relaxed(&shard->dss_min);
+	while (value < old && !atomic_compare_exchange(&shard->dss_min, old, value))
+		;
+	old = atomic_load_relaxed(&shard->dss_max);
+	while (value > old && !atomic_compare_exchange(&shard->dss_max, old, value))
+		;
+	atomic_fetch_add_relaxed(&shard->dss_sum, value);
+	atomic_fetch_add_relaxed(&shard->dss_buckets[sketch_bucket(value)], 1);
+}
+
+/**
+ * Append a record of \a nr values to the ring metric, the missing values are
+ * zeroed.  This is lock-free and can be called by several threads.  The
+ * record is dropped in the unlikely case its slot is still being written by
+ * a thread that is a full ring behind.
+ *
+ * \param[in,out]	metric	Pointer to the metric
+ * \param[in]		fields	The values of the record
+ * \param[in]		nr	Number of values, up to D_TM_RING_FIELDS
+ */
+void
+d_tm_append_ring(struct d_tm_node_t *metric, uint64_t *fields, int nr)
+{
+	struct d_tm_ring	*ring;
+	struct d_tm_ring_slot	*slot;
+	uint64_t		 seq;
+	uint64_t		 old;
+	int			 i;
+
+	if (metric == NULL)
+		return;
+
+	if (metric->dtn_type != D_TM_RING || nr > D_TM_RING_FIELDS) {
+		D_ERROR("Failed to append record [%s] on item not a ring, or "
+			"too many values.  Operation mismatch: " DF_RC "\n",
+			metric->dtn_name, DP_RC(-DER_OP_NOT_PERMITTED));
+		return;
+	}
+
+	ring = metric->dtn_metric->dtm_ring;
+	seq = atomic_fetch_add_relaxed(&ring->dtr_head, 1);
+	slot = &ring->dtr_slots[seq % D_TM_RING_RECORDS];
+
+	old = atomic_load_relaxed(&slot->drs_seq);
+	if ((old & 1) ||
+	    !atomic_compare_exchange_strong_explicit(&slot->drs_seq, &old, 2 * seq + 1,
+						     memory_order_relaxed, memory_order_relaxed))
+		return;
+	atomic_thread_fence(memory_order_release);
+
+	for (i = 0; i < D_TM_RING_FIELDS; i++)
+		atomic_store_relaxed(&slot->drs_fields[i], i < nr ? fields[i] : 0);
+	atomic_store_release(&slot->drs_seq, 2 * seq + 2);
+}
+
 /**
  * Convert a D_TM_CLOCK_* type into a clockid_t
  *
@@ -2165,6 +2578,27 @@ add_metric(struct d_tm_context *ctx, struct d_tm_node_t **node, int metric_type,
 		}
 	}
 
+	temp->dtn_metric->dtm_sketch = NULL;
+	if (metric_type == D_TM_QUANTILE) {
+		temp->dtn_metric->dtm_sketch =
+			shmalloc(shmem, D_TM_SKETCH_SHARDS *
+					sizeof(struct d_tm_sketch_shard));
+		if (temp->dtn_metric->dtm_sketch == NULL) {
+			rc = -DER_NO_SHMEM;
+			goto out;
+		}
+		sketch_reset(temp->dtn_metric->dtm_sketch);
+	}
+
+	temp->dtn_metric->dtm_ring = NULL;
+	if (metric_type == D_TM_RING) {
+		temp->dtn_metric->dtm_ring = shmalloc(shmem, sizeof(struct d_tm_ring));
+		if (temp->dtn_metric->dtm_ring == NULL) {
+			rc = -DER_NO_SHMEM;
+			goto out;
+		}
+	}
+
 	buff_len = 0;
 	if (desc != NULL)
 		buff_len = strnlen(desc, D_TM_MAX_DESC_LEN);
@@ -3249,6 +3683,155 @@ d_tm_get_gauge(struct d_tm_context *ctx, uint64_t *val,
 	return DER_SUCCESS;
 }
 
+/**
+ * Client function to read the quantile sketch of a quantile metric.  The
+ * shards of the sketch are merged into \a sketch, which can then be used with
+ * d_tm_sketch_quantile(), or merged with the sketch of other metrics.
+ *
+ * \param[in]	ctx	Client context
+ * \param[out]	sketch	The merged sketch is stored here
+ * \param[in]	node	Pointer to the stored metric node
+ *
+ * \return	DER_SUCCESS		Success
+ *		-DER_INVAL		Invalid input
+ *		-DER_METRIC_NOT_FOUND	Metric not found
+ *		-DER_OP_NOT_PERMITTED	Metric was not a quantile
+ */
+int
+d_tm_get_quantile(struct d_tm_context *ctx, struct d_tm_sketch_t *sketch,
+		  struct d_tm_node_t *node)
+{
+	struct d_tm_metric_t		*metric_data = NULL;
+	struct d_tm_sketch_shard	*shards = NULL;
+	struct d_tm_shmem_hdr		*shmem = NULL;
+	uint64_t			 count;
+	uint64_t			 min;
+	uint64_t			 max;
+	int				 i;
+	int				 j;
+	int				 rc;
+
+	if (ctx == NULL || sketch == NULL || node == NULL)
+		return -DER_INVAL;
+
+	rc = validate_node_ptr(ctx, node, &shmem);
+	if (rc != 0)
+		return rc;
+
+	if (node->dtn_type != D_TM_QUANTILE)
+		return -DER_OP_NOT_PERMITTED;
+
+	metric_data = conv_ptr(shmem, node->dtn_metric);
+	if (metric_data == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	shards = conv_ptr(shmem, metric_data->dtm_sketch);
+	if (shards == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	memset(sketch, 0, sizeof(*sketch));
+	for (i = 0; i < D_TM_SKETCH_SHARDS; i++) {
+		count = 0;
+		for (j = 0; j < D_TM_SKETCH_BUCKETS; j++) {
+			uint64_t nr = atomic_load_relaxed(&shards[i].dss_buckets[j]);
+
+			sketch->dts_buckets[j] += nr;
+			count += nr;
+		}
+		if (count == 0)
+			continue;
+
+		min = atomic_load_relaxed(&shards[i].dss_min);
+		max = atomic_load_relaxed(&shards[i].dss_max);
+		if (sketch->dts_count == 0 || min < sketch->dts_min)
+			sketch->dts_min = min;
+		if (max > sketch->dts_max)
+			sketch->dts_max = max;
+		sketch->dts_sum += atomic_load_relaxed(&shards[i].dss_sum);
+		sketch->dts_count += count;
+	}
+
+	return DER_SUCCESS;
+}
+
+static int
+ring_rec_cmp(const void *a, const void *b)
+{
+	const struct d_tm_ring_rec_t	*ra = a;
+	const struct d_tm_ring_rec_t	*rb = b;
+
+	if (ra->dtr_seq < rb->dtr_seq)
+		return -1;
+	return ra->dtr_seq > rb->dtr_seq;
+}
+
+/**
+ * Client function to read the records of a ring metric, oldest first.  The
+ * records being written while they are read are skipped.
+ *
+ * \param[in]	ctx	Client context
+ * \param[out]	recs	Array of D_TM_RING_RECORDS records filled with the
+ *			records read
+ * \param[out]	nr	The number of records read is stored here
+ * \param[in]	node	Pointer to the stored metric node
+ *
+ * \return	DER_SUCCESS		Success
+ *		-DER_INVAL		Invalid input
+ *		-DER_METRIC_NOT_FOUND	Metric not found
+ *		-DER_OP_NOT_PERMITTED	Metric was not a ring
+ */
+int
+d_tm_get_ring(struct d_tm_context *ctx, struct d_tm_ring_rec_t *recs, int *nr,
+	      struct d_tm_node_t *node)
+{
+	struct d_tm_metric_t	*metric_data = NULL;
+	struct d_tm_shmem_hdr	*shmem = NULL;
+	struct d_tm_ring	*ring = NULL;
+	struct d_tm_ring_slot	*slot;
+	uint64_t		 seq;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	if (ctx == NULL || recs == NULL || nr == NULL || node == NULL)
+		return -DER_INVAL;
+
+	rc = validate_node_ptr(ctx, node, &shmem);
+	if (rc != 0)
+		return rc;
+
+	if (node->dtn_type != D_TM_RING)
+		return -DER_OP_NOT_PERMITTED;
+
+	metric_data = conv_ptr(shmem, node->dtn_metric);
+	if (metric_data == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	ring = conv_ptr(shmem, metric_data->dtm_ring);
+	if (ring == NULL)
+		return -DER_METRIC_NOT_FOUND;
+
+	*nr = 0;
+	for (i = 0; i < D_TM_RING_RECORDS; i++) {
+		slot = &ring->dtr_slots[i];
+		seq = atomic_load_explicit(&slot->drs_seq, memory_order_acquire);
+		if (seq == 0 || (seq & 1))
+			continue;
+
+		for (j = 0; j < D_TM_RING_FIELDS; j++)
+			recs[*nr].dtr_fields[j] = atomic_load_relaxed(&slot->drs_fields[j]);
+		atomic_thread_fence(memory_order_acquire);
+		if (atomic_load_relaxed(&slot->drs_seq) != seq)
+			continue;
+
+		recs[*nr].dtr_seq = seq / 2;
+		(*nr)++;
+	}
+	qsort(recs, *nr, sizeof(*recs), ring_rec_cmp);
+
+	return DER_SUCCESS;
+}
+
 /**
  * Client function to read the metadata for the specified metric.
  * Memory is allocated for the \a desc and \a units and should be freed by the
@@ -20,6 +20,7 @@
 #include <gurt/heap.h>
 #include <gurt/dlog.h>
 #include <gurt/hash.h>
+#include <gurt/slab.h>
 #include <gurt/atomic.h>
 #include "mocks_gurt.h"
 
@@ -1036,6 +1037,168 @@ test_gurt_hash_insert_lookup_delete(void **state)
 	test_gurt_hash_free_items(entries, TEST_GURT_HASH_NUM_ENTRIES);
 }
 
+/* Check that D_HASH_FT_RCU hash table grows while inserting
+ */
+static void
+test_gurt_hash_rcu_grow(void **state)
+{
+	/* Start from the minimum size so that it has to grow several times */
+	const int		  num_bits = 1;
+	struct d_hash_table	 *thtab;
+	int			  rc;
+	struct test_hash_entry	**entries;
+	d_list_t		 *test;
+	int			  i;
+	int			  expected_count;
+	bool			  deleted;
+
+	/* RCU can't be used with LRU or without rec_hash / tryaddref */
+	rc = d_hash_table_create(D_HASH_FT_RCU | D_HASH_FT_LRU, num_bits, NULL,
+				 &th_ops, &thtab);
+	assert_int_equal(rc, -DER_INVAL);
+	rc = d_hash_table_create(D_HASH_FT_RCU, num_bits, NULL, &th_ops_ref,
+				 &thtab);
+	assert_int_equal(rc, -DER_INVAL);
+
+	/* Allocate test entries to use */
+	entries = test_gurt_hash_alloc_items(TEST_GURT_HASH_NUM_ENTRIES);
+	assert_non_null(entries);
+
+	rc = d_hash_table_create(D_HASH_FT_RCU, num_bits, NULL, &th_ops,
+				 &thtab);
+	assert_int_equal(rc, 0);
+
+	/* Every inserted entry can be found while the buckets grow */
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		rc = d_hash_rec_insert(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &entries[i]->tl_link, 1);
+		assert_int_equal(rc, 0);
+
+		test = d_hash_rec_find(thtab, entries[i / 2]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN);
+		assert_int_equal(test, &entries[i / 2]->tl_link);
+	}
+
+	/* Traverse the hash table and count number of entries */
+	expected_count = TEST_GURT_HASH_NUM_ENTRIES;
+	rc = d_hash_table_traverse(thtab, test_gurt_hash_traverse_count_cb,
+				   &expected_count);
+	assert_int_equal(rc, 0);
+	assert_int_equal(expected_count, 0);
+
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		test = d_hash_rec_find(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN);
+		assert_int_equal(test, &entries[i]->tl_link);
+
+		rc = d_hash_rec_insert(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &entries[i]->tl_link, 1);
+		assert_int_equal(rc, -DER_EXIST);
+	}
+
+	/* Remove all entries from the hash table */
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		deleted = d_hash_rec_delete(thtab, entries[i]->tl_key,
+					    TEST_GURT_HASH_KEY_LEN);
+		assert_true(deleted);
+		assert_true(d_hash_rec_unlinked(&entries[i]->tl_link));
+	}
+
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		test = d_hash_rec_find(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN);
+		assert_null(test);
+	}
+
+	/* Destroy the hash table, force = false (should fail if not empty) */
+	rc = d_hash_table_destroy(thtab, 0);
+	assert_int_equal(rc, 0);
+
+	/* Free the temporary keys */
+	test_gurt_hash_free_items(entries, TEST_GURT_HASH_NUM_ENTRIES);
+}
+
+static int test_gurt_hash_rcu_freed;
+
+/* The records only have the reference of the hash table */
+static bool
+test_gurt_hash_op_rec_decref_last(struct d_hash_table *thtab, d_list_t *link)
+{
+	return true;
+}
+
+static void
+test_gurt_hash_op_rec_free_count(struct d_hash_table *thtab, d_list_t *link)
+{
+	test_gurt_hash_rcu_freed++;
+}
+
+static d_hash_table_ops_t th_ops_rcu_free = {
+	.hop_key_cmp	= test_gurt_hash_op_key_cmp,
+	.hop_rec_hash	= test_gurt_hash_op_rec_hash,
+	.hop_rec_decref	= test_gurt_hash_op_rec_decref_last,
+	.hop_rec_free	= test_gurt_hash_op_rec_free_count,
+};
+
+/* Check that D_HASH_FT_RCU hash table frees the deleted records once no
+ * lookup can see them
+ */
+static void
+test_gurt_hash_rcu_free(void **state)
+{
+	const int		  num_bits = TEST_GURT_HASH_NUM_BITS;
+	struct d_hash_table	 *thtab;
+	int			  rc;
+	struct test_hash_entry	**entries;
+	int			  i;
+	bool			  deleted;
+
+	entries = test_gurt_hash_alloc_items(TEST_GURT_HASH_NUM_ENTRIES);
+	assert_non_null(entries);
+
+	rc = d_hash_table_create(D_HASH_FT_RCU, num_bits, NULL,
+				 &th_ops_rcu_free, &thtab);
+	assert_int_equal(rc, 0);
+
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		rc = d_hash_rec_insert(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &entries[i]->tl_link, 1);
+		assert_int_equal(rc, 0);
+	}
+
+	test_gurt_hash_rcu_freed = 0;
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		deleted = d_hash_rec_delete(thtab, entries[i]->tl_key,
+					    TEST_GURT_HASH_KEY_LEN);
+		assert_true(deleted);
+	}
+
+	/* No lookup is in progress, so each delete frees its record at once */
+	assert_int_equal(test_gurt_hash_rcu_freed, TEST_GURT_HASH_NUM_ENTRIES);
+
+	/* Everything deleted so far is freed after a grace period */
+	d_hash_table_synchronize(thtab);
+	assert_int_equal(test_gurt_hash_rcu_freed, TEST_GURT_HASH_NUM_ENTRIES);
+
+	/* The pending frees are done by the destroy */
+	for (i = 0; i < TEST_GURT_HASH_NUM_ENTRIES; i++) {
+		rc = d_hash_rec_insert(thtab, entries[i]->tl_key,
+				       TEST_GURT_HASH_KEY_LEN,
+				       &entries[i]->tl_link, 1);
+		assert_int_equal(rc, 0);
+	}
+
+	rc = d_hash_table_destroy(thtab, true);
+	assert_int_equal(rc, 0);
+	assert_int_equal(test_gurt_hash_rcu_freed,
+			 TEST_GURT_HASH_NUM_ENTRIES * 2);
+
+	test_gurt_hash_free_items(entries, TEST_GURT_HASH_NUM_ENTRIES);
+}
+
 /* Check that addref/decref work with D_HASH_FT_EPHEMERAL
  */
 static void
@@ -1748,6 +1911,9 @@ test_gurt_hash_parallel_same_operations(void **state)
 	test_gurt_hash_threaded_same_operations(D_HASH_FT_RWLOCK
 						| D_HASH_FT_EPHEMERAL);
 	test_gurt_hash_threaded_same_operations(D_HASH_FT_LRU);
+	test_gurt_hash_threaded_same_operations(D_HASH_FT_RCU);
+	test_gurt_hash_threaded_same_operations(D_HASH_FT_RCU
+						| D_HASH_FT_EPHEMERAL);
 }
 
 static void
@@ -1759,6 +1925,9 @@ test_gurt_hash_parallel_different_operations(void **state)
 	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_RWLOCK
 						      | D_HASH_FT_EPHEMERAL);
 	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_LRU);
+	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_RCU);
+	test_gurt_hash_threaded_concurrent_operations(D_HASH_FT_RCU
+						      | D_HASH_FT_RWLOCK);
 }
 
 static void
@@ -1998,6 +2167,129 @@ test_hash_perf(void **state)
 		hash_perf(HASH_JCH, 1 << i, el << i);
 }
 
+#define TEST_SLAB_BURST 8
+
+struct test_slab_desc {
+	d_list_t	tsd_link;
+	int		tsd_in_use;
+};
+
+struct test_slab_arg {
+	struct d_slab_type	*tsa_type;
+	pthread_barrier_t	*tsa_barrier;
+	unsigned int		 tsa_loop;
+};
+
+static ATOMIC int test_slab_resets;
+
+static bool
+test_slab_reset(void *desc)
+{
+	struct test_slab_desc *tsd = desc;
+
+	atomic_fetch_add_relaxed(&test_slab_resets, 1);
+	tsd->tsd_in_use = 0;
+	return true;
+}
+
+static void *
+test_slab_thread(void *input)
+{
+	struct test_slab_arg	*arg = input;
+	struct test_slab_desc	*descs[TEST_SLAB_BURST];
+	unsigned int		 i;
+	int			 j;
+
+	pthread_barrier_wait(arg->tsa_barrier);
+	for (i = 0; i < arg->tsa_loop; i++) {
+		for (j = 0; j < TEST_SLAB_BURST; j++) {
+			descs[j] = d_slab_acquire(arg->tsa_type);
+			D_ASSERT(descs[j] != NULL);
+			/* Never handed out twice */
+			D_ASSERT(descs[j]->tsd_in_use == 0);
+			descs[j]->tsd_in_use = 1;
+		}
+		for (j = 0; j < TEST_SLAB_BURST; j++)
+			d_slab_release(arg->tsa_type, descs[j]);
+		d_slab_restock(arg->tsa_type);
+	}
+	return NULL;
+}
+
+static void
+slab_perf(struct d_slab *slab, int nthreads, unsigned int loop)
+{
+	struct d_slab_reg	 reg = {.sr_reset = test_slab_reset,
+					POOL_TYPE_INIT(test_slab_desc, tsd_link)};
+	struct d_slab_type	*type;
+	struct test_slab_arg	 arg;
+	pthread_barrier_t	 barrier;
+	pthread_t		*threads;
+	struct timespec		 then;
+	struct timespec		 now;
+	double			 duration;
+	bool			 in_use;
+	int			 count;
+	int			 rc;
+	int			 i;
+
+	rc = d_slab_register(slab, &reg, NULL, &type);
+	assert_int_equal(rc, 0);
+
+	D_ALLOC_ARRAY(threads, nthreads);
+	assert_non_null(threads);
+
+	pthread_barrier_init(&barrier, NULL, nthreads + 1);
+	arg.tsa_type	= type;
+	arg.tsa_barrier	= &barrier;
+	arg.tsa_loop	= loop;
+	for (i = 0; i < nthreads; i++) {
+		rc = pthread_create(&threads[i], NULL, test_slab_thread, &arg);
+		assert_int_equal(rc, 0);
+	}
+
+	pthread_barrier_wait(&barrier);
+	d_gettime(&then);
+	for (i = 0; i < nthreads; i++)
+		pthread_join(threads[i], NULL);
+	d_gettime(&now);
+	pthread_barrier_destroy(&barrier);
+
+	duration = (double)d_timediff_ns(&then, &now) / NSEC_PER_SEC;
+	count = type->st_count;
+
+	/* Every object is created then reset before being reused */
+	assert_true(atomic_load(&test_slab_resets) >= count);
+
+	/* All the objects cached by the magazines are reclaimed */
+	in_use = d_slab_reclaim(slab);
+	assert_false(in_use);
+
+	fprintf(stdout, "Slab: threads: %d, objects: %d, magazine hits/misses: "
+		DF_U64 "/" DF_U64 ", rate: %F\n", nthreads, count,
+		type->st_mag_hits, type->st_mag_misses,
+		(double)nthreads * loop * TEST_SLAB_BURST / duration);
+	D_FREE(threads);
+}
+
+static void
+test_slab_perf(void **state)
+{
+	struct d_slab	slab;
+	unsigned int	loop = D_ON_VALGRIND ? 100 : 100000;
+	int		rc;
+	int		i;
+
+	rc = d_slab_init(&slab, NULL);
+	assert_int_equal(rc, 0);
+
+	/* Same total number of objects for each run */
+	for (i = 1; i <= TEST_GURT_HASH_NUM_THREADS; i *= 2)
+		slab_perf(&slab, i, loop / i);
+
+	d_slab_destroy(&slab);
+}
+
 static void
 verify_rank_list_dup_uniq(int *src_ranks, int num_src_ranks,
 			  int *exp_ranks, int num_exp_ranks)
@@ -2525,6 +2817,8 @@ main(int argc, char **argv)
 	    cmocka_unit_test(test_log),
 	    cmocka_unit_test(test_gurt_hash_empty),
 	    cmocka_unit_test(test_gurt_hash_insert_lookup_delete),
+	    cmocka_unit_test(test_gurt_hash_rcu_grow),
+	    cmocka_unit_test(test_gurt_hash_rcu_free),
 	    cmocka_unit_test(test_gurt_hash_decref),
 	    cmocka_unit_test(test_gurt_alloc),
 	    cmocka_unit_test(test_gurt_hash_parallel_same_operations),
@@ -2534,6 +2828,7 @@ main(int argc, char **argv)
 	    cmocka_unit_test(test_gurt_string_buffer),
 	    cmocka_unit_test(test_d_rank_list_dup_sort_uniq),
 	    cmocka_unit_test(test_hash_perf),
+	    cmocka_unit_test(test_slab_perf),
 	    cmocka_unit_test_setup_teardown(test_d_getenv_str, setup_getenv_mocks,
 					    teardown_getenv_mocks),
 	    cmocka_unit_test_setup_teardown(test_d_agetenv_str, setup_getenv_mocks,
@@ -271,6 +271,164 @@ test_gauge_stats(void **state)
 	assert_int_equal(stats.std_dev, 0);
 }
 
+static void *
+record_quantile_thread(void *arg)
+{
+	struct d_tm_node_t	*quantile = arg;
+	uint64_t		 i;
+
+	for (i = 1001; i <= 2000; i++)
+		d_tm_record_quantile(quantile, i);
+
+	return NULL;
+}
+
+static void
+check_quantile(struct d_tm_sketch_t *sketch, double q, uint64_t exp)
+{
+	uint64_t	val;
+
+	/* the sketch has a relative error of about 1.6% */
+	val = d_tm_sketch_quantile(sketch, q);
+	assert_true(val >= exp - exp / 50 && val <= exp + exp / 50);
+}
+
+static void
+test_quantile(void **state)
+{
+	struct d_tm_node_t	*quantile;
+	struct d_tm_node_t	*gauge;
+	struct d_tm_sketch_t	*sketch;
+	struct d_tm_sketch_t	*merged;
+	pthread_t		 thread;
+	uint64_t		 i;
+	int			 rc;
+
+	D_ALLOC_PTR(sketch);
+	assert_non_null(sketch);
+	D_ALLOC_PTR(merged);
+	assert_non_null(merged);
+
+	rc = d_tm_add_metric(&quantile, D_TM_QUANTILE, NULL, D_TM_MICROSECOND,
+			     "gurt/tests/telem/quantile");
+	assert_rc_equal(rc, 0);
+
+	rc = d_tm_add_metric(&gauge, D_TM_GAUGE, NULL, NULL,
+			     "gurt/tests/telem/quantile-gauge");
+	assert_rc_equal(rc, 0);
+
+	/* an empty sketch */
+	rc = d_tm_get_quantile(cli_ctx, sketch, srv_to_cli_node(quantile));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(sketch->dts_count, 0);
+	assert_int_equal(d_tm_sketch_quantile(sketch, 0.99), 0);
+
+	/* samples from two threads land in different shards */
+	for (i = 1; i <= 1000; i++)
+		d_tm_record_quantile(quantile, i);
+	rc = pthread_create(&thread, NULL, record_quantile_thread, quantile);
+	assert_int_equal(rc, 0);
+	rc = pthread_join(thread, NULL);
+	assert_int_equal(rc, 0);
+
+	/* no quantile on a gauge */
+	d_tm_record_quantile(gauge, 5);
+	rc = d_tm_get_quantile(cli_ctx, sketch, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, -DER_OP_NOT_PERMITTED);
+
+	rc = d_tm_get_quantile(cli_ctx, sketch, srv_to_cli_node(quantile));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(sketch->dts_count, 2000);
+	assert_int_equal(sketch->dts_sum, 2001000);
+	assert_int_equal(sketch->dts_min, 1);
+	assert_int_equal(sketch->dts_max, 2000);
+	assert_int_equal(d_tm_sketch_quantile(sketch, 0), 1);
+	assert_int_equal(d_tm_sketch_quantile(sketch, 1), 2000);
+	assert_int_equal(d_tm_sketch_quantile(sketch, 0.001), 2);
+	check_quantile(sketch, 0.5, 1000);
+	check_quantile(sketch, 0.9, 1800);
+	check_quantile(sketch, 0.99, 1980);
+	check_quantile(sketch, 0.999, 1998);
+
+	/* merging a sketch twice keeps the quantiles */
+	d_tm_merge_sketch(merged, sketch);
+	d_tm_merge_sketch(merged, sketch);
+	assert_int_equal(merged->dts_count, 4000);
+	assert_int_equal(merged->dts_min, 1);
+	assert_int_equal(merged->dts_max, 2000);
+	check_quantile(merged, 0.5, 1000);
+	check_quantile(merged, 0.99, 1980);
+
+	D_FREE(merged);
+	D_FREE(sketch);
+}
+
+static void
+test_ring(void **state)
+{
+	struct d_tm_node_t	*ring;
+	struct d_tm_node_t	*gauge;
+	struct d_tm_ring_rec_t	*recs;
+	uint64_t		 fields[D_TM_RING_FIELDS + 1] = {0};
+	uint64_t		 i;
+	int			 nr;
+	int			 rc;
+
+	D_ALLOC_ARRAY(recs, D_TM_RING_RECORDS);
+	assert_non_null(recs);
+
+	rc = d_tm_add_metric(&ring, D_TM_RING, NULL, D_TM_MICROSECOND,
+			     "gurt/tests/telem/ring");
+	assert_rc_equal(rc, 0);
+
+	rc = d_tm_add_metric(&gauge, D_TM_GAUGE, NULL, NULL,
+			     "gurt/tests/telem/ring-gauge");
+	assert_rc_equal(rc, 0);
+
+	/* an empty ring */
+	rc = d_tm_get_ring(cli_ctx, recs, &nr, srv_to_cli_node(ring));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(nr, 0);
+
+	/* a short record is padded with zeros */
+	fields[0] = 7;
+	fields[1] = 8;
+	d_tm_append_ring(ring, fields, 2);
+	rc = d_tm_get_ring(cli_ctx, recs, &nr, srv_to_cli_node(ring));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(nr, 1);
+	assert_int_equal(recs[0].dtr_seq, 1);
+	assert_int_equal(recs[0].dtr_fields[0], 7);
+	assert_int_equal(recs[0].dtr_fields[1], 8);
+	assert_int_equal(recs[0].dtr_fields[D_TM_RING_FIELDS - 1], 0);
+
+	/* the oldest records are overwritten once the ring is full */
+	for (i = 2; i <= D_TM_RING_RECORDS + 10; i++) {
+		fields[0] = i;
+		fields[D_TM_RING_FIELDS - 1] = i * 2;
+		d_tm_append_ring(ring, fields, D_TM_RING_FIELDS);
+	}
+	rc = d_tm_get_ring(cli_ctx, recs, &nr, srv_to_cli_node(ring));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(nr, D_TM_RING_RECORDS);
+	for (i = 0; i < nr; i++) {
+		assert_int_equal(recs[i].dtr_seq, i + 11);
+		assert_int_equal(recs[i].dtr_fields[0], i + 11);
+		assert_int_equal(recs[i].dtr_fields[D_TM_RING_FIELDS - 1], (i + 11) * 2);
+	}
+
+	/* too many values, or not a ring */
+	d_tm_append_ring(ring, fields, D_TM_RING_FIELDS + 1);
+	d_tm_append_ring(gauge, fields, 1);
+	rc = d_tm_get_ring(cli_ctx, recs, &nr, srv_to_cli_node(gauge));
+	assert_rc_equal(rc, -DER_OP_NOT_PERMITTED);
+	rc = d_tm_get_ring(cli_ctx, recs, &nr, srv_to_cli_node(ring));
+	assert_rc_equal(rc, DER_SUCCESS);
+	assert_int_equal(recs[nr - 1].dtr_seq, D_TM_RING_RECORDS + 10);
+
+	D_FREE(recs);
+}
+
 static void
 test_duration_stats(void **state)
 {
@@ -1188,7 +1346,7 @@ test_verify_object_count(void **state)
 	struct d_tm_node_t	*node;
 	int			num;
 	int			exp_num_ctr = 20;
-	int			exp_num_gauge = 3;
+	int			exp_num_gauge = 5;
 	int			exp_num_gauge_stats = 3;
 	int			exp_num_dur = 2;
 	int			exp_num_timestamp = 2;
@@ -1236,7 +1394,8 @@ test_print_metrics(void **state)
 	assert_non_null(node);
 
 	filter = (D_TM_COUNTER | D_TM_TIMESTAMP | D_TM_TIMER_SNAPSHOT |
-		  D_TM_DURATION | D_TM_GAUGE | D_TM_DIRECTORY);
+		  D_TM_DURATION | D_TM_GAUGE | D_TM_QUANTILE | D_TM_RING |
+		  D_TM_DIRECTORY);
 
 	d_tm_iterate(cli_ctx, node, 0, filter, NULL, D_TM_STANDARD,
 		     D_TM_INCLUDE_METADATA, D_TM_ITER_READ, stdout);
@@ -1353,6 +1512,8 @@ main(int argc, char **argv)
 		cmocka_unit_test(test_interval_timer),
 		cmocka_unit_test(test_gauge_stats),
 		cmocka_unit_test(test_duration_stats),
+		cmocka_unit_test(test_quantile),
+		cmocka_unit_test(test_ring),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_1),
 		cmocka_unit_test(test_gauge_with_histogram_multiplier_2),
 		cmocka_unit_test(test_units),
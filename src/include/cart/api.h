@@ -335,6 +335,20 @@ crt_req_set_timeout(crt_rpc_t *req, uint32_t timeout_sec);
 int
 crt_req_get_timeout(crt_rpc_t *req, uint32_t *timeout_sec);
 
+/**
+ * Get the time a request was received by the server, and the time its input
+ * was decoded. Both are in ns on the monotonic clock of d_gettime(), and are 0
+ * if they were not recorded, like on the origin side or for batched requests.
+ *
+ * \param[in] req              pointer to RPC request
+ * \param[out] recv_ns         time the request was received
+ * \param[out] decoded_ns      time the input of the request was decoded
+ *
+ * \return                     DER_SUCCESS on success, negative value if error
+ */
+int
+crt_req_get_recv_time(crt_rpc_t *req, uint64_t *recv_ns, uint64_t *decoded_ns);
+
 /**
  * Add reference of the RPC request.
  *
@@ -1061,7 +1075,13 @@ enum crt_tree_type {
 	CRT_TREE_FLAT		= 1,
 	CRT_TREE_KARY		= 2,
 	CRT_TREE_KNOMIAL	= 3,
-	CRT_TREE_MAX		= 3,
+	/*
+	 * Topology aware tree, ranks of the same domain (see
+	 * crt_group_domains_set()) get one inbound message from the other
+	 * domains and fan it out locally, the domains form a KNOMIAL tree.
+	 */
+	CRT_TREE_DOMAIN		= 4,
+	CRT_TREE_MAX		= 4,
 };
 
 #define CRT_TREE_TYPE_SHIFT	(16U)
@@ -1073,7 +1093,7 @@ enum crt_tree_type {
  *
  * \param[in] tree_type        tree type
  * \param[in] branch_ratio     branch ratio, be ignored for CRT_TREE_FLAT.
- *                             for KNOMIAL tree or KARY tree, the valid value
+ *                             for KNOMIAL, KARY or DOMAIN tree, the valid value
  *                             should within the range of
  *                             [CRT_TREE_MIN_RATIO, CRT_TREE_MAX_RATIO], or
  *                             will be treated as invalid parameter.
@@ -1441,6 +1461,39 @@ int
 crt_proc_memcpy(crt_proc_t proc, crt_proc_op_t proc_op,
 		void *data, size_t data_size);
 
+/**
+ * Decode data in place: point at the data in the received request buffer
+ * rather than allocating memory and copying the data into it.
+ *
+ * It only succeeds when decoding the input of an RPC registered with
+ * \ref CRT_RPC_FEAT_INPLACE_DECODE, and if the data is aligned on \a align
+ * bytes in the request buffer. Otherwise nothing is decoded, and the caller
+ * should allocate the memory and decode with crt_proc_memcpy() as usual.
+ * The data decoded in place is valid until the RPC is destroyed, and should
+ * not be freed, see crt_proc_inplace_data().
+ *
+ * \param[in,out] proc         abstract processor object
+ * \param[out] data            returned pointer to data
+ * \param[in] data_size        data size
+ * \param[in] align            required alignment of data, power of 2
+ *
+ * \return                     true if decoded in place, false otherwise
+ */
+bool
+crt_proc_inplace_decode(crt_proc_t proc, void **data, size_t data_size, size_t align);
+
+/**
+ * Check if the data was decoded in place by crt_proc_inplace_decode(), the
+ * proc functions should not free such data with CRT_PROC_FREE.
+ *
+ * \param[in] proc             abstract processor object
+ * \param[in] data             pointer to data
+ *
+ * \return                     true if decoded in place, false otherwise
+ */
+bool
+crt_proc_inplace_data(crt_proc_t proc, const void *data);
+
 /**
  * Generic processing routine.
  *
@@ -1967,6 +2020,27 @@ crt_rank_state_get(crt_group_t *grp, d_rank_t rank,
 int
 crt_group_rank_remove(crt_group_t *group, d_rank_t rank);
 
+/**
+ * Set the topology domain (e.g. the node) of the ranks of a group for a group
+ * version, the ranks of the same domain are placed in the same subtree by
+ * CRT_TREE_DOMAIN. The collective RPCs of that group version use these domains,
+ * so they should be set on all the ranks before the group moves to \a version.
+ * The domains of the previous version are kept for the collective RPCs still
+ * in flight, a rank without domain at a version is a domain by itself.
+ *
+ * \param[in] group             Group identifier, NULL for the primary group
+ * \param[in] ranks             Ranks of the group
+ * \param[in] domains           Domain identifier of each rank of \a ranks
+ * \param[in] version           Group version the domains are for, not older
+ *                              than the current version of the group
+ *
+ * \return                      DER_SUCCESS on success, negative value on
+ *                              failure.
+ */
+int
+crt_group_domains_set(crt_group_t *group, d_rank_list_t *ranks, uint32_t *domains,
+		      uint32_t version);
+
 /**
  * Retrieve uri of self for the specified tag.  The uri must be freed by the
  * user using D_FREE().
@@ -45,6 +45,9 @@ struct swim_member_state {
 struct swim_member_update {
 	uint64_t		 smu_id;
 	struct swim_member_state smu_state;
+	uint64_t		 smu_origin;	  /**< member which originated
+						       the state, i.e. the one
+						       which suspected it first */
 };
 
 /** opaque SWIM context type */
@@ -289,6 +292,14 @@ int swim_progress(struct swim_context *ctx, int64_t timeout);
 int swim_net_glitch_update(struct swim_context *ctx, swim_id_t id,
 			   uint64_t delay);
 
+/**
+ * Set the count of SWIM members, used to scale the protocol for large groups.
+ *
+ * @param[in]  ctx	SWIM context pointer from swim_init()
+ * @param[in]  count	count of members
+ */
+void swim_member_count_set(struct swim_context *ctx, uint64_t count);
+
 /**
  * Delete a SWIM member.
  *
@@ -312,6 +312,14 @@ typedef enum {
  */
 #define CRT_RPC_FEAT_QUEUE_FRONT	(1U << 3)
 
+/**
+ * Allow the proc functions of the RPC input to decode data in place, i.e. to
+ * refer to the received request buffer instead of allocating and copying, see
+ * crt_proc_inplace_decode(). The decoded input is valid until the RPC is
+ * destroyed.
+ */
+#define CRT_RPC_FEAT_INPLACE_DECODE	(1U << 4)
+
 typedef void *crt_bulk_opid_t;
 
 /** Bulk transfer permissions */
@@ -18,6 +18,9 @@ int dc_array_create(tse_task_t *task);
 int dc_array_open(tse_task_t *task);
 int dc_array_close(tse_task_t *task);
 int dc_array_close_direct(daos_handle_t oh);
+int dc_array_flush(tse_task_t *task);
+int dc_array_set_write_back(daos_handle_t oh, daos_size_t size, uint32_t max_age_ms);
+int dc_array_set_read_ahead(daos_handle_t oh, daos_size_t size);
 int dc_array_destroy(tse_task_t *task);
 int dc_array_get_attr(daos_handle_t oh, daos_size_t *chunk_size, daos_size_t *cell_size);
 int dc_array_read(tse_task_t *task);
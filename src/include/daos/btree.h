@@ -217,7 +217,9 @@ typedef struct {
 	 * Comparison of hashed key.
 	 *
 	 * Absent:
-	 * Calls memcmp.
+	 * Calls memcmp. The node search is then done inline without going
+	 * through the callback, so it should be left out for fixed size
+	 * hashed keys that are ordered as byte strings.
 	 *
 	 * \param tins	[IN]	Tree instance which contains the root umem
 	 *			offset and memory class etc.
@@ -558,6 +560,21 @@ int  dbtree_query(daos_handle_t toh, struct btr_attr *attr,
 int  dbtree_is_empty(daos_handle_t toh);
 int  dbtree_feats_set(struct btr_root *root, struct umem_instance *umm, uint64_t feats);
 
+/**
+ * Prototype of dbtree_bulk_load() callback, it returns the next record of the
+ * input in \a key and \a val, they should stay valid until the next call.
+ *
+ *   - if rc == 0, a record is returned;
+ *   - if rc == 1, end of the input, dbtree_bulk_load() returns 0;
+ *   - other positive values are invalid, dbtree_bulk_load() stops and
+ *     returns -DER_INVAL;
+ *   - otherwise, dbtree_bulk_load() stops and returns rc.
+ */
+typedef int (*dbtree_load_cb_t)(d_iov_t *key, d_iov_t *val, void *arg);
+int  dbtree_bulk_load(daos_handle_t toh, dbtree_load_cb_t load_cb, void *arg);
+int  dbtree_delete_range(daos_handle_t toh, d_iov_t *key_lo, d_iov_t *key_hi,
+			 void *args);
+
 static inline uint64_t
 dbtree_feats_get(struct btr_root *root)
 {
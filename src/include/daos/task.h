@@ -77,6 +77,7 @@ struct daos_task_args {
 		daos_obj_query_key_t	obj_query_key;
 		struct daos_obj_sync_args obj_sync;
 		daos_obj_fetch_t	obj_fetch;
+		daos_obj_fetch_multi_t	obj_fetch_multi;
 		daos_obj_update_t	obj_update;
 		daos_obj_list_dkey_t	obj_list_dkey;
 		daos_obj_list_akey_t	obj_list_akey;
@@ -87,6 +88,7 @@ struct daos_task_args {
 		daos_array_create_t	array_create;
 		daos_array_open_t	array_open;
 		daos_array_close_t	array_close;
+		daos_array_flush_t	array_flush;
 		daos_array_destroy_t	array_destroy;
 		daos_array_io_t		array_io;
 		daos_array_get_size_t	array_get_size;
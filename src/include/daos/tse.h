@@ -86,6 +86,20 @@ int
 tse_sched_init(tse_sched_t *sched, tse_sched_comp_cb_t comp_cb,
 		void *udata);
 
+/**
+ * Switch task completion of the scheduler to a lock-free completion queue.
+ * tse_task_complete() on a running task then only pushes the task to the
+ * queue, and the thread calling tse_sched_progress() moves the queued tasks
+ * to the complete list and wakes up their dependents in one batch. This
+ * avoids contention on the scheduler lock when many threads complete tasks,
+ * but a completed task is only fully processed on the next progress call.
+ *
+ * \param[in] sched		the scheduler, usually right after tse_sched_init().
+ * \param[in] enable		true to use the completion queue.
+ */
+void
+tse_sched_set_comp_queue(tse_sched_t *sched, bool enable);
+
 /**
  * Finish the scheduler.
  *
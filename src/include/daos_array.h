@@ -240,7 +240,8 @@ daos_array_global2local(daos_handle_t coh, d_iov_t glob, unsigned int mode,
 			daos_handle_t *oh);
 
 /**
- * Close an opened array object.
+ * Close an opened array object. Data buffered by write-back coalescing is flushed first; if the
+ * flush fails, the error is returned and the handle remains open.
  *
  * \param[in]	oh	Array object open handle.
  * \param[in]	ev	Completion event, it is optional and can be NULL.
@@ -254,6 +255,68 @@ daos_array_global2local(daos_handle_t coh, d_iov_t glob, unsigned int mode,
 int
 daos_array_close(daos_handle_t oh, daos_event_t *ev);
 
+/**
+ * Enable (or disable) client-side write-back coalescing on an array open handle. Once enabled,
+ * small writes that fall in a single dkey chunk and are not part of a transaction are copied
+ * into a per-handle buffer and completed immediately. Adjacent extents are merged and overwrites
+ * of buffered extents are applied in place, so many small writes are persisted with a single
+ * update. The buffer is flushed when it is full, when its oldest data is older than
+ * \a max_age_ms (checked on the next write), on daos_array_flush(), on daos_array_close(), and
+ * before any other operation on the handle, so reads through the same handle always see the
+ * buffered data. Other handles, or other processes, do not see buffered data until it is flushed.
+ *
+ * An error encountered while flushing in the background is returned by the next operation on
+ * the handle.
+ *
+ * \param[in]	oh	Array object open handle.
+ * \param[in]	size	Max bytes to buffer per handle (capped to the dkey chunk size in
+ *			bytes). Pass 0 to disable write-back.
+ * \param[in]	max_age_ms
+ *			Max age of buffered data in milliseconds, 0 for no age limit.
+ *
+ * \return		These values will be returned:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_BUSY	Data is still buffered or being flushed on the handle
+ */
+int
+daos_array_set_write_back(daos_handle_t oh, daos_size_t size, uint32_t max_age_ms);
+
+/**
+ * Enable (or disable) read-ahead on a byte array open handle. The handle tracks the offsets and
+ * sizes of its reads; once sequential or strided reads of the same size are detected, the
+ * following extents are prefetched asynchronously into a cache of at most \a size bytes and
+ * later reads covered by the cache are served from it. Any modification through the handle
+ * drops the cache; modifications through other handles are not seen by cached extents until
+ * they are consumed or evicted.
+ *
+ * \param[in]	oh	Array object open handle.
+ * \param[in]	size	Max bytes cached per handle. Pass 0 to disable read-ahead.
+ *
+ * \return		These values will be returned:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ */
+int
+daos_array_set_read_ahead(daos_handle_t oh, daos_size_t size);
+
+/**
+ * Flush data buffered by write-back coalescing on an array open handle, see
+ * daos_array_set_write_back(). This is a no-op if write-back is not enabled.
+ *
+ * \param[in]	oh	Array object open handle.
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode:
+ *			0		Success
+ *			-DER_NO_HDL	Invalid object open handle
+ *			-DER_UNREACH	Network is unreachable
+ */
+int
+daos_array_flush(daos_handle_t oh, daos_event_t *ev);
+
 /**
  * Read data from an array object.
  *
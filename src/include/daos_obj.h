@@ -773,6 +773,57 @@ daos_obj_fetch(daos_handle_t oh, daos_handle_t th, uint64_t flags,
 	       daos_key_t *dkey, unsigned int nr, daos_iod_t *iods,
 	       d_sg_list_t *sgls, daos_iom_t *ioms, daos_event_t *ev);
 
+/** One fetch request of daos_obj_fetch_multi(). */
+typedef struct {
+	/** Object open handle */
+	daos_handle_t		 ofr_oh;
+	/** Distribution key associated with the fetch */
+	daos_key_t		*ofr_dkey;
+	/** Number of elements in \a ofr_iods and \a ofr_sgls */
+	uint32_t		 ofr_nr;
+	/** [out] Result of this request */
+	int32_t			 ofr_rc;
+	/** I/O descriptors, see daos_obj_fetch() */
+	daos_iod_t		*ofr_iods;
+	/** Scatter/gather lists to store records, see daos_obj_fetch() */
+	d_sg_list_t		*ofr_sgls;
+} daos_obj_fetch_req_t;
+
+/**
+ * Fetch records from a list of objects in one call. The requests that map to
+ * the same storage target are shipped to the engine in one RPC and served
+ * there together, which saves a lot of round-trips when the application reads
+ * many small objects. Each request has the same semantics as daos_obj_fetch()
+ * without I/O map, the requests that cannot be batched (EC objects, checksum
+ * enabled containers, transactional or conditional fetch, large buffers) are
+ * transparently issued as regular fetches.
+ *
+ * \param[in]	th	Optional transaction handle to fetch with.
+ *			Use DAOS_TX_NONE for an independent transaction.
+ *
+ * \param[in]	flags	Fetch flags (conditional ops), applied to all requests.
+ *
+ * \param[in]	nr	Number of requests in \a reqs.
+ *
+ * \param[in,out]
+ *		reqs	Array of fetch requests. The result of each one is
+ *			returned in \a reqs[]::ofr_rc.
+ *
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			Function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		These values will be returned by \a ev::ev_error in
+ *			non-blocking mode:
+ *			0		Success, all the requests succeeded
+ *			-DER_INVAL	Invalid parameter
+ *			-DER_NOMEM	Out of memory
+ *			Otherwise, the first error of the requests, see
+ *			daos_obj_fetch().
+ */
+int
+daos_obj_fetch_multi(daos_handle_t th, uint64_t flags, unsigned int nr,
+		     daos_obj_fetch_req_t *reqs, daos_event_t *ev);
+
 /**
  * Insert or update object records stored in co-located arrays.
  *
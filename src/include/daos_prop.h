@@ -139,6 +139,8 @@ enum daos_pool_props {
 	DAOS_PROP_PO_SVC_OPS_ENABLED,
 	/** Metadata duplicate operations SVC_OPS KVS max entry age (seconds), default 300 */
 	DAOS_PROP_PO_SVC_OPS_ENTRY_AGE,
+	/** IO scheduling policy on the engine targets, fifo|job_rr|job_prio, default is fifo */
+	DAOS_PROP_PO_SCHED_POLICY,
 	DAOS_PROP_PO_MAX,
 };
 
@@ -223,6 +225,19 @@ enum {
  */
 #define DAOS_PROP_PO_REINT_MODE_DEFAULT	DAOS_REINT_MODE_DATA_SYNC
 
+/** IO scheduling policy of the pool on engine targets */
+enum {
+	/** All IO requests are processed in FIFO */
+	DAOS_SCHED_POLICY_FIFO = 0,
+	/** IO requests are queued per client job and processed in deficit round-robin */
+	DAOS_SCHED_POLICY_JOB_RR,
+	/** Same as JOB_RR, but weighted by the job priorities configured on engine */
+	DAOS_SCHED_POLICY_JOB_PRIO,
+	DAOS_SCHED_POLICY_MAX,
+};
+
+#define DAOS_PROP_PO_SCHED_POLICY_DEFAULT	DAOS_SCHED_POLICY_FIFO
+
 /**
  * Pool checksum scrubbing schedule type
  * It is expected that these stay contiguous.
@@ -239,6 +239,8 @@ struct sched_req_attr {
 	uint32_t	sra_timeout;
 	/* Hint for RPC rejection */
 	uint64_t	sra_enqueue_id;
+	/* Job ID of the request for ID based policies, only used on enqueue */
+	char		*sra_jobid;
 };
 
 static inline void
@@ -247,6 +249,7 @@ sched_req_attr_init(struct sched_req_attr *attr, unsigned int type,
 {
 	attr->sra_type = type;
 	attr->sra_flags = 0;
+	attr->sra_jobid = NULL;
 	uuid_copy(attr->sra_pool_id, *pool_id);
 }
 
@@ -336,6 +339,16 @@ bool sched_req_is_aborted(struct sched_request *req);
  */
 int sched_req_space_check(struct sched_request *req);
 
+/**
+ * Set the IO scheduling policy (DAOS_SCHED_POLICY_*) of the pool on the caller xstream.
+ *
+ * \param[in] pool_id	Pool UUID.
+ * \param[in] policy	Scheduling policy.
+ *
+ * \retval		Zero on success, negative value on error.
+ */
+int sched_pool_policy_set(uuid_t pool_id, unsigned int policy);
+
 /**
  * Wrapper of ABT_cond_wait(), inform scheduler that it's going
  * to be blocked for a relative long time.
@@ -380,6 +393,30 @@ struct sched_request *
 sched_create_ult(struct sched_req_attr *attr, void (*func)(void *), void *arg,
 		 size_t stack_size);
 
+/** ULT classes for per-ULT CPU accounting (enabled by DAOS_SCHED_ULT_ACCT) */
+enum dss_ult_cls {
+	DSS_ULT_CLS_OTHER	= 0,
+	/* RPC handler, accounted per module and opcode */
+	DSS_ULT_CLS_RPC,
+	DSS_ULT_CLS_GC,
+	DSS_ULT_CLS_AGG,
+	DSS_ULT_CLS_DTX,
+	DSS_ULT_CLS_SCRUB,
+	DSS_ULT_CLS_REBUILD,
+	DSS_ULT_CLS_MAX,
+};
+
+/**
+ * Tag the ULT with a class for the per-ULT CPU accounting. ULTs attached to a
+ * GC, SCRUB or MIGRATE sched request are tagged accordingly by default, RPC
+ * handlers are tagged by module and opcode automatically.
+ *
+ * \param[in] ult	ULT to be tagged, self ULT when ult == ABT_THREAD_NULL.
+ * \param[in] cls	ULT class, see dss_ult_cls.
+ */
+void
+sched_ult_cls_set(ABT_thread ult, unsigned int cls);
+
 static inline bool
 dss_ult_exiting(struct sched_request *req)
 {
@@ -514,6 +551,8 @@ enum dss_ult_flags {
 	DSS_ULT_DEEP_STACK	= (1 << 1),
 	/* Use current ULT (instead of creating new one) for the task. */
 	DSS_USE_CURRENT_ULT	= (1 << 2),
+	/* Create in the shared work-stealing pool of helper XS, if it's enabled */
+	DSS_ULT_FL_STEAL	= (1 << 3),
 };
 
 int dss_ult_create(void (*func)(void *), void *arg, int xs_type, int tgt_id,
@@ -670,7 +709,10 @@ int dss_rpc_reply(crt_rpc_t *rpc, unsigned int fail_loc);
 enum {
 	/** Min Value */
 	DSS_OFFLOAD_MIN = -1,
-	/** Does computation on same ULT */
+	/**
+	 * Does computation in a ULT on the helper xstream of the caller's
+	 * target, or in place if there is no helper xstream.
+	 */
 	DSS_OFFLOAD_ULT = 1,
 	/** Offload to an accelerator */
 	DSS_OFFLOAD_ACC = 2,
@@ -695,7 +737,8 @@ struct dss_acc_task {
 	 */
 	void		*at_params;
 	/**
-	 * Callback required for offload task
+	 * Callback required for offload task, it is called with \a at_params
+	 * and its return value is returned by dss_acc_offload().
 	 * \param cb_args		[IN] arguments for offload
 	 */
 	int		(*at_cb)(void *cb_args);
@@ -727,6 +727,18 @@ typedef struct {
 
 /** fetch args struct */
 typedef daos_obj_rw_t		daos_obj_fetch_t;
+
+/** Multi-object fetch args */
+typedef struct {
+	/** Transaction open handle. */
+	daos_handle_t		th;
+	/** API flags. */
+	uint64_t		flags;
+	/** Number of elements in \a reqs. */
+	uint32_t		nr;
+	/** Fetch requests. */
+	daos_obj_fetch_req_t	*reqs;
+} daos_obj_fetch_multi_t;
 /** update args struct */
 typedef daos_obj_rw_t		daos_obj_update_t;
 
@@ -900,6 +912,12 @@ typedef struct {
 	daos_handle_t		oh;
 } daos_array_close_t;
 
+/** Array flush args */
+typedef struct {
+	/** Array open handle. */
+	daos_handle_t		oh;
+} daos_array_flush_t;
+
 /** Array read/write args */
 typedef struct {
 	/** Array open handle. */
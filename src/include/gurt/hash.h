@@ -147,6 +147,21 @@ typedef struct {
 	 * \param[in]	link	The record being freed.
 	 */
 	void	 (*hop_rec_free)(struct d_hash_table *htable, d_list_t *link);
+
+	/**
+	 * Optional, increase refcount on the record \p link unless it has
+	 * already dropped to zero.
+	 * Mandatory if hop_rec_addref() is provided and the hash table is
+	 * created with D_HASH_FT_RCU, it is called by the lockless lookup.
+	 *
+	 * \param[in]	htable	hash table
+	 * \param[in]	link	The record being referenced.
+	 *
+	 * \retval	true	A refcount has been taken
+	 * \retval	false	The record is being freed, skip it
+	 */
+	bool	 (*hop_rec_tryaddref)(struct d_hash_table *htable,
+				      d_list_t *link);
 } d_hash_table_ops_t;
 
 enum d_hash_feats {
@@ -205,6 +220,31 @@ enum d_hash_feats {
 	 */
 	D_HASH_FT_NO_KEYINIT_LOCK	= (1 << 5),
 
+	/**
+	 * Read-mostly hash table with lockless lookup.
+	 *
+	 * d_hash_rec_find() takes no lock, the other operations still take
+	 * the bucket locks. The buckets are doubled online when the table
+	 * grows, the records are migrated by a few buckets at a time on
+	 * insert, so \a bits of d_hash_table_create() is the initial size.
+	 * Records are freed after a grace period, i.e. once no lookup can
+	 * see them anymore. The delete does not wait for it: hop_rec_free()
+	 * is called at once if no lookup is in progress, otherwise it is
+	 * deferred and called in batches by the later deletes and inserts,
+	 * or by d_hash_table_synchronize(). Users which must not keep
+	 * records around on an idle table should call the latter
+	 * periodically.
+	 *
+	 * Requirements:
+	 * - hop_rec_hash() is mandatory.
+	 * - refcount changes must be atomic, and hop_rec_tryaddref() must
+	 *   be provided together with hop_rec_addref().
+	 * - It is incompatible with D_HASH_FT_NOLOCK and D_HASH_FT_LRU.
+	 * - A deleted record that is not freed by hop_rec_free() can only
+	 *   be freed or reinserted after d_hash_table_synchronize().
+	 */
+	D_HASH_FT_RCU			= (1 << 6),
+
 	/**
 	 * Use Global Table Lock instead of per bucket locking.
 	 * TODO: should be removed when all will use per bucket locking.
@@ -225,6 +265,8 @@ struct d_hash_bucket {
 #endif
 };
 
+struct d_hash_rcu;
+
 struct d_hash_table {
 	/** different type of locks based on ht_feats */
 	union d_hash_lock	 ht_lock;
@@ -248,6 +290,8 @@ struct d_hash_table {
 	struct d_hash_bucket	*ht_buckets;
 	/** different type of locks based on ht_feats */
 	union d_hash_lock	*ht_locks;
+	/** resizable buckets and grace period of D_HASH_FT_RCU */
+	struct d_hash_rcu	*ht_rcu;
 };
 
 /**
@@ -337,6 +381,16 @@ int  d_hash_table_destroy(struct d_hash_table *htable, bool force);
  */
 int  d_hash_table_destroy_inplace(struct d_hash_table *htable, bool force);
 
+/**
+ * Wait for the end of a grace period of a D_HASH_FT_RCU hash table, after
+ * that none of the records deleted before the call can still be seen by a
+ * lookup, and the deferred hop_rec_free() of these records has been called.
+ * It must not be called from a hop_* callback.
+ *
+ * \param[in] htable		Pointer to the hash table
+ */
+void d_hash_table_synchronize(struct d_hash_table *htable);
+
 /**
  * lookup \p key in the hash table, the found chain link is returned on
  * success.
@@ -9,6 +9,7 @@
 
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <gurt/list.h>
 
 /* A data structure used to describe and register a type */
@@ -40,6 +41,33 @@ struct d_slab_reg {
  * however once max_desc is reached no more descriptors will be created.
  */
 
+/* Maximum number of released objects a magazine holds before handing them over to the type */
+#define D_SLAB_MAG_SIZE  32
+
+struct d_tm_node_t;
+struct d_slab_type;
+
+/* A per-thread cache of objects in front of the type, so that acquire() and release() only take
+ * the lock of the type once per batch of D_SLAB_MAG_SIZE / 2 objects.  Objects are moved between
+ * the magazines and the type in batches, the type acts as the shared depot.
+ *
+ * Each thread gets its own magazine on first use of the type, and hands it back to the type when
+ * it exits.  The magazine lock is only taken by other threads to drain the magazine, on reclaim
+ * or when the descriptor limit is hit, so it is normally uncontended.
+ */
+struct d_slab_mag {
+	pthread_mutex_t     sm_lock;
+	/* On st_mag_list of the type */
+	d_list_t            sm_link;
+	struct d_slab_type *sm_type;
+	d_list_t            sm_free_list;
+	d_list_t            sm_pending_list;
+	int                 sm_free_count;
+	int                 sm_pending_count;
+	/* Number of acquire() calls served by the magazine since the last refill */
+	int                 sm_hits;
+} __attribute__((aligned(64)));
+
 #define POOL_TYPE_INIT(itype, imember)                                                             \
 	.sr_size = sizeof(struct itype), .sr_offset = offsetof(struct itype, imember),             \
 	.sr_name = #itype,
@@ -72,12 +100,27 @@ struct d_slab_type {
 	/* Number of sequental calls to acquire() without a call to restock() */
 	int               st_no_restock;     /* Current count */
 	int               st_no_restock_hwm; /* High water mark */
+
+	/* Magazine metrics, a miss is a refill from the type */
+	uint64_t            st_mag_hits;
+	uint64_t            st_mag_misses;
+	struct d_tm_node_t *st_tm_hits;
+	struct d_tm_node_t *st_tm_misses;
+
+	/* Magazine of the calling thread */
+	pthread_key_t       st_mag_key;
+	/* Protects st_mag_list */
+	pthread_mutex_t     st_mag_lock;
+	d_list_t            st_mag_list;
+	/* Shared by the threads which failed to allocate their own magazine */
+	struct d_slab_mag   st_mag_shared;
 };
 
 struct d_slab {
 	d_list_t        slab_list;
 	void           *slab_arg;
 	pthread_mutex_t slab_lock;
+	int             slab_type_count;
 	bool            slab_init;
 };
 
@@ -88,11 +131,15 @@ struct d_slab {
 int
 d_slab_init(struct d_slab *slab, void *arg) __attribute((warn_unused_result, nonnull(1)));
 
-/* Destroy a data slab manager, called once at shutdown */
+/* Destroy a data slab manager, called once at shutdown, once the other threads using it have
+ * stopped using it or exited.
+ */
 void
 d_slab_destroy(struct d_slab *slab);
 
-/* Register a new type to a manager, called multiple times after init */
+/* Register a new type to a manager, called multiple times after init.  Each type uses a
+ * pthread key for the magazines of the threads.
+ */
 int
 d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d_slab_type **type);
 
@@ -100,7 +147,9 @@ d_slab_register(struct d_slab *slab, struct d_slab_reg *reg, void *arg, struct d
 void *
 d_slab_acquire(struct d_slab_type *type);
 
-/* Release a data structure in a performant way */
+/* Release a data structure in a performant way, it is reused once restock() has been called from
+ * the same thread or once D_SLAB_MAG_SIZE objects have been released.
+ */
 void
 d_slab_release(struct d_slab_type *type, void *desc);
 
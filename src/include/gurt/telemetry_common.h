@@ -140,6 +140,8 @@ enum {
 	D_TM_CLOCK_THREAD_CPUTIME	= 0x200,
 	D_TM_LINK			= 0x400,
 	D_TM_MEMINFO			= 0x800,
+	D_TM_QUANTILE			= 0x1000,
+	D_TM_RING			= 0x2000,
 	D_TM_ALL_NODES			= (D_TM_DIRECTORY | \
 					   D_TM_COUNTER | \
 					   D_TM_TIMESTAMP | \
@@ -148,7 +150,9 @@ enum {
 					   D_TM_GAUGE | \
 					   D_TM_STATS_GAUGE | \
 					   D_TM_LINK | \
-					   D_TM_MEMINFO)
+					   D_TM_MEMINFO | \
+					   D_TM_QUANTILE | \
+					   D_TM_RING)
 };
 
 enum {
@@ -205,6 +209,55 @@ struct d_tm_histogram_t {
 	int			dth_value_multiplier;
 };
 
+/**
+ * Quantile sketch geometry.  Values below 2^D_TM_SKETCH_SUB_BITS have a bucket
+ * each, and every further power of two is split into 2^D_TM_SKETCH_SUB_BITS
+ * buckets, which bounds the relative error of a quantile to about 1.6%.
+ * Values of D_TM_SKETCH_MAX_BITS bits or more all land in the last bucket.
+ */
+#define D_TM_SKETCH_SUB_BITS	5
+#define D_TM_SKETCH_MAX_BITS	32
+#define D_TM_SKETCH_BUCKETS	((D_TM_SKETCH_MAX_BITS - D_TM_SKETCH_SUB_BITS + 1) << \
+				 D_TM_SKETCH_SUB_BITS)
+/** Number of shards of a quantile metric, updaters are spread among them */
+#define D_TM_SKETCH_SHARDS	4
+
+/**
+ * @brief Merged content of a quantile metric
+ *
+ * Sketches of the same geometry can be merged by adding up the buckets, so
+ * they can be combined across shards, targets and engines.
+ */
+struct d_tm_sketch_t {
+	uint64_t	dts_count;
+	uint64_t	dts_sum;
+	uint64_t	dts_min;
+	uint64_t	dts_max;
+	uint64_t	dts_buckets[D_TM_SKETCH_BUCKETS];
+};
+
+/** Per-shard sketch in shared memory, private to the telemetry library */
+struct d_tm_sketch_shard;
+
+/** Number of values of a record of a ring metric */
+#define D_TM_RING_FIELDS	8
+/** Number of records kept by a ring metric, older records are overwritten */
+#define D_TM_RING_RECORDS	64
+
+/**
+ * @brief Copy of a record of a ring metric
+ *
+ * Records are numbered from 1 in the order they were appended, so that the
+ * records read at different times can be told apart.
+ */
+struct d_tm_ring_rec_t {
+	uint64_t	dtr_seq;
+	uint64_t	dtr_fields[D_TM_RING_FIELDS];
+};
+
+/** Ring of records in shared memory, private to the telemetry library */
+struct d_tm_ring;
+
 struct d_tm_meminfo_t {
 	uint64_t arena;
 	uint64_t ordblks;
@@ -220,6 +273,8 @@ struct d_tm_metric_t {
 	}			dtm_data;
 	struct d_tm_stats_t	*dtm_stats;
 	struct d_tm_histogram_t	*dtm_histogram;
+	struct d_tm_sketch_shard *dtm_sketch;
+	struct d_tm_ring	*dtm_ring;
 	char			*dtm_desc;
 	char			*dtm_units;
 };
@@ -248,6 +303,14 @@ struct d_tm_nodeList_t {
 			  D_TM_MAX_DESC_LEN + D_TM_MAX_NAME_LEN + D_TM_MAX_UNIT_LEN + \
 			  sizeof(struct d_tm_stats_t))
 
+/* Size of a quantile metric, the shards of its sketch come on top of a regular metric */
+#define D_TM_QUANTILE_SIZE (D_TM_METRIC_SIZE + \
+			    D_TM_SKETCH_SHARDS * sizeof(struct d_tm_sketch_t))
+
+/* Size of a ring metric, the head and the records come on top of a regular metric */
+#define D_TM_RING_SIZE (D_TM_METRIC_SIZE + sizeof(uint64_t) + \
+			D_TM_RING_RECORDS * sizeof(struct d_tm_ring_rec_t))
+
 /** Context for a telemetry instance */
 struct d_tm_context;
 
@@ -263,4 +326,6 @@ double d_tm_compute_standard_dev(double sum_of_squares, uint64_t sample_size,
 				 double mean);
 void d_tm_compute_histogram(struct d_tm_node_t *node, uint64_t value);
 void d_tm_print_stats(FILE *stream, struct d_tm_stats_t *stats, int format);
+void d_tm_merge_sketch(struct d_tm_sketch_t *dst, struct d_tm_sketch_t *src);
+uint64_t d_tm_sketch_quantile(struct d_tm_sketch_t *sketch, double quantile);
 #endif /* __TELEMETRY_COMMON_H__ */
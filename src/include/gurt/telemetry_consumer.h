@@ -20,6 +20,10 @@ int d_tm_get_gauge(struct d_tm_context *ctx, uint64_t *val,
 		   struct d_tm_stats_t *stats, struct d_tm_node_t *node);
 int d_tm_get_duration(struct d_tm_context *ctx, struct timespec *tms,
 		      struct d_tm_stats_t *stats, struct d_tm_node_t *node);
+int d_tm_get_quantile(struct d_tm_context *ctx, struct d_tm_sketch_t *sketch,
+		      struct d_tm_node_t *node);
+int d_tm_get_ring(struct d_tm_context *ctx, struct d_tm_ring_rec_t *recs,
+		  int *nr, struct d_tm_node_t *node);
 int d_tm_get_metadata(struct d_tm_context *ctx, char **desc, char **units,
 		      struct d_tm_node_t *node);
 int d_tm_get_num_buckets(struct d_tm_context *ctx,
@@ -67,6 +71,10 @@ void d_tm_print_duration(struct timespec *tms, struct d_tm_stats_t *stats,
 			 FILE *stream);
 void d_tm_print_gauge(uint64_t val, struct d_tm_stats_t *stats, char *name,
 		      int format, char *units, int opt_fields, FILE *stream);
+void d_tm_print_quantile(struct d_tm_sketch_t *sketch, char *name, int format,
+			 char *units, int opt_fields, FILE *stream);
+void d_tm_print_ring(struct d_tm_ring_rec_t *recs, int nr, char *name,
+		     int format, char *units, int opt_fields, FILE *stream);
 void d_tm_print_metadata(char *desc, char *units, int format, FILE *stream);
 int d_tm_clock_id(int clk_id);
 char *d_tm_clock_string(int clk_id);
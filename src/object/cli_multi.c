@@ -0,0 +1,543 @@
+/**
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * src/object/cli_multi.c
+ *
+ * For client side multi-object fetch.
+ *
+ * The fetch requests against small objects are grouped by the target of the
+ * shard that will serve them, each group is shipped as one DAOS_OBJ_RPC_MULTI_FETCH
+ * RPC with the data packed inline in the reply. The requests that cannot be
+ * batched, or that failed in the batched RPC for whatever reason, are issued as
+ * regular fetch that will handle the retry, degraded and error cases.
+ */
+#define D_LOGFAC	DD_FAC(object)
+
+#include <daos/object.h>
+#include <daos/container.h>
+#include <daos/mgmt.h>
+#include <daos/pool.h>
+#include <daos/task.h>
+#include <daos_task.h>
+#include <daos_types.h>
+#include <daos_obj.h>
+#include "obj_rpc.h"
+#include "obj_internal.h"
+
+/* The max sub-requests in one multi-fetch RPC. */
+#define OBJ_MFETCH_SUB_MAX	64
+
+/* Rough per sub-request overhead for the RPC size estimation. */
+#define OBJ_MFETCH_SUB_OVERHEAD	64
+
+struct obj_mfetch_group {
+	d_list_t		 omg_link;
+	/* Hold the first object in the group for the pool and container. */
+	struct dc_object	*omg_obj;
+	struct obj_mfetch_args	*omg_args;
+	crt_rpc_t		*omg_rpc;
+	uint32_t		 omg_map_ver;
+	d_rank_t		 omg_rank;
+	uint32_t		 omg_tgt_idx;
+	uint32_t		 omg_nr;
+	daos_size_t		 omg_size;
+	/* Index of the request in the API reqs array for each sub-request. */
+	uint32_t		 omg_idx[OBJ_MFETCH_SUB_MAX];
+	struct obj_mfetch_sub	 omg_subs[OBJ_MFETCH_SUB_MAX];
+};
+
+struct obj_mfetch_args {
+	d_list_t		 oma_groups;
+	daos_obj_fetch_multi_t	*oma_api;
+	/* Set for the requests that need to be fetched via regular fetch. */
+	uint8_t			*oma_retry;
+	uint32_t		 oma_retry_nr;
+	/* Regular fetch has been issued for the left requests. */
+	uint32_t		 oma_retried:1;
+};
+
+static void
+obj_mfetch_group_free(struct obj_mfetch_group *omg)
+{
+	int	i;
+
+	for (i = 0; i < omg->omg_nr; i++)
+		D_FREE(omg->omg_subs[i].oms_sgls);
+	obj_decref(omg->omg_obj);
+	D_FREE(omg);
+}
+
+static void
+obj_mfetch_args_free(struct obj_mfetch_args *oma)
+{
+	struct obj_mfetch_group	*omg;
+
+	while ((omg = d_list_pop_entry(&oma->oma_groups, struct obj_mfetch_group,
+				       omg_link)) != NULL)
+		obj_mfetch_group_free(omg);
+
+	D_FREE(oma->oma_retry);
+	D_FREE(oma);
+}
+
+static void
+obj_mfetch_set_retry(struct obj_mfetch_args *oma, uint32_t idx)
+{
+	if (isclr(oma->oma_retry, idx)) {
+		setbit(oma->oma_retry, idx);
+		oma->oma_retry_nr++;
+	}
+}
+
+static void
+obj_mfetch_group_retry(struct obj_mfetch_group *omg)
+{
+	int	i;
+
+	for (i = 0; i < omg->omg_nr; i++)
+		obj_mfetch_set_retry(omg->omg_args, omg->omg_idx[i]);
+}
+
+/* Size of the sub-request in the request and reply, only inline sized fetch is batched. */
+static daos_size_t
+obj_mfetch_req_size(daos_obj_fetch_req_t *req)
+{
+	daos_size_t	size;
+	int		i;
+
+	size = OBJ_MFETCH_SUB_OVERHEAD + req->ofr_dkey->iov_len +
+	       daos_sgls_buf_size(req->ofr_sgls, req->ofr_nr);
+	for (i = 0; i < req->ofr_nr; i++)
+		size += req->ofr_iods[i].iod_name.iov_len +
+			req->ofr_iods[i].iod_nr * sizeof(daos_recx_t) +
+			req->ofr_sgls[i].sg_nr * sizeof(d_iov_t) + OBJ_MFETCH_SUB_OVERHEAD;
+
+	return size;
+}
+
+/* Build the buffer layout for the server, only iov_buf_len is needed. */
+static int
+obj_mfetch_sgls_layout(daos_obj_fetch_req_t *req, d_sg_list_t **sglsp)
+{
+	d_sg_list_t	*sgls;
+	d_iov_t		*iovs;
+	uint32_t	 iov_nr = 0;
+	int		 i;
+	int		 j;
+
+	for (i = 0; i < req->ofr_nr; i++)
+		iov_nr += req->ofr_sgls[i].sg_nr;
+
+	/* One allocation for both the sgls and the iovs. */
+	D_ALLOC(sgls, req->ofr_nr * sizeof(*sgls) + iov_nr * sizeof(*iovs));
+	if (sgls == NULL)
+		return -DER_NOMEM;
+
+	iovs = (d_iov_t *)&sgls[req->ofr_nr];
+	for (i = 0; i < req->ofr_nr; i++) {
+		sgls[i].sg_nr = req->ofr_sgls[i].sg_nr;
+		sgls[i].sg_iovs = iovs;
+		for (j = 0; j < sgls[i].sg_nr; j++)
+			iovs[j].iov_buf_len = req->ofr_sgls[i].sg_iovs[j].iov_buf_len;
+		iovs += sgls[i].sg_nr;
+	}
+
+	*sglsp = sgls;
+	return 0;
+}
+
+/*
+ * Add the request into the group for its target. Return 1 if it cannot be batched,
+ * then the caller will issue regular fetch for it.
+ */
+static int
+obj_mfetch_req_add(struct obj_mfetch_args *oma, uint32_t idx)
+{
+	daos_obj_fetch_req_t	*req = &oma->oma_api->reqs[idx];
+	struct obj_mfetch_group	*omg;
+	struct obj_mfetch_sub	*oms;
+	struct dc_obj_shard	*obj_shard;
+	struct dc_object	*obj;
+	daos_size_t		 size;
+	uint64_t		 dkey_hash;
+	uint32_t		 map_ver;
+	int			 grp_idx;
+	int			 shard;
+	int			 rc;
+
+	/* Leave the parameters check to regular fetch. */
+	if (req->ofr_dkey == NULL || req->ofr_nr == 0 || req->ofr_iods == NULL ||
+	    req->ofr_sgls == NULL)
+		return 1;
+
+	obj = obj_hdl2ptr(req->ofr_oh);
+	if (obj == NULL)
+		return 1;
+
+	if (obj_is_ec(obj) || obj->cob_co->dc_props.dcp_csum_enabled)
+		D_GOTO(out, rc = 1);
+
+	size = obj_mfetch_req_size(req);
+	if (size > DAOS_BULK_LIMIT)
+		D_GOTO(out, rc = 1);
+
+	map_ver = obj->cob_version;
+	dkey_hash = obj_dkey2hash(obj->cob_md.omd_id, req->ofr_dkey);
+	grp_idx = obj_dkey2grpidx(obj, dkey_hash, map_ver);
+	if (grp_idx < 0)
+		D_GOTO(out, rc = 1);
+
+	/* Fetch from the leader, that is stable for the same dkey and avoids DTX refresh. */
+	shard = obj_grp_leader_get(obj, grp_idx, dkey_hash, false, map_ver, NULL);
+	if (shard < 0)
+		D_GOTO(out, rc = 1);
+
+	rc = obj_shard_open(obj, shard, map_ver, &obj_shard);
+	if (rc != 0)
+		D_GOTO(out, rc = 1);
+
+	d_list_for_each_entry(omg, &oma->oma_groups, omg_link) {
+		if (omg->omg_obj->cob_co == obj->cob_co && omg->omg_map_ver == map_ver &&
+		    omg->omg_rank == obj_shard->do_target_rank &&
+		    omg->omg_tgt_idx == obj_shard->do_target_idx &&
+		    omg->omg_nr < OBJ_MFETCH_SUB_MAX && omg->omg_size + size <= DAOS_BULK_LIMIT)
+			goto found;
+	}
+
+	D_ALLOC_PTR(omg);
+	if (omg == NULL) {
+		obj_shard_close(obj_shard);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	omg->omg_obj = obj_addref(obj);
+	omg->omg_args = oma;
+	omg->omg_map_ver = map_ver;
+	omg->omg_rank = obj_shard->do_target_rank;
+	omg->omg_tgt_idx = obj_shard->do_target_idx;
+	d_list_add_tail(&omg->omg_link, &oma->oma_groups);
+
+found:
+	oms = &omg->omg_subs[omg->omg_nr];
+	rc = obj_mfetch_sgls_layout(req, &oms->oms_sgls);
+	if (rc != 0) {
+		obj_shard_close(obj_shard);
+		goto out;
+	}
+
+	oms->oms_oid = obj_shard->do_id;
+	oms->oms_dkey = *req->ofr_dkey;
+	oms->oms_dkey_hash = dkey_hash;
+	oms->oms_nr = req->ofr_nr;
+	oms->oms_iods = req->ofr_iods;
+	omg->omg_idx[omg->omg_nr++] = idx;
+	omg->omg_size += size;
+	obj_shard_close(obj_shard);
+
+out:
+	obj_decref(obj);
+	return rc;
+}
+
+static int
+obj_mfetch_rpc_cb(tse_task_t *task, void *data)
+{
+	struct obj_mfetch_group		*omg = *(struct obj_mfetch_group **)data;
+	struct obj_mfetch_args		*oma = omg->omg_args;
+	struct obj_multi_fetch_out	*omfo = crt_reply_get(omg->omg_rpc);
+	struct obj_mfetch_rep		*reps = NULL;
+	daos_obj_fetch_req_t		*req;
+	int				 rc = task->dt_result;
+	int				 i;
+	int				 j;
+
+	if (rc == 0)
+		rc = obj_reply_get_status(omg->omg_rpc);
+
+	if (rc == 0) {
+		reps = omfo->omfo_reps.ca_arrays;
+		if (omfo->omfo_reps.ca_count != omg->omg_nr) {
+			D_ERROR("Invalid multi-fetch reply count %u/%u\n",
+				(uint32_t)omfo->omfo_reps.ca_count, omg->omg_nr);
+			rc = -DER_PROTO;
+		}
+	}
+
+	if (rc != 0) {
+		D_DEBUG(DB_IO, "Multi-fetch %u sub-requests to rank %u tag %u: "DF_RC"\n",
+			omg->omg_nr, omg->omg_rank, omg->omg_tgt_idx, DP_RC(rc));
+		obj_mfetch_group_retry(omg);
+		goto out;
+	}
+
+	for (i = 0; i < omg->omg_nr; i++) {
+		req = &oma->oma_api->reqs[omg->omg_idx[i]];
+		if (reps[i].omr_ret != 0 || reps[i].omr_nr != req->ofr_nr ||
+		    daos_sgls_copy_data_out(req->ofr_sgls, req->ofr_nr, reps[i].omr_sgls,
+					    reps[i].omr_nr) != 0) {
+			obj_mfetch_set_retry(oma, omg->omg_idx[i]);
+			continue;
+		}
+
+		for (j = 0; j < req->ofr_nr; j++)
+			req->ofr_iods[j].iod_size = reps[i].omr_sizes[j];
+		req->ofr_rc = 0;
+	}
+
+out:
+	crt_req_decref(omg->omg_rpc);
+	omg->omg_rpc = NULL;
+
+	/* The failed sub-requests will be retried via regular fetch. */
+	return 0;
+}
+
+static int
+obj_mfetch_rpc_send(tse_task_t *task)
+{
+	struct obj_mfetch_group		*omg = tse_task_get_priv(task);
+	struct dc_object		*obj = omg->omg_obj;
+	struct dc_pool			*pool = obj->cob_pool;
+	struct obj_multi_fetch_in	*omfi;
+	crt_endpoint_t			 tgt_ep = { 0 };
+	crt_rpc_t			*req = NULL;
+	int				 rc;
+
+	tgt_ep.ep_grp = pool->dp_sys->sy_group;
+	tgt_ep.ep_rank = omg->omg_rank;
+	tgt_ep.ep_tag = omg->omg_tgt_idx;
+
+	rc = obj_req_create(daos_task2ctx(task), &tgt_ep, DAOS_OBJ_RPC_MULTI_FETCH, &req);
+	if (rc != 0)
+		goto out;
+
+	crt_req_addref(req);
+	omg->omg_rpc = req;
+	rc = tse_task_register_comp_cb(task, obj_mfetch_rpc_cb, &omg, sizeof(omg));
+	if (rc != 0) {
+		omg->omg_rpc = NULL;
+		crt_req_decref(req);
+		crt_req_decref(req);
+		goto out;
+	}
+
+	omfi = crt_req_get(req);
+	daos_dti_gen(&omfi->omfi_dti, false);
+	uuid_copy(omfi->omfi_po_uuid, pool->dp_pool);
+	uuid_copy(omfi->omfi_co_hdl, obj->cob_co->dc_cont_hdl);
+	uuid_copy(omfi->omfi_co_uuid, obj->cob_co->dc_uuid);
+	/* Let the server choose the epoch, as regular independent fetch does. */
+	omfi->omfi_epoch = DAOS_EPOCH_MAX;
+	omfi->omfi_map_ver = omg->omg_map_ver;
+	omfi->omfi_flags = 0;
+	omfi->omfi_subs.ca_count = omg->omg_nr;
+	omfi->omfi_subs.ca_arrays = omg->omg_subs;
+
+	D_DEBUG(DB_IO, "MULTI_FETCH_RPC %u sub-requests, rank=%d tag=%d.\n", omg->omg_nr,
+		tgt_ep.ep_rank, tgt_ep.ep_tag);
+
+	return daos_rpc_send(req, task);
+
+out:
+	/* Failed to send, all the sub-requests will be retried via regular fetch. */
+	obj_mfetch_group_retry(omg);
+	tse_task_complete(task, 0);
+	return rc;
+}
+
+static int
+obj_mfetch_regular_cb(tse_task_t *task, void *data)
+{
+	daos_obj_fetch_req_t	*req = *(daos_obj_fetch_req_t **)data;
+
+	req->ofr_rc = task->dt_result;
+	return 0;
+}
+
+static int
+obj_mfetch_regular(tse_task_t *api_task, daos_obj_fetch_req_t *req, d_list_t *task_list)
+{
+	daos_obj_fetch_multi_t	*args = dc_task_get_args(api_task);
+	tse_task_t		*task;
+	int			 rc;
+
+	rc = dc_obj_fetch_task_create(req->ofr_oh, args->th, args->flags, req->ofr_dkey,
+				      req->ofr_nr, 0, req->ofr_iods, req->ofr_sgls, NULL, NULL,
+				      NULL, NULL, tse_task2sched(api_task), &task);
+	if (rc != 0)
+		return rc;
+
+	rc = tse_task_register_comp_cb(task, obj_mfetch_regular_cb, &req, sizeof(req));
+	if (rc != 0)
+		goto fail;
+
+	rc = tse_task_register_deps(api_task, 1, &task);
+	if (rc != 0)
+		goto fail;
+
+	tse_task_list_add(task, task_list);
+	return 0;
+
+fail:
+	tse_task_complete(task, rc);
+	return rc;
+}
+
+static int
+obj_mfetch_dispatch(tse_task_t *api_task, struct obj_mfetch_args *oma)
+{
+	daos_obj_fetch_multi_t	*args = oma->oma_api;
+	struct obj_mfetch_group	*omg;
+	tse_task_t		*task;
+	d_list_t		 task_list;
+	bool			 batch;
+	int			 rc = 0;
+	int			 i;
+
+	D_INIT_LIST_HEAD(&task_list);
+
+	/*
+	 * Transactional or conditional fetch is not batched, neither against the engines
+	 * that do not support multi-fetch RPC.
+	 */
+	batch = daos_handle_is_inval(args->th) && args->flags == 0 &&
+		dc_obj_proto_version >= DAOS_OBJ_VERSION_MULTI_FETCH;
+	for (i = 0; i < args->nr; i++) {
+		args->reqs[i].ofr_rc = -DER_INVAL;
+		if (!batch) {
+			obj_mfetch_set_retry(oma, i);
+			continue;
+		}
+
+		rc = obj_mfetch_req_add(oma, i);
+		if (rc < 0)
+			goto out;
+		if (rc > 0)
+			obj_mfetch_set_retry(oma, i);
+	}
+
+	/* Nothing can be batched, issue regular fetch directly. */
+	if (d_list_empty(&oma->oma_groups))
+		return 0;
+
+	d_list_for_each_entry(omg, &oma->oma_groups, omg_link) {
+		rc = tse_task_create(obj_mfetch_rpc_send, tse_task2sched(api_task), omg, &task);
+		if (rc != 0)
+			goto out;
+
+		rc = tse_task_register_deps(api_task, 1, &task);
+		if (rc != 0) {
+			tse_task_complete(task, rc);
+			goto out;
+		}
+
+		tse_task_list_add(task, &task_list);
+	}
+
+	rc = tse_task_reinit(api_task);
+
+out:
+	if (rc != 0)
+		tse_task_list_abort(&task_list, rc);
+	else
+		tse_task_list_sched(&task_list, false);
+	return rc;
+}
+
+static int
+obj_mfetch_retry(tse_task_t *api_task, struct obj_mfetch_args *oma)
+{
+	daos_obj_fetch_multi_t	*args = oma->oma_api;
+	d_list_t		 task_list;
+	int			 rc = 0;
+	int			 i;
+
+	D_DEBUG(DB_IO, "Multi-fetch %u/%u requests via regular fetch\n",
+		oma->oma_retry_nr, args->nr);
+
+	D_INIT_LIST_HEAD(&task_list);
+	for (i = 0; i < args->nr; i++) {
+		if (isclr(oma->oma_retry, i))
+			continue;
+
+		rc = obj_mfetch_regular(api_task, &args->reqs[i], &task_list);
+		if (rc != 0)
+			goto out;
+	}
+
+	rc = tse_task_reinit(api_task);
+
+out:
+	if (rc != 0)
+		tse_task_list_abort(&task_list, rc);
+	else
+		tse_task_list_sched(&task_list, false);
+	return rc;
+}
+
+int
+dc_obj_fetch_multi(tse_task_t *task)
+{
+	daos_obj_fetch_multi_t	*args = dc_task_get_args(task);
+	struct obj_mfetch_args	*oma = dc_task_get_priv(task);
+	int			 rc = 0;
+	int			 i;
+
+	if (oma == NULL) {
+		if (args->nr == 0 || args->reqs == NULL)
+			D_GOTO(out, rc = -DER_INVAL);
+
+		D_ALLOC_PTR(oma);
+		if (oma == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		D_ALLOC(oma->oma_retry, (args->nr + NBBY - 1) / NBBY);
+		if (oma->oma_retry == NULL) {
+			D_FREE(oma);
+			D_GOTO(out, rc = -DER_NOMEM);
+		}
+
+		D_INIT_LIST_HEAD(&oma->oma_groups);
+		oma->oma_api = args;
+		dc_task_set_priv(task, oma);
+
+		/* Each request carries its own result, do not fail the others. */
+		tse_disable_propagate(task);
+
+		rc = obj_mfetch_dispatch(task, oma);
+		if (rc != 0)
+			goto out;
+
+		/* Re-run after the batched RPCs are done. */
+		if (!d_list_empty(&oma->oma_groups))
+			return 0;
+	}
+
+	if (!oma->oma_retried && oma->oma_retry_nr != 0) {
+		oma->oma_retried = 1;
+		rc = obj_mfetch_retry(task, oma);
+		if (rc != 0)
+			goto out;
+
+		/* Re-run after the regular fetches are done. */
+		return 0;
+	}
+
+	for (i = 0; i < args->nr; i++) {
+		if (args->reqs[i].ofr_rc != 0) {
+			rc = args->reqs[i].ofr_rc;
+			break;
+		}
+	}
+
+out:
+	if (oma != NULL) {
+		obj_mfetch_args_free(oma);
+		dc_task_set_priv(task, NULL);
+	}
+	tse_task_complete(task, rc);
+	return rc;
+}
@@ -9,6 +9,7 @@
 #define D_LOGFAC	DD_FAC(object)
 
 #include <daos/container.h>
+#include <daos/job.h>
 #include <daos/mgmt.h>
 #include <daos/pool.h>
 #include <daos/pool_map.h>
@@ -1086,6 +1087,8 @@ dc_obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 	orw->orw_iod_array.oia_offs = args->offs;
 	/* for retry RPC */
 	orw->orw_comm_in.req_in_enqueue_id = auxi->enqueue_id;
+	/* for job ID based IO scheduling policies on server */
+	orw->orw_comm_in.req_in_jobid = dc_jobid;
 
 	D_DEBUG(DB_IO, "rpc %p opc %d "DF_UOID" "DF_KEY" rank %d tag %d eph "
 		DF_U64", DTI = "DF_DTI" start shard %u ver %u\n", req, opc,
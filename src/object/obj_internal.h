@@ -810,10 +810,17 @@ struct obj_io_context {
 	uint32_t		 ioc_opc;
 	uint64_t		 ioc_start_time;
 	uint64_t		 ioc_io_size;
+	/* time spent in each stage (ns), only for the sampled requests */
+	uint64_t		 ioc_vos_time;
+	uint64_t		 ioc_bio_time;
+	uint64_t		 ioc_bulk_time;
+	uint64_t		 ioc_reply_time;
 	uint32_t		 ioc_began:1,
 				 ioc_free_sgls:1,
 				 ioc_lost_reply:1,
-				 ioc_fetch_snap:1;
+				 ioc_fetch_snap:1,
+				 /* stage timings of the request are sampled */
+				 ioc_prof:1;
 };
 
 static inline uint64_t
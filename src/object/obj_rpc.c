@@ -132,6 +132,7 @@ crt_proc_daos_iod_and_csum(crt_proc_t proc, crt_proc_op_t proc_op,
 	uint32_t	start, nr;
 	bool		proc_one = false;
 	bool		singv = false;
+	bool		inplace = false;
 	uint32_t	existing_flags = 0;
 	int		rc;
 
@@ -215,15 +216,19 @@ crt_proc_daos_iod_and_csum(crt_proc_t proc, crt_proc_op_t proc_op,
 	if (unlikely(rc))
 		D_GOTO(out, rc);
 
-	if (DECODING(proc_op)) {
-		if (existing_flags & IOD_REC_EXIST) {
+	if (DECODING(proc_op) && (existing_flags & IOD_REC_EXIST)) {
+		/* refer to the recxs in the request buffer if possible */
+		inplace = crt_proc_inplace_decode(proc, (void **)&iod->iod_recxs,
+						  nr * sizeof(*iod->iod_recxs),
+						  __alignof__(*iod->iod_recxs));
+		if (!inplace) {
 			D_ALLOC_ARRAY(iod->iod_recxs, nr);
 			if (iod->iod_recxs == NULL)
 				D_GOTO(out, rc = -DER_NOMEM);
 		}
 	}
 
-	if (existing_flags & IOD_REC_EXIST) {
+	if ((existing_flags & IOD_REC_EXIST) && !inplace) {
 		D_ASSERT(iod->iod_recxs != NULL || nr == 0);
 		if (nr > 0) {
 			rc = crt_proc_memcpy(proc, proc_op,
@@ -248,7 +253,8 @@ crt_proc_daos_iod_and_csum(crt_proc_t proc, crt_proc_op_t proc_op,
 
 	if (FREEING(proc_op)) {
 out_free:
-		if (existing_flags & IOD_REC_EXIST)
+		if ((existing_flags & IOD_REC_EXIST) &&
+		    !crt_proc_inplace_data(proc, iod->iod_recxs))
 			D_FREE(iod->iod_recxs);
 	}
 out:
@@ -422,7 +428,14 @@ crt_proc_struct_obj_iod_array(crt_proc_t proc, crt_proc_op_t proc_op,
 
 		iod_size = roundup(sizeof(daos_iod_t) * iod_array->oia_iod_nr,
 				   8);
-		off_size = sizeof(*iod_array->oia_offs) * off_nr;
+		iod_array->oia_offs = NULL;
+		if (off_nr != 0 &&
+		    !crt_proc_inplace_decode(proc, (void **)&iod_array->oia_offs,
+					     off_nr * sizeof(*iod_array->oia_offs),
+					     __alignof__(*iod_array->oia_offs)))
+			off_size = sizeof(*iod_array->oia_offs) * off_nr;
+		else
+			off_size = 0;
 		if (with_iod_csums)
 			csum_size = roundup(sizeof(struct dcs_iod_csums) *
 					    iod_array->oia_iod_nr, 8);
@@ -436,7 +449,7 @@ crt_proc_struct_obj_iod_array(crt_proc_t proc, crt_proc_op_t proc_op,
 		if (buf == NULL)
 			return -DER_NOMEM;
 		iod_array->oia_iods = buf;
-		if (off_nr != 0) {
+		if (off_size != 0) {
 			iod_array->oia_offs = buf + iod_size;
 			rc = crt_proc_memcpy(proc, proc_op,
 					     iod_array->oia_offs, off_nr *
@@ -445,8 +458,6 @@ crt_proc_struct_obj_iod_array(crt_proc_t proc, crt_proc_op_t proc_op,
 				D_FREE(iod_array->oia_iods);
 				return rc;
 			}
-		} else {
-			iod_array->oia_offs = NULL;
 		}
 
 		if (with_iod_csums)
@@ -587,7 +598,8 @@ crt_proc_daos_iod_t(crt_proc_t proc, crt_proc_op_t proc_op, daos_iod_t *iod)
 
 	if (FREEING(proc_op)) {
 		/* NB: don't need free in crt_proc_d_iov_t() */
-		D_FREE(iod->iod_recxs);
+		if (!crt_proc_inplace_data(proc, iod->iod_recxs))
+			D_FREE(iod->iod_recxs);
 		return 0;
 	}
 
@@ -612,6 +624,11 @@ crt_proc_daos_iod_t(crt_proc_t proc, crt_proc_op_t proc_op, daos_iod_t *iod)
 		return 0;
 
 	if (DECODING(proc_op)) {
+		if (crt_proc_inplace_decode(proc, (void **)&iod->iod_recxs,
+					    iod->iod_nr * sizeof(*iod->iod_recxs),
+					    __alignof__(*iod->iod_recxs)))
+			return 0;
+
 		D_ALLOC_ARRAY(iod->iod_recxs, iod->iod_nr);
 		if (iod->iod_recxs == NULL)
 			return -DER_NOMEM;
@@ -1249,6 +1266,123 @@ out:
 	return rc;
 }
 
+static int
+crt_proc_struct_obj_mfetch_sub(crt_proc_t proc, crt_proc_op_t proc_op, struct obj_mfetch_sub *oms)
+{
+	int	rc = 0;
+	int	i;
+
+	if (FREEING(proc_op))
+		goto out;
+
+	rc = crt_proc_daos_unit_oid_t(proc, proc_op, &oms->oms_oid);
+	if (unlikely(rc))
+		return rc;
+
+	rc = crt_proc_daos_key_t(proc, proc_op, &oms->oms_dkey);
+	if (unlikely(rc))
+		return rc;
+
+	rc = crt_proc_uint64_t(proc, proc_op, &oms->oms_dkey_hash);
+	if (unlikely(rc))
+		return rc;
+
+	rc = crt_proc_uint32_t(proc, proc_op, &oms->oms_nr);
+	if (unlikely(rc))
+		return rc;
+
+	if (oms->oms_nr == 0)
+		return 0;
+
+	if (DECODING(proc_op)) {
+		D_ALLOC_ARRAY(oms->oms_iods, oms->oms_nr);
+		if (oms->oms_iods == NULL)
+			return -DER_NOMEM;
+
+		D_ALLOC_ARRAY(oms->oms_sgls, oms->oms_nr);
+		if (oms->oms_sgls == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	for (i = 0; i < oms->oms_nr; i++) {
+		rc = crt_proc_daos_iod_t(proc, proc_op, &oms->oms_iods[i]);
+		if (unlikely(rc))
+			goto out;
+
+		rc = crt_proc_d_sg_list_t(proc, proc_op, &oms->oms_sgls[i]);
+		if (unlikely(rc))
+			goto out;
+	}
+
+out:
+	if (FREEING(proc_op) || (unlikely(rc) && DECODING(proc_op))) {
+		for (i = 0; i < oms->oms_nr; i++) {
+			if (oms->oms_iods != NULL)
+				crt_proc_daos_iod_t(proc, CRT_PROC_FREE, &oms->oms_iods[i]);
+			if (oms->oms_sgls != NULL)
+				crt_proc_d_sg_list_t(proc, CRT_PROC_FREE, &oms->oms_sgls[i]);
+		}
+		D_FREE(oms->oms_iods);
+		D_FREE(oms->oms_sgls);
+	}
+
+	return rc;
+}
+
+static int
+crt_proc_struct_obj_mfetch_rep(crt_proc_t proc, crt_proc_op_t proc_op, struct obj_mfetch_rep *omr)
+{
+	int	rc = 0;
+	int	i;
+
+	if (FREEING(proc_op))
+		goto out;
+
+	rc = crt_proc_int32_t(proc, proc_op, &omr->omr_ret);
+	if (unlikely(rc))
+		return rc;
+
+	rc = crt_proc_uint32_t(proc, proc_op, &omr->omr_nr);
+	if (unlikely(rc))
+		return rc;
+
+	/* Nothing is packed for the failed sub-request. */
+	if (omr->omr_ret != 0 || omr->omr_nr == 0)
+		return 0;
+
+	if (DECODING(proc_op)) {
+		D_ALLOC_ARRAY(omr->omr_sizes, omr->omr_nr);
+		if (omr->omr_sizes == NULL)
+			return -DER_NOMEM;
+
+		D_ALLOC_ARRAY(omr->omr_sgls, omr->omr_nr);
+		if (omr->omr_sgls == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+	}
+
+	rc = crt_proc_memcpy(proc, proc_op, omr->omr_sizes, omr->omr_nr * sizeof(*omr->omr_sizes));
+	if (unlikely(rc))
+		goto out;
+
+	for (i = 0; i < omr->omr_nr; i++) {
+		rc = crt_proc_d_sg_list_t(proc, proc_op, &omr->omr_sgls[i]);
+		if (unlikely(rc))
+			goto out;
+	}
+
+out:
+	if (FREEING(proc_op) || (unlikely(rc) && DECODING(proc_op))) {
+		if (omr->omr_sgls != NULL) {
+			for (i = 0; i < omr->omr_nr; i++)
+				crt_proc_d_sg_list_t(proc, CRT_PROC_FREE, &omr->omr_sgls[i]);
+		}
+		D_FREE(omr->omr_sizes);
+		D_FREE(omr->omr_sgls);
+	}
+
+	return rc;
+}
+
 CRT_RPC_DEFINE(obj_rw, DAOS_ISEQ_OBJ_RW, DAOS_OSEQ_OBJ_RW)
 CRT_RPC_DEFINE(obj_rw_v10, DAOS_ISEQ_OBJ_RW_V10, DAOS_OSEQ_OBJ_RW_V10)
 CRT_RPC_DEFINE(obj_key_enum, DAOS_ISEQ_OBJ_KEY_ENUM, DAOS_OSEQ_OBJ_KEY_ENUM)
@@ -1267,6 +1401,7 @@ CRT_RPC_DEFINE(obj_key2anchor, DAOS_ISEQ_OBJ_KEY2ANCHOR, DAOS_OSEQ_OBJ_KEY2ANCHO
 CRT_RPC_DEFINE(obj_key2anchor_v10, DAOS_ISEQ_OBJ_KEY2ANCHOR_V10, DAOS_OSEQ_OBJ_KEY2ANCHOR_V10)
 CRT_RPC_DEFINE(obj_coll_punch, DAOS_ISEQ_OBJ_COLL_PUNCH, DAOS_OSEQ_OBJ_COLL_PUNCH)
 CRT_RPC_DEFINE(obj_coll_query, DAOS_ISEQ_OBJ_COLL_QUERY, DAOS_OSEQ_OBJ_COLL_QUERY)
+CRT_RPC_DEFINE(obj_multi_fetch, DAOS_ISEQ_OBJ_MULTI_FETCH, DAOS_OSEQ_OBJ_MULTI_FETCH)
 
 /* Define for obj_proto_rpc_fmt[] array population below.
  * See OBJ_PROTO_*_RPC_LIST macro definition
@@ -1279,29 +1414,29 @@ CRT_RPC_DEFINE(obj_coll_query, DAOS_ISEQ_OBJ_COLL_QUERY, DAOS_OSEQ_OBJ_COLL_QUER
 	.prf_co_ops  = NULL,	\
 },
 
-static struct crt_proto_rpc_format obj_proto_rpc_fmt_v9[] = {
-	OBJ_PROTO_CLI_RPC_LIST(9)
+static struct crt_proto_rpc_format obj_proto_rpc_fmt_v10[] = {
+	OBJ_PROTO_CLI_RPC_LIST_V10
 };
 
-static struct crt_proto_rpc_format obj_proto_rpc_fmt_v10[] = {
-	OBJ_PROTO_CLI_RPC_LIST(10)
+static struct crt_proto_rpc_format obj_proto_rpc_fmt_v11[] = {
+	OBJ_PROTO_CLI_RPC_LIST
 };
 
 #undef X
 
-struct crt_proto_format obj_proto_fmt_v9 = {
+struct crt_proto_format obj_proto_fmt_v10 = {
 	.cpf_name  = "daos-object",
 	.cpf_ver   = DAOS_OBJ_VERSION - 1,
-	.cpf_count = ARRAY_SIZE(obj_proto_rpc_fmt_v9),
-	.cpf_prf   = obj_proto_rpc_fmt_v9,
+	.cpf_count = ARRAY_SIZE(obj_proto_rpc_fmt_v10),
+	.cpf_prf   = obj_proto_rpc_fmt_v10,
 	.cpf_base  = DAOS_RPC_OPCODE(0, DAOS_OBJ_MODULE, 0)
 };
 
-struct crt_proto_format obj_proto_fmt_v10 = {
+struct crt_proto_format obj_proto_fmt_v11 = {
 	.cpf_name  = "daos-object",
 	.cpf_ver   = DAOS_OBJ_VERSION,
-	.cpf_count = ARRAY_SIZE(obj_proto_rpc_fmt_v10),
-	.cpf_prf   = obj_proto_rpc_fmt_v10,
+	.cpf_count = ARRAY_SIZE(obj_proto_rpc_fmt_v11),
+	.cpf_prf   = obj_proto_rpc_fmt_v11,
 	.cpf_base  = DAOS_RPC_OPCODE(0, DAOS_OBJ_MODULE, 0)
 };
 
@@ -1354,6 +1489,9 @@ obj_reply_set_status(crt_rpc_t *rpc, int status)
 	case DAOS_OBJ_RPC_COLL_QUERY:
 		((struct obj_coll_query_out *)reply)->ocqo_ret = status;
 		break;
+	case DAOS_OBJ_RPC_MULTI_FETCH:
+		((struct obj_multi_fetch_out *)reply)->omfo_ret = status;
+		break;
 	default:
 		D_ASSERT(0);
 	}
@@ -1397,6 +1535,8 @@ obj_reply_get_status(crt_rpc_t *rpc)
 		return ((struct obj_coll_punch_out *)reply)->ocpo_ret;
 	case DAOS_OBJ_RPC_COLL_QUERY:
 		return ((struct obj_coll_query_out *)reply)->ocqo_ret;
+	case DAOS_OBJ_RPC_MULTI_FETCH:
+		return ((struct obj_multi_fetch_out *)reply)->omfo_ret;
 	default:
 		D_ASSERT(0);
 	}
@@ -1452,6 +1592,9 @@ obj_reply_map_version_set(crt_rpc_t *rpc, uint32_t map_version)
 	case DAOS_OBJ_RPC_COLL_QUERY:
 		((struct obj_coll_query_out *)reply)->ocqo_map_version = map_version;
 		break;
+	case DAOS_OBJ_RPC_MULTI_FETCH:
+		((struct obj_multi_fetch_out *)reply)->omfo_map_version = map_version;
+		break;
 	default:
 		D_ASSERT(0);
 	}
@@ -1491,6 +1634,8 @@ obj_reply_map_version_get(crt_rpc_t *rpc)
 		return ((struct obj_coll_punch_out *)reply)->ocpo_map_version;
 	case DAOS_OBJ_RPC_COLL_QUERY:
 		return ((struct obj_coll_query_out *)reply)->ocqo_map_version;
+	case DAOS_OBJ_RPC_MULTI_FETCH:
+		return ((struct obj_multi_fetch_out *)reply)->omfo_map_version;
 	default:
 		D_ASSERT(0);
 	}
@@ -31,57 +31,58 @@
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See daos_rpc.h.
  */
-#define DAOS_OBJ_VERSION 10
+#define DAOS_OBJ_VERSION 11
+/* first version of the protocol with DAOS_OBJ_RPC_MULTI_FETCH */
+#define DAOS_OBJ_VERSION_MULTI_FETCH 11
 /* LIST of internal RPCS in form of:
  * OPCODE, flags, FMT, handler, corpc_hdlr and name
  */
 
-#define OBJ_PROTO_CLI_RPC_LIST(ver)					\
+#define OBJ_PROTO_CLI_RPC_LIST_V10					\
 	X(DAOS_OBJ_RPC_UPDATE,						\
-		0, ver == 9 ? &CQF_obj_rw : &CQF_obj_rw_v10,		\
+		CRT_RPC_FEAT_INPLACE_DECODE, &CQF_obj_rw_v10,		\
 		ds_obj_rw_handler, NULL, "update")			\
 	X(DAOS_OBJ_RPC_FETCH,						\
-		0, ver == 9 ? &CQF_obj_rw : &CQF_obj_rw_v10,		\
+		CRT_RPC_FEAT_INPLACE_DECODE, &CQF_obj_rw_v10,		\
 		ds_obj_rw_handler, NULL, "fetch")			\
 	X(DAOS_OBJ_DKEY_RPC_ENUMERATE,					\
-		0, ver == 9 ? &CQF_obj_key_enum : &CQF_obj_key_enum_v10,\
+		0, &CQF_obj_key_enum_v10,				\
 		ds_obj_enum_handler, NULL, "dkey_enum")			\
 	X(DAOS_OBJ_AKEY_RPC_ENUMERATE,					\
-		0, ver == 9 ? &CQF_obj_key_enum : &CQF_obj_key_enum_v10,\
+		0, &CQF_obj_key_enum_v10,				\
 		ds_obj_enum_handler, NULL, "akey_enum")			\
 	X(DAOS_OBJ_RECX_RPC_ENUMERATE,					\
-		0, ver == 9 ? &CQF_obj_key_enum : &CQF_obj_key_enum_v10,\
+		0, &CQF_obj_key_enum_v10,				\
 		ds_obj_enum_handler, NULL, "recx_enum")			\
 	X(DAOS_OBJ_RPC_ENUMERATE,					\
-		0, ver == 9 ? &CQF_obj_key_enum : &CQF_obj_key_enum_v10,\
+		0, &CQF_obj_key_enum_v10,				\
 		ds_obj_enum_handler, NULL, "obj_enum")			\
 	X(DAOS_OBJ_RPC_PUNCH,						\
-		0, ver == 9 ? &CQF_obj_punch : &CQF_obj_punch_v10,	\
+		0, &CQF_obj_punch_v10,					\
 		ds_obj_punch_handler, NULL, "obj_punch")		\
 	X(DAOS_OBJ_RPC_PUNCH_DKEYS,					\
-		0, ver == 9 ? &CQF_obj_punch : &CQF_obj_punch_v10,	\
+		0, &CQF_obj_punch_v10,					\
 		ds_obj_punch_handler, NULL, "dkey_punch")		\
 	X(DAOS_OBJ_RPC_PUNCH_AKEYS,					\
-		0, ver == 9 ? &CQF_obj_punch : &CQF_obj_punch_v10,	\
+		0, &CQF_obj_punch_v10,					\
 		ds_obj_punch_handler, NULL, "akey_punch")		\
 	X(DAOS_OBJ_RPC_QUERY_KEY,					\
-		0, ver == 9 ? &CQF_obj_query_key :			\
-					&CQF_obj_query_key_v10,		\
+		0, &CQF_obj_query_key_v10,				\
 		ds_obj_query_key_handler, NULL, "key_query")		\
 	X(DAOS_OBJ_RPC_SYNC,						\
-		0, ver == 9 ? &CQF_obj_sync : &CQF_obj_sync_v10,	\
+		0, &CQF_obj_sync_v10,					\
 		ds_obj_sync_handler, NULL, "obj_sync")			\
 	X(DAOS_OBJ_RPC_TGT_UPDATE,					\
-		0, ver == 9 ? &CQF_obj_rw : &CQF_obj_rw_v10,		\
+		CRT_RPC_FEAT_INPLACE_DECODE, &CQF_obj_rw_v10,		\
 		ds_obj_tgt_update_handler, NULL, "tgt_update")		\
 	X(DAOS_OBJ_RPC_TGT_PUNCH,					\
-		0, ver == 9 ? &CQF_obj_punch : &CQF_obj_punch_v10,	\
+		0, &CQF_obj_punch_v10,					\
 		ds_obj_tgt_punch_handler, NULL, "tgt_punch")		\
 	X(DAOS_OBJ_RPC_TGT_PUNCH_DKEYS,					\
-		0, ver == 9 ? &CQF_obj_punch : &CQF_obj_punch_v10,	\
+		0, &CQF_obj_punch_v10,					\
 		ds_obj_tgt_punch_handler, NULL, "tgt_dkey_punch")	\
 	X(DAOS_OBJ_RPC_TGT_PUNCH_AKEYS,					\
-		0, ver == 9 ? &CQF_obj_punch : &CQF_obj_punch_v10,	\
+		0, &CQF_obj_punch_v10,					\
 		ds_obj_tgt_punch_handler, NULL, "tgt_akey_punch")	\
 	X(DAOS_OBJ_RPC_MIGRATE,						\
 		0, &CQF_obj_migrate,					\
@@ -96,8 +97,7 @@
 		0, &CQF_obj_cpd,					\
 		ds_obj_cpd_handler, NULL, "compound")			\
 	X(DAOS_OBJ_RPC_KEY2ANCHOR,					\
-		0, ver == 9 ? &CQF_obj_key2anchor :			\
-				&CQF_obj_key2anchor_v10,		\
+		0, &CQF_obj_key2anchor_v10,				\
 		ds_obj_key2anchor_handler, NULL, "key2anchor")		\
 	X(DAOS_OBJ_RPC_COLL_PUNCH,					\
 		0, &CQF_obj_coll_punch, ds_obj_coll_punch_handler,	\
@@ -106,17 +106,26 @@
 		0, &CQF_obj_coll_query, ds_obj_coll_query_handler,	\
 		NULL, "obj_coll_query")
 
+/* The RPCs added since DAOS_OBJ_VERSION_MULTI_FETCH are appended to the ones of version 10. */
+#define OBJ_PROTO_CLI_RPC_LIST						\
+	OBJ_PROTO_CLI_RPC_LIST_V10					\
+	X(DAOS_OBJ_RPC_MULTI_FETCH,					\
+		0, &CQF_obj_multi_fetch, ds_obj_multi_fetch_handler,	\
+		NULL, "obj_multi_fetch")
+
 /* Define for RPC enum population below */
 #define X(a, b, c, d, e, f) a,
 enum obj_rpc_opc {
-	OBJ_PROTO_CLI_RPC_LIST(10)
+	OBJ_PROTO_CLI_RPC_LIST
 	OBJ_PROTO_CLI_COUNT,
 	OBJ_PROTO_CLI_LAST = OBJ_PROTO_CLI_COUNT - 1,
+	/* RPC count of the version 10 protocol, that has no multi-fetch */
+	OBJ_PROTO_CLI_COUNT_V10 = DAOS_OBJ_RPC_MULTI_FETCH,
 };
 #undef X
 
-extern struct crt_proto_format obj_proto_fmt_v9;
 extern struct crt_proto_format obj_proto_fmt_v10;
+extern struct crt_proto_format obj_proto_fmt_v11;
 extern int dc_obj_proto_version;
 
 /* Helper function to convert opc to name */
@@ -125,7 +134,7 @@ obj_opc_to_str(crt_opcode_t opc)
 {
 	switch (opc) {
 #define X(a, b, c, d, e, f) case a: return f;
-		OBJ_PROTO_CLI_RPC_LIST(10)
+		OBJ_PROTO_CLI_RPC_LIST
 #undef X
 	}
 	return "unknown";
@@ -790,6 +799,43 @@ CRT_RPC_DECLARE(obj_coll_punch, DAOS_ISEQ_OBJ_COLL_PUNCH, DAOS_OSEQ_OBJ_COLL_PUN
 
 CRT_RPC_DECLARE(obj_coll_query, DAOS_ISEQ_OBJ_COLL_QUERY, DAOS_OSEQ_OBJ_COLL_QUERY)
 
+/* One sub-request of multi-object fetch, all of them are against the same VOS target. */
+struct obj_mfetch_sub {
+	daos_unit_oid_t		 oms_oid;
+	daos_key_t		 oms_dkey;
+	uint64_t		 oms_dkey_hash;
+	uint32_t		 oms_nr;
+	uint32_t		 oms_padding;
+	daos_iod_t		*oms_iods;
+	/* Only carry the buffer layout (iov_buf_len), no data. */
+	d_sg_list_t		*oms_sgls;
+};
+
+struct obj_mfetch_rep {
+	int32_t			 omr_ret;
+	uint32_t		 omr_nr;
+	uint64_t		*omr_sizes;
+	d_sg_list_t		*omr_sgls;
+};
+
+#define DAOS_ISEQ_OBJ_MULTI_FETCH	/* input fields */				\
+	((struct dtx_id)		(omfi_dti)			CRT_VAR)	\
+	((uuid_t)			(omfi_po_uuid)			CRT_VAR)	\
+	((uuid_t)			(omfi_co_hdl)			CRT_VAR)	\
+	((uuid_t)			(omfi_co_uuid)			CRT_VAR)	\
+	((uint64_t)			(omfi_epoch)			CRT_VAR)	\
+	((uint32_t)			(omfi_map_ver)			CRT_VAR)	\
+	((uint32_t)			(omfi_flags)			CRT_VAR)	\
+	((struct obj_mfetch_sub)	(omfi_subs)			CRT_ARRAY)
+
+#define DAOS_OSEQ_OBJ_MULTI_FETCH	/* output fields */				\
+	((int32_t)			(omfo_ret)			CRT_VAR)	\
+	((uint32_t)			(omfo_map_version)		CRT_VAR)	\
+	((uint64_t)			(omfo_epoch)			CRT_VAR)	\
+	((struct obj_mfetch_rep)	(omfo_reps)			CRT_ARRAY)
+
+CRT_RPC_DECLARE(obj_multi_fetch, DAOS_ISEQ_OBJ_MULTI_FETCH, DAOS_OSEQ_OBJ_MULTI_FETCH)
+
 static inline int
 obj_req_create(crt_context_t crt_ctx, crt_endpoint_t *tgt_ep, crt_opcode_t opc,
 	       crt_rpc_t **req)
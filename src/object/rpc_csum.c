@@ -35,7 +35,8 @@ proc_struct_dcs_csum_info_adv(crt_proc_t proc, crt_proc_op_t proc_op,
 		return 0;
 
 	if (FREEING(proc_op)) {
-		D_FREE(csum->cs_csum);
+		if (!crt_proc_inplace_data(proc, csum->cs_csum))
+			D_FREE(csum->cs_csum);
 		return 0;
 	}
 
@@ -71,6 +72,9 @@ proc_struct_dcs_csum_info_adv(crt_proc_t proc, crt_proc_op_t proc_op,
 	}
 
 	if (DECODING(proc_op)) {
+		if (crt_proc_inplace_decode(proc, (void **)&csum->cs_csum, csum->cs_buf_len, 1))
+			return 0;
+
 		D_ALLOC(csum->cs_csum, csum->cs_buf_len);
 		if (csum->cs_csum == NULL)
 			return -DER_NOMEM;
@@ -59,6 +59,11 @@
 
 #define EC_AGG_ITERATION_MAX	1024
 
+/* Maximum number of full stripes fetched and encoded as one batch. */
+#define EC_AGG_BATCH_MAX	64
+/* Upper bound of the data buffer of one batch, in bytes. */
+#define EC_AGG_BATCH_BUF_MAX	(32UL << 20)
+
 /* Pool/container info. Shared handle UUIDs, and service list are initialized
  * in system Xstream.
  */
@@ -97,6 +102,29 @@ struct ec_agg_stripe {
 	bool		as_has_holes;   /* stripe includes holes             */
 };
 
+/* Full stripe deferred to the batch.
+ */
+struct ec_agg_batch_stripe {
+	daos_off_t	abs_stripenum;	/* ordinal of stripe                 */
+	daos_epoch_t	abs_hi_epoch;	/* highest epoch in stripe           */
+	d_list_t	abs_dextents;	/* list of stripe's data extents     */
+};
+
+/* Full stripes of the current akey for which this target (the leader)
+ * generates the parity. They are fetched by a single VOS fetch, encoded by
+ * one offloaded ULT and their parity is written with coalesced VOS updates.
+ */
+struct ec_agg_batch {
+	struct ec_agg_batch_stripe *ab_stripes;	/* deferred stripes  */
+	daos_recx_t		   *ab_recxs;	/* recxs for VOS I/O */
+	d_iov_t			   *ab_iovs;	/* iovs for VOS I/O  */
+	d_iov_t			    ab_data;	/* data cells        */
+	d_iov_t			    ab_parity;	/* parity cells      */
+	daos_size_t		    ab_rsize;	/* record size       */
+	unsigned int		    ab_cnt;	/* # deferred stripes */
+	unsigned int		    ab_max;	/* # stripes per batch */
+};
+
 /* Aggregation state for an object.
  */
 struct ec_agg_entry {
@@ -114,6 +142,7 @@ struct ec_agg_entry {
 	daos_handle_t		 ae_obj_hdl;	 /* Object handle for cur obj */
 	struct pl_obj_layout	*ae_obj_layout;
 	struct daos_shard_loc	 ae_peer_pshards[OBJ_EC_MAX_P];
+	struct ec_agg_batch	 ae_batch;	 /* Batched full stripes      */
 	uint32_t		 ae_grp_idx;
 	uint32_t		ae_is_leader:1;
 };
@@ -147,6 +176,9 @@ struct ec_agg_stripe_ud {
 	daos_iod_t		 asu_iod;
 	d_iov_t			 asu_csum_iov;
 	struct dcs_iod_csums	*asu_iod_csums; /* iod csums */
+	daos_off_t		 asu_stripenum; /* Stripe for peer update */
+	daos_epoch_t		 asu_hi_epoch;  /* Epoch for peer update */
+	unsigned char		*asu_parity;    /* Parity for peer update */
 	ABT_eventual		 asu_eventual;  /* Eventual for offload  */
 };
 
@@ -617,129 +649,6 @@ out:
 	return rc;
 }
 
-/* Fetches the full data stripe (called when replicas form a full stripe).
- */
-static int
-agg_fetch_data_stripe(struct ec_agg_entry *entry)
-{
-	daos_iod_t		 iod = { 0 };
-	daos_recx_t		 recx = { 0 };
-	struct ec_agg_param	*agg_param;
-	unsigned int		 len = ec_age2cs(entry);
-	unsigned int		 k = ec_age2k(entry);
-	int			 rc = 0;
-
-	rc = agg_prep_sgl(entry);
-	if (rc)
-		goto out;
-
-	recx.rx_idx = entry->ae_cur_stripe.as_stripenum * k * len;
-	recx.rx_nr = k * len;
-	iod.iod_name = entry->ae_akey;
-	iod.iod_type = DAOS_IOD_ARRAY;
-	iod.iod_size = entry->ae_rsize;
-	iod.iod_nr = 1;
-	iod.iod_recxs = &recx;
-	entry->ae_sgl.sg_nr = 1;
-	entry->ae_sgl.sg_iovs[AGG_IOV_DATA].iov_len =
-						len * k * entry->ae_rsize;
-
-	agg_param = container_of(entry, struct ec_agg_param, ap_agg_entry);
-	rc = vos_obj_fetch(agg_param->ap_cont_handle, entry->ae_oid,
-			   entry->ae_cur_stripe.as_hi_epoch, 0, &entry->ae_dkey,
-			   1, &iod, &entry->ae_sgl);
-	if (rc)
-		D_ERROR(DF_UOID" vos_obj_fetch "DF_RECX" failed: "DF_RC"\n",
-			DP_UOID(entry->ae_oid), DP_RECX(recx), DP_RC(rc));
-	entry->ae_sgl.sg_nr = AGG_IOV_CNT;
-out:
-	return rc;
-}
-
-/* Xstream offload function for encoding new parity from full stripe of
- * replicas.
- */
-static void
-agg_encode_full_stripe_ult(void *arg)
-{
-	struct ec_agg_stripe_ud	*stripe_ud =
-					(struct ec_agg_stripe_ud *)arg;
-	struct ec_agg_entry	*entry = stripe_ud->asu_agg_entry;
-	unsigned int		 k = ec_age2k(entry);
-	unsigned int		 p = ec_age2p(entry);
-	unsigned int		 cell_bytes = ec_age2cs_b(entry);
-	unsigned char		*data[OBJ_EC_MAX_K];
-	unsigned char		*parity_bufs[OBJ_EC_MAX_P];
-	unsigned char		*buf;
-	int			 i, rc = 0;
-
-	buf = entry->ae_sgl.sg_iovs[AGG_IOV_DATA].iov_buf;
-	for (i = 0; i < k; i++)
-		data[i] = &buf[i * cell_bytes];
-
-	buf = entry->ae_sgl.sg_iovs[AGG_IOV_PARITY].iov_buf;
-	for (i = 0; i < p; i++)
-		parity_bufs[i] = &buf[i * cell_bytes];
-
-	ec_encode_data(cell_bytes, k, p, entry->ae_codec->ec_gftbls, data,
-		       parity_bufs);
-
-	ABT_eventual_set(stripe_ud->asu_eventual, (void *)&rc, sizeof(rc));
-}
-
-/* Encodes a full stripe. Called when replicas form a full stripe.
- */
-static int
-agg_encode_full_stripe(struct ec_agg_entry *entry)
-{
-	struct ec_agg_stripe_ud		stripe_ud = { 0 };
-	int				*status;
-	int				tid, rc = 0;
-
-	stripe_ud.asu_agg_entry = entry;
-	tid = dss_get_module_info()->dmi_tgt_id;
-	rc = ABT_eventual_create(sizeof(*status), &stripe_ud.asu_eventual);
-	if (rc != ABT_SUCCESS) {
-		rc = dss_abterr2der(rc);
-		goto out;
-	}
-	rc = dss_ult_create(agg_encode_full_stripe_ult, &stripe_ud,
-			    DSS_XS_OFFLOAD, tid, 0, NULL);
-	if (rc)
-		goto ev_out;
-
-	rc = ABT_eventual_wait(stripe_ud.asu_eventual, (void **)&status);
-	if (rc != ABT_SUCCESS) {
-		rc = dss_abterr2der(rc);
-		goto ev_out;
-	}
-	if (*status != 0)
-		rc = *status;
-	else
-		rc = 0;
-
-ev_out:
-	ABT_eventual_free(&stripe_ud.asu_eventual);
-out:
-	return rc;
-}
-
-/* Driver function for full_stripe encode. Fetches the data and then invokes
- * second function to encode the parity.
- */
-static int
-agg_encode_local_parity(struct ec_agg_entry *entry)
-{
-	int rc = 0;
-
-	rc = agg_fetch_data_stripe(entry);
-	if (rc)
-		goto out;
-	agg_encode_full_stripe(entry);
-out:
-	return rc;
-}
-
 /* True if all extents within the stripe are at a higher epoch than
  * the parity for the stripe.
  */
@@ -1336,9 +1245,8 @@ retry:
 		ec_agg_in->ea_oid.id_shard = peer_shard;
 		ec_agg_in->ea_dkey = entry->ae_dkey;
 		ec_agg_in->ea_epoch_range.epr_lo = agg_param->ap_epr.epr_lo;
-		ec_agg_in->ea_epoch_range.epr_hi =
-			entry->ae_cur_stripe.as_hi_epoch;
-		ec_agg_in->ea_stripenum = entry->ae_cur_stripe.as_stripenum;
+		ec_agg_in->ea_epoch_range.epr_hi = stripe_ud->asu_hi_epoch;
+		ec_agg_in->ea_stripenum = stripe_ud->asu_stripenum;
 		ec_agg_in->ea_map_ver =
 			agg_param->ap_pool_info.api_pool->sp_map_version;
 		ec_agg_in->ea_iod_csums.ca_arrays = NULL;
@@ -1351,8 +1259,7 @@ retry:
 			recx.rx_nr = len;
 			iod.iod_nr = 1;
 			iod.iod_recxs = &recx;
-			buf = (unsigned char *)
-				entry->ae_sgl.sg_iovs[AGG_IOV_PARITY].iov_buf;
+			buf = stripe_ud->asu_parity;
 			d_iov_set(&iov, &buf[peer * cell_b], cell_b);
 			sgl.sg_iovs = &iov;
 			sgl.sg_nr = sgl.sg_nr_out = 1;
@@ -1431,10 +1338,11 @@ out:
 }
 
 /* Invokes helper function to send the generated parity and the stripe number
- * to the peer parity target.
+ * to the peer parity target. \a parity holds the p parity cells of the stripe.
  */
 static int
-agg_peer_update(struct ec_agg_entry *entry, bool write_parity)
+agg_peer_update(struct ec_agg_entry *entry, daos_off_t stripenum, daos_epoch_t hi_epoch,
+		unsigned char *parity, bool write_parity)
 {
 	struct ec_agg_stripe_ud	 stripe_ud = { 0 };
 	struct ec_agg_param	*agg_param;
@@ -1447,8 +1355,7 @@ agg_peer_update(struct ec_agg_entry *entry, bool write_parity)
 	uint32_t		 peer;
 	int			 i, tid, rc = 0;
 
-	D_ASSERT(!write_parity ||
-		 entry->ae_sgl.sg_iovs[AGG_IOV_PARITY].iov_buf);
+	D_ASSERT(!write_parity || parity != NULL);
 
 	rc = agg_get_obj_handle(entry);
 	if (rc) {
@@ -1485,6 +1392,9 @@ agg_peer_update(struct ec_agg_entry *entry, bool write_parity)
 
 	stripe_ud.asu_write_par = write_parity;
 	stripe_ud.asu_agg_entry = entry;
+	stripe_ud.asu_stripenum = stripenum;
+	stripe_ud.asu_hi_epoch = hi_epoch;
+	stripe_ud.asu_parity = parity;
 
 	rc = ABT_eventual_create(sizeof(*status), &stripe_ud.asu_eventual);
 	if (rc != ABT_SUCCESS) {
@@ -1802,6 +1712,361 @@ out:
 	return rc;
 }
 
+/* Frees the extents of the batched stripes and empties the batch.
+ */
+static void
+agg_batch_discard(struct ec_agg_batch *batch)
+{
+	struct ec_agg_extent	*ext, *ext_tmp;
+	unsigned int		 i;
+
+	for (i = 0; i < batch->ab_cnt; i++) {
+		d_list_for_each_entry_safe(ext, ext_tmp,
+					   &batch->ab_stripes[i].abs_dextents,
+					   ae_link) {
+			d_list_del(&ext->ae_link);
+			D_FREE(ext);
+		}
+	}
+	batch->ab_cnt = 0;
+}
+
+static void
+agg_batch_fini(struct ec_agg_batch *batch)
+{
+	agg_batch_discard(batch);
+	D_FREE(batch->ab_stripes);
+	D_FREE(batch->ab_recxs);
+	D_FREE(batch->ab_iovs);
+	D_FREE(batch->ab_data.iov_buf);
+	D_FREE(batch->ab_parity.iov_buf);
+	memset(batch, 0, sizeof(*batch));
+}
+
+/* Allocates an aligned batch buffer of at least \a len bytes.
+ */
+static int
+agg_batch_alloc_buf(d_iov_t *iov, size_t len)
+{
+	void	*buf;
+
+	if (iov->iov_buf_len >= len)
+		return 0;
+
+	D_ALIGNED_ALLOC_NZ(buf, 32, len);
+	if (buf == NULL)
+		return -DER_NOMEM;
+	D_FREE(iov->iov_buf);
+	d_iov_set(iov, buf, len);
+	return 0;
+}
+
+/* Sizes the batch for the object class and record size of the current akey.
+ * Called when the first stripe is added to an empty batch.
+ */
+static int
+agg_batch_prep(struct ec_agg_entry *entry)
+{
+	struct ec_agg_batch	*batch = &entry->ae_batch;
+	uint64_t		 cell_b = ec_age2cs_b(entry);
+	uint64_t		 stripe_b = ec_age2k(entry) * cell_b;
+	unsigned int		 i;
+	int			 rc;
+
+	D_ASSERT(batch->ab_cnt == 0);
+	if (batch->ab_stripes == NULL) {
+		D_ALLOC_ARRAY(batch->ab_stripes, EC_AGG_BATCH_MAX);
+		if (batch->ab_stripes == NULL)
+			return -DER_NOMEM;
+		for (i = 0; i < EC_AGG_BATCH_MAX; i++)
+			D_INIT_LIST_HEAD(&batch->ab_stripes[i].abs_dextents);
+	}
+	if (batch->ab_recxs == NULL) {
+		D_ALLOC_ARRAY(batch->ab_recxs, EC_AGG_BATCH_MAX);
+		if (batch->ab_recxs == NULL)
+			return -DER_NOMEM;
+	}
+	if (batch->ab_iovs == NULL) {
+		D_ALLOC_ARRAY(batch->ab_iovs, EC_AGG_BATCH_MAX);
+		if (batch->ab_iovs == NULL)
+			return -DER_NOMEM;
+	}
+
+	batch->ab_max = min(EC_AGG_BATCH_MAX, max(EC_AGG_BATCH_BUF_MAX / stripe_b, 1));
+	rc = agg_batch_alloc_buf(&batch->ab_data, batch->ab_max * stripe_b);
+	if (rc)
+		return rc;
+	rc = agg_batch_alloc_buf(&batch->ab_parity,
+				 batch->ab_max * ec_age2p(entry) * cell_b);
+	if (rc)
+		return rc;
+
+	batch->ab_rsize = entry->ae_rsize;
+	return 0;
+}
+
+/* Fetches the replicas of all batched stripes with a single VOS fetch, so
+ * that the underlying media reads of the batch are in flight together.
+ *
+ * Fetching at the highest epoch of the batch returns the same data as
+ * fetching each stripe at its own highest epoch: every visible extent of the
+ * akey up to the aggregation upper bound has been accounted to its stripe by
+ * the iterator, and the replicas of a full stripe cover all of it.
+ */
+static int
+agg_batch_fetch(struct ec_agg_param *agg_param, struct ec_agg_entry *entry)
+{
+	struct ec_agg_batch	*batch = &entry->ae_batch;
+	unsigned char		*buf = batch->ab_data.iov_buf;
+	unsigned int		 len = ec_age2cs(entry);
+	unsigned int		 k = ec_age2k(entry);
+	uint64_t		 stripe_b = k * len * batch->ab_rsize;
+	daos_epoch_t		 epoch = 0;
+	daos_iod_t		 iod = { 0 };
+	d_sg_list_t		 sgl = { 0 };
+	unsigned int		 i;
+	int			 rc;
+
+	for (i = 0; i < batch->ab_cnt; i++) {
+		batch->ab_recxs[i].rx_idx = batch->ab_stripes[i].abs_stripenum * k * len;
+		batch->ab_recxs[i].rx_nr = k * len;
+		d_iov_set(&batch->ab_iovs[i], &buf[i * stripe_b], stripe_b);
+		epoch = max(epoch, batch->ab_stripes[i].abs_hi_epoch);
+	}
+
+	iod.iod_name = entry->ae_akey;
+	iod.iod_type = DAOS_IOD_ARRAY;
+	iod.iod_size = batch->ab_rsize;
+	iod.iod_nr = batch->ab_cnt;
+	iod.iod_recxs = batch->ab_recxs;
+	sgl.sg_nr = batch->ab_cnt;
+	sgl.sg_iovs = batch->ab_iovs;
+
+	rc = vos_obj_fetch(agg_param->ap_cont_handle, entry->ae_oid, epoch, 0,
+			   &entry->ae_dkey, 1, &iod, &sgl);
+	if (rc)
+		D_ERROR(DF_UOID" vos_obj_fetch of %u stripes failed: "DF_RC"\n",
+			DP_UOID(entry->ae_oid), batch->ab_cnt, DP_RC(rc));
+	return rc;
+}
+
+/* Xstream offload function encoding the parity of all batched stripes.
+ */
+static int
+agg_batch_encode_ult(void *arg)
+{
+	struct ec_agg_entry	*entry = arg;
+	struct ec_agg_batch	*batch = &entry->ae_batch;
+	unsigned int		 k = ec_age2k(entry);
+	unsigned int		 p = ec_age2p(entry);
+	uint64_t		 cell_b = ec_age2cs(entry) * batch->ab_rsize;
+	unsigned char		*dbuf = batch->ab_data.iov_buf;
+	unsigned char		*pbuf = batch->ab_parity.iov_buf;
+	unsigned char		*data[OBJ_EC_MAX_K];
+	unsigned char		*parity_bufs[OBJ_EC_MAX_P];
+	unsigned int		 i, j;
+
+	for (i = 0; i < batch->ab_cnt; i++) {
+		for (j = 0; j < k; j++)
+			data[j] = &dbuf[(i * k + j) * cell_b];
+		for (j = 0; j < p; j++)
+			parity_bufs[j] = &pbuf[(i * p + j) * cell_b];
+		ec_encode_data(cell_b, k, p, entry->ae_codec->ec_gftbls, data,
+			       parity_bufs);
+	}
+
+	return 0;
+}
+
+/* Writes the local parity of \a nr adjacent batched stripes, starting from
+ * \a start, with one VOS update, then removes their replicas. The stripes
+ * share the same highest epoch.
+ */
+static int
+agg_batch_update_vos(struct ec_agg_param *agg_param, struct ec_agg_entry *entry,
+		     unsigned int start, unsigned int nr)
+{
+	struct ec_agg_batch		*batch = &entry->ae_batch;
+	struct ec_agg_batch_stripe	*bs = &batch->ab_stripes[start];
+	unsigned char			*buf = batch->ab_parity.iov_buf;
+	uint32_t			 len = ec_age2cs(entry);
+	uint32_t			 p = ec_age2p(entry);
+	uint32_t			 pidx = ec_age2pidx(entry);
+	uint64_t			 cell_b = len * batch->ab_rsize;
+	struct daos_csummer		*csummer;
+	struct dcs_iod_csums		*iod_csums = NULL;
+	struct ec_agg_extent		*ext;
+	daos_epoch_range_t		 epoch_range = { 0 };
+	daos_recx_t			 recx = { 0 };
+	daos_iod_t			 iod = { 0 };
+	d_sg_list_t			 sgl = { 0 };
+	unsigned int			 i;
+	int				 rc;
+
+	for (i = 0; i < nr; i++)
+		d_iov_set(&batch->ab_iovs[i], &buf[((start + i) * p + pidx) * cell_b],
+			  cell_b);
+	sgl.sg_iovs = batch->ab_iovs;
+	sgl.sg_nr = nr;
+	recx.rx_idx = (bs->abs_stripenum * len) | PARITY_INDICATOR;
+	recx.rx_nr = nr * len;
+	iod.iod_nr = 1;
+	iod.iod_size = batch->ab_rsize;
+	iod.iod_name = entry->ae_akey;
+	iod.iod_type = DAOS_IOD_ARRAY;
+	iod.iod_recxs = &recx;
+
+	csummer = ec_agg_param2csummer(agg_param);
+	if (csummer != NULL) {
+		rc = daos_csummer_calc_iods(csummer, &sgl, &iod, NULL, 1, false,
+					    NULL, 0, &iod_csums);
+		if (rc) {
+			D_ERROR("daos_csummer_calc_iods failed: "DF_RC"\n", DP_RC(rc));
+			return rc;
+		}
+		D_ASSERT(iod_csums != NULL);
+	}
+	rc = vos_obj_update(agg_param->ap_cont_handle, entry->ae_oid,
+			    bs->abs_hi_epoch, 0, 0, &entry->ae_dkey, 1, &iod,
+			    iod_csums, &sgl);
+	if (csummer != NULL && iod_csums != NULL)
+		daos_csummer_free_ic(csummer, &iod_csums);
+	if (rc) {
+		D_ERROR("vos_obj_update failed: "DF_RC"\n", DP_RC(rc));
+		return rc;
+	}
+
+	for (i = start; i < start + nr; i++) {
+		d_list_for_each_entry(ext, &batch->ab_stripes[i].abs_dextents,
+				      ae_link) {
+			int err;
+
+			epoch_range.epr_lo = epoch_range.epr_hi = ext->ae_epoch;
+			err = vos_obj_array_remove(agg_param->ap_cont_handle,
+						   entry->ae_oid, &epoch_range,
+						   &entry->ae_dkey,
+						   &entry->ae_akey,
+						   &ext->ae_recx);
+			if (err)
+				D_ERROR("array_remove fails: "DF_RC"\n", DP_RC(err));
+			if (!rc && err)
+				rc = err;
+		}
+	}
+
+	return rc;
+}
+
+/* Processes the batched full stripes: fetches all replicas, encodes all the
+ * parity on the offload xstream, pushes the remote parity to the peer parity
+ * targets, and writes the local parity of adjacent stripes with the same
+ * epoch in a single VOS update.
+ */
+static int
+agg_batch_flush(struct ec_agg_param *agg_param, struct ec_agg_entry *entry)
+{
+	struct ec_agg_batch		*batch = &entry->ae_batch;
+	struct ec_agg_batch_stripe	*bs, *next;
+	uint32_t			 p = ec_age2p(entry);
+	uint64_t			 cell_b = ec_age2cs(entry) * batch->ab_rsize;
+	unsigned char			*parity = batch->ab_parity.iov_buf;
+	unsigned int			 i, start = 0;
+	int				 rc;
+
+	if (batch->ab_cnt == 0)
+		return 0;
+
+	rc = agg_batch_fetch(agg_param, entry);
+	if (rc)
+		goto out;
+
+	rc = dss_offload_exec(agg_batch_encode_ult, entry);
+	if (rc) {
+		D_ERROR(DF_UOID" encode of %u stripes failed: "DF_RC"\n",
+			DP_UOID(entry->ae_oid), batch->ab_cnt, DP_RC(rc));
+		goto out;
+	}
+
+	for (i = 0; i < batch->ab_cnt; i++) {
+		bs = &batch->ab_stripes[i];
+		if (p > 1) {
+			/* offload of ds_obj_update to push remote parity */
+			rc = agg_peer_update(entry, bs->abs_stripenum, bs->abs_hi_epoch,
+					     &parity[i * p * cell_b], true);
+			if (rc) {
+				D_ERROR("agg_peer_update fail: "DF_RC"\n", DP_RC(rc));
+				break;
+			}
+		}
+
+		next = i + 1 < batch->ab_cnt ? &batch->ab_stripes[i + 1] : NULL;
+		if (next != NULL && next->abs_stripenum == bs->abs_stripenum + 1 &&
+		    next->abs_hi_epoch == bs->abs_hi_epoch)
+			continue;
+
+		rc = agg_batch_update_vos(agg_param, entry, start, i + 1 - start);
+		if (rc) {
+			D_ERROR("agg_batch_update_vos failed: "DF_RC"\n", DP_RC(rc));
+			goto out;
+		}
+		start = i + 1;
+	}
+
+	/* The peers of the stripes prior to the failed one have got their
+	 * parity, finish them locally as well.
+	 */
+	if (rc != 0 && i > start) {
+		int err;
+
+		err = agg_batch_update_vos(agg_param, entry, start, i - start);
+		if (err)
+			D_ERROR("agg_batch_update_vos failed: "DF_RC"\n", DP_RC(err));
+	}
+out:
+	agg_batch_discard(batch);
+	return rc;
+}
+
+/* Moves the current full stripe into the batch, the batch is processed once
+ * it is full, or at the end of the akey.
+ */
+static int
+agg_batch_add(struct ec_agg_param *agg_param, struct ec_agg_entry *entry)
+{
+	struct ec_agg_batch		*batch = &entry->ae_batch;
+	struct ec_agg_batch_stripe	*bs;
+	int				 rc;
+
+	if (batch->ab_cnt > 0 && batch->ab_rsize != entry->ae_rsize) {
+		rc = agg_batch_flush(agg_param, entry);
+		if (rc)
+			return rc;
+	}
+
+	if (batch->ab_cnt == 0) {
+		rc = agg_batch_prep(entry);
+		if (rc)
+			return rc;
+	}
+
+	bs = &batch->ab_stripes[batch->ab_cnt++];
+	bs->abs_stripenum = entry->ae_cur_stripe.as_stripenum;
+	bs->abs_hi_epoch = entry->ae_cur_stripe.as_hi_epoch;
+	d_list_splice_init(&entry->ae_cur_stripe.as_dextents, &bs->abs_dextents);
+
+	entry->ae_cur_stripe.as_extent_cnt = 0;
+	entry->ae_cur_stripe.as_offset = 0U;
+	entry->ae_cur_stripe.as_hi_epoch = 0UL;
+	entry->ae_cur_stripe.as_lo_epoch = 0UL;
+	entry->ae_cur_stripe.as_stripe_fill = 0;
+	entry->ae_cur_stripe.as_has_holes = false;
+
+	if (batch->ab_cnt == batch->ab_max)
+		return agg_batch_flush(agg_param, entry);
+
+	return 0;
+}
+
 /* Process the prior stripe. Invoked when the iterator has moved to the first
  * extent in the subsequent.
  */
@@ -1861,7 +2126,9 @@ agg_process_stripe(struct ec_agg_param *agg_param, struct ec_agg_entry *entry)
 	 */
 	if (ec_age_stripe_full(entry, ec_age_with_parity(entry))) {
 		if (entry->ae_is_leader) {
-			rc = agg_encode_local_parity(entry);
+			/* fetched, encoded and written with the batch */
+			update_vos = false;
+			rc = agg_batch_add(agg_param, entry);
 		} else {
 			update_vos = false;
 			agg_param->ap_min_unagg_eph = min(agg_param->ap_min_unagg_eph,
@@ -1894,8 +2161,14 @@ out:
 		rc = agg_process_holes(entry);
 	} else if (update_vos && rc == 0) {
 		if (ec_age2p(entry) > 1)  {
+			unsigned char *parity = NULL;
+
+			if (write_parity)
+				parity = entry->ae_sgl.sg_iovs[AGG_IOV_PARITY].iov_buf;
 			/* offload of ds_obj_update to push remote parity */
-			rc = agg_peer_update(entry, write_parity);
+			rc = agg_peer_update(entry, entry->ae_cur_stripe.as_stripenum,
+					     entry->ae_cur_stripe.as_hi_epoch, parity,
+					     write_parity);
 			if (rc)
 				D_ERROR("agg_peer_update fail: "DF_RC"\n",
 					DP_RC(rc));
@@ -2064,6 +2337,10 @@ agg_akey_post(daos_handle_t ih, struct ec_agg_param *agg_param,
 		agg_entry->ae_cur_stripe.as_offset	= 0U;
 	}
 
+	rc = agg_batch_flush(agg_param, agg_entry);
+	if (rc)
+		D_ERROR("Process stripe batch returned "DF_RC"\n", DP_RC(rc));
+
 	return rc;
 }
 
@@ -2153,6 +2430,7 @@ static void
 agg_reset_dkey_entry(struct ec_agg_entry *agg_entry, vos_iter_entry_t *entry)
 {
 	agg_clear_extents(agg_entry);
+	agg_batch_discard(&agg_entry->ae_batch);
 	agg_reset_pos(VOS_ITER_AKEY, agg_entry);
 
 	agg_entry->ae_cur_stripe.as_stripenum	= 0UL;
@@ -2534,6 +2812,7 @@ ec_agg_param_fini(struct ds_cont_child *cont, struct ec_agg_param *agg_param)
 
 	D_ASSERT(agg_entry->ae_sgl.sg_nr == AGG_IOV_CNT || agg_entry->ae_sgl.sg_nr == 0);
 	d_sgl_fini(&agg_entry->ae_sgl, true);
+	agg_batch_fini(&agg_entry->ae_batch);
 	if (daos_handle_is_valid(agg_param->ap_pool_info.api_pool_hdl))
 		dsc_pool_close(agg_param->ap_pool_info.api_pool_hdl);
 
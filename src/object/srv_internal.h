@@ -25,6 +25,23 @@
 
 extern struct dss_module_key obj_module_key;
 
+/* Default I/O size from which checksum calculation and verification are
+ * offloaded to the helper xstream.
+ */
+#define OBJ_CSUM_OFFLOAD_MIN_DEF	(64 << 10)
+extern unsigned int obj_csum_offload_min;
+/* Max number of csummer copies cached by each xstream for the offloaded work */
+#define OBJ_CSUMMER_CACHE_MAX		8
+
+/* Per-opcode latency quantiles, shared by all the targets of the engine */
+extern struct d_tm_node_t *obj_op_lat_quantile[OBJ_PROTO_CLI_COUNT];
+
+/* Stage timings of 1 in DAOS_OBJ_PROF_SAMPLE requests are recorded, 0 to disable */
+#define OBJ_PROF_SAMPLE_DEF		1024
+extern unsigned int obj_prof_sample;
+/* Per-opcode rings of the sampled stage timings, shared by all the targets */
+extern struct d_tm_node_t *obj_op_prof_ring[OBJ_PROTO_CLI_COUNT];
+
 /* Per pool attached to the migrate tls(per xstream) */
 struct migrate_pool_tls {
 	/* POOL UUID and pool to be migrated */
@@ -198,6 +215,13 @@ struct obj_tls {
 
 	struct d_tm_node_t	*ot_update_bio_lat[NR_LATENCY_BUCKETS];
 	struct d_tm_node_t	*ot_fetch_bio_lat[NR_LATENCY_BUCKETS];
+
+	/** Requests since the last one sampled for stage timings */
+	uint32_t		ot_prof_cnt;
+
+	/** Idle csummer copies of the offloaded checksum work, see obj_csum_offload() */
+	struct daos_csummer	*ot_csummers[OBJ_CSUMMER_CACHE_MAX];
+	int			 ot_csummer_nr;
 };
 
 static inline struct obj_tls *
@@ -228,8 +252,34 @@ enum latency_type {
 	BULK_LATENCY,
 	BIO_LATENCY,
 	VOS_LATENCY,
+	REPLY_LATENCY,
 };
 
+/** Account \a latency (ns) to a stage of the request if it is sampled */
+static inline void
+obj_ioc_prof_add(struct obj_io_context *ioc, uint32_t type, uint64_t latency)
+{
+	if (likely(!ioc->ioc_prof))
+		return;
+
+	switch (type) {
+	case BULK_LATENCY:
+		ioc->ioc_bulk_time += latency;
+		break;
+	case BIO_LATENCY:
+		ioc->ioc_bio_time += latency;
+		break;
+	case VOS_LATENCY:
+		ioc->ioc_vos_time += latency;
+		break;
+	case REPLY_LATENCY:
+		ioc->ioc_reply_time += latency;
+		break;
+	default:
+		D_ASSERT(0);
+	}
+}
+
 static inline void
 obj_update_latency(uint32_t opc, uint32_t type, uint64_t latency, uint64_t io_size)
 {
@@ -309,6 +359,7 @@ void ds_obj_punch_handler(crt_rpc_t *rpc);
 void ds_obj_tgt_punch_handler(crt_rpc_t *rpc);
 void ds_obj_query_key_handler(crt_rpc_t *rpc);
 void ds_obj_coll_query_handler(crt_rpc_t *rpc);
+void ds_obj_multi_fetch_handler(crt_rpc_t *rpc);
 void ds_obj_sync_handler(crt_rpc_t *rpc);
 void ds_obj_migrate_handler(crt_rpc_t *rpc);
 void ds_obj_ec_agg_handler(crt_rpc_t *rpc);
@@ -15,6 +15,41 @@
 #include "obj_rpc.h"
 #include "srv_internal.h"
 
+static void
+obj_quantile_tm_init(void)
+{
+	uint32_t	opc;
+	int		rc;
+
+	/** per-opcode tail latency of the whole engine, merged over the xstreams */
+	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
+		rc = d_tm_add_metric(&obj_op_lat_quantile[opc], D_TM_QUANTILE,
+				     "object RPC processing time quantiles", "us",
+				     "io/ops/%s/latency_quantile", obj_opc_to_str(opc));
+		if (rc)
+			D_WARN("Failed to create latency quantile sensor: "DF_RC"\n",
+			       DP_RC(rc));
+	}
+}
+
+static void
+obj_prof_tm_init(void)
+{
+	uint32_t	opc;
+	int		rc;
+
+	/** per-opcode stage timings of the sampled requests of the whole engine */
+	for (opc = 0; opc < OBJ_PROTO_CLI_COUNT; opc++) {
+		rc = d_tm_add_metric(&obj_op_prof_ring[opc], D_TM_RING,
+				     "sampled object RPC stage timings: total, decode, queue, "
+				     "vos, bio, bulk, reply, I/O size (bytes)", "us",
+				     "io/ops/%s/stages", obj_opc_to_str(opc));
+		if (rc)
+			D_WARN("Failed to create stage timings sensor: "DF_RC"\n",
+			       DP_RC(rc));
+	}
+}
+
 /**
  * Switch of enable DTX or not, enabled by default.
  */
@@ -37,6 +72,17 @@ obj_mod_init(void)
 		goto out_class;
 	}
 
+	d_getenv_uint("DAOS_OBJ_CSUM_OFFLOAD_MIN", &obj_csum_offload_min);
+	D_INFO("Checksum offload threshold is %u bytes\n", obj_csum_offload_min);
+
+	obj_quantile_tm_init();
+
+	d_getenv_uint("DAOS_OBJ_PROF_SAMPLE", &obj_prof_sample);
+	if (obj_prof_sample != 0) {
+		D_INFO("Stage timings of 1 in %u requests are sampled\n", obj_prof_sample);
+		obj_prof_tm_init();
+	}
+
 	return 0;
 
 out_class:
@@ -67,12 +113,12 @@ obj_mod_fini(void)
 	.dr_corpc_ops = e,	\
 },
 
-static struct daos_rpc_handler obj_handlers_v9[] = {
-	OBJ_PROTO_CLI_RPC_LIST(9)
+static struct daos_rpc_handler obj_handlers_v10[] = {
+	OBJ_PROTO_CLI_RPC_LIST_V10
 };
 
-static struct daos_rpc_handler obj_handlers_v10[] = {
-	OBJ_PROTO_CLI_RPC_LIST(10)
+static struct daos_rpc_handler obj_handlers_v11[] = {
+	OBJ_PROTO_CLI_RPC_LIST
 };
 
 #undef X
@@ -200,6 +246,9 @@ obj_tls_fini(int tags, void *data)
 
 	d_sgl_fini(&tls->ot_echo_sgl, true);
 
+	while (tls->ot_csummer_nr > 0)
+		daos_csummer_destroy(&tls->ot_csummers[--tls->ot_csummer_nr]);
+
 	D_FREE(tls);
 }
 
@@ -219,13 +268,6 @@ obj_get_req_attr(crt_rpc_t *rpc, struct sched_req_attr *attr)
 
 	D_ASSERT(proto_ver == DAOS_OBJ_VERSION || proto_ver == DAOS_OBJ_VERSION - 1);
 
-	/*
-	 * Proto v9 doesn't support hint return cart timeout for retry
-	 * skip RPC rejections for them.
-	 */
-	if (proto_ver == 9)
-		attr->sra_flags |= SCHED_REQ_FL_NO_REJECT;
-
 	/* Extract hint from RPC */
 	attr->sra_enqueue_id = 0;
 
@@ -234,15 +276,17 @@ obj_get_req_attr(crt_rpc_t *rpc, struct sched_req_attr *attr)
 	case DAOS_OBJ_RPC_TGT_UPDATE:
 	case DAOS_OBJ_RPC_FETCH: {
 		struct obj_rw_in	*orw = crt_req_get(rpc);
+		struct obj_rw_v10_in	*orw_v10 = NULL;
 
 		if (proto_ver >= 10) {
-			struct obj_rw_v10_in *orw_v10 = crt_req_get(rpc);
-
+			orw_v10 = crt_req_get(rpc);
 			attr->sra_enqueue_id = orw_v10->orw_comm_in.req_in_enqueue_id;
 		}
 		sched_req_attr_init(attr, obj_rpc_is_update(rpc) ?
 				    SCHED_REQ_UPDATE : SCHED_REQ_FETCH,
 				    &orw->orw_pool_uuid);
+		if (orw_v10 != NULL)
+			attr->sra_jobid = orw_v10->orw_comm_in.req_in_jobid;
 		break;
 	}
 	case DAOS_OBJ_RPC_MIGRATE: {
@@ -349,6 +393,12 @@ obj_get_req_attr(crt_rpc_t *rpc, struct sched_req_attr *attr)
 		sched_req_attr_init(attr, SCHED_REQ_FETCH, &ocqi->ocqi_po_uuid);
 		break;
 	}
+	case DAOS_OBJ_RPC_MULTI_FETCH: {
+		struct obj_multi_fetch_in *omfi = crt_req_get(rpc);
+
+		sched_req_attr_init(attr, SCHED_REQ_FETCH, &omfi->omfi_po_uuid);
+		break;
+	}
 	default:
 		/* Other requests will not be queued, see dss_rpc_hdlr() */
 		rc = -DER_NOSYS;
@@ -365,8 +415,8 @@ obj_set_req(crt_rpc_t *rpc, struct sched_req_attr *attr)
 	int	proto_ver = crt_req_get_proto_ver(rpc);
 	int	rc = -DER_OVERLOAD_RETRY;
 
-	/* Old protocol RPCs won't be rejected. */
-	D_ASSERT(proto_ver == DAOS_OBJ_VERSION);
+	/* Both supported protocols return the retry hint to the client. */
+	D_ASSERT(proto_ver == DAOS_OBJ_VERSION || proto_ver == DAOS_OBJ_VERSION - 1);
 
 	switch (opc) {
 	case DAOS_OBJ_RPC_UPDATE:
@@ -460,6 +510,13 @@ obj_set_req(crt_rpc_t *rpc, struct sched_req_attr *attr)
 		ocqo->ocqo_ret = -DER_OVERLOAD_RETRY;
 		break;
 	}
+	case DAOS_OBJ_RPC_MULTI_FETCH: {
+		struct obj_multi_fetch_out *omfo = crt_reply_get(rpc);
+
+		/* The client will fall back to regular fetch for each sub-request. */
+		omfo->omfo_ret = -DER_OVERLOAD_RETRY;
+		break;
+	}
 	default:
 		/* Other requests will not be queued, see dss_rpc_hdlr() */
 		rc = -DER_TIMEDOUT;
@@ -583,9 +640,9 @@ struct dss_module obj_module = {
 	.sm_init	= obj_mod_init,
 	.sm_fini	= obj_mod_fini,
 	.sm_proto_count	= 2,
-	.sm_proto_fmt	= {&obj_proto_fmt_v9, &obj_proto_fmt_v10},
-	.sm_cli_count	= {OBJ_PROTO_CLI_COUNT, OBJ_PROTO_CLI_COUNT},
-	.sm_handlers	= {obj_handlers_v9, obj_handlers_v10},
+	.sm_proto_fmt	= {&obj_proto_fmt_v10, &obj_proto_fmt_v11},
+	.sm_cli_count	= {OBJ_PROTO_CLI_COUNT_V10, OBJ_PROTO_CLI_COUNT},
+	.sm_handlers	= {obj_handlers_v10, obj_handlers_v11},
 	.sm_key		= &obj_module_key,
 	.sm_mod_ops	= &ds_obj_mod_ops,
 	.sm_metrics	= &obj_metrics,
@@ -29,6 +29,14 @@
 #include "obj_rpc.h"
 #include "srv_internal.h"
 
+/* I/O size in bytes from which the checksum work is offloaded, 0 to disable */
+unsigned int obj_csum_offload_min = OBJ_CSUM_OFFLOAD_MIN_DEF;
+
+struct d_tm_node_t *obj_op_lat_quantile[OBJ_PROTO_CLI_COUNT];
+
+unsigned int obj_prof_sample = OBJ_PROF_SAMPLE_DEF;
+struct d_tm_node_t *obj_op_prof_ring[OBJ_PROTO_CLI_COUNT];
+
 static int
 obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
 		    struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
@@ -134,9 +142,12 @@ obj_rw_complete(crt_rpc_t *rpc, struct obj_io_context *ioc,
 			rc = vos_update_end(ioh, ioc->ioc_map_ver,
 					    &orwi->orw_dkey, status,
 					    &ioc->ioc_io_size, dth);
-			if (rc == 0)
-				obj_update_latency(ioc->ioc_opc, VOS_LATENCY,
-						   daos_get_ntime() - time, ioc->ioc_io_size);
+			if (rc == 0) {
+				time = daos_get_ntime() - time;
+				obj_update_latency(ioc->ioc_opc, VOS_LATENCY, time,
+						   ioc->ioc_io_size);
+				obj_ioc_prof_add(ioc, VOS_LATENCY, time);
+			}
 		} else {
 			rc = vos_fetch_end(ioh, &ioc->ioc_io_size, status);
 		}
@@ -163,6 +174,7 @@ obj_rw_reply(crt_rpc_t *rpc, int status, uint64_t epoch,
 	     struct obj_io_context *ioc)
 {
 	struct obj_rw_out	*orwo = crt_reply_get(rpc);
+	uint64_t		 time = 0;
 	int			 rc;
 	int			 i;
 
@@ -184,9 +196,13 @@ obj_rw_reply(crt_rpc_t *rpc, int status, uint64_t epoch,
 		ioc->ioc_map_ver, orwo->orw_epoch, status);
 
 	if (!ioc->ioc_lost_reply) {
+		if (unlikely(ioc->ioc_prof))
+			time = daos_get_ntime();
 		rc = crt_reply_send(rpc);
 		if (rc != 0)
 			D_ERROR("send reply failed: "DF_RC"\n", DP_RC(rc));
+		if (unlikely(ioc->ioc_prof))
+			obj_ioc_prof_add(ioc, REPLY_LATENCY, daos_get_ntime() - time);
 	} else {
 		D_WARN("lost reply rpc %p\n", rpc);
 	}
@@ -870,31 +886,116 @@ get_iod_csum(struct dcs_iod_csums *iod_csums, int i)
 	return &iod_csums[i];
 }
 
+/* Arguments of the checksum work of one I/O, see obj_csum_offload(). */
+struct obj_csum_args {
+	daos_obj_id_t		 ca_oid;
+	daos_handle_t		 ca_ioh;
+	daos_iod_t		*ca_iods;
+	struct dcs_iod_csums	*ca_iod_csums;
+	struct bio_desc		*ca_biod;
+	struct daos_csummer	*ca_csummer;
+	uint8_t			*ca_skips;
+	uint32_t		 ca_iods_nr;
+};
+
+/*
+ * Get a copy of the container csummer \a csummer for an offloaded task. The
+ * copies are cached by the xstream, which avoids to allocate and initialize
+ * the hash context for every I/O.
+ */
+static struct daos_csummer *
+obj_csummer_get(struct daos_csummer *csummer)
+{
+	struct obj_tls		*tls = obj_tls_get();
+	struct daos_csummer	*copy;
+	int			 i;
+
+	for (i = 0; i < tls->ot_csummer_nr; i++) {
+		copy = tls->ot_csummers[i];
+		if (copy->dcs_algo != csummer->dcs_algo ||
+		    copy->dcs_chunk_size != csummer->dcs_chunk_size ||
+		    copy->dcs_srv_verify != csummer->dcs_srv_verify)
+			continue;
+
+		tls->ot_csummers[i] = tls->ot_csummers[--tls->ot_csummer_nr];
+		copy->dcs_skip_key_calc = csummer->dcs_skip_key_calc;
+		copy->dcs_skip_key_verify = csummer->dcs_skip_key_verify;
+		copy->dcs_skip_data_verify = csummer->dcs_skip_data_verify;
+		return copy;
+	}
+
+	return daos_csummer_copy(csummer);
+}
+
+static void
+obj_csummer_put(struct daos_csummer *copy)
+{
+	struct obj_tls	*tls = obj_tls_get();
+
+	if (tls->ot_csummer_nr < OBJ_CSUMMER_CACHE_MAX)
+		tls->ot_csummers[tls->ot_csummer_nr++] = copy;
+	else
+		daos_csummer_destroy(&copy);
+}
+
+/**
+ * Runs the checksum work of one I/O. The work of all iods is executed by a
+ * single offload task on the helper xstream, as long as the I/O is large
+ * enough to amortize the ULT creation, otherwise it is executed in place.
+ */
 static int
-csum_add2iods(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
-	      uint8_t *skips, struct daos_csummer *csummer,
-	      struct dcs_iod_csums *iod_csums, daos_unit_oid_t oid,
-	      daos_key_t *dkey)
+obj_csum_offload(int (*func)(void *), struct obj_csum_args *args)
+{
+	struct daos_csummer	*csummer = args->ca_csummer;
+	struct dss_acc_task	 task = { 0 };
+	int			 rc;
+
+	if (obj_csum_offload_min == 0 ||
+	    daos_iods_len(args->ca_iods, args->ca_iods_nr) < obj_csum_offload_min)
+		return func(args);
+
+	/* The hash context of the container csummer can't be shared with the
+	 * ULTs running concurrently on the target xstream.
+	 */
+	args->ca_csummer = obj_csummer_get(csummer);
+	if (args->ca_csummer == NULL) {
+		args->ca_csummer = csummer;
+		return -DER_NOMEM;
+	}
+
+	task.at_offload_type = DSS_OFFLOAD_ULT;
+	task.at_params = args;
+	task.at_cb = func;
+	rc = dss_acc_offload(&task);
+
+	obj_csummer_put(args->ca_csummer);
+	args->ca_csummer = csummer;
+	return rc;
+}
+
+static int
+csum_add2iods_ult(void *arg)
 {
+	struct obj_csum_args	*args = arg;
 	int	 rc = 0;
 	uint32_t biov_csums_idx = 0;
 	size_t	 biov_csums_used = 0;
 	int	 i, idx;
 
-	struct bio_desc *biod = vos_ioh2desc(ioh);
-	struct dcs_ci_list *csum_infos = vos_ioh2ci(ioh);
-	uint32_t csum_info_nr = vos_ioh2ci_nr(ioh);
+	struct bio_desc *biod = vos_ioh2desc(args->ca_ioh);
+	struct dcs_ci_list *csum_infos = vos_ioh2ci(args->ca_ioh);
+	uint32_t csum_info_nr = vos_ioh2ci_nr(args->ca_ioh);
 
-	for (i = 0, idx = 0; i < iods_nr; i++) {
-		if (skips != NULL && isset(skips, i))
+	for (i = 0, idx = 0; i < args->ca_iods_nr; i++) {
+		if (args->ca_skips != NULL && isset(args->ca_skips, i))
 			continue;
 		if (biov_csums_idx >= csum_info_nr)
 			break; /** no more csums to add */
 		csum_infos->dcl_csum_offset += biov_csums_used;
 		rc = ds_csum_add2iod(
-			&iods[i], csummer,
+			&args->ca_iods[i], args->ca_csummer,
 			bio_iod_sgl(biod, idx), csum_infos,
-			&biov_csums_used, get_iod_csum(iod_csums, i));
+			&biov_csums_used, get_iod_csum(args->ca_iod_csums, i));
 		idx++;
 		if (rc != 0) {
 			D_ERROR("Failed to add csum for iod\n");
@@ -906,6 +1007,25 @@ csum_add2iods(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
 	return rc;
 }
 
+static int
+csum_add2iods(daos_handle_t ioh, daos_iod_t *iods, uint32_t iods_nr,
+	      uint8_t *skips, struct daos_csummer *csummer,
+	      struct dcs_iod_csums *iod_csums, daos_unit_oid_t oid,
+	      daos_key_t *dkey)
+{
+	struct obj_csum_args	args = { 0 };
+
+	args.ca_oid = oid.id_pub;
+	args.ca_ioh = ioh;
+	args.ca_iods = iods;
+	args.ca_iods_nr = iods_nr;
+	args.ca_skips = skips;
+	args.ca_csummer = csummer;
+	args.ca_iod_csums = iod_csums;
+
+	return obj_csum_offload(csum_add2iods_ult, &args);
+}
+
 static int
 csum_verify_keys(struct daos_csummer *csummer, daos_key_t *dkey,
 		 struct dcs_csum_info *dkey_csum,
@@ -1490,8 +1610,9 @@ obj_local_rw_internal(crt_rpc_t *rpc, struct obj_io_context *ioc, daos_iod_t *io
 			goto out;
 		}
 
-		obj_update_latency(ioc->ioc_opc, VOS_LATENCY, daos_get_ntime() - time,
-				   vos_get_io_size(ioh));
+		time = daos_get_ntime() - time;
+		obj_update_latency(ioc->ioc_opc, VOS_LATENCY, time, vos_get_io_size(ioh));
+		obj_ioc_prof_add(ioc, VOS_LATENCY, time);
 
 		if (get_parity_list) {
 			parity_list = vos_ioh2recx_list(ioh);
@@ -1617,8 +1738,12 @@ obj_local_rw_internal(crt_rpc_t *rpc, struct obj_io_context *ioc, daos_iod_t *io
 
 	if (rma) {
 		bulk_bind = orw->orw_flags & ORF_BULK_BIND;
+		if (unlikely(ioc->ioc_prof))
+			time = daos_get_ntime();
 		rc = obj_bulk_transfer(rpc, bulk_op, bulk_bind, orw->orw_bulks.ca_arrays, offs,
 				       skips, ioh, NULL, iods_nr, NULL, ioc->ioc_coh);
+		if (unlikely(ioc->ioc_prof))
+			obj_ioc_prof_add(ioc, BULK_LATENCY, daos_get_ntime() - time);
 		if (rc == 0) {
 			bio_iod_flush(biod);
 
@@ -1744,12 +1869,15 @@ out:
 	rc = obj_rw_complete(rpc, ioc, ioh, rc, dth);
 	if (rc == 0) {
 		/* Update latency after getting fetch/update IO size by obj_rw_complete */
-		if (obj_rpc_is_update(rpc))
+		if (obj_rpc_is_update(rpc)) {
 			obj_update_latency(ioc->ioc_opc, BIO_LATENCY, bio_post_latency,
 					   ioc->ioc_io_size);
-		else
+			obj_ioc_prof_add(ioc, BIO_LATENCY, bio_post_latency);
+		} else {
 			obj_update_latency(ioc->ioc_opc, BIO_LATENCY, bio_pre_latency,
 					   ioc->ioc_io_size);
+			obj_ioc_prof_add(ioc, BIO_LATENCY, bio_pre_latency);
+		}
 	}
 	if (iods_dup != NULL)
 		daos_iod_recx_free(iods_dup, iods_nr);
@@ -2195,11 +2323,44 @@ out:
 	/** increment active request counter and start the chrono */
 	tls = obj_tls_get();
 	d_tm_inc_gauge(tls->ot_op_active[opc_get(rpc->cr_opc)], 1);
+	if (obj_prof_sample != 0 && ++tls->ot_prof_cnt >= obj_prof_sample) {
+		tls->ot_prof_cnt = 0;
+		ioc->ioc_prof = 1;
+	}
 	ioc->ioc_start_time = daos_get_ntime();
 	ioc->ioc_began = 1;
 	return rc;
 }
 
+/**
+ * Record the stage timings of a sampled request in the ring of its opcode, all
+ * in us: total, RPC decode, queue (scheduler and handler setup), VOS, BIO, bulk,
+ * reply and the I/O size in bytes.
+ */
+static void
+obj_prof_record(struct obj_io_context *ioc, uint64_t end)
+{
+	uint64_t	fields[D_TM_RING_FIELDS] = { 0 };
+	uint64_t	recv_ts = 0;
+	uint64_t	decode_ts = 0;
+	uint64_t	start = ioc->ioc_start_time;
+
+	crt_req_get_recv_time(ioc->ioc_rpc, &recv_ts, &decode_ts);
+	if (recv_ts != 0 && decode_ts >= recv_ts && start >= decode_ts) {
+		fields[1] = (decode_ts - recv_ts) >> 10;
+		fields[2] = (start - decode_ts) >> 10;
+		start = recv_ts;
+	}
+	fields[0] = (end - start) >> 10;
+	fields[3] = ioc->ioc_vos_time >> 10;
+	fields[4] = ioc->ioc_bio_time >> 10;
+	fields[5] = ioc->ioc_bulk_time >> 10;
+	fields[6] = ioc->ioc_reply_time >> 10;
+	fields[7] = ioc->ioc_io_size;
+
+	d_tm_append_ring(obj_op_prof_ring[ioc->ioc_opc], fields, ARRAY_SIZE(fields));
+}
+
 static inline void
 obj_update_sensors(struct obj_io_context *ioc, int err)
 {
@@ -2208,6 +2369,7 @@ obj_update_sensors(struct obj_io_context *ioc, int err)
 	struct obj_rw_in	*orw;
 	struct d_tm_node_t	*lat;
 	uint32_t		opc = ioc->ioc_opc;
+	uint64_t		end;
 	uint64_t		time;
 
 	opm = ioc->ioc_coc->sc_pool->spc_metrics[DAOS_OBJ_MODULE];
@@ -2222,7 +2384,10 @@ obj_update_sensors(struct obj_io_context *ioc, int err)
 	 * Measure latency of successful I/O only.
 	 * Use bit shift for performance and tolerate some inaccuracy.
 	 */
-	time = daos_get_ntime() - ioc->ioc_start_time;
+	end = daos_get_ntime();
+	if (unlikely(ioc->ioc_prof))
+		obj_prof_record(ioc, end);
+	time = end - ioc->ioc_start_time;
 	time >>= 10;
 
 	switch (opc) {
@@ -2242,10 +2407,15 @@ obj_update_sensors(struct obj_io_context *ioc, int err)
 		d_tm_inc_counter(opm->opm_fetch_bytes, ioc->ioc_io_size);
 		lat = tls->ot_fetch_lat[lat_bucket(ioc->ioc_io_size)];
 		break;
+	case DAOS_OBJ_RPC_MULTI_FETCH:
+		d_tm_inc_counter(opm->opm_fetch_bytes, ioc->ioc_io_size);
+		lat = tls->ot_op_lat[opc];
+		break;
 	default:
 		lat = tls->ot_op_lat[opc];
 	}
 	d_tm_set_gauge(lat, time);
+	d_tm_record_quantile(obj_op_lat_quantile[opc], time);
 }
 
 static void
@@ -4257,21 +4427,19 @@ out:
 }
 
 static int
-obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
-		    struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
-		    struct daos_csummer *csummer, uint32_t iods_nr)
+obj_verify_bio_csum_ult(void *arg)
 {
-	unsigned int	i;
-	int		rc = 0;
-
-	if (!daos_csummer_initialized(csummer) ||
-	    csummer->dcs_skip_data_verify ||
-	    !csummer->dcs_srv_verify)
-		return 0;
+	struct obj_csum_args	*args = arg;
+	daos_obj_id_t		 oid = args->ca_oid;
+	daos_iod_t		*iods = args->ca_iods;
+	struct dcs_iod_csums	*iod_csums = args->ca_iod_csums;
+	uint32_t		 iods_nr = args->ca_iods_nr;
+	unsigned int		 i;
+	int			 rc = 0;
 
 	for (i = 0; i < iods_nr; i++) {
 		daos_iod_t		*iod = &iods[i];
-		struct bio_sglist	*bsgl = bio_iod_sgl(biod, i);
+		struct bio_sglist	*bsgl = bio_iod_sgl(args->ca_biod, i);
 		d_sg_list_t		 sgl;
 
 		if (!csum_iod_is_supported(iod))
@@ -4288,7 +4456,7 @@ obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
 		rc = bio_sgl_convert(bsgl, &sgl);
 
 		if (rc == 0)
-			rc = daos_csummer_verify_iod(csummer, iod, &sgl,
+			rc = daos_csummer_verify_iod(args->ca_csummer, iod, &sgl,
 						     &iod_csums[i], NULL, 0,
 						     NULL);
 
@@ -4311,6 +4479,28 @@ obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
 	return rc;
 }
 
+static int
+obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
+		    struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
+		    struct daos_csummer *csummer, uint32_t iods_nr)
+{
+	struct obj_csum_args	args = { 0 };
+
+	if (!daos_csummer_initialized(csummer) ||
+	    csummer->dcs_skip_data_verify ||
+	    !csummer->dcs_srv_verify)
+		return 0;
+
+	args.ca_oid = oid;
+	args.ca_iods = iods;
+	args.ca_iods_nr = iods_nr;
+	args.ca_iod_csums = iod_csums;
+	args.ca_biod = biod;
+	args.ca_csummer = csummer;
+
+	return obj_csum_offload(obj_verify_bio_csum_ult, &args);
+}
+
 static inline void
 ds_obj_cpd_set_sub_result(struct obj_cpd_out *oco, int idx,
 			  int result, daos_epoch_t epoch)
@@ -5911,3 +6101,193 @@ out:
 
 	obj_ioc_end(&ioc, rc);
 }
+
+static void
+obj_mfetch_rep_free(struct obj_mfetch_rep *omr)
+{
+	int	i;
+	int	j;
+
+	if (omr->omr_sgls != NULL) {
+		for (i = 0; i < omr->omr_nr; i++) {
+			for (j = 0; j < omr->omr_sgls[i].sg_nr; j++)
+				D_FREE(omr->omr_sgls[i].sg_iovs[j].iov_buf);
+			D_FREE(omr->omr_sgls[i].sg_iovs);
+		}
+		D_FREE(omr->omr_sgls);
+	}
+	D_FREE(omr->omr_sizes);
+	omr->omr_nr = 0;
+}
+
+static int
+obj_mfetch_rep_prep(struct obj_mfetch_sub *oms, struct obj_mfetch_rep *omr)
+{
+	d_sg_list_t	*sgls;
+	int		 i;
+	int		 j;
+
+	omr->omr_nr = oms->oms_nr;
+	D_ALLOC_ARRAY(omr->omr_sizes, oms->oms_nr);
+	if (omr->omr_sizes == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY(omr->omr_sgls, oms->oms_nr);
+	if (omr->omr_sgls == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0, sgls = omr->omr_sgls; i < oms->oms_nr; i++) {
+		D_ALLOC_ARRAY(sgls[i].sg_iovs, oms->oms_sgls[i].sg_nr);
+		if (sgls[i].sg_iovs == NULL)
+			return -DER_NOMEM;
+
+		sgls[i].sg_nr = oms->oms_sgls[i].sg_nr;
+		for (j = 0; j < sgls[i].sg_nr; j++) {
+			d_iov_t	*iov = &sgls[i].sg_iovs[j];
+
+			iov->iov_buf_len = oms->oms_sgls[i].sg_iovs[j].iov_buf_len;
+			if (iov->iov_buf_len == 0)
+				continue;
+
+			D_ALLOC(iov->iov_buf, iov->iov_buf_len);
+			if (iov->iov_buf == NULL)
+				return -DER_NOMEM;
+		}
+	}
+
+	return 0;
+}
+
+/* Fetch one sub-request of multi-object fetch, the data is packed inline in the reply. */
+static int
+obj_mfetch_one(struct obj_io_context *ioc, struct obj_multi_fetch_in *omfi,
+	       struct obj_mfetch_sub *oms, struct obj_mfetch_rep *omr)
+{
+	struct dtx_handle	*dth = NULL;
+	struct dtx_epoch	 epoch;
+	struct bio_desc		*biod;
+	daos_handle_t		 ioh = DAOS_HDL_INVAL;
+	daos_size_t		 size = 0;
+	int			 rc;
+	int			 i;
+
+	rc = obj_ioc_init_oca(ioc, oms->oms_oid.id_pub);
+	if (rc != 0)
+		goto out;
+
+	/* EC object fetch needs the client side reassembly, it is never batched. */
+	if (daos_oclass_is_ec(&ioc->ioc_oca) || oms->oms_nr == 0)
+		D_GOTO(out, rc = -DER_INVAL);
+
+	rc = obj_mfetch_rep_prep(oms, omr);
+	if (rc != 0)
+		goto out;
+
+	epoch.oe_value = omfi->omfi_epoch;
+	epoch.oe_first = omfi->omfi_epoch;
+	epoch.oe_flags = 0;
+
+	rc = dtx_begin(ioc->ioc_vos_coh, &omfi->omfi_dti, &epoch, 0, omfi->omfi_map_ver,
+		       &oms->oms_oid, NULL, 0, 0, NULL, &dth);
+	if (rc != 0)
+		goto out;
+
+	rc = vos_fetch_begin(ioc->ioc_vos_coh, oms->oms_oid, omfi->omfi_epoch, &oms->oms_dkey,
+			     oms->oms_nr, oms->oms_iods, 0, NULL, &ioh, dth);
+	if (rc != 0) {
+		DL_CDEBUG(rc == -DER_INPROGRESS || rc == -DER_NONEXIST || rc == -DER_TX_RESTART,
+			  DB_IO, DLOG_ERR, rc, "Multi-fetch begin for " DF_UOID " failed",
+			  DP_UOID(oms->oms_oid));
+		goto end;
+	}
+
+	for (i = 0; i < oms->oms_nr; i++)
+		omr->omr_sizes[i] = oms->oms_iods[i].iod_size;
+
+	biod = vos_ioh2desc(ioh);
+	rc = bio_iod_prep(biod, BIO_CHK_TYPE_IO, NULL, CRT_BULK_RW);
+	if (rc != 0) {
+		D_ERROR(DF_UOID " bio_iod_prep failed: " DF_RC "\n", DP_UOID(oms->oms_oid),
+			DP_RC(rc));
+		goto fetch_end;
+	}
+
+	rc = bio_iod_copy(biod, omr->omr_sgls, oms->oms_nr);
+	if (rc == -DER_OVERFLOW)
+		rc = -DER_REC2BIG;
+	rc = bio_iod_post_async(biod, rc);
+
+fetch_end:
+	rc = vos_fetch_end(ioh, &size, rc);
+	if (rc == 0)
+		ioc->ioc_io_size += size;
+end:
+	rc = dtx_end(dth, ioc->ioc_coc, rc);
+out:
+	if (rc != 0)
+		obj_mfetch_rep_free(omr);
+	return rc;
+}
+
+void
+ds_obj_multi_fetch_handler(crt_rpc_t *rpc)
+{
+	struct obj_multi_fetch_in	*omfi = crt_req_get(rpc);
+	struct obj_multi_fetch_out	*omfo = crt_reply_get(rpc);
+	struct obj_mfetch_sub		*subs = omfi->omfi_subs.ca_arrays;
+	struct obj_mfetch_rep		*reps = NULL;
+	struct obj_io_context		 ioc = { 0 };
+	uint32_t			 nr = omfi->omfi_subs.ca_count;
+	int				 rc;
+	int				 i;
+
+	rc = obj_ioc_begin_lite(omfi->omfi_map_ver, omfi->omfi_po_uuid, omfi->omfi_co_hdl,
+				omfi->omfi_co_uuid, rpc, &ioc);
+	if (rc != 0)
+		goto out;
+
+	rc = obj_capa_check(ioc.ioc_coh, false, false);
+	if (rc != 0)
+		goto out;
+
+	D_ALLOC_ARRAY(reps, nr);
+	if (reps == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	/* All the sub-requests are served with the same epoch. */
+	process_epoch(&omfi->omfi_epoch, NULL, &omfi->omfi_flags);
+
+	/*
+	 * Handle all the sub-requests in current ULT one by one, the failed one will not affect
+	 * others, the client will retry it via regular fetch.
+	 */
+	for (i = 0; i < nr; i++) {
+		reps[i].omr_ret = obj_mfetch_one(&ioc, omfi, &subs[i], &reps[i]);
+		D_DEBUG(DB_IO, "Multi-fetch %d/%u for " DF_UOID " dkey " DF_KEY ": " DF_RC "\n",
+			i, nr, DP_UOID(subs[i].oms_oid), DP_KEY(&subs[i].oms_dkey),
+			DP_RC(reps[i].omr_ret));
+	}
+
+	omfo->omfo_reps.ca_count = nr;
+	omfo->omfo_reps.ca_arrays = reps;
+
+out:
+	obj_reply_set_status(rpc, rc);
+	obj_reply_map_version_set(rpc, ioc.ioc_map_ver);
+	omfo->omfo_epoch = omfi->omfi_epoch;
+
+	rc = crt_reply_send(rpc);
+	if (rc != 0)
+		D_ERROR("send reply failed: "DF_RC"\n", DP_RC(rc));
+
+	if (reps != NULL) {
+		for (i = 0; i < nr; i++)
+			obj_mfetch_rep_free(&reps[i]);
+		D_FREE(reps);
+		omfo->omfo_reps.ca_count = 0;
+		omfo->omfo_reps.ca_arrays = NULL;
+	}
+
+	/* It is no matter even if obj_ioc_begin_lite() was not called. */
+	obj_ioc_end(&ioc, rc);
+}
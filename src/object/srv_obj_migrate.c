@@ -1774,6 +1774,7 @@ migrate_one_ult(void *arg)
 	daos_size_t		data_size;
 	int			rc = 0;
 
+	sched_ult_cls_set(ABT_THREAD_NULL, DSS_ULT_CLS_REBUILD);
 	while (daos_fail_check(DAOS_REBUILD_TGT_REBUILD_HANG))
 		dss_sleep(0);
 
@@ -2980,6 +2981,7 @@ migrate_obj_ult(void *data)
 	int			 i;
 	int			 rc = 0;
 
+	sched_ult_cls_set(ABT_THREAD_NULL, DSS_ULT_CLS_REBUILD);
 	tls = migrate_pool_tls_lookup(arg->pool_uuid, arg->version, arg->generation);
 	if (tls == NULL || tls->mpt_fini) {
 		D_WARN("some one abort the rebuild "DF_UUID"\n",
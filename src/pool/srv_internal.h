@@ -94,6 +94,7 @@ struct pool_iv_prop {
 	uint32_t	pip_reint_mode;
 	uint32_t         pip_svc_ops_enabled;
 	uint32_t         pip_svc_ops_entry_age;
+	uint32_t	pip_sched_policy;
 	char		pip_iv_buf[0];
 };
 
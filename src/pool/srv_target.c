@@ -1678,6 +1678,60 @@ ds_pool_tgt_disconnect_aggregator(crt_rpc_t *source, crt_rpc_t *result,
 	return 0;
 }
 
+/*
+ * Set the node of each rank as its topology domain for the new version of the
+ * pool group, so that the collective RPCs over it (CRT_TREE_DOMAIN) send one
+ * message to each node.
+ */
+static int
+update_pool_group_domains(struct ds_pool *pool, struct pool_map *map)
+{
+	struct pool_domain	*nodes;
+	struct pool_domain	*rank_dom;
+	d_rank_list_t		*ranks;
+	uint32_t		*domains;
+	int			 nr;
+	int			 i;
+	int			 j;
+	int			 rc;
+
+	nr = pool_map_find_domain(map, PO_COMP_TP_NODE, PO_COMP_ID_ALL, &nodes);
+	if (nr <= 0)
+		return 0;
+
+	ranks = d_rank_list_alloc(pool_map_node_nr(map));
+	if (ranks == NULL)
+		return -DER_NOMEM;
+
+	D_ALLOC_ARRAY(domains, ranks->rl_nr);
+	if (domains == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
+
+	ranks->rl_nr = 0;
+	for (i = 0; i < nr; i++) {
+		for (j = 0; j < nodes[i].do_child_nr; j++) {
+			rank_dom = &nodes[i].do_children[j];
+			if (rank_dom->do_comp.co_type != PO_COMP_TP_RANK)
+				continue;
+
+			D_ASSERT(ranks->rl_nr < pool_map_node_nr(map));
+			ranks->rl_ranks[ranks->rl_nr] = rank_dom->do_comp.co_rank;
+			domains[ranks->rl_nr] = nodes[i].do_comp.co_id;
+			ranks->rl_nr++;
+		}
+	}
+
+	rc = crt_group_domains_set(pool->sp_group, ranks, domains, pool_map_get_version(map));
+	if (rc != 0)
+		DL_ERROR(rc, DF_UUID ": failed to set domains of version %u",
+			 DP_UUID(pool->sp_uuid), pool_map_get_version(map));
+
+	D_FREE(domains);
+out:
+	d_rank_list_free(ranks);
+	return rc;
+}
+
 static int
 update_pool_group(struct ds_pool *pool, struct pool_map *map)
 {
@@ -1694,6 +1748,13 @@ update_pool_group(struct ds_pool *pool, struct pool_map *map)
 	if (rc != 0)
 		return rc;
 
+	/* domains must be known before the new group version is used */
+	rc = update_pool_group_domains(pool, map);
+	if (rc != 0) {
+		map_ranks_fini(&ranks);
+		return rc;
+	}
+
 	/* Let secondary rank == primary rank. */
 	rc = crt_group_secondary_modify(pool->sp_group, &ranks, &ranks,
 					CRT_GROUP_MOD_OP_REPLACE,
@@ -1901,6 +1962,10 @@ update_vos_prop_on_targets(void *in)
 	if (child == NULL)
 		return -DER_NONEXIST;	/* no child created yet? */
 
+	ret = sched_pool_policy_set(pool->sp_uuid, pool->sp_sched_policy);
+	if (ret)
+		goto out;
+
 	ret = vos_pool_ctl(child->spc_hdl, VOS_PO_CTL_SET_DATA_THRESH, &pool->sp_data_thresh);
 	if (ret)
 		goto out;
@@ -1961,6 +2026,7 @@ ds_pool_tgt_prop_update(struct ds_pool *pool, struct pool_iv_prop *iv_prop)
 	pool->sp_scrub_freq_sec = iv_prop->pip_scrub_freq;
 	pool->sp_scrub_thresh = iv_prop->pip_scrub_thresh;
 	pool->sp_reint_mode = iv_prop->pip_reint_mode;
+	pool->sp_sched_policy = iv_prop->pip_sched_policy;
 
 	pool->sp_checkpoint_props_changed = 0;
 	if (pool->sp_checkpoint_mode != iv_prop->pip_checkpoint_mode) {
@@ -0,0 +1,25 @@
+'''
+  (C) Copyright 2024 Intel Corporation.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+'''
+from cart_utils import CartTest
+
+
+class CartCoRpcPipeTest(CartTest):
+    # pylint: disable=too-few-public-methods
+    """Run CaRT CoRPC tests with a pipelined chained bulk.
+
+    :avocado: recursive
+    """
+
+    def test_cart_corpc_pipe(self):
+        """Test CaRT CoRPC with a chained bulk pipelined through the tree.
+
+        :avocado: tags=all,pr,daily_regression
+        :avocado: tags=vm
+        :avocado: tags=cart,corpc,five_node,memcheck
+        :avocado: tags=CartCoRpcPipeTest,test_cart_corpc_pipe
+        """
+        cmd = self.build_cmd(self.env, "test_servers")
+        self.launch_test(cmd)
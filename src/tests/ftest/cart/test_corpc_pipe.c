@@ -0,0 +1,289 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * CORPC test of the pipelined chained bulk. Rank0 sends a CORPC request with a
+ * bulk of many chunks (CRT_CORPC_PIPE_CHUNK) to the other ranks through a
+ * binary tree, so that the ranks below the first level pull the data from a
+ * pipelined parent. All ranks verify the data they received.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <assert.h>
+#include <sys/stat.h>
+#include "crt_utils.h"
+
+#define TEST_CORPC_PIPE_CHUNK	4096
+/* not a multiple of the chunk size, to have a partial last chunk */
+#define TEST_CORPC_PIPE_LEN	(TEST_CORPC_PIPE_CHUNK * 64 + 123)
+
+#define TEST_CORPC_PIPE_BASE	0x010000000
+#define TEST_CORPC_PIPE_VER	0
+
+#define CRT_ISEQ_PIPE_CORPC	/* input fields */		 \
+	((uint32_t)		(len)			CRT_VAR)
+
+#define CRT_OSEQ_PIPE_CORPC	/* output fields */		 \
+	((uint32_t)		(nr_ok)			CRT_VAR)
+
+CRT_RPC_DECLARE(pipe_corpc, CRT_ISEQ_PIPE_CORPC, CRT_OSEQ_PIPE_CORPC)
+CRT_RPC_DEFINE(pipe_corpc, CRT_ISEQ_PIPE_CORPC, CRT_OSEQ_PIPE_CORPC)
+
+static uint32_t	nr_ok;
+
+static inline uint8_t
+pipe_pattern(uint32_t off)
+{
+	return (off * 7 + 3) & 0xff;
+}
+
+static int
+corpc_aggregate(crt_rpc_t *src, crt_rpc_t *result, void *priv)
+{
+	struct pipe_corpc_out	*out_src = crt_reply_get(src);
+	struct pipe_corpc_out	*out_result = crt_reply_get(result);
+
+	out_result->nr_ok += out_src->nr_ok;
+	return 0;
+}
+
+/*
+ * Stop the progress only once the subtree replied, the children may still pull
+ * the data from this rank after its handler was called.
+ */
+static int
+corpc_post_reply(crt_rpc_t *rpc, void *arg)
+{
+	DBG_PRINT("Post-reply called\n");
+	crtu_progress_stop();
+	return 0;
+}
+
+struct crt_corpc_ops corpc_pipe_ops = {
+	.co_aggregate = corpc_aggregate,
+	.co_post_reply = corpc_post_reply,
+};
+
+static void
+test_pipe_corpc_hdlr(crt_rpc_t *rpc)
+{
+	struct pipe_corpc_in	*in = crt_req_get(rpc);
+	struct pipe_corpc_out	*out = crt_reply_get(rpc);
+	d_sg_list_t		 sgl;
+	d_iov_t			 iov = {0};
+	uint8_t			*buf;
+	uint32_t		 i;
+	int			 rc;
+
+	DBG_PRINT("Handler called\n");
+
+	if (rpc->cr_co_bulk_hdl == CRT_BULK_NULL) {
+		D_ERROR("No chained bulk\n");
+		assert(0);
+	}
+
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+	rc = crt_bulk_access(rpc->cr_co_bulk_hdl, &sgl);
+	assert(rc == 0);
+
+	if (iov.iov_len != in->len) {
+		D_ERROR("Bulk length %zu, expected %u\n", iov.iov_len, in->len);
+		assert(0);
+	}
+
+	buf = iov.iov_buf;
+	for (i = 0; i < in->len; i++) {
+		if (buf[i] != pipe_pattern(i)) {
+			D_ERROR("Bad data at offset %u: %#x\n", i, buf[i]);
+			assert(0);
+		}
+	}
+
+	nr_ok++;
+	out->nr_ok = 1;
+	rc = crt_reply_send(rpc);
+	assert(rc == 0);
+}
+
+static void
+corpc_response_hdlr(const struct crt_cb_info *info)
+{
+	struct pipe_corpc_out	*out = crt_reply_get(info->cci_rpc);
+	uint32_t		 expected = *(uint32_t *)info->cci_arg;
+
+	if (info->cci_rc != 0) {
+		D_ERROR("CORPC failed; rc=%d\n", info->cci_rc);
+		assert(0);
+	}
+	if (out->nr_ok != expected) {
+		D_ERROR("%u ranks got the data, expected %u\n", out->nr_ok, expected);
+		assert(0);
+	}
+
+	nr_ok = out->nr_ok;
+	crtu_progress_stop();
+}
+
+static struct crt_proto_rpc_format my_proto_rpc_fmt_pipe_corpc[] = {
+	{
+		.prf_flags	= 0,
+		.prf_req_fmt	= &CQF_pipe_corpc,
+		.prf_hdlr	= test_pipe_corpc_hdlr,
+		.prf_co_ops	= &corpc_pipe_ops,
+	}
+};
+
+static struct crt_proto_format my_proto_fmt_pipe_corpc = {
+	.cpf_name = "my-proto-pipe_corpc",
+	.cpf_ver = TEST_CORPC_PIPE_VER,
+	.cpf_count = ARRAY_SIZE(my_proto_rpc_fmt_pipe_corpc),
+	.cpf_prf = &my_proto_rpc_fmt_pipe_corpc[0],
+	.cpf_base = TEST_CORPC_PIPE_BASE,
+};
+
+int main(void)
+{
+	int			 rc;
+	crt_context_t		 g_main_ctx;
+	d_rank_list_t		*rank_list;
+	d_rank_list_t		 excluded_membs;
+	d_rank_t		 excluded_ranks = {0};
+	crt_rpc_t		*rpc;
+	struct pipe_corpc_in	*in;
+	d_rank_t		 my_rank;
+	crt_group_t		*grp;
+	char			*env_self_rank;
+	char			*grp_cfg_file;
+	pthread_t		 progress_thread;
+	crt_bulk_t		 bulk_hdl = CRT_BULK_NULL;
+	d_sg_list_t		 sgl;
+	d_iov_t			 iov;
+	uint8_t			*buf = NULL;
+	uint32_t		 expected = 0;
+	uint32_t		 i;
+
+	excluded_membs.rl_nr = 1;
+	excluded_membs.rl_ranks = &excluded_ranks;
+
+	d_agetenv_str(&env_self_rank, "CRT_L_RANK");
+	my_rank = atoi(env_self_rank);
+	d_freeenv_str(&env_self_rank);
+
+	/* rank, num_attach_retries, is_server, assert_on_error */
+	crtu_test_init(my_rank, 20, true, true);
+
+	rc = d_log_init();
+	assert(rc == 0);
+
+	/* pipeline any bulk larger than one small chunk, TEST_CORPC_PIPE_CHUNK */
+	rc = d_setenv("CRT_CORPC_PIPE_CHUNK", "4096", 1);
+	assert(rc == 0);
+
+	rc = crt_init(NULL, CRT_FLAG_BIT_SERVER | CRT_FLAG_BIT_AUTO_SWIM_DISABLE);
+	assert(rc == 0);
+
+	rc = crt_proto_register(&my_proto_fmt_pipe_corpc);
+	assert(rc == 0);
+
+	rc = crt_context_create(&g_main_ctx);
+	assert(rc == 0);
+
+	rc = pthread_create(&progress_thread, 0,
+			    crtu_progress_fn, &g_main_ctx);
+	if (rc != 0) {
+		D_ERROR("pthread_create() failed; rc=%d\n", rc);
+		assert(0);
+	}
+
+	d_agetenv_str(&grp_cfg_file, "CRT_L_GRP_CFG");
+
+	rc = crt_rank_self_set(my_rank, 1 /* group_version_min */);
+	if (rc != 0) {
+		D_ERROR("crt_rank_self_set(%d) failed; rc=%d\n",
+			my_rank, rc);
+		assert(0);
+	}
+
+	grp = crt_group_lookup(NULL);
+	if (!grp) {
+		D_ERROR("Failed to lookup group\n");
+		assert(0);
+	}
+
+	/* load group info from a config file and delete file upon return */
+	rc = crtu_load_group_from_file(grp_cfg_file, g_main_ctx, grp, my_rank,
+				       true);
+	d_freeenv_str(&grp_cfg_file);
+	if (rc != 0) {
+		D_ERROR("crtu_load_group_from_file() failed; rc=%d\n", rc);
+		assert(0);
+	}
+
+	if (my_rank == 0) {
+		rc = crt_group_ranks_get(grp, &rank_list);
+		if (rc != 0) {
+			D_ERROR("crt_group_ranks_get() failed; rc=%d\n", rc);
+			assert(0);
+		}
+
+		rc = crtu_wait_for_ranks(g_main_ctx, grp, rank_list,
+					 0, 1, 50, 100.0);
+		if (rc != 0) {
+			D_ERROR("wait_for_ranks() failed; rc=%d\n", rc);
+			assert(0);
+		}
+
+		expected = rank_list->rl_nr - 1;
+		d_rank_list_free(rank_list);
+		rank_list = NULL;
+
+		D_ALLOC(buf, TEST_CORPC_PIPE_LEN);
+		assert(buf != NULL);
+		for (i = 0; i < TEST_CORPC_PIPE_LEN; i++)
+			buf[i] = pipe_pattern(i);
+
+		d_iov_set(&iov, buf, TEST_CORPC_PIPE_LEN);
+		sgl.sg_nr = 1;
+		sgl.sg_iovs = &iov;
+		rc = crt_bulk_create(g_main_ctx, &sgl, CRT_BULK_RO, &bulk_hdl);
+		assert(rc == 0);
+
+		DBG_PRINT("Rank 0 sending CORPC call\n");
+		rc = crt_corpc_req_create(g_main_ctx, NULL, &excluded_membs,
+			CRT_PROTO_OPC(TEST_CORPC_PIPE_BASE,
+				TEST_CORPC_PIPE_VER, 0), bulk_hdl, NULL, 0,
+			crt_tree_topo(CRT_TREE_KNOMIAL, 2), &rpc);
+		assert(rc == 0);
+
+		in = crt_req_get(rpc);
+		in->len = TEST_CORPC_PIPE_LEN;
+		rc = crt_req_send(rpc, corpc_response_hdlr, &expected);
+		assert(rc == 0);
+	}
+
+	pthread_join(progress_thread, NULL);
+	DBG_PRINT("Test finished\n");
+
+	if (nr_ok == 0) {
+		D_ERROR("data was not received\n");
+		assert(0);
+	}
+
+	if (my_rank == 0) {
+		rc = crt_bulk_free(bulk_hdl);
+		assert(rc == 0);
+		D_FREE(buf);
+	}
+
+	rc = crt_finalize();
+	assert(rc == 0);
+
+	d_log_fini();
+
+	return 0;
+}
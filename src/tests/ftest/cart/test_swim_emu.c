@@ -28,6 +28,7 @@
 #define FAILURES_MAX	1000
 
 static int verbose;
+static int lifeguard;
 static int glitches;
 static int failures;
 static int net_delay;
@@ -534,6 +535,11 @@ int test_init(void)
 		}
 	}
 
+	if (lifeguard)
+		swim_lifeguard_set(true);
+	for (i = 0; i < members_count; i++)
+		swim_member_count_set(g.swim_ctx[i], members_count);
+
 	rc = D_SPIN_INIT(&g.lock, PTHREAD_PROCESS_PRIVATE);
 	if (rc) {
 		fprintf(stderr, "D_SPIN_INIT() rc=%d\n", rc);
@@ -567,11 +573,12 @@ int test_parse_args(int argc, char **argv)
 		{"failures", required_argument, 0, 'f'},
 		{"delay",    required_argument, 0, 'd'},
 		{"verbose",  no_argument, &verbose, 1},
+		{"lifeguard", no_argument, &lifeguard, 1},
 		{0, 0, 0, 0}
 	};
 
 	while (1) {
-		rc = getopt_long(argc, argv, "?s:g:f:d:v", long_options,
+		rc = getopt_long(argc, argv, "?s:g:f:d:lv", long_options,
 				 &option_index);
 		if (rc == -1)
 			break;
@@ -629,6 +636,10 @@ int test_parse_args(int argc, char **argv)
 					"net delay.\n", nr);
 			}
 			break;
+		case 'l':
+			lifeguard = 1;
+			fprintf(stderr, "will use Lifeguard extensions.\n");
+			break;
 		case 'v':
 			verbose = 1;
 			break;
@@ -643,6 +654,7 @@ int test_parse_args(int argc, char **argv)
 "-g (--glitches) : how many glitches will be introduced in communication\n"
 "-f (--failures) : how many failures will be introduced in communication\n"
 "-d (--delay)    : the amount of communication delay for each packet in usec\n"
+"-l (--lifeguard): use Lifeguard extensions of SWIM\n"
 "-v              : verbose output about internal state during simulation\n");
 			return 1;
 		}
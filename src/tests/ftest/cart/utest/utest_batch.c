@@ -0,0 +1,312 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It tests the batching of small RPCs, the
+ * RPCs are sent by the engine to itself.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define UTEST_BATCH_BASE	0x01000000
+#define UTEST_BATCH_VER		0
+#define UTEST_BATCH_MAX		8
+/* Max time waiting for the RPCs, in seconds */
+#define UTEST_BATCH_WAIT	30
+
+enum {
+	UTEST_OPC_PING = CRT_PROTO_OPC(UTEST_BATCH_BASE, UTEST_BATCH_VER, 0),
+};
+
+enum {
+	/* reply right away */
+	PING_REPLY,
+	/* reply later, see utest_held */
+	PING_HOLD,
+	/* never reply */
+	PING_NOREPLY,
+};
+
+#define CRT_ISEQ_UTEST_PING	/* input fields */		 \
+	((uint32_t)		(val)			CRT_VAR) \
+	((uint32_t)		(mode)			CRT_VAR)
+
+#define CRT_OSEQ_UTEST_PING	/* output fields */		 \
+	((uint32_t)		(val)			CRT_VAR)
+
+CRT_RPC_DECLARE(utest_ping, CRT_ISEQ_UTEST_PING, CRT_OSEQ_UTEST_PING)
+CRT_RPC_DEFINE(utest_ping, CRT_ISEQ_UTEST_PING, CRT_OSEQ_UTEST_PING)
+
+struct utest_req {
+	int		ur_rc;
+	uint32_t	ur_val;
+	bool		ur_done;
+};
+
+static crt_context_t	 utest_ctx;
+static crt_rpc_t	*utest_held;
+
+static void
+utest_ping_hdlr(crt_rpc_t *rpc)
+{
+	struct utest_ping_in	*in = crt_req_get(rpc);
+	struct utest_ping_out	*out = crt_reply_get(rpc);
+
+	out->val = in->val + 1;
+	switch (in->mode) {
+	case PING_REPLY:
+		assert_int_equal(crt_reply_send(rpc), 0);
+		break;
+	case PING_HOLD:
+		assert_null(utest_held);
+		RPC_PUB_ADDREF(rpc);
+		utest_held = rpc;
+		break;
+	case PING_NOREPLY:
+		break;
+	}
+}
+
+static struct crt_proto_rpc_format utest_proto_rpc_fmt[] = {
+	{
+		.prf_flags	= 0,
+		.prf_req_fmt	= &CQF_utest_ping,
+		.prf_hdlr	= utest_ping_hdlr,
+		.prf_co_ops	= NULL,
+	}
+};
+
+static struct crt_proto_format utest_proto_fmt = {
+	.cpf_name	= "utest-batch",
+	.cpf_ver	= UTEST_BATCH_VER,
+	.cpf_count	= ARRAY_SIZE(utest_proto_rpc_fmt),
+	.cpf_prf	= &utest_proto_rpc_fmt[0],
+	.cpf_base	= UTEST_BATCH_BASE,
+};
+
+static void
+utest_ping_cb(const struct crt_cb_info *cb_info)
+{
+	struct utest_req	*req = cb_info->cci_arg;
+	struct utest_ping_out	*out;
+
+	req->ur_rc = cb_info->cci_rc;
+	if (req->ur_rc == 0) {
+		out = crt_reply_get(cb_info->cci_rpc);
+		req->ur_val = out->val;
+	}
+	req->ur_done = true;
+}
+
+static void
+utest_ping_send(struct utest_req *req, uint32_t val, uint32_t mode)
+{
+	struct utest_ping_in	*in;
+	crt_endpoint_t		 ep = { .ep_grp = NULL, .ep_rank = 0, .ep_tag = 0 };
+	crt_rpc_t		*rpc;
+	int			 rc;
+
+	memset(req, 0, sizeof(*req));
+	rc = crt_req_create(utest_ctx, &ep, UTEST_OPC_PING, &rpc);
+	assert_int_equal(rc, 0);
+
+	in = crt_req_get(rpc);
+	in->val = val;
+	in->mode = mode;
+	rc = crt_req_send(rpc, utest_ping_cb, req);
+	assert_int_equal(rc, 0);
+}
+
+/* Count the batches of the context, \a nr_sent of them are in flight */
+static int
+utest_batch_count(int *nr_sent)
+{
+	struct crt_context	*ctx = utest_ctx;
+	struct crt_batch	*batch;
+	int			 nr = 0;
+
+	*nr_sent = 0;
+	D_MUTEX_LOCK(&ctx->cc_mutex);
+	d_list_for_each_entry(batch, &ctx->cc_batch_list, cb_link) {
+		nr++;
+		if (batch->cb_sent)
+			(*nr_sent)++;
+	}
+	D_MUTEX_UNLOCK(&ctx->cc_mutex);
+
+	return nr;
+}
+
+/* Progress until the \a nr requests are done */
+static void
+utest_progress(struct utest_req *reqs, int nr)
+{
+	uint64_t	deadline;
+	int		i;
+
+	deadline = d_timeus_secdiff(UTEST_BATCH_WAIT);
+	while (d_timeus_secdiff(0) < deadline) {
+		for (i = 0; i < nr; i++) {
+			if (!reqs[i].ur_done)
+				break;
+		}
+		if (i == nr)
+			return;
+
+		crt_progress(utest_ctx, 1000);
+	}
+	fail_msg("RPCs not done after %d seconds", UTEST_BATCH_WAIT);
+}
+
+static void
+test_batch_flush_on_size(void **state)
+{
+	struct utest_req	reqs[1 + UTEST_BATCH_MAX];
+	int			nr_sent;
+	int			i;
+
+	/* Never flush on timeout */
+	crt_gdata.cg_batch_window = UTEST_BATCH_WAIT * 1000000;
+
+	/* Nothing in flight, sent right away */
+	utest_ping_send(&reqs[0], 0, PING_REPLY);
+	assert_int_equal(utest_batch_count(&nr_sent), 1);
+	assert_int_equal(nr_sent, 1);
+
+	/* Collected behind the one in flight until the batch is full */
+	for (i = 1; i < UTEST_BATCH_MAX; i++)
+		utest_ping_send(&reqs[i], i, PING_REPLY);
+	assert_int_equal(utest_batch_count(&nr_sent), 2);
+	assert_int_equal(nr_sent, 1);
+
+	utest_ping_send(&reqs[UTEST_BATCH_MAX], UTEST_BATCH_MAX, PING_REPLY);
+	assert_int_equal(utest_batch_count(&nr_sent), 2);
+	assert_int_equal(nr_sent, 2);
+
+	utest_progress(reqs, ARRAY_SIZE(reqs));
+	for (i = 0; i < ARRAY_SIZE(reqs); i++) {
+		assert_int_equal(reqs[i].ur_rc, 0);
+		assert_int_equal(reqs[i].ur_val, i + 1);
+	}
+	assert_int_equal(utest_batch_count(&nr_sent), 0);
+}
+
+static void
+test_batch_flush_on_timeout(void **state)
+{
+	struct utest_req	reqs[4];
+	int			nr_sent;
+	int			i;
+
+	crt_gdata.cg_batch_window = 100000;
+
+	/* The reply is held, so the batch stays in flight */
+	utest_ping_send(&reqs[0], 0, PING_HOLD);
+	for (i = 1; i < ARRAY_SIZE(reqs); i++)
+		utest_ping_send(&reqs[i], i, PING_REPLY);
+	assert_int_equal(utest_batch_count(&nr_sent), 2);
+	assert_int_equal(nr_sent, 1);
+
+	/* The window expires, the collected batch is sent without waiting for the held one */
+	utest_progress(&reqs[1], ARRAY_SIZE(reqs) - 1);
+	assert_false(reqs[0].ur_done);
+	for (i = 1; i < ARRAY_SIZE(reqs); i++) {
+		assert_int_equal(reqs[i].ur_rc, 0);
+		assert_int_equal(reqs[i].ur_val, i + 1);
+	}
+
+	assert_non_null(utest_held);
+	assert_int_equal(crt_reply_send(utest_held), 0);
+	RPC_PUB_DECREF(utest_held);
+	utest_held = NULL;
+
+	utest_progress(reqs, 1);
+	assert_int_equal(reqs[0].ur_rc, 0);
+	assert_int_equal(reqs[0].ur_val, 1);
+	assert_int_equal(utest_batch_count(&nr_sent), 0);
+}
+
+static void
+test_batch_member_error(void **state)
+{
+	struct utest_req	reqs[1 + UTEST_BATCH_MAX / 2];
+	int			nr_sent;
+	int			i;
+
+	crt_gdata.cg_batch_window = UTEST_BATCH_WAIT * 1000000;
+
+	/* The second batch is sent on completion of the first one */
+	for (i = 0; i < ARRAY_SIZE(reqs); i++)
+		utest_ping_send(&reqs[i], i, i == 2 ? PING_NOREPLY : PING_REPLY);
+	assert_int_equal(utest_batch_count(&nr_sent), 2);
+	assert_int_equal(nr_sent, 1);
+
+	/* Only the member without reply fails */
+	utest_progress(reqs, ARRAY_SIZE(reqs));
+	for (i = 0; i < ARRAY_SIZE(reqs); i++) {
+		if (i == 2) {
+			assert_int_equal(reqs[i].ur_rc, -DER_NOREPLY);
+			continue;
+		}
+		assert_int_equal(reqs[i].ur_rc, 0);
+		assert_int_equal(reqs[i].ur_val, i + 1);
+	}
+	assert_int_equal(utest_batch_count(&nr_sent), 0);
+}
+
+static int
+init_tests(void **state)
+{
+	int	rc;
+
+	d_setenv("CRT_PHY_ADDR_STR", "ofi+tcp", 1);
+	d_setenv("OFI_INTERFACE", "lo", 1);
+	d_setenv("CRT_BATCH_RPCS", "8", 1);
+
+	rc = crt_init(NULL, CRT_FLAG_BIT_SERVER | CRT_FLAG_BIT_AUTO_SWIM_DISABLE);
+	assert_int_equal(rc, 0);
+	assert_true(crt_batch_enabled());
+
+	rc = crt_context_create(&utest_ctx);
+	assert_int_equal(rc, 0);
+
+	rc = crt_rank_self_set(0, 1 /* group_version_min */);
+	assert_int_equal(rc, 0);
+
+	return crt_proto_register(&utest_proto_fmt);
+}
+
+static int
+fini_tests(void **state)
+{
+	int	rc;
+
+	rc = crt_context_destroy(utest_ctx, false);
+	assert_int_equal(rc, 0);
+
+	return crt_finalize();
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_batch_flush_on_size),
+		cmocka_unit_test(test_batch_flush_on_timeout),
+		cmocka_unit_test(test_batch_member_error),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_batch", tests, init_tests, fini_tests);
+}
@@ -0,0 +1,174 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It tests the adaptation of the HG handle
+ * pool size to the workload.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+/* Max number of progress calls to reach the pool size targets */
+#define UTEST_POOL_PROGRESS	1000
+
+static crt_context_t	 utest_ctx;
+
+static struct crt_hg_context *
+utest_hg_ctx(void)
+{
+	return &((struct crt_context *)utest_ctx)->cc_hg_ctx;
+}
+
+/* Adapt the pool as if \a hits and \a misses happened since the last adaptation */
+static void
+utest_pool_adapt(uint32_t hits, uint32_t misses)
+{
+	struct crt_hg_pool	*hg_pool = &utest_hg_ctx()->chc_hg_pool;
+
+	D_SPIN_LOCK(&hg_pool->chp_lock);
+	hg_pool->chp_hits = hits;
+	hg_pool->chp_misses = misses;
+	hg_pool->chp_adapt_ts = 0;
+	D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+	crt_hg_pool_adapt(utest_hg_ctx());
+}
+
+/* Progress until the pool size is within the targets, keep them unchanged meanwhile */
+static void
+utest_pool_refill(void)
+{
+	struct crt_hg_pool	*hg_pool = &utest_hg_ctx()->chc_hg_pool;
+	int32_t			 num;
+	int			 i;
+
+	for (i = 0; i < UTEST_POOL_PROGRESS; i++) {
+		D_SPIN_LOCK(&hg_pool->chp_lock);
+		hg_pool->chp_hits = hg_pool->chp_prepost_num;
+		hg_pool->chp_misses = 0;
+		num = hg_pool->chp_num;
+		D_SPIN_UNLOCK(&hg_pool->chp_lock);
+
+		if (num >= hg_pool->chp_prepost_num && num <= hg_pool->chp_max_num)
+			return;
+
+		crt_progress(utest_ctx, 0);
+	}
+	fail_msg("hg_pool size %d not within [%d, %d]\n", hg_pool->chp_num,
+		 hg_pool->chp_prepost_num, hg_pool->chp_max_num);
+}
+
+static void
+test_hg_pool_grow(void **state)
+{
+	struct crt_hg_pool	*hg_pool = &utest_hg_ctx()->chc_hg_pool;
+
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM);
+	assert_int_equal(hg_pool->chp_max_num, CRT_HG_POOL_MAX_NUM);
+
+	/* No miss, nothing changes */
+	utest_pool_adapt(CRT_HG_POOL_PREPOST_NUM, 0);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM);
+	assert_int_equal(hg_pool->chp_max_num, CRT_HG_POOL_MAX_NUM);
+
+	/* A few misses double the prepost number */
+	utest_pool_adapt(0, 1);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM * 2);
+	assert_int_equal(hg_pool->chp_max_num, CRT_HG_POOL_MAX_NUM);
+
+	/* A burst grows it by the number of misses, and the capacity with it */
+	utest_pool_adapt(0, 1000);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM * 2 + 1000);
+	assert_int_equal(hg_pool->chp_max_num, (CRT_HG_POOL_PREPOST_NUM * 2 + 1000) * 2);
+
+	/* The adaptation alone does not create any handle */
+	assert_true(hg_pool->chp_num < hg_pool->chp_prepost_num);
+
+	/* Refilled by bounded steps from the idle progress */
+	crt_progress(utest_ctx, 0);
+	assert_true(hg_pool->chp_num <= CRT_HG_POOL_PREPOST_NUM * 2 + CRT_HG_POOL_REFILL_MAX);
+	utest_pool_refill();
+	assert_int_equal(hg_pool->chp_num, hg_pool->chp_prepost_num);
+}
+
+static void
+test_hg_pool_shrink(void **state)
+{
+	struct crt_hg_pool	*hg_pool = &utest_hg_ctx()->chc_hg_pool;
+	int			 i;
+
+	assert_true(hg_pool->chp_num > CRT_HG_POOL_MAX_NUM);
+
+	/* A demand close to the prepost number keeps it */
+	utest_pool_adapt(hg_pool->chp_prepost_num / 2, 0);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM * 2 + 1000);
+
+	/* Halved while idle, down to the default */
+	for (i = 0; i < 32 && hg_pool->chp_prepost_num > CRT_HG_POOL_PREPOST_NUM; i++)
+		utest_pool_adapt(0, 0);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM);
+	assert_int_equal(hg_pool->chp_max_num, CRT_HG_POOL_MAX_NUM);
+
+	/* The handles above the capacity are released from the idle progress */
+	assert_true(hg_pool->chp_num > CRT_HG_POOL_MAX_NUM);
+	utest_pool_refill();
+	assert_int_equal(hg_pool->chp_num, CRT_HG_POOL_MAX_NUM);
+
+	/* Never beyond the limit */
+	utest_pool_adapt(0, CRT_HG_POOL_MAX_LIMIT * 2);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_MAX_LIMIT);
+	assert_int_equal(hg_pool->chp_max_num, CRT_HG_POOL_MAX_LIMIT);
+
+	for (i = 0; i < 32 && hg_pool->chp_prepost_num > CRT_HG_POOL_PREPOST_NUM; i++)
+		utest_pool_adapt(0, 0);
+	assert_int_equal(hg_pool->chp_prepost_num, CRT_HG_POOL_PREPOST_NUM);
+	assert_int_equal(hg_pool->chp_max_num, CRT_HG_POOL_MAX_NUM);
+}
+
+static int
+init_tests(void **state)
+{
+	int	rc;
+
+	d_setenv("CRT_PHY_ADDR_STR", "ofi+tcp", 1);
+	d_setenv("OFI_INTERFACE", "lo", 1);
+
+	rc = crt_init(NULL, CRT_FLAG_BIT_SERVER | CRT_FLAG_BIT_AUTO_SWIM_DISABLE);
+	assert_int_equal(rc, 0);
+
+	return crt_context_create(&utest_ctx);
+}
+
+static int
+fini_tests(void **state)
+{
+	int	rc;
+
+	rc = crt_context_destroy(utest_ctx, false);
+	assert_int_equal(rc, 0);
+
+	return crt_finalize();
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_hg_pool_grow),
+		cmocka_unit_test(test_hg_pool_shrink),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_hg_pool", tests, init_tests, fini_tests);
+}
@@ -1,5 +1,5 @@
 /*
- * (C) Copyright 2020-2022 Intel Corporation.
+ * (C) Copyright 2020-2024 Intel Corporation.
  *
  * SPDX-License-Identifier: BSD-2-Clause-Patent
  */
@@ -50,6 +50,136 @@ test_swim(void **state)
 	assert_int_equal(rc, 0);
 }
 
+#define UTEST_SWIM_MEMBERS	8
+#define UTEST_SWIM_VICTIM	5
+
+static struct swim_member_state utest_swim_states[UTEST_SWIM_MEMBERS];
+
+static int
+utest_swim_send_request(struct swim_context *ctx, swim_id_t id, swim_id_t to,
+			struct swim_member_update *upds, size_t nupds)
+{
+	D_FREE(upds);
+	return 0;
+}
+
+static swim_id_t
+utest_swim_get_target(struct swim_context *ctx)
+{
+	return SWIM_ID_INVALID;
+}
+
+static int
+utest_swim_get_member_state(struct swim_context *ctx, swim_id_t id,
+			    struct swim_member_state *state)
+{
+	if (id >= UTEST_SWIM_MEMBERS)
+		return -DER_NONEXIST;
+	*state = utest_swim_states[id];
+	return 0;
+}
+
+static int
+utest_swim_set_member_state(struct swim_context *ctx, swim_id_t id,
+			    struct swim_member_state *state)
+{
+	if (id >= UTEST_SWIM_MEMBERS)
+		return -DER_NONEXIST;
+	utest_swim_states[id] = *state;
+	return 0;
+}
+
+static struct swim_ops utest_swim_ops = {
+	.send_request		= utest_swim_send_request,
+	.get_dping_target	= utest_swim_get_target,
+	.get_iping_target	= utest_swim_get_target,
+	.get_member_state	= utest_swim_get_member_state,
+	.set_member_state	= utest_swim_set_member_state,
+};
+
+/* \a from relays the suspicion of the victim originated by \a origin */
+static void
+utest_swim_suspect(struct swim_context *ctx, swim_id_t from, swim_id_t origin)
+{
+	struct swim_member_update	upd = {
+		.smu_id		= UTEST_SWIM_VICTIM,
+		.smu_state	= {
+			.sms_incarnation	= 0,
+			.sms_status		= SWIM_MEMBER_SUSPECT,
+		},
+		.smu_origin	= origin,
+	};
+	int				rc;
+
+	rc = swim_updates_parse(ctx, from, from, &upd, 1);
+	assert_int_equal(rc, 0);
+}
+
+static uint32_t
+utest_swim_suspecters(struct swim_context *ctx)
+{
+	struct swim_item	*item;
+
+	TAILQ_FOREACH(item, &ctx->sc_suspects, si_link) {
+		if (item->si_id == UTEST_SWIM_VICTIM)
+			return item->si_nsuspecters;
+	}
+	return 0;
+}
+
+static void
+test_swim_suspect_origin(void **state)
+{
+	struct swim_context		*ctx;
+	struct swim_member_update	*upds;
+	size_t				 nupds;
+	int				 i;
+	int				 rc;
+
+	for (i = 0; i < UTEST_SWIM_MEMBERS; i++) {
+		utest_swim_states[i].sms_incarnation = 0;
+		utest_swim_states[i].sms_status = SWIM_MEMBER_ALIVE;
+		utest_swim_states[i].sms_delay = 0;
+	}
+
+	ctx = swim_init(0, &utest_swim_ops, NULL);
+	assert_non_null(ctx);
+	swim_lifeguard_set(true);
+	swim_member_count_set(ctx, UTEST_SWIM_MEMBERS);
+
+	utest_swim_suspect(ctx, 1, 1);
+	assert_int_equal(utest_swim_states[UTEST_SWIM_VICTIM].sms_status, SWIM_MEMBER_SUSPECT);
+	assert_int_equal(utest_swim_suspecters(ctx), 1);
+
+	/* relayed by other members, still the same suspicion */
+	utest_swim_suspect(ctx, 2, 1);
+	utest_swim_suspect(ctx, 3, 1);
+	assert_int_equal(utest_swim_suspecters(ctx), 1);
+
+	/* independent suspicions, whoever relays them */
+	utest_swim_suspect(ctx, 2, 3);
+	assert_int_equal(utest_swim_suspecters(ctx), 2);
+	utest_swim_suspect(ctx, 3, 3);
+	assert_int_equal(utest_swim_suspecters(ctx), 2);
+
+	/* the origin is unknown, counted as the relayer */
+	utest_swim_suspect(ctx, 4, SWIM_ID_INVALID);
+	assert_int_equal(utest_swim_suspecters(ctx), 3);
+
+	/* the origin is carried when the suspicion is piggybacked */
+	rc = swim_updates_prepare(ctx, UTEST_SWIM_VICTIM, UTEST_SWIM_VICTIM, &upds, &nupds);
+	assert_int_equal(rc, 0);
+	assert_true(nupds >= 2);
+	assert_int_equal(upds[0].smu_id, UTEST_SWIM_VICTIM);
+	assert_int_equal(upds[0].smu_origin, 1);
+	assert_int_equal(upds[1].smu_id, 0);
+	assert_int_equal(upds[1].smu_origin, 0);
+	D_FREE(upds);
+
+	swim_lifeguard_set(false);
+	swim_fini(ctx);
+}
+
 static int
 init_tests(void **state)
 {
@@ -76,6 +206,7 @@ int main(int argc, char **argv)
 {
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_swim),
+		cmocka_unit_test(test_swim_suspect_origin),
 	};
 
 	d_register_alt_assert(mock_assert);
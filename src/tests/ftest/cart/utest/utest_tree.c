@@ -0,0 +1,244 @@
+/*
+ * (C) Copyright 2024 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * This file is part of CaRT testing. It tests the topology aware tree of the
+ * collective RPCs (CRT_TREE_DOMAIN) and the versioning of the rank domains.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#include <cmocka.h>
+
+#include <cart/api.h>
+#include "../cart/crt_internal.h"
+
+#define UTEST_TREE_MAX_SIZE	40
+#define UTEST_TREE_MAX_DOMAINS	UTEST_TREE_MAX_SIZE
+
+/*
+ * Build the tree from \a grp_root and walk it from the root: every rank must be
+ * reached exactly once, from the parent it reports, and every domain but the
+ * one of the root must get exactly one message from the other domains.
+ */
+static void
+check_tree_root(uint32_t grp_size, uint32_t ratio, uint32_t grp_root, uint32_t *domains)
+{
+	struct crt_topo_ops	*ops = crt_tops[CRT_TREE_DOMAIN];
+	uint32_t		 children[UTEST_TREE_MAX_SIZE];
+	uint32_t		 queue[UTEST_TREE_MAX_SIZE];
+	uint32_t		 covered[UTEST_TREE_MAX_SIZE] = {0};
+	uint32_t		 inbound[UTEST_TREE_MAX_DOMAINS] = {0};
+	uint32_t		 head = 0;
+	uint32_t		 tail = 0;
+	uint32_t		 nchildren;
+	uint32_t		 parent;
+	uint32_t		 self;
+	uint32_t		 i;
+	int			 rc;
+
+	queue[tail++] = grp_root;
+	covered[grp_root] = 1;
+	while (head < tail) {
+		self = queue[head++];
+
+		rc = ops->to_get_children_cnt(grp_size, ratio, grp_root, self, domains,
+					      &nchildren);
+		assert_int_equal(rc, 0);
+		assert_true(nchildren < grp_size);
+		if (nchildren == 0)
+			continue;
+
+		rc = ops->to_get_children(grp_size, ratio, grp_root, self, domains, children);
+		assert_int_equal(rc, 0);
+
+		for (i = 0; i < nchildren; i++) {
+			assert_true(children[i] < grp_size);
+			assert_int_equal(covered[children[i]], 0);
+			covered[children[i]] = 1;
+			queue[tail++] = children[i];
+
+			rc = ops->to_get_parent(grp_size, ratio, grp_root, children[i], domains,
+						&parent);
+			assert_int_equal(rc, 0);
+			assert_int_equal(parent, self);
+
+			if (domains != NULL && domains[children[i]] != CRT_NO_DOMAIN &&
+			    domains[children[i]] != domains[self])
+				inbound[domains[children[i]]]++;
+		}
+	}
+	assert_int_equal(tail, grp_size);
+
+	if (domains == NULL)
+		return;
+
+	for (i = 0; i < grp_size; i++) {
+		if (domains[i] == CRT_NO_DOMAIN)
+			continue;
+		if (domains[i] == domains[grp_root])
+			assert_int_equal(inbound[domains[i]], 0);
+		else
+			assert_int_equal(inbound[domains[i]], 1);
+	}
+}
+
+static void
+check_tree(uint32_t grp_size, uint32_t *domains)
+{
+	uint32_t	ratios[] = {CRT_TREE_MIN_RATIO, 4, CRT_TREE_MAX_RATIO};
+	uint32_t	root;
+	int		i;
+
+	for (i = 0; i < ARRAY_SIZE(ratios); i++)
+		for (root = 0; root < grp_size; root++)
+			check_tree_root(grp_size, ratios[i], root, domains);
+}
+
+static void
+test_tree_no_domain(void **state)
+{
+	uint32_t	domains[UTEST_TREE_MAX_SIZE];
+	uint32_t	size;
+	uint32_t	i;
+
+	for (size = 1; size <= UTEST_TREE_MAX_SIZE; size++) {
+		check_tree(size, NULL);
+
+		for (i = 0; i < size; i++)
+			domains[i] = CRT_NO_DOMAIN;
+		check_tree(size, domains);
+	}
+}
+
+static void
+test_tree_domains(void **state)
+{
+	uint32_t	domains[UTEST_TREE_MAX_SIZE];
+	uint32_t	size;
+	uint32_t	nr;
+	uint32_t	i;
+
+	for (size = 1; size <= UTEST_TREE_MAX_SIZE; size++) {
+		for (nr = 1; nr <= 5; nr++) {
+			/* consecutive ranks on the same node */
+			for (i = 0; i < size; i++)
+				domains[i] = i / nr;
+			check_tree(size, domains);
+
+			/* ranks spread over the nodes, with reversed domain numbers */
+			for (i = 0; i < size; i++)
+				domains[i] = nr - 1 - i % nr;
+			check_tree(size, domains);
+
+			/* some ranks of unknown domain */
+			for (i = 0; i < size; i++)
+				domains[i] = i % 7 == 3 ? CRT_NO_DOMAIN : i % nr;
+			check_tree(size, domains);
+		}
+	}
+}
+
+static void
+test_tree_domain_versions(void **state)
+{
+	d_rank_t	 ranks_buf[] = {5, 1, 3, 0};
+	d_rank_list_t	 ranks = {.rl_ranks = ranks_buf, .rl_nr = ARRAY_SIZE(ranks_buf)};
+	d_rank_t	 query_buf[] = {0, 1, 2, 3, 5};
+	d_rank_list_t	 query = {.rl_ranks = query_buf, .rl_nr = ARRAY_SIZE(query_buf)};
+	uint32_t	 v2[] = {20, 21, 22, 23};
+	uint32_t	 v3[] = {30, 31, 32, 33};
+	uint32_t	 v4[] = {40, 41, 42, 43};
+	uint32_t	 got[ARRAY_SIZE(query_buf)];
+	struct crt_grp_priv	*grp_priv = crt_grp_pub2priv(NULL);
+	int		 rc;
+
+	rc = crt_group_version_set(NULL, 2);
+	assert_int_equal(rc, 0);
+
+	rc = crt_group_domains_set(NULL, &ranks, v2, 2);
+	assert_int_equal(rc, 0);
+	rc = crt_group_domains_set(NULL, &ranks, v3, 3);
+	assert_int_equal(rc, 0);
+
+	/* domains of each version, looked up by rank */
+	crt_grp_priv_get_domains(grp_priv, 2, &query, got);
+	assert_int_equal(got[0], 23);
+	assert_int_equal(got[1], 21);
+	assert_int_equal(got[2], CRT_NO_DOMAIN);
+	assert_int_equal(got[3], 22);
+	assert_int_equal(got[4], 20);
+
+	crt_grp_priv_get_domains(grp_priv, 3, &query, got);
+	assert_int_equal(got[0], 33);
+	assert_int_equal(got[4], 30);
+
+	/* a version without domains has none */
+	crt_grp_priv_get_domains(grp_priv, 1, &query, got);
+	assert_int_equal(got[0], CRT_NO_DOMAIN);
+	assert_int_equal(got[4], CRT_NO_DOMAIN);
+
+	/* only the two latest versions are kept */
+	rc = crt_group_version_set(NULL, 3);
+	assert_int_equal(rc, 0);
+	rc = crt_group_domains_set(NULL, &ranks, v4, 4);
+	assert_int_equal(rc, 0);
+
+	crt_grp_priv_get_domains(grp_priv, 2, &query, got);
+	assert_int_equal(got[0], CRT_NO_DOMAIN);
+	crt_grp_priv_get_domains(grp_priv, 3, &query, got);
+	assert_int_equal(got[0], 33);
+	crt_grp_priv_get_domains(grp_priv, 4, &query, got);
+	assert_int_equal(got[0], 43);
+
+	/* set again for the same version */
+	rc = crt_group_domains_set(NULL, &ranks, v2, 4);
+	assert_int_equal(rc, 0);
+	crt_grp_priv_get_domains(grp_priv, 4, &query, got);
+	assert_int_equal(got[0], 23);
+	crt_grp_priv_get_domains(grp_priv, 3, &query, got);
+	assert_int_equal(got[0], 33);
+
+	/* not older than the group version */
+	rc = crt_group_domains_set(NULL, &ranks, v2, 2);
+	assert_int_equal(rc, -DER_INVAL);
+
+	/* no duplicate rank */
+	ranks_buf[1] = 5;
+	rc = crt_group_domains_set(NULL, &ranks, v2, 5);
+	assert_int_equal(rc, -DER_INVAL);
+}
+
+static int
+init_tests(void **state)
+{
+	d_setenv("CRT_PHY_ADDR_STR", "ofi+tcp", 1);
+	d_setenv("OFI_INTERFACE", "lo", 1);
+
+	return crt_init(NULL, CRT_FLAG_BIT_SERVER | CRT_FLAG_BIT_AUTO_SWIM_DISABLE);
+}
+
+static int
+fini_tests(void **state)
+{
+	return crt_finalize();
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_tree_no_domain),
+		cmocka_unit_test(test_tree_domains),
+		cmocka_unit_test(test_tree_domain_versions),
+	};
+
+	d_register_alt_assert(mock_assert);
+
+	return cmocka_run_group_tests_name("utest_tree", tests, init_tests, fini_tests);
+}
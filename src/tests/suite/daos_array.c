@@ -1103,6 +1103,218 @@ truncate_array(void **state)
 	par_barrier(PAR_COMM_WORLD);
 } /* End truncate_array */
 
+#define WB_IO_SIZE	512
+#define WB_IO_NR	64
+#define WB_CHUNK_SIZE	(WB_IO_SIZE * WB_IO_NR)
+
+static void
+write_back_io(void **state)
+{
+	test_arg_t		*arg = *state;
+	daos_obj_id_t		oid;
+	daos_handle_t		oh;
+	daos_array_iod_t	iod = {};
+	daos_range_t		rg = {};
+	d_iov_t			iov = {};
+	d_sg_list_t		sgl = {};
+	char			*wbuf;
+	char			*rbuf;
+	daos_size_t		size;
+	int			i;
+	int			rc;
+
+	par_barrier(PAR_COMM_WORLD);
+	oid = daos_test_oid_gen(arg->coh, OC_SX, typeb, 0, arg->myrank);
+
+	rc = daos_array_create(arg->coh, oid, DAOS_TX_NONE, 1, WB_CHUNK_SIZE, &oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	rc = daos_array_set_write_back(oh, WB_CHUNK_SIZE / 2, 0);
+	assert_rc_equal(rc, 0);
+
+	D_ALLOC(wbuf, WB_CHUNK_SIZE * 2);
+	assert_non_null(wbuf);
+	D_ALLOC(rbuf, WB_CHUNK_SIZE * 2);
+	assert_non_null(rbuf);
+	for (i = 0; i < WB_CHUNK_SIZE * 2; i++)
+		wbuf[i] = i % 251;
+
+	iod.arr_nr = 1;
+	iod.arr_rgs = &rg;
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+
+	/** small sequential writes over two chunks, all but the last one */
+	for (i = 0; i < WB_IO_NR * 2 - 1; i++) {
+		rg.rg_idx = i * WB_IO_SIZE;
+		rg.rg_len = WB_IO_SIZE;
+		d_iov_set(&iov, wbuf + rg.rg_idx, WB_IO_SIZE);
+		rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	/** overwrite part of the data that is still buffered */
+	rg.rg_idx = WB_CHUNK_SIZE * 2 - 4 * WB_IO_SIZE + 100;
+	rg.rg_len = WB_IO_SIZE;
+	memset(wbuf + rg.rg_idx, 0xa5, WB_IO_SIZE);
+	d_iov_set(&iov, wbuf + rg.rg_idx, WB_IO_SIZE);
+	rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+
+	/** buffered data can't be dropped by changing the settings */
+	rc = daos_array_set_write_back(oh, 0, 0);
+	assert_rc_equal(rc, -DER_BUSY);
+
+	rg.rg_idx = WB_CHUNK_SIZE * 2 - WB_IO_SIZE;
+	rg.rg_len = WB_IO_SIZE;
+	d_iov_set(&iov, wbuf + rg.rg_idx, WB_IO_SIZE);
+	rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+
+	/** size and reads on the handle see buffered data */
+	rc = daos_array_get_size(oh, DAOS_TX_NONE, &size, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(size, WB_CHUNK_SIZE * 2);
+
+	rg.rg_idx = 0;
+	rg.rg_len = WB_CHUNK_SIZE * 2;
+	d_iov_set(&iov, rbuf, WB_CHUNK_SIZE * 2);
+	rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(rbuf, wbuf, WB_CHUNK_SIZE * 2);
+
+	/** an explicit flush writes back the buffered data */
+	rc = daos_array_flush(oh, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_set_write_back(oh, WB_CHUNK_SIZE / 2, 0);
+	assert_rc_equal(rc, 0);
+
+	/** data still buffered at close is flushed by the close */
+	rg.rg_idx = WB_CHUNK_SIZE * 2;
+	rg.rg_len = WB_IO_SIZE;
+	d_iov_set(&iov, wbuf, WB_IO_SIZE);
+	rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_set_write_back(oh, 0, 0);
+	assert_rc_equal(rc, -DER_BUSY);
+
+	rc = daos_array_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	rc = daos_array_open_with_attr(arg->coh, oid, DAOS_TX_NONE, DAOS_OO_RW, 1, WB_CHUNK_SIZE,
+				       &oh, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_array_get_size(oh, DAOS_TX_NONE, &size, NULL);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(size, WB_CHUNK_SIZE * 2 + WB_IO_SIZE);
+	rc = daos_array_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	D_FREE(rbuf);
+	D_FREE(wbuf);
+	par_barrier(PAR_COMM_WORLD);
+} /* End write_back_io */
+
+#define RA_IO_SIZE	1024
+#define RA_IO_NR	64
+
+static void
+read_ahead_io(void **state)
+{
+	test_arg_t		*arg = *state;
+	daos_obj_id_t		oid;
+	daos_handle_t		oh;
+	daos_array_iod_t	iod = {};
+	daos_range_t		rg = {};
+	d_iov_t			iov = {};
+	d_sg_list_t		sgl = {};
+	char			*wbuf;
+	char			*rbuf;
+	int			i;
+	int			rc;
+
+	par_barrier(PAR_COMM_WORLD);
+	oid = daos_test_oid_gen(arg->coh, OC_SX, typeb, 0, arg->myrank);
+
+	rc = daos_array_create(arg->coh, oid, DAOS_TX_NONE, 1, RA_IO_SIZE * 16, &oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	D_ALLOC(wbuf, RA_IO_SIZE * RA_IO_NR);
+	assert_non_null(wbuf);
+	D_ALLOC(rbuf, RA_IO_SIZE);
+	assert_non_null(rbuf);
+	for (i = 0; i < RA_IO_SIZE * RA_IO_NR; i++)
+		wbuf[i] = i % 253;
+
+	iod.arr_nr = 1;
+	iod.arr_rgs = &rg;
+	sgl.sg_nr = 1;
+	sgl.sg_iovs = &iov;
+
+	rg.rg_idx = 0;
+	rg.rg_len = RA_IO_SIZE * RA_IO_NR;
+	d_iov_set(&iov, wbuf, RA_IO_SIZE * RA_IO_NR);
+	rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+	assert_rc_equal(rc, 0);
+
+	rc = daos_array_set_read_ahead(oh, RA_IO_SIZE * 32);
+	assert_rc_equal(rc, 0);
+
+	/** sequential reads, then past the end of the array */
+	for (i = 0; i < RA_IO_NR + 2; i++) {
+		rg.rg_idx = i * RA_IO_SIZE;
+		rg.rg_len = RA_IO_SIZE;
+		d_iov_set(&iov, rbuf, RA_IO_SIZE);
+		rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+		assert_rc_equal(rc, 0);
+		if (i < RA_IO_NR) {
+			assert_int_equal(iod.arr_nr_read, RA_IO_SIZE);
+			assert_memory_equal(rbuf, wbuf + i * RA_IO_SIZE, RA_IO_SIZE);
+		} else {
+			assert_int_equal(iod.arr_nr_read, 0);
+		}
+	}
+
+	/** strided reads, with a write through the handle in the middle */
+	for (i = 0; i < RA_IO_NR / 2; i++) {
+		if (i == RA_IO_NR / 4) {
+			memset(wbuf + (i + 2) * 2 * RA_IO_SIZE, 0x5a, RA_IO_SIZE);
+			rg.rg_idx = (i + 2) * 2 * RA_IO_SIZE;
+			rg.rg_len = RA_IO_SIZE;
+			d_iov_set(&iov, wbuf + rg.rg_idx, RA_IO_SIZE);
+			rc = daos_array_write(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+			assert_rc_equal(rc, 0);
+		}
+		rg.rg_idx = i * 2 * RA_IO_SIZE;
+		rg.rg_len = RA_IO_SIZE;
+		d_iov_set(&iov, rbuf, RA_IO_SIZE);
+		rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+		assert_rc_equal(rc, 0);
+		assert_memory_equal(rbuf, wbuf + rg.rg_idx, RA_IO_SIZE);
+	}
+
+	/** sequential reads again, failing the first prefetch, readers fall back to fetching */
+	for (i = 0; i < RA_IO_NR / 2; i++) {
+		if (i == 3)
+			daos_fail_loc_set(DAOS_SHARD_OBJ_FAIL | DAOS_FAIL_ONCE);
+		rg.rg_idx = i * RA_IO_SIZE;
+		rg.rg_len = RA_IO_SIZE;
+		d_iov_set(&iov, rbuf, RA_IO_SIZE);
+		rc = daos_array_read(oh, DAOS_TX_NONE, &iod, &sgl, NULL);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(iod.arr_nr_read, RA_IO_SIZE);
+		assert_memory_equal(rbuf, wbuf + rg.rg_idx, RA_IO_SIZE);
+	}
+	daos_fail_loc_set(0);
+
+	rc = daos_array_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+
+	D_FREE(rbuf);
+	D_FREE(wbuf);
+	par_barrier(PAR_COMM_WORLD);
+} /* End read_ahead_io */
+
 #define DFS_ITER_NR		128
 #define DFS_ITER_DKEY_BUF	(DFS_ITER_NR * sizeof(uint64_t))
 
@@ -1235,6 +1447,10 @@ static const struct CMUnitTest array_api_tests[] = {
 	 truncate_array, async_disable, NULL},
 	{"Array 11: EC Array Key Query",
 	 ec_array_key_query, async_disable, NULL},
+	{"Array 12: write-back coalescing of small writes",
+	 write_back_io, async_disable, NULL},
+	{"Array 13: read-ahead of sequential and strided reads",
+	 read_ahead_io, async_disable, NULL},
 };
 
 static int
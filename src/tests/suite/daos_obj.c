@@ -5309,6 +5309,117 @@ io_55(void **state)
 	obj_coll_query(arg, OC_EC_4P1GX);
 }
 
+#define MFETCH_OBJ_NR	8
+#define MFETCH_BUF_LEN	32
+
+static void
+io_56(void **state)
+{
+	test_arg_t		*arg = *state;
+	daos_oclass_id_t	 oclasses[] = { OC_S1, OC_SX, OC_RP_2G1, OC_EC_2P1G1 };
+	daos_obj_fetch_req_t	 reqs[MFETCH_OBJ_NR];
+	daos_handle_t		 ohs[MFETCH_OBJ_NR];
+	daos_iod_t		 iods[MFETCH_OBJ_NR];
+	d_sg_list_t		 sgls[MFETCH_OBJ_NR];
+	d_iov_t			 iovs[MFETCH_OBJ_NR];
+	char			 bufs[MFETCH_OBJ_NR][MFETCH_BUF_LEN];
+	char			 val[MFETCH_BUF_LEN];
+	daos_obj_id_t		 oid;
+	d_iov_t			 dkey;
+	d_iov_t			 dkey_miss;
+	int			 i;
+	int			 rc;
+
+	print_message("Multi-object fetch\n");
+
+	if (!test_runable(arg, 3))
+		return;
+
+	d_iov_set(&dkey, "mfetch_dkey", strlen("mfetch_dkey"));
+	d_iov_set(&dkey_miss, "mfetch_miss", strlen("mfetch_miss"));
+
+	/** a mix of single, sharded, replicated and EC objects, the latter are not batched */
+	for (i = 0; i < MFETCH_OBJ_NR; i++) {
+		oid = daos_test_oid_gen(arg->coh, oclasses[i % ARRAY_SIZE(oclasses)], 0, 0,
+					arg->myrank);
+		rc = daos_obj_open(arg->coh, oid, DAOS_OO_RW, &ohs[i], NULL);
+		assert_rc_equal(rc, 0);
+
+		memset(&iods[i], 0, sizeof(iods[i]));
+		d_iov_set(&iods[i].iod_name, "mfetch_akey", strlen("mfetch_akey"));
+		iods[i].iod_type = DAOS_IOD_SINGLE;
+		iods[i].iod_nr = 1;
+
+		snprintf(val, sizeof(val), "mfetch-value-%d", i);
+		iods[i].iod_size = strlen(val) + 1;
+		d_iov_set(&iovs[i], val, iods[i].iod_size);
+		sgls[i].sg_nr = 1;
+		sgls[i].sg_iovs = &iovs[i];
+		rc = daos_obj_update(ohs[i], DAOS_TX_NONE, 0, &dkey, 1, &iods[i], &sgls[i], NULL);
+		assert_rc_equal(rc, 0);
+	}
+
+	print_message("empty request list\n");
+	rc = daos_obj_fetch_multi(DAOS_TX_NONE, 0, 0, reqs, NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+	rc = daos_obj_fetch_multi(DAOS_TX_NONE, 0, MFETCH_OBJ_NR, NULL, NULL);
+	assert_rc_equal(rc, -DER_INVAL);
+
+	print_message("fetch all objects\n");
+	for (i = 0; i < MFETCH_OBJ_NR; i++) {
+		memset(bufs[i], 0, MFETCH_BUF_LEN);
+		iods[i].iod_size = DAOS_REC_ANY;
+		d_iov_set(&iovs[i], bufs[i], MFETCH_BUF_LEN);
+		reqs[i].ofr_oh = ohs[i];
+		reqs[i].ofr_dkey = &dkey;
+		reqs[i].ofr_nr = 1;
+		reqs[i].ofr_rc = 0;
+		reqs[i].ofr_iods = &iods[i];
+		reqs[i].ofr_sgls = &sgls[i];
+	}
+	rc = daos_obj_fetch_multi(DAOS_TX_NONE, 0, MFETCH_OBJ_NR, reqs, NULL);
+	assert_rc_equal(rc, 0);
+	for (i = 0; i < MFETCH_OBJ_NR; i++) {
+		snprintf(val, sizeof(val), "mfetch-value-%d", i);
+		assert_rc_equal(reqs[i].ofr_rc, 0);
+		assert_int_equal(iods[i].iod_size, strlen(val) + 1);
+		assert_string_equal(bufs[i], val);
+	}
+
+	/** one invalid handle and one missing dkey, the others must not be affected */
+	print_message("fetch with partial failures\n");
+	for (i = 0; i < MFETCH_OBJ_NR; i++) {
+		memset(bufs[i], 0, MFETCH_BUF_LEN);
+		iods[i].iod_size = DAOS_REC_ANY;
+		reqs[i].ofr_rc = 0;
+	}
+	reqs[2].ofr_oh = DAOS_HDL_INVAL;
+	reqs[5].ofr_dkey = &dkey_miss;
+	rc = daos_obj_fetch_multi(DAOS_TX_NONE, 0, MFETCH_OBJ_NR, reqs, NULL);
+	assert_rc_equal(rc, -DER_NO_HDL);
+	for (i = 0; i < MFETCH_OBJ_NR; i++) {
+		if (i == 2) {
+			assert_rc_equal(reqs[i].ofr_rc, -DER_NO_HDL);
+			continue;
+		}
+
+		assert_rc_equal(reqs[i].ofr_rc, 0);
+		if (i == 5) {
+			assert_int_equal(iods[i].iod_size, 0);
+			continue;
+		}
+
+		snprintf(val, sizeof(val), "mfetch-value-%d", i);
+		assert_int_equal(iods[i].iod_size, strlen(val) + 1);
+		assert_string_equal(bufs[i], val);
+	}
+
+	for (i = 0; i < MFETCH_OBJ_NR; i++) {
+		rc = daos_obj_close(ohs[i], NULL);
+		assert_rc_equal(rc, 0);
+	}
+}
+
 static const struct CMUnitTest io_tests[] = {
 	{ "IO1: simple update/fetch/verify",
 	  io_simple, async_disable, test_case_teardown},
@@ -5419,6 +5530,8 @@ static const struct CMUnitTest io_tests[] = {
 	  io_54, async_disable, test_case_teardown},
 	{ "IO55: collective object query - OC_EC_4P1GX",
 	  io_55, async_disable, test_case_teardown},
+	{ "IO56: multi-object fetch",
+	  io_56, async_disable, test_case_teardown},
 };
 
 int
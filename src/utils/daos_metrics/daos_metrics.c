@@ -51,6 +51,10 @@ print_usage(const char *prog_name)
 	       "\tInclude timer snapshots\n"
 	       "--gauge, -g\n"
 	       "\tInclude gauges\n"
+	       "--quantile, -q\n"
+	       "\tInclude quantile sketches (p50, p90, p99, p999)\n"
+	       "--ring, -R\n"
+	       "\tInclude rings of sampled records (e.g. RPC stage timings)\n"
 	       "--read, -r\n"
 	       "\tInclude timestamp of when metric was read\n"
 	       "--reset, -e\n"
@@ -90,6 +94,8 @@ main(int argc, char **argv)
 			{"timestamp", no_argument, NULL, 't'},
 			{"snapshot", no_argument, NULL, 's'},
 			{"gauge", no_argument, NULL, 'g'},
+			{"quantile", no_argument, NULL, 'q'},
+			{"ring", no_argument, NULL, 'R'},
 			{"iterations", required_argument, NULL, 'i'},
 			{"path", required_argument, NULL, 'p'},
 			{"delay", required_argument, NULL, 'D'},
@@ -102,7 +108,7 @@ main(int argc, char **argv)
 			{NULL, 0, NULL, 0}
 		};
 
-		opt = getopt_long_only(argc, argv, "S:cCdtsgi:p:D:MmTrhe",
+		opt = getopt_long_only(argc, argv, "S:cCdtsgqRi:p:D:MmTrhe",
 				       long_options, NULL);
 		if (opt == -1)
 			break;
@@ -129,6 +135,12 @@ main(int argc, char **argv)
 		case 'g':
 			filter |= D_TM_GAUGE | D_TM_STATS_GAUGE;
 			break;
+		case 'q':
+			filter |= D_TM_QUANTILE;
+			break;
+		case 'R':
+			filter |= D_TM_RING;
+			break;
 		case 'i':
 			num_iter = atoi(optarg);
 			break;
@@ -166,7 +178,8 @@ main(int argc, char **argv)
 
 	if (filter == 0)
 		filter = D_TM_COUNTER | D_TM_DURATION | D_TM_TIMESTAMP | D_TM_MEMINFO |
-			 D_TM_TIMER_SNAPSHOT | D_TM_GAUGE | D_TM_STATS_GAUGE;
+			 D_TM_TIMER_SNAPSHOT | D_TM_GAUGE | D_TM_STATS_GAUGE | D_TM_QUANTILE |
+			 D_TM_RING;
 
 	ctx = d_tm_open(srv_idx);
 	if (!ctx)
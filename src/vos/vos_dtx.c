@@ -231,18 +231,6 @@ dtx_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
 	memcpy(hkey, key_iov->iov_buf, key_iov->iov_len);
 }
 
-static int
-dtx_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
-{
-	struct dtx_id	*hkey1 = (struct dtx_id *)&rec->rec_hkey[0];
-	struct dtx_id	*hkey2 = (struct dtx_id *)hkey;
-	int		 rc;
-
-	rc = memcmp(hkey1, hkey2, sizeof(struct dtx_id));
-
-	return dbtree_key_cmp_rc(rc);
-}
-
 static int
 dtx_act_ent_alloc(struct btr_instance *tins, d_iov_t *key_iov,
 		  d_iov_t *val_iov, struct btr_record *rec, d_iov_t *val_out)
@@ -331,7 +319,6 @@ dtx_act_ent_update(struct btr_instance *tins, struct btr_record *rec,
 static btr_ops_t dtx_active_btr_ops = {
 	.to_hkey_size	= dtx_hkey_size,
 	.to_hkey_gen	= dtx_hkey_gen,
-	.to_hkey_cmp	= dtx_hkey_cmp,
 	.to_rec_alloc	= dtx_act_ent_alloc,
 	.to_rec_free	= dtx_act_ent_free,
 	.to_rec_fetch	= dtx_act_ent_fetch,
@@ -421,7 +408,6 @@ dtx_cmt_ent_update(struct btr_instance *tins, struct btr_record *rec,
 static btr_ops_t dtx_committed_btr_ops = {
 	.to_hkey_size	= dtx_hkey_size,
 	.to_hkey_gen	= dtx_hkey_gen,
-	.to_hkey_cmp	= dtx_hkey_cmp,
 	.to_rec_alloc	= dtx_cmt_ent_alloc,
 	.to_rec_free	= dtx_cmt_ent_free,
 	.to_rec_fetch	= dtx_cmt_ent_fetch,
@@ -58,15 +58,6 @@ oi_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
 	memcpy(hkey, key_iov->iov_buf, sizeof(daos_unit_oid_t));
 }
 
-static int
-oi_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
-{
-	daos_unit_oid_t	*oid1 = (daos_unit_oid_t *)&rec->rec_hkey[0];
-	daos_unit_oid_t	*oid2 = (daos_unit_oid_t *)hkey;
-
-	return dbtree_key_cmp_rc(memcmp(oid1, oid2, sizeof(*oid1)));
-}
-
 static int
 oi_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov,
 	     d_iov_t *val_iov, struct btr_record *rec, d_iov_t *val_out)
@@ -198,7 +189,6 @@ static btr_ops_t oi_btr_ops = {
 	.to_rec_msize		= oi_rec_msize,
 	.to_hkey_size		= oi_hkey_size,
 	.to_hkey_gen		= oi_hkey_gen,
-	.to_hkey_cmp		= oi_hkey_cmp,
 	.to_rec_alloc		= oi_rec_alloc,
 	.to_rec_free		= oi_rec_free,
 	.to_rec_fetch		= oi_rec_fetch,
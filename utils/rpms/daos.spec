@@ -15,7 +15,7 @@
 
 Name:          daos
 Version:       2.5.100
-Release:       16%{?relval}%{?dist}
+Release:       17%{?relval}%{?dist}
 Summary:       DAOS Storage Engine
 
 License:       BSD-2-Clause-Patent
@@ -176,6 +176,9 @@ Requires: libfabric >= %{libfabric_version}
 %if (0%{?suse_version} >= 1500)
 Requires: libfabric1 >= %{libfabric_version}
 Requires: libfuse3-3 >= 3.4.2
+Requires: libhwloc15
+%else
+Requires: hwloc-libs
 %endif
 Requires: /usr/bin/fusermount3
 %{?systemd_requires}
@@ -586,6 +589,9 @@ getent passwd daos_agent >/dev/null || useradd -s /sbin/nologin -r -g daos_agent
 # No files in a shim package
 
 %changelog
+* Mon Oct 19 2026 agent <agent@local> 2.5.100-17
+- Add R: hwloc to daos-client, libdaos pins its EQ progress threads with it
+
 * Tue Feb 27 2024 Li Wei <wei.g.li@intel.com> 2.5.100-16
 - Update raft to 0.11.0-1.416.g12dbc15
 